@@ -165,44 +165,51 @@ void network_broadcast_api::on_applied_block(const signed_block& b)
 
     fc::async([this, capture_this, b]() {
         int32_t block_num = int32_t(b.block_num());
-        if (_callbacks.size())
+
+        // callbacks are invoked after the lock is released, they send to the client
+        vector<std::pair<confirmation_callback, transaction_confirmation>> confirmations;
         {
-            for (size_t trx_num = 0; trx_num < b.transactions.size(); ++trx_num)
+            std::lock_guard<std::mutex> lock(_callbacks_mutex);
+
+            if (_callbacks.size())
             {
-                const auto& trx = b.transactions[trx_num];
-                auto id = trx.id();
-                auto itr = _callbacks.find(id);
-                if (itr == _callbacks.end())
-                    continue;
-                confirmation_callback callback = itr->second;
-                itr->second = [](variant) {};
-                callback(fc::variant(transaction_confirmation(id, block_num, int32_t(trx_num), false)));
+                for (size_t trx_num = 0; trx_num < b.transactions.size(); ++trx_num)
+                {
+                    const auto& trx = b.transactions[trx_num];
+                    auto id = trx.id();
+                    auto itr = _callbacks.find(id);
+                    if (itr == _callbacks.end())
+                        continue;
+                    confirmations.emplace_back(itr->second, transaction_confirmation(id, block_num, int32_t(trx_num), false));
+                    itr->second = [](variant) {};
+                }
             }
-        }
 
-        /// clear all expirations
-        while (true)
-        {
-            auto exp_it = _callbacks_expirations.begin();
-            if (exp_it == _callbacks_expirations.end())
-                break;
-            if (exp_it->first >= b.timestamp)
-                break;
-            for (const transaction_id_type& txid : exp_it->second)
+            /// clear all expirations
+            while (true)
             {
-                auto cb_it = _callbacks.find(txid);
-                // If it's empty, that means the transaction has been confirmed and has been deleted by the above check.
-                if (cb_it == _callbacks.end())
-                    continue;
-
-                confirmation_callback callback = cb_it->second;
-                transaction_id_type txid_byval = txid; // can't pass in by reference as it's going to be deleted
-                callback(fc::variant(transaction_confirmation{ txid_byval, block_num, -1, true }));
-
-                _callbacks.erase(cb_it);
+                auto exp_it = _callbacks_expirations.begin();
+                if (exp_it == _callbacks_expirations.end())
+                    break;
+                if (exp_it->first >= b.timestamp)
+                    break;
+                for (const transaction_id_type& txid : exp_it->second)
+                {
+                    auto cb_it = _callbacks.find(txid);
+                    // If it's empty, that means the transaction has been confirmed and has been deleted by the above check.
+                    if (cb_it == _callbacks.end())
+                        continue;
+
+                    confirmations.emplace_back(cb_it->second, transaction_confirmation{ txid, block_num, -1, true });
+
+                    _callbacks.erase(cb_it);
+                }
+                _callbacks_expirations.erase(exp_it);
             }
-            _callbacks_expirations.erase(exp_it);
         }
+
+        for (const auto& confirmation : confirmations)
+            confirmation.first(fc::variant(confirmation.second));
     }); /// fc::async
 }
 
@@ -287,8 +294,11 @@ void network_broadcast_api::broadcast_transaction_with_callback(confirmation_cal
     {
         FC_ASSERT(!check_max_block_age(_max_block_age));
         trx.validate();
-        _callbacks[trx.id()] = cb;
-        _callbacks_expirations[trx.expiration].push_back(trx.id());
+        {
+            std::lock_guard<std::mutex> lock(_callbacks_mutex);
+            _callbacks[trx.id()] = cb;
+            _callbacks_expirations[trx.expiration].push_back(trx.id());
+        }
 
         _app.chain_database()->push_transaction(trx);
         _app.p2p_node()->broadcast_transaction(trx);
@@ -335,5 +345,10 @@ void network_node_api::set_advanced_node_parameters(const fc::variant_object& pa
 {
     return _app.p2p_node()->set_advanced_node_parameters(params);
 }
+
+std::map<std::string, api_method_stats> network_node_api::get_api_stats() const
+{
+    return _app.get_api_stats();
+}
 }
 } // deip::app
@@ -0,0 +1,290 @@
+#include <deip/app/api_thread_pool.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <graphene/utilities/metrics.hpp>
+
+#include <algorithm>
+
+namespace deip {
+namespace app {
+
+namespace {
+
+using graphene::utilities::metrics;
+
+graphene::utilities::gauge& queued_calls_metric()
+{
+    static graphene::utilities::gauge& queued = metrics().get_gauge("deip_api_queued_calls", "API calls waiting for a thread");
+    return queued;
+}
+}
+
+api_thread_pool::api_thread_pool(uint32_t num_threads,
+                                 const fc::microseconds& deadline,
+                                 const std::map<std::string, uint32_t>& method_concurrency)
+    : _deadline(deadline)
+    , _method_concurrency(method_concurrency)
+{
+    FC_ASSERT(num_threads > 0, "At least one API thread is required");
+
+    _thread_pool.resize(num_threads);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        _thread_pool[i] = std::make_shared<fc::thread>("api");
+        _idle_threads.push_back(i);
+    }
+}
+
+api_thread_pool::~api_thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.clear();
+    }
+
+    for (const auto& thread : _thread_pool)
+        thread->quit();
+}
+
+void api_thread_pool::post(const std::string& method, std::function<void()> run, std::function<void()> expire)
+{
+    post(nullptr, method, std::move(run), std::move(expire));
+}
+
+void api_thread_pool::post(const void* sequence,
+                           const std::string& method,
+                           std::function<void()> run,
+                           std::function<void()> expire)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _queue.push_back({ sequence, method, fc::time_point::now(), std::move(run), std::move(expire) });
+    dispatch();
+}
+
+std::map<std::string, api_method_stats> api_thread_pool::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void api_thread_pool::dispatch()
+{
+    // sequences with a call left in the queue, their later calls wait behind it
+    std::set<const void*> waiting_sequences;
+
+    auto itr = _queue.begin();
+    while (!_idle_threads.empty() && itr != _queue.end())
+    {
+        if (itr->sequence
+            && (_running_sequences.count(itr->sequence) || waiting_sequences.count(itr->sequence)))
+        {
+            ++itr;
+            continue;
+        }
+
+        auto limit = _method_concurrency.find(itr->method);
+        if (limit != _method_concurrency.end() && _running[itr->method] >= limit->second)
+        {
+            if (itr->sequence)
+                waiting_sequences.insert(itr->sequence);
+            ++itr;
+            continue;
+        }
+
+        const size_t thread_index = _idle_threads.back();
+        _idle_threads.pop_back();
+        ++_running[itr->method];
+        if (itr->sequence)
+            _running_sequences.insert(itr->sequence);
+
+        call c = std::move(*itr);
+        itr = _queue.erase(itr);
+
+        _thread_pool[thread_index]->async([this, thread_index, c]() { execute(thread_index, c); }, "api call");
+    }
+
+    queued_calls_metric().set(_queue.size());
+}
+
+void api_thread_pool::execute(size_t thread_index, const call& c)
+{
+    bool expired = false;
+
+    if (_deadline.count() > 0 && fc::time_point::now() - c.queued > _deadline)
+    {
+        expired = true;
+        try
+        {
+            c.expire();
+        }
+        catch (const fc::exception& e)
+        {
+            wlog("Failed to cancel API call ${m}: ${e}", ("m", c.method)("e", e.to_detail_string()));
+        }
+    }
+    else
+    {
+        try
+        {
+            c.run();
+        }
+        catch (const fc::exception& e)
+        {
+            wlog("API call ${m} failed: ${e}", ("m", c.method)("e", e.to_detail_string()));
+        }
+        catch (const std::exception& e)
+        {
+            wlog("API call ${m} failed: ${e}", ("m", c.method)("e", e.what()));
+        }
+    }
+
+    const int64_t latency = std::max<int64_t>((fc::time_point::now() - c.queued).count(), 0);
+
+    const graphene::utilities::metric_labels labels = { { "method", c.method } };
+    if (expired)
+    {
+        metrics().get_counter("deip_api_calls_expired_total", "API calls cancelled at their deadline", labels).inc();
+    }
+    else
+    {
+        static const std::vector<double> bounds = graphene::utilities::histogram::exponential_bounds(0.0001, 2, 18);
+        metrics()
+            .get_histogram("deip_api_call_seconds", "Latency of API calls, queueing included", bounds, labels)
+            .observe(latency / 1000000.0);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    api_method_stats& stats = _stats[c.method];
+    if (expired)
+    {
+        ++stats.expired;
+    }
+    else
+    {
+        size_t bucket = 0;
+        while (bucket + 1 < histogram_size && (uint64_t(1) << (bucket + 1)) <= uint64_t(latency))
+            ++bucket;
+
+        stats.latency_histogram.resize(histogram_size);
+        ++stats.latency_histogram[bucket];
+        ++stats.calls;
+        stats.total_latency_us += latency;
+    }
+
+    --_running[c.method];
+    if (c.sequence)
+        _running_sequences.erase(c.sequence);
+    _idle_threads.push_back(thread_index);
+    dispatch();
+}
+
+pooled_websocket_api_connection::pooled_websocket_api_connection(const fc::http::websocket_connection_ptr& c,
+                                                                 const std::shared_ptr<api_thread_pool>& pool,
+                                                                 const request_handler& handler)
+    : binary_websocket_api_connection(c, handler)
+    , _pool(pool)
+{
+    // replaces the handler installed by websocket_api_connection, which executes calls in place
+    c->on_message_handler([this](const std::string& message) { on_pooled_message(message); });
+}
+
+void pooled_websocket_api_connection::on_pooled_message(const std::string& message)
+{
+    if (is_binary_rpc_frame(message))
+    {
+        on_pooled_binary_message(message);
+        return;
+    }
+
+    std::string method = "unknown";
+    fc::variant id;
+
+    try
+    {
+        const fc::variant_object request = fc::json::from_string(message).get_object();
+        if (request.contains("id"))
+            id = request["id"];
+
+        if (request.contains("method"))
+        {
+            method = request["method"].as_string();
+
+            // "call" requests are [api, method, args], account them to the called method
+            if (method == "call" && request.contains("params"))
+            {
+                const auto& params = request["params"].get_array();
+                if (params.size() > 1 && params[1].is_string())
+                    method = params[1].as_string();
+            }
+        }
+    }
+    catch (const fc::exception&)
+    {
+        // malformed requests are reported by websocket_api_connection itself
+    }
+
+    auto self = std::static_pointer_cast<pooled_websocket_api_connection>(shared_from_this());
+    auto weak_connection = _weak_connection;
+
+    // the API tables of the connection are not synchronized and requests may depend on earlier ones
+    _pool->post(this, method,
+                [self, weak_connection, message]() {
+                    auto connection = weak_connection.lock();
+                    if (!connection)
+                        return;
+                    self->on_message(message, true);
+                },
+                [weak_connection, id, method]() {
+                    auto connection = weak_connection.lock();
+                    if (!connection)
+                        return;
+
+                    fc::mutable_variant_object error;
+                    error("code", -32000)("message", "API call " + method + " was not started before its deadline");
+
+                    fc::mutable_variant_object response;
+                    response("id", id)("jsonrpc", "2.0")("error", error);
+
+                    connection->send_message(fc::json::to_string(response));
+                });
+}
+
+void pooled_websocket_api_connection::on_pooled_binary_message(const std::string& message)
+{
+    binary_rpc_request request;
+    try
+    {
+        request = unpack_binary_rpc_frame<binary_rpc_request>(message);
+    }
+    catch (const fc::exception& e)
+    {
+        binary_rpc_response response;
+        response.error = "Malformed binary RPC request: " + e.to_string();
+        send_binary_response(response);
+        return;
+    }
+
+    auto self = std::static_pointer_cast<pooled_websocket_api_connection>(shared_from_this());
+
+    // accounted to the called method like JSON calls, so that the same concurrency limits apply,
+    // and in order with them
+    _pool->post(this, request.method,
+                [self, request]() {
+                    if (self->_weak_connection.expired())
+                        return;
+                    self->on_binary_request(request);
+                },
+                [self, request]() {
+                    binary_rpc_response response;
+                    response.id = request.id;
+                    response.error = "API call " + request.method + " was not started before its deadline";
+                    self->send_binary_response(response);
+                });
+}
+}
+}
@@ -23,12 +23,16 @@
  */
 #include <deip/app/api.hpp>
 #include <deip/app/api_access.hpp>
+#include <deip/app/api_thread_pool.hpp>
 #include <deip/app/application.hpp>
+#include <deip/app/metrics_server.hpp>
 #include <deip/app/plugin.hpp>
 
 #include <deip/chain/schema/deip_objects.hpp>
 #include <deip/chain/schema/deip_object_types.hpp>
 #include <deip/chain/database/database_exceptions.hpp>
+#include <deip/chain/database/block_prevalidator.hpp>
+#include <deip/chain/genesis_reader.hpp>
 #include <deip/chain/genesis_state.hpp>
 #include <deip/egenesis/egenesis.hpp>
 
@@ -52,6 +56,7 @@
 #include <boost/signals2.hpp>
 #include <boost/range/algorithm/reverse.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 #include <fc/log/file_appender.hpp>
@@ -93,6 +98,7 @@ public:
     fc::optional<fc::temp_file> _lock_file;
     bool _is_block_producer = false;
     bool _force_validate = false;
+    std::unique_ptr<chain::block_prevalidator> _block_prevalidator;
 
     void reset_p2p_node(const fc::path& data_dir)
     {
@@ -206,6 +212,22 @@ public:
         FC_CAPTURE_AND_RETHROW()
     }
 
+    void reset_metrics_server()
+    {
+        try
+        {
+            if (!_options->count("metrics-endpoint"))
+                return;
+
+            auto metrics_endpoint = _options->at("metrics-endpoint").as<string>();
+            ilog("Configured metrics to be served on ${ip}", ("ip", metrics_endpoint));
+            auto endpoints = resolve_string_to_ip_endpoints(metrics_endpoint);
+            FC_ASSERT(endpoints.size(), "metrics-endpoint ${hostname} did not resolve", ("hostname", metrics_endpoint));
+            _metrics_server = std::make_shared<metrics_server>(endpoints[0]);
+        }
+        FC_CAPTURE_AND_RETHROW()
+    }
+
     void reset_websocket_tls_server()
     {
         try
@@ -235,10 +257,59 @@ public:
         FC_CAPTURE_AND_RETHROW()
     }
 
+    void reset_api_thread_pool()
+    {
+        try
+        {
+            const uint32_t api_threads = _options->at("api-threads").as<uint32_t>();
+            if (api_threads == 0)
+                return;
+
+            std::map<std::string, uint32_t> method_concurrency;
+            if (_options->count("api-method-concurrency"))
+            {
+                for (const std::string& arg : _options->at("api-method-concurrency").as<std::vector<std::string>>())
+                {
+                    const auto pos = arg.rfind(':');
+                    FC_ASSERT(pos != std::string::npos && pos > 0 && pos + 1 < arg.size(),
+                              "api-method-concurrency ${a} is not in the METHOD:LIMIT form", ("a", arg));
+                    method_concurrency[arg.substr(0, pos)] = boost::lexical_cast<uint32_t>(arg.substr(pos + 1));
+                }
+            }
+
+            // a synchronous broadcast holds its thread until the transaction is in a block
+            if (!method_concurrency.count("broadcast_transaction_synchronous"))
+                method_concurrency["broadcast_transaction_synchronous"] = std::max<uint32_t>(api_threads / 4, 1);
+
+            const auto deadline = fc::milliseconds(_options->at("api-request-deadline").as<uint32_t>());
+
+            ilog("Executing API calls in ${n} threads", ("n", api_threads));
+            _api_thread_pool = std::make_shared<api_thread_pool>(api_threads, deadline, method_concurrency);
+        }
+        FC_CAPTURE_AND_RETHROW()
+    }
+
     void on_connection(const fc::http::websocket_connection_ptr& c)
     {
         std::shared_ptr<api_session_data> session = std::make_shared<api_session_data>();
-        session->wsc = std::make_shared<fc::rpc::websocket_api_connection>(*c);
+        std::weak_ptr<api_session_data> weak_session = session;
+
+        auto binary_request_handler = [this, weak_session](const binary_rpc_request& request) -> binary_rpc_response {
+            auto locked_session = weak_session.lock();
+            if (!locked_session)
+            {
+                binary_rpc_response response;
+                response.id = request.id;
+                response.error = "Connection is closed";
+                return response;
+            }
+            return call_binary_api(*locked_session, request);
+        };
+
+        if (_api_thread_pool)
+            session->wsc = std::make_shared<pooled_websocket_api_connection>(c, _api_thread_pool, binary_request_handler);
+        else
+            session->wsc = std::make_shared<binary_websocket_api_connection>(c, binary_request_handler);
 
         for (const std::string& name : _public_apis)
         {
@@ -271,27 +342,32 @@ public:
         _self->register_api_factory<database_api>("database_api");
         _self->register_api_factory<network_node_api>("network_node_api");
         _self->register_api_factory<network_broadcast_api>("network_broadcast_api");
+        _self->register_binary_api_factory<login_api>("login_api");
+        _self->register_binary_api_factory<database_api>("database_api");
     }
 
     void compute_genesis_state(deip::chain::genesis_state_type& genesis_state)
     {
-        std::string genesis_str;
+        std::shared_ptr<deip::chain::genesis_reader> reader;
 
         if (_options->count("genesis-json"))
         {
             fc::path genesis_json_filename = _options->at("genesis-json").as<boost::filesystem::path>();
 
-            fc::read_file_contents(genesis_json_filename, genesis_str);
+            // mapped and read record by record in init_genesis, the file may not fit in memory once parsed
+            reader = std::make_shared<deip::chain::genesis_reader>(genesis_json_filename);
         }
         else
         {
+            std::string genesis_str;
             deip::egenesis::compute_egenesis_json(genesis_str);
-        }
 
-        FC_ASSERT(!genesis_str.empty());
+            FC_ASSERT(!genesis_str.empty());
+            reader = std::make_shared<deip::chain::genesis_reader>(std::move(genesis_str));
+        }
 
-        genesis_state = fc::json::from_string(genesis_str).as<genesis_state_type>();
-        genesis_state.initial_chain_id = fc::sha256::hash(genesis_str);
+        genesis_state = reader->header();
+        genesis_state.initial_chain_id = reader->chain_id();
     }
 
     void startup()
@@ -303,9 +379,6 @@ public:
 
             ilog("node chain ID: ${chain_id}", ("chain_id", genesis_state.initial_chain_id));
 
-            if (_options->count("data-dir"))
-                _data_dir = fc::path(_options->at("data-dir").as<boost::filesystem::path>());
-
             _shared_file_size = fc::parse_size(_options->at("shared-file-size").as<std::string>());
             ilog("shared_file_size is ${n} bytes", ("n", _shared_file_size));
             bool read_only = _options->count("read-only");
@@ -338,6 +411,9 @@ public:
                     _chain_db->wipe(_data_dir / "blockchain", _shared_dir, true);
 
                 _chain_db->set_flush_interval(_options->at("flush").as<uint32_t>());
+                _chain_db->set_block_log_queue_size(_options->at("block-log-queue-size").as<uint32_t>());
+                _chain_db->set_transaction_verification_threads(
+                    _options->at("transaction-verification-threads").as<uint32_t>());
 
                 flat_map<uint32_t, block_id_type> loaded_checkpoints;
                 if (_options->count("checkpoint"))
@@ -386,6 +462,13 @@ public:
                     ilog("All transaction signatures will be validated");
                     _force_validate = true;
                 }
+
+                const uint32_t sync_verification_threads = _options->at("sync-verification-threads").as<uint32_t>();
+                if (sync_verification_threads > 0 && !_force_validate)
+                {
+                    ilog("Verifying sync blocks ahead of application in ${n} threads", ("n", sync_verification_threads));
+                    _block_prevalidator.reset(new chain::block_prevalidator(sync_verification_threads));
+                }
             }
             else
             {
@@ -453,8 +536,12 @@ public:
                 reset_p2p_node(_data_dir);
             }
 
+            reset_api_thread_pool();
+            _binary_rpc_enabled = _options->at("rpc-binary").as<bool>();
+
             reset_websocket_server();
             reset_websocket_tls_server();
+            reset_metrics_server();
         }
         FC_LOG_AND_RETHROW()
     }
@@ -493,6 +580,72 @@ public:
         return it->second(ctx);
     }
 
+    void register_binary_api_factory(const std::string& name,
+                                     std::function<std::shared_ptr<binary_api>(const fc::api_ptr&)> factory)
+    {
+        _binary_api_factories_by_name[name] = factory;
+    }
+
+    std::shared_ptr<binary_api> get_binary_api(api_session_data& session, const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(session.binary_api_mutex);
+
+        auto cached = session.binary_api_map.find(name);
+        if (cached != session.binary_api_map.end())
+            return cached->second;
+
+        // only the APIs of the session, so that login permissions apply as they do to JSON calls
+        auto api = session.api_map.find(name);
+        FC_ASSERT(api != session.api_map.end() && api->second, "API ${api} is not available on this connection",
+                  ("api", name));
+
+        auto factory = _binary_api_factories_by_name.find(name);
+        FC_ASSERT(factory != _binary_api_factories_by_name.end(), "API ${api} is not callable over binary RPC",
+                  ("api", name));
+
+        std::shared_ptr<binary_api> result = factory->second(api->second);
+        FC_ASSERT(result, "API ${api} is not callable over binary RPC", ("api", name));
+
+        session.binary_api_map[name] = result;
+        return result;
+    }
+
+    binary_rpc_response call_binary_api(api_session_data& session, const binary_rpc_request& request)
+    {
+        binary_rpc_response response;
+        response.id = request.id;
+
+        try
+        {
+            if (request.api == binary_rpc_negotiate_api && request.method == binary_rpc_negotiate_method)
+            {
+                FC_ASSERT(_binary_rpc_enabled, "Binary RPC is disabled on this node");
+
+                const uint32_t client_version = fc::raw::unpack<uint32_t>(request.params);
+                FC_ASSERT(client_version > 0, "Binary RPC version must be positive");
+
+                const uint32_t version = std::min(client_version, binary_rpc_version);
+                session.binary_rpc_version = version;
+                response.result = fc::raw::pack(version);
+                return response;
+            }
+
+            FC_ASSERT(session.binary_rpc_version > 0, "Binary RPC has not been negotiated on this connection");
+
+            response.result = get_binary_api(session, request.api)->call(request.method, request.params);
+        }
+        catch (const fc::exception& e)
+        {
+            response.error = e.to_string();
+        }
+        catch (const std::exception& e)
+        {
+            response.error = std::string(e.what());
+        }
+
+        return response;
+    }
+
     /**
      * If delegate has the item, the network has no need to fetch it.
      */
@@ -558,14 +711,17 @@ public:
 
                 try
                 {
+                    uint32_t skip = (_is_block_producer | _force_validate) ? database::skip_nothing
+                                                                           : database::skip_transaction_signatures;
+
+                    if (sync_mode && _block_prevalidator)
+                        skip |= _block_prevalidator->get_skip_flags(*_chain_db, blk_msg.block);
+
                     // TODO: in the case where this block is valid but on a fork that's too old for us to switch to,
                     // you can help the network code out by throwing a block_older_than_undo_history exception.
                     // when the net code sees that, it will stop trying to push blocks from that chain, but
                     // leave that peer connected so that they can get sync blocks from us
-                    bool result = _chain_db->push_block(blk_msg.block,
-                                                        (_is_block_producer | _force_validate)
-                                                            ? database::skip_nothing
-                                                            : database::skip_transaction_signatures);
+                    bool result = _chain_db->push_block(blk_msg.block, skip);
 
                     if (!sync_mode)
                     {
@@ -599,6 +755,16 @@ public:
         FC_CAPTURE_AND_RETHROW((blk_msg)(sync_mode))
     }
 
+    /**
+     * @brief starts verification of a sync block's signature and merkle root while the blocks
+     * before it are still being applied
+     */
+    virtual void prevalidate_sync_block(const graphene::net::block_message& blk_msg) override
+    {
+        if (_running && _block_prevalidator)
+            _block_prevalidator->schedule(blk_msg.block);
+    }
+
     virtual void handle_transaction(const graphene::net::trx_message& transaction_message) override
     {
         try
@@ -1015,10 +1181,14 @@ public:
     std::shared_ptr<graphene::net::node> _p2p_network;
     std::shared_ptr<fc::http::websocket_server> _websocket_server;
     std::shared_ptr<fc::http::websocket_tls_server> _websocket_tls_server;
+    std::shared_ptr<api_thread_pool> _api_thread_pool;
+    std::shared_ptr<metrics_server> _metrics_server;
 
     std::map<string, std::shared_ptr<abstract_plugin>> _plugins_available;
     std::map<string, std::shared_ptr<abstract_plugin>> _plugins_enabled;
     flat_map<std::string, std::function<fc::api_ptr(const api_context&)>> _api_factories_by_name;
+    flat_map<std::string, std::function<std::shared_ptr<binary_api>(const fc::api_ptr&)>> _binary_api_factories_by_name;
+    bool _binary_rpc_enabled = true;
     std::vector<std::string> _public_apis;
     int32_t _max_block_age = -1;
     uint64_t _shared_file_size;
@@ -1079,6 +1249,11 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("shared-file-size", bpo::value<string>()->default_value("54G"), "Size of the shared memory file. Default: 54G")
          ("rpc-endpoint", bpo::value<string>()->implicit_value("127.0.0.1:8090"), "Endpoint for websocket RPC to listen on")
          ("rpc-tls-endpoint", bpo::value<string>()->implicit_value("127.0.0.1:8089"), "Endpoint for TLS websocket RPC to listen on")
+         ("api-threads", bpo::value< uint32_t >()->default_value(4), "Number of threads executing websocket API calls, 0 to execute them on the server thread")
+         ("api-request-deadline", bpo::value< uint32_t >()->default_value(10000), "Milliseconds an API call may wait for a thread before it is cancelled, 0 for no deadline")
+         ("api-method-concurrency", bpo::value< vector<string> >()->composing(), "METHOD:LIMIT pair limiting the number of concurrently executing calls of an API method, may be specified multiple times. broadcast_transaction_synchronous is limited to a quarter of api-threads unless specified")
+         ("rpc-binary", bpo::value< bool >()->default_value(true), "Let websocket RPC clients switch their connection to binary fc::raw framing")
+         ("metrics-endpoint", bpo::value<string>()->implicit_value("127.0.0.1:9100"), "Local endpoint to serve node metrics on at /metrics, in the Prometheus text format")
          ("read-forward-rpc", bpo::value<string>(), "Endpoint to forward write API calls to for a read node" )
          ("server-pem,p", bpo::value<string>()->implicit_value("server.pem"), "The TLS certificate file for this server")
          ("server-pem-password,P", bpo::value<string>()->implicit_value(""), "Password for this certificate")
@@ -1086,7 +1261,10 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("public-api", bpo::value< vector<string> >()->composing()->default_value(default_apis, str_default_apis), "Set an API to be publicly available, may be specified multiple times")
          ("enable-plugin", bpo::value< vector<string> >()->composing()->default_value(default_plugins, str_default_plugins), "Plugin(s) to enable, may be specified multiple times")
          ("max-block-age", bpo::value< int32_t >()->default_value(200), "Maximum age of head block when broadcasting tx via API")
-         ("flush", bpo::value< uint32_t >()->default_value(100000), "Flush shared memory file to disk this many blocks")
+         ("flush", bpo::value< uint32_t >()->default_value(100000), "Checkpoint the shared memory file to disk every this many blocks, so that a killed node resumes without a reindex. A node whose host crashed is reindexed")
+         ("block-log-queue-size", bpo::value< uint32_t >()->default_value(1024), "Maximum number of irreversible blocks waiting to be written to the block log")
+         ("sync-verification-threads", bpo::value< uint32_t >()->default_value(2), "Number of threads verifying block signatures and merkle roots ahead of application during sync, 0 to disable")
+         ("transaction-verification-threads", bpo::value< uint32_t >()->default_value(2), "Number of threads verifying the transactions of each block ahead of their application, 0 to disable")
          ("genesis-json,g", bpo::value<boost::filesystem::path>(), "File to read genesis state from")
          ("tenant", bpo::value<string>()->default_value(""), "Tenant marker for transactions");
     command_line_options.add(configuration_file_options);
@@ -1214,6 +1392,13 @@ void application::initialize(const boost::program_options::variables_map& option
     ilog("initializing node with config:\n${config}", ("config", print_config(options)));
 
     my->_options = &options;
+
+    if (options.count("data-dir"))
+    {
+        my->_data_dir = fc::path(options.at("data-dir").as<boost::filesystem::path>());
+        if (my->_data_dir.is_relative())
+            my->_data_dir = fc::current_path() / my->_data_dir;
+    }
 }
 
 void application::startup()
@@ -1247,6 +1432,13 @@ std::shared_ptr<abstract_plugin> application::get_plugin(const string& name) con
     return null_plugin;
 }
 
+std::map<std::string, api_method_stats> application::get_api_stats() const
+{
+    if (!my->_api_thread_pool)
+        return {};
+    return my->_api_thread_pool->get_stats();
+}
+
 graphene::net::node_ptr application::p2p_node()
 {
     return my->_p2p_network;
@@ -1257,6 +1449,11 @@ std::shared_ptr<chain::database> application::chain_database() const
     return my->_chain_db;
 }
 
+fc::path application::data_dir() const
+{
+    return my->_data_dir;
+}
+
 void application::set_block_production(bool producing_blocks)
 {
     my->_is_block_producer = producing_blocks;
@@ -1282,6 +1479,17 @@ fc::api_ptr application::create_api_by_name(const api_context& ctx)
     return my->create_api_by_name(ctx);
 }
 
+void application::register_binary_api_factory(const string& name,
+                                              std::function<std::shared_ptr<binary_api>(const fc::api_ptr&)> factory)
+{
+    my->register_binary_api_factory(name, factory);
+}
+
+binary_rpc_response application::call_binary_api(api_session_data& session, const binary_rpc_request& request)
+{
+    return my->call_binary_api(session, request);
+}
+
 void application::get_max_block_age(int32_t& result)
 {
     my->get_max_block_age(result);
@@ -0,0 +1,171 @@
+#include <deip/app/binary_rpc.hpp>
+
+#include <fc/crypto/base64.hpp>
+#include <fc/exception/exception.hpp>
+
+namespace deip {
+namespace app {
+
+namespace {
+
+const size_t binary_rpc_frame_prefix_size = sizeof(binary_rpc_frame_prefix) - 1;
+
+template <typename T> std::string pack_frame(const T& value)
+{
+    const std::vector<char> packed = fc::raw::pack(value);
+    return binary_rpc_frame_prefix + fc::base64_encode(std::string(packed.begin(), packed.end()));
+}
+}
+
+bool is_binary_rpc_frame(const std::string& message)
+{
+    return message.compare(0, binary_rpc_frame_prefix_size, binary_rpc_frame_prefix) == 0;
+}
+
+std::string pack_binary_rpc_frame(const binary_rpc_request& request)
+{
+    return pack_frame(request);
+}
+
+std::string pack_binary_rpc_frame(const binary_rpc_response& response)
+{
+    return pack_frame(response);
+}
+
+template <typename T> T unpack_binary_rpc_frame(const std::string& message)
+{
+    FC_ASSERT(is_binary_rpc_frame(message), "Message is not a binary RPC frame");
+
+    const std::string packed = fc::base64_decode(message.substr(binary_rpc_frame_prefix_size));
+    return fc::raw::unpack<T>(std::vector<char>(packed.begin(), packed.end()));
+}
+
+template binary_rpc_request unpack_binary_rpc_frame<binary_rpc_request>(const std::string& message);
+template binary_rpc_response unpack_binary_rpc_frame<binary_rpc_response>(const std::string& message);
+
+std::vector<char> binary_api::call(const std::string& method, const std::vector<char>& params) const
+{
+    auto itr = _methods.find(method);
+    FC_ASSERT(itr != _methods.end(), "Method ${m} is not callable over binary RPC", ("m", method));
+    return itr->second(params);
+}
+
+binary_websocket_api_connection::binary_websocket_api_connection(const fc::http::websocket_connection_ptr& c,
+                                                                 const request_handler& handler)
+    : fc::rpc::websocket_api_connection(*c)
+    , _weak_connection(c)
+    , _handler(handler)
+{
+    // replaces the handler installed by websocket_api_connection, which only understands JSON
+    c->on_message_handler([this](const std::string& message) { on_websocket_message(message); });
+}
+
+void binary_websocket_api_connection::on_websocket_message(const std::string& message)
+{
+    if (!is_binary_rpc_frame(message))
+    {
+        on_message(message, true);
+        return;
+    }
+
+    binary_rpc_request request;
+    try
+    {
+        request = unpack_binary_rpc_frame<binary_rpc_request>(message);
+    }
+    catch (const fc::exception& e)
+    {
+        binary_rpc_response response;
+        response.error = "Malformed binary RPC request: " + e.to_string();
+        send_binary_response(response);
+        return;
+    }
+
+    on_binary_request(request);
+}
+
+void binary_websocket_api_connection::on_binary_request(const binary_rpc_request& request)
+{
+    send_binary_response(_handler(request));
+}
+
+void binary_websocket_api_connection::send_binary_response(const binary_rpc_response& response)
+{
+    auto connection = _weak_connection.lock();
+    if (!connection)
+        return;
+
+    connection->send_message(pack_binary_rpc_frame(response));
+}
+
+binary_rpc_client::binary_rpc_client(const fc::http::websocket_connection_ptr& c)
+    : _connection(c)
+{
+    _connection->on_message_handler([this](const std::string& message) { on_message(message); });
+}
+
+binary_rpc_client::~binary_rpc_client()
+{
+    _connection->on_message_handler([](const std::string&) {});
+}
+
+uint32_t binary_rpc_client::negotiate(uint32_t version)
+{
+    return call<uint32_t>(binary_rpc_negotiate_api, binary_rpc_negotiate_method, version);
+}
+
+std::vector<char> binary_rpc_client::send(binary_rpc_request& request)
+{
+    fc::promise<binary_rpc_response>::ptr response_promise(new fc::promise<binary_rpc_response>("binary_rpc_client::send"));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request.id = _next_id++;
+        _awaiting_responses[request.id] = response_promise;
+    }
+
+    try
+    {
+        _connection->send_message(pack_binary_rpc_frame(request));
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _awaiting_responses.erase(request.id);
+        throw;
+    }
+
+    const binary_rpc_response response = fc::future<binary_rpc_response>(response_promise).wait();
+
+    FC_ASSERT(!response.error.valid(), "${api}.${method} failed: ${e}",
+              ("api", request.api)("method", request.method)("e", *response.error));
+    return response.result;
+}
+
+void binary_rpc_client::on_message(const std::string& message)
+{
+    try
+    {
+        const binary_rpc_response response = unpack_binary_rpc_frame<binary_rpc_response>(message);
+
+        fc::promise<binary_rpc_response>::ptr response_promise;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto itr = _awaiting_responses.find(response.id);
+            if (itr == _awaiting_responses.end())
+            {
+                wlog("Unexpected binary RPC response ${id}", ("id", response.id));
+                return;
+            }
+            response_promise = itr->second;
+            _awaiting_responses.erase(itr);
+        }
+
+        response_promise->set_value(response);
+    }
+    catch (const fc::exception& e)
+    {
+        wlog("Malformed binary RPC response: ${e}", ("e", e.to_detail_string()));
+    }
+}
+}
+}
@@ -56,6 +56,7 @@ public:
 
     // Subscriptions
     void set_block_applied_callback(std::function<void(const variant& block_id)> cb);
+    void set_changed_objects_callback(std::function<void(const variant& changeset)> cb);
 
     // Blocks and transactions
     optional<signed_block_api_obj> get_block(uint32_t block_num) const;
@@ -230,12 +231,15 @@ public:
 
     // signal handlers
     void on_applied_block(const chain::signed_block& b);
+    void on_changed_objects(const chain::block_changeset& changeset);
 
     std::function<void(const fc::variant&)> _block_applied_callback;
+    std::function<void(const fc::variant&)> _changed_objects_callback;
 
     deip::chain::database& _db;
 
     boost::signals2::scoped_connection _block_applied_connection;
+    boost::signals2::scoped_connection _changed_objects_connection;
 
     bool _disable_get_block = false;
 };
@@ -269,6 +273,29 @@ void database_api_impl::set_block_applied_callback(std::function<void(const vari
     _block_applied_connection = connect_signal(_db.applied_block, *this, &database_api_impl::on_applied_block);
 }
 
+void database_api::set_changed_objects_callback(std::function<void(const variant& changeset)> cb)
+{
+    my->_db.with_read_lock([&]() { my->set_changed_objects_callback(cb); });
+}
+
+void database_api_impl::on_changed_objects(const chain::block_changeset& changeset)
+{
+    try
+    {
+        _changed_objects_callback(fc::variant(changeset));
+    }
+    catch (...)
+    {
+        _changed_objects_connection.release();
+    }
+}
+
+void database_api_impl::set_changed_objects_callback(std::function<void(const variant& changeset)> cb)
+{
+    _changed_objects_callback = cb;
+    _changed_objects_connection = connect_signal(_db.changed_objects, *this, &database_api_impl::on_changed_objects);
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Constructors                                                     //
@@ -410,7 +437,7 @@ vector<optional<account_api_obj>> database_api_impl::get_accounts(const set<stri
             const auto& auth = accounts_service.get_account_authority(name);
             const auto& account_balances = account_balances_service.get_account_balances_by_owner(name);
 
-            result = account_api_obj(account, auth, account_balances);
+            result = account_api_obj(account, auth, account_balances, account_balances_service.get_pending_license_revenue(account.name));
         }
 
         results.push_back(result);
@@ -438,7 +465,7 @@ vector<account_api_obj> database_api_impl::lookup_accounts(const string& lower_b
     {
         const auto& auth = accounts_service.get_account_authority(account.name);
         const auto& account_balances = account_balances_service.get_account_balances_by_owner(account.name);
-        result.push_back(account_api_obj(account, auth, account_balances));
+        result.push_back(account_api_obj(account, auth, account_balances, account_balances_service.get_pending_license_revenue(account.name)));
     }
 
     return result;
@@ -581,7 +608,7 @@ vector<account_api_obj> database_api_impl::get_accounts_by_expert_discipline(con
         const auto& account = accounts_by_expert_discipline[i].get();
         const auto& auth = accounts_service.get_account_authority(account.name);
         const auto account_balances = account_balances_service.get_account_balances_by_owner(account.name);
-        result.push_back(account_api_obj(account, auth, account_balances));
+        result.push_back(account_api_obj(account, auth, account_balances, account_balances_service.get_pending_license_revenue(account.name)));
     }
 
     return result;
@@ -712,22 +739,18 @@ bool database_api::verify_authority(const signed_transaction& trx) const
 
 bool database_api_impl::verify_authority(const signed_transaction& trx) const
 {
+    auto& authorities = _db.get_authority_cache();
+
     auto get_active = [&](const string& account_name) {
-        return authority(_db.get<account_authority_object, by_account>(account_name).active);
+        return authorities.get_active(account_name);
     };
 
     auto get_owner = [&](const string& account_name) {
-        return authority(_db.get<account_authority_object, by_account>(account_name).owner);
+        return authorities.get_owner(account_name);
     };
 
     auto get_active_overrides = [&](const string& account_name, const uint16_t& op_tag) {
-        fc::optional<authority> result;
-        const auto& auth = _db.get<account_authority_object, by_account>(account_name);
-        if (auth.active_overrides.find(op_tag) != auth.active_overrides.end())
-        {
-            result = auth.active_overrides.at(op_tag);
-        }
-        return result;
+        return authorities.get_active_override(account_name, op_tag);
     };
 
     trx.verify_authority(get_chain_id(), get_active, get_owner, get_active_overrides);
@@ -838,7 +861,7 @@ state database_api::get_state(string path) const
                 const auto& auth = accounts_service.get_account_authority(acnt);
                 const auto balances = account_balances_service.get_account_balances_by_owner(acnt);
 
-                _state.accounts[acnt] = account_api_obj(account, auth, balances);
+                _state.accounts[acnt] = account_api_obj(account, auth, balances, account_balances_service.get_pending_license_revenue(account.name));
 
                 // auto& eacnt = _state.accounts[acnt];
                 if (part[1] == "transfers")
@@ -887,7 +910,7 @@ state database_api::get_state(string path) const
                 const auto& account = accounts_service.get_account(a);
                 const auto& auth = accounts_service.get_account_authority(a);
                 const auto balances = account_balances_service.get_account_balances_by_owner(a);
-                _state.accounts[a] = account_api_obj(account, auth, balances);
+                _state.accounts[a] = account_api_obj(account, auth, balances, account_balances_service.get_pending_license_revenue(account.name));
             }
 
             _state.witness_schedule = my->_db.get_witness_schedule_object();
@@ -1395,6 +1418,16 @@ fc::optional<expert_token_api_obj> database_api_impl::get_expert_token(const exp
             result = expert_token_api_obj(expert_token, discipline_opt->name);
         }
     }
+    else
+    {
+        // the id may be reserved for a token of the default expertise
+        const auto& implicit_token_opt = expert_token_service.get_implicit_expert_token_if_exists(id);
+        if (implicit_token_opt.valid())
+        {
+            const auto& discipline = _db.get<chain::discipline_object>(implicit_token_opt->discipline_id);
+            result = expert_token_api_obj(implicit_token_opt->id, implicit_token_opt->account_name, discipline, share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT));
+        }
+    }
     return result;
 }
 
@@ -1416,6 +1449,15 @@ vector<expert_token_api_obj> database_api_impl::get_expert_tokens_by_account_nam
             results.push_back(expert_token_api_obj(expert_token, fc::to_string(discipline.name)));
     }
 
+    for (const auto& implicit_token : expert_token_service.get_implicit_expert_tokens_by_account_name(account_name))
+    {
+        auto& discipline = discipline_service.get_discipline(implicit_token.discipline_id);
+        results.push_back(expert_token_api_obj(implicit_token.id, implicit_token.account_name, discipline, share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT)));
+    }
+
+    std::sort(results.begin(), results.end(),
+      [](const expert_token_api_obj& a, const expert_token_api_obj& b) { return a.id < b.id; });
+
     return results;
 }
 
@@ -1438,6 +1480,19 @@ vector<expert_token_api_obj> database_api_impl::get_expert_tokens_by_discipline(
         results.push_back(expert_token_api_obj(expert_token, fc::to_string(discipline.name)));
     }
 
+    const auto& discipline_opt = discipline_service.get_discipline_if_exists(discipline_external_id);
+    if (discipline_opt.valid())
+    {
+        const chain::discipline_object& discipline = (*discipline_opt).get();
+        for (const auto& implicit_token : expert_token_service.get_implicit_expert_tokens_by_discipline(discipline.id))
+        {
+            results.push_back(expert_token_api_obj(implicit_token.id, implicit_token.account_name, discipline, share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT)));
+        }
+    }
+
+    std::sort(results.begin(), results.end(),
+      [](const expert_token_api_obj& a, const expert_token_api_obj& b) { return a.id < b.id; });
+
     return results;
 }
 
@@ -2388,7 +2443,8 @@ std::map<discipline_id_type, share_type> database_api::calculate_research_eci(co
 {
     return my->_db.with_read_lock([&]() {
         const auto& research_service = my->_db.obtain_service<chain::dbs_research>();
-        return research_service.get_eci_evaluation(research_id);
+        const auto& research = research_service.get_research(research_id);
+        return std::map<discipline_id_type, share_type>(research.eci_per_discipline.begin(), research.eci_per_discipline.end());
     });
 }
 
@@ -2396,7 +2452,8 @@ std::map<discipline_id_type, share_type> database_api::calculate_research_conten
 {
     return my->_db.with_read_lock([&]() {
         const auto& research_content_service = my->_db.obtain_service<chain::dbs_research_content>();
-        return research_content_service.get_eci_evaluation(research_content_id);
+        const auto& research_content = research_content_service.get_research_content(research_content_id);
+        return std::map<discipline_id_type, share_type>(research_content.eci_per_discipline.begin(), research_content.eci_per_discipline.end());
     });
 }
 
@@ -2522,9 +2579,13 @@ vector<account_balance_api_obj> database_api_impl::get_account_assets_balances(c
     const auto& account_balance_service = _db.obtain_service<chain::dbs_account_balance>();
 
     auto account_balances = account_balance_service.get_account_balances_by_owner(owner);
+    const auto pending_license_revenue = account_balance_service.get_pending_license_revenue(owner);
 
     for (const chain::account_balance_object& account_balance : account_balances)
-        results.push_back(account_balance);
+    {
+        const auto itr = pending_license_revenue.find(account_balance.symbol);
+        results.push_back(account_balance_api_obj(account_balance, itr != pending_license_revenue.end() ? itr->second : share_type(0)));
+    }
 
     return results;
 }
@@ -2542,7 +2603,11 @@ vector<account_balance_api_obj> database_api_impl::get_accounts_asset_balances_b
     auto account_balances = account_balance_service.get_accounts_balances_by_symbol(symbol);
 
     for (const chain::account_balance_object& account_balance : account_balances)
-        results.push_back(account_balance);
+    {
+        const auto pending_license_revenue = account_balance_service.get_pending_license_revenue(account_balance.owner);
+        const auto itr = pending_license_revenue.find(account_balance.symbol);
+        results.push_back(account_balance_api_obj(account_balance, itr != pending_license_revenue.end() ? itr->second : share_type(0)));
+    }
 
     return results;
 }
@@ -2562,7 +2627,10 @@ fc::optional<account_balance_api_obj> database_api_impl::get_account_asset_balan
 
     if (opt.valid())
     {
-        result = account_balance_api_obj(*opt);
+        const chain::account_balance_object& account_balance = *opt;
+        const auto pending_license_revenue = account_balance_service.get_pending_license_revenue(owner);
+        const auto itr = pending_license_revenue.find(account_balance.symbol);
+        result = account_balance_api_obj(account_balance, itr != pending_license_revenue.end() ? itr->second : share_type(0));
     }
 
     return result;
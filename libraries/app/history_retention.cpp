@@ -0,0 +1,45 @@
+#include <deip/app/history_retention.hpp>
+
+#include <deip/protocol/config.hpp>
+
+namespace deip {
+namespace app {
+
+fc::time_point_sec history_retention::age_cutoff(const chain::database& db) const
+{
+    const uint64_t age = uint64_t(max_age_blocks) * DEIP_BLOCK_INTERVAL;
+    const uint32_t now = db.head_block_time().sec_since_epoch();
+    return fc::time_point_sec(now > age ? uint32_t(now - age) : 0);
+}
+
+void history_retention::add_program_options(boost::program_options::options_description& cfg,
+                                            const std::string& prefix)
+{
+    namespace bpo = boost::program_options;
+
+    // clang-format off
+    cfg.add_options()
+        ((prefix + "-retention-blocks").c_str(), bpo::value<uint32_t>()->default_value(0), "Prune history entries older than this many blocks, 0 to keep them")
+        ((prefix + "-retention-objects").c_str(), bpo::value<uint32_t>()->default_value(0), "Prune the oldest history entries beyond this number, 0 to keep them")
+        ((prefix + "-prune-batch").c_str(), bpo::value<uint32_t>()->default_value(1000), "Maximum number of history entries pruned per block");
+    // clang-format on
+}
+
+history_retention history_retention::from_options(const boost::program_options::variables_map& options,
+                                                  const std::string& prefix)
+{
+    history_retention retention;
+
+    if (options.count(prefix + "-retention-blocks"))
+        retention.max_age_blocks = options.at(prefix + "-retention-blocks").as<uint32_t>();
+    if (options.count(prefix + "-retention-objects"))
+        retention.max_objects = options.at(prefix + "-retention-objects").as<uint32_t>();
+    if (options.count(prefix + "-prune-batch"))
+        retention.batch_size = options.at(prefix + "-prune-batch").as<uint32_t>();
+
+    FC_ASSERT(retention.batch_size > 0, "${p}-prune-batch must be greater than zero", ("p", prefix));
+
+    return retention;
+}
+}
+}
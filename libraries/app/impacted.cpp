@@ -207,6 +207,11 @@ struct get_impacted_account_visitor
     {
         _impacted.insert(op.producer);
     }
+
+    void operator()(const token_sale_contribution_settled_operation& op)
+    {
+        _impacted.insert(op.contributor);
+    }
 };
 
 void operation_get_impacted_accounts(const operation& op, flat_set<account_name_type>& result)
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <deip/app/api_context.hpp>
+#include <deip/app/api_thread_pool.hpp>
 #include <deip/app/database_api.hpp>
 #include <deip/protocol/types.hpp>
 
@@ -38,6 +39,7 @@
 
 #include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -93,7 +95,8 @@ public:
     void broadcast_transaction_with_callback(confirmation_callback cb, const signed_transaction& trx);
 
     /**
-     * This call will not return until the transaction is included in a block.
+     * This call will not return until the transaction is included in a block. It holds an API thread
+     * meanwhile, so the number of such calls executing at once is limited, see api-method-concurrency.
      */
     fc::variant broadcast_transaction_synchronous(const signed_transaction& trx);
 
@@ -120,6 +123,8 @@ public:
 private:
     boost::signals2::scoped_connection _applied_block_connection;
 
+    /// registered by API threads and consumed by on_applied_block, guarded by _callbacks_mutex
+    std::mutex _callbacks_mutex;
     map<transaction_id_type, confirmation_callback> _callbacks;
     map<time_point_sec, vector<transaction_id_type>> _callbacks_expirations;
 
@@ -170,6 +175,11 @@ public:
      */
     std::vector<graphene::net::potential_peer_record> get_potential_peers() const;
 
+    /**
+     * @brief Return call counts and latency histograms of the API thread pool by method
+     */
+    std::map<std::string, api_method_stats> get_api_stats() const;
+
     /// internal method, not exposed via JSON RPC
     void on_api_startup();
 
@@ -235,5 +245,5 @@ FC_REFLECT(deip::app::deip_version_info, (blockchain_version)(deip_revision)(fc_
 FC_API(deip::app::network_broadcast_api, (broadcast_transaction)(broadcast_transaction_with_callback)(
                                                broadcast_transaction_synchronous)(broadcast_block)(set_max_block_age))
 FC_API(deip::app::network_node_api, (get_info)(add_node)(get_connected_peers)(get_potential_peers)(
-                                          get_advanced_node_parameters)(set_advanced_node_parameters))
+                                          get_advanced_node_parameters)(set_advanced_node_parameters)(get_api_stats))
 FC_API(deip::app::login_api, (login)(get_api_by_name)(get_version))
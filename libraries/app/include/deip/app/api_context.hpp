@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -17,6 +19,7 @@ namespace deip {
 namespace app {
 
 class application;
+class binary_api;
 
 /**
  * Contains state shared by all API's on the same connection.
@@ -27,6 +30,13 @@ struct api_session_data
 {
     std::shared_ptr<fc::rpc::websocket_api_connection> wsc;
     std::map<std::string, fc::api_ptr> api_map;
+
+    /// binary RPC version negotiated on the connection, 0 until the client switches to binary RPC
+    std::atomic<uint32_t> binary_rpc_version{ 0 };
+
+    /// binary RPC method tables of the APIs in api_map, built on their first binary call
+    std::map<std::string, std::shared_ptr<binary_api>> binary_api_map;
+    std::mutex binary_api_mutex;
 };
 
 /**
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <deip/app/binary_rpc.hpp>
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/rpc/websocket_api.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/time.hpp>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace deip {
+namespace app {
+
+struct api_method_stats
+{
+    uint64_t calls = 0;
+    uint64_t expired = 0;
+    uint64_t total_latency_us = 0;
+
+    /// latency_histogram[i] counts calls completed in [2^i, 2^(i+1)) microseconds, queueing included
+    std::vector<uint64_t> latency_histogram;
+};
+
+/**
+ *  Executes API calls on a pool of worker threads, so that one slow call does not hold up
+ *  the calls of other connections behind it on the server thread.
+ *
+ *  Calls of a method can be limited to a number of concurrently executing ones, the rest wait
+ *  in the queue while calls of other methods go ahead. Calls posted in the same sequence, such
+ *  as the calls of one connection, run one at a time in the order they were posted. Calls which
+ *  have been waiting longer
+ *  than the deadline are cancelled with an error instead of being executed. A call which has
+ *  started runs to completion.
+ */
+class api_thread_pool
+{
+public:
+    api_thread_pool(uint32_t num_threads,
+                    const fc::microseconds& deadline,
+                    const std::map<std::string, uint32_t>& method_concurrency);
+    ~api_thread_pool();
+
+    /**
+     *  Queues the call. run executes it on a worker thread, expire reports the cancellation
+     *  if it did not start before the deadline.
+     */
+    void post(const std::string& method, std::function<void()> run, std::function<void()> expire);
+
+    /// Queues the call behind the calls of the sequence which have not completed yet
+    void post(const void* sequence, const std::string& method, std::function<void()> run, std::function<void()> expire);
+
+    std::map<std::string, api_method_stats> get_stats() const;
+
+private:
+    static constexpr size_t histogram_size = 32;
+
+    struct call
+    {
+        const void* sequence;
+        std::string method;
+        fc::time_point queued;
+        std::function<void()> run;
+        std::function<void()> expire;
+    };
+
+    void dispatch();
+    void execute(size_t thread_index, const call& c);
+
+    const fc::microseconds _deadline;
+    const std::map<std::string, uint32_t> _method_concurrency;
+
+    std::vector<std::shared_ptr<fc::thread>> _thread_pool;
+
+    mutable std::mutex _mutex;
+    std::vector<size_t> _idle_threads;
+    std::deque<call> _queue;
+    std::map<std::string, uint32_t> _running;
+    std::set<const void*> _running_sequences;
+    std::map<std::string, api_method_stats> _stats;
+};
+
+/**
+ *  Websocket API connection which hands incoming messages to the api_thread_pool instead of
+ *  executing them on the server thread. Responses are sent from the worker thread. The calls of
+ *  a connection run one at a time and in order, calls of different connections run in parallel.
+ */
+class pooled_websocket_api_connection : public binary_websocket_api_connection
+{
+public:
+    pooled_websocket_api_connection(const fc::http::websocket_connection_ptr& c,
+                                    const std::shared_ptr<api_thread_pool>& pool,
+                                    const request_handler& handler);
+
+private:
+    void on_pooled_message(const std::string& message);
+    void on_pooled_binary_message(const std::string& message);
+
+    std::shared_ptr<api_thread_pool> _pool;
+};
+}
+}
+
+FC_REFLECT(deip::app::api_method_stats, (calls)(expired)(total_latency_us)(latency_histogram))
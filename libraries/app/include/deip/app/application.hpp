@@ -25,6 +25,8 @@
 
 #include <deip/app/api_access.hpp>
 #include <deip/app/api_context.hpp>
+#include <deip/app/api_thread_pool.hpp>
+#include <deip/app/binary_rpc.hpp>
 #include <deip/chain/database/database.hpp>
 
 #include <graphene/net/node.hpp>
@@ -95,7 +97,13 @@ public:
     }
 
     graphene::net::node_ptr p2p_node();
+    std::map<std::string, api_method_stats> get_api_stats() const;
     std::shared_ptr<chain::database> chain_database() const;
+
+    /**
+     * The data directory resolved to an absolute path by initialize().
+     */
+    fc::path data_dir() const;
     // std::shared_ptr<graphene::db::object_database> pending_trx_database() const;
 
     void set_block_production(bool producing_blocks);
@@ -130,6 +138,31 @@ public:
      */
     fc::api_ptr create_api_by_name(const api_context& ctx);
 
+    /**
+     * Make the named API callable over binary RPC, see binary_rpc.hpp. The factory builds the method table
+     * from an instance created by the API factory.
+     */
+    void register_binary_api_factory(const std::string& name,
+                                     std::function<std::shared_ptr<binary_api>(const fc::api_ptr&)> factory);
+
+    /**
+     * Convenience method for an API registered with register_api_factory<Api>.
+     */
+    template <typename Api> void register_binary_api_factory(const std::string& name)
+    {
+        register_binary_api_factory(name, [](const fc::api_ptr& api) -> std::shared_ptr<binary_api> {
+            auto typed_api = std::dynamic_pointer_cast<fc::api<Api>>(api);
+            if (!typed_api)
+                return nullptr;
+            return std::make_shared<binary_api>(*typed_api);
+        });
+    }
+
+    /**
+     * Execute a binary RPC request against the APIs of the session.
+     */
+    binary_rpc_response call_binary_api(api_session_data& session, const binary_rpc_request& request);
+
     void get_max_block_age(int32_t& result);
 
     void connect_to_write_node();
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <fc/api.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/optional.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/rpc/websocket_api.hpp>
+#include <fc/thread/future.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace deip {
+namespace app {
+
+/**
+ *  Binary RPC lets a websocket client call API methods with fc::raw packed arguments and results
+ *  instead of JSON, which saves converting large results like blocks and accounts to fc::variant
+ *  and JSON text. It uses the same connection, API names and login permissions as JSON RPC.
+ *
+ *  A client switches its connection to binary RPC with a negotiate request, after which both
+ *  kinds of messages are accepted on it. A binary message is a text frame holding
+ *  binary_rpc_frame_prefix followed by a base64 encoded, fc::raw packed binary_rpc_request or
+ *  binary_rpc_response.
+ */
+static const char binary_rpc_frame_prefix[] = "bin:";
+static const uint32_t binary_rpc_version = 1;
+
+/// api and method of the request which switches a connection to binary RPC
+static const char binary_rpc_negotiate_api[] = "binary_rpc";
+static const char binary_rpc_negotiate_method[] = "negotiate";
+
+struct binary_rpc_request
+{
+    uint64_t id = 0;
+    std::string api;
+    std::string method;
+
+    /// fc::raw packed arguments of the method, one after another
+    std::vector<char> params;
+};
+
+struct binary_rpc_response
+{
+    uint64_t id = 0;
+
+    /// fc::raw packed result of the method, empty for methods returning void
+    std::vector<char> result;
+    fc::optional<std::string> error;
+};
+
+bool is_binary_rpc_frame(const std::string& message);
+
+std::string pack_binary_rpc_frame(const binary_rpc_request& request);
+std::string pack_binary_rpc_frame(const binary_rpc_response& response);
+
+template <typename T> T unpack_binary_rpc_frame(const std::string& message);
+
+namespace detail {
+
+/// Types which fc::raw cannot pack, methods taking or returning them are not callable over binary RPC
+template <typename T> struct is_binary_rpc_type : std::true_type
+{
+};
+
+template <typename T> struct is_binary_rpc_type<std::function<T>> : std::false_type
+{
+};
+
+template <typename T> struct is_binary_rpc_type<fc::api<T>> : std::false_type
+{
+};
+
+template <> struct is_binary_rpc_type<fc::api_ptr> : std::false_type
+{
+};
+
+template <typename T> struct is_binary_rpc_type<fc::optional<T>> : is_binary_rpc_type<T>
+{
+};
+
+template <typename... T> struct are_binary_rpc_types : std::true_type
+{
+};
+
+template <typename T, typename... Rest>
+struct are_binary_rpc_types<T, Rest...>
+    : std::integral_constant<bool,
+                             is_binary_rpc_type<typename std::decay<T>::type>::value
+                                 && are_binary_rpc_types<Rest...>::value>
+{
+};
+
+template <typename R> struct binary_rpc_result
+{
+    template <typename F> static std::vector<char> call(F&& f)
+    {
+        return fc::raw::pack(f());
+    }
+
+    static R unpack(const std::vector<char>& result)
+    {
+        return fc::raw::unpack<R>(result);
+    }
+};
+
+template <> struct binary_rpc_result<void>
+{
+    template <typename F> static std::vector<char> call(F&& f)
+    {
+        f();
+        return std::vector<char>();
+    }
+
+    static void unpack(const std::vector<char>&)
+    {
+    }
+};
+
+template <typename T> void append_binary_rpc_param(std::vector<char>& params, const T& param)
+{
+    const std::vector<char> packed = fc::raw::pack(param);
+    params.insert(params.end(), packed.begin(), packed.end());
+}
+
+} // namespace detail
+
+/**
+ *  Methods of an fc::api callable with fc::raw packed arguments. Built from the same FC_API
+ *  method list as the JSON registry, methods with callback arguments or API results are left
+ *  out.
+ */
+class binary_api
+{
+public:
+    template <typename Api> explicit binary_api(const fc::api<Api>& api)
+    {
+        api->visit(visitor(_methods));
+    }
+
+    /// Unpacks the arguments, calls the method and packs its result
+    std::vector<char> call(const std::string& method, const std::vector<char>& params) const;
+
+    bool has_method(const std::string& method) const
+    {
+        return _methods.find(method) != _methods.end();
+    }
+
+private:
+    typedef std::function<std::vector<char>(const std::vector<char>&)> method_type;
+
+    struct visitor
+    {
+        explicit visitor(std::map<std::string, method_type>& methods)
+            : _methods(methods)
+        {
+        }
+
+        template <typename R, typename... Args>
+        void operator()(const char* name, std::function<R(Args...)>& memb) const
+        {
+            add(name, memb, std::integral_constant<bool, detail::is_binary_rpc_type<R>::value
+                                                             && detail::are_binary_rpc_types<Args...>::value>());
+        }
+
+        template <typename R, typename... Args>
+        void add(const char* name, const std::function<R(Args...)>& memb, std::true_type) const
+        {
+            _methods[name] = [memb](const std::vector<char>& params) -> std::vector<char> {
+                fc::datastream<const char*> ds(params.data(), params.size());
+                return invoke(memb, ds);
+            };
+        }
+
+        template <typename R, typename... Args>
+        void add(const char*, const std::function<R(Args...)>&, std::false_type) const
+        {
+        }
+
+        std::map<std::string, method_type>& _methods;
+    };
+
+    template <typename R> static std::vector<char> invoke(const std::function<R()>& f, fc::datastream<const char*>& ds)
+    {
+        FC_ASSERT(ds.remaining() == 0, "Unexpected ${n} bytes after the last parameter", ("n", ds.remaining()));
+        return detail::binary_rpc_result<R>::call(f);
+    }
+
+    template <typename R, typename Arg, typename... Rest>
+    static std::vector<char> invoke(const std::function<R(Arg, Rest...)>& f, fc::datastream<const char*>& ds)
+    {
+        typename std::decay<Arg>::type arg;
+        fc::raw::unpack(ds, arg);
+
+        const std::function<R(Rest...)> bound = [&f, &arg](Rest... rest) -> R { return f(arg, std::forward<Rest>(rest)...); };
+        return invoke(bound, ds);
+    }
+
+    std::map<std::string, method_type> _methods;
+};
+
+/**
+ *  Websocket API connection which accepts binary RPC frames besides JSON messages. Binary
+ *  requests are passed to the handler, which executes them against the APIs of the session.
+ */
+class binary_websocket_api_connection : public fc::rpc::websocket_api_connection
+{
+public:
+    typedef std::function<binary_rpc_response(const binary_rpc_request&)> request_handler;
+
+    binary_websocket_api_connection(const fc::http::websocket_connection_ptr& c, const request_handler& handler);
+
+protected:
+    void on_binary_request(const binary_rpc_request& request);
+    void send_binary_response(const binary_rpc_response& response);
+
+    std::weak_ptr<fc::http::websocket_connection> _weak_connection;
+
+private:
+    void on_websocket_message(const std::string& message);
+
+    request_handler _handler;
+};
+
+/**
+ *  Client side of binary RPC. Takes over the messages of the connection, so it cannot share
+ *  the connection with a JSON websocket_api_connection. A call blocks the calling task until
+ *  its response arrives.
+ */
+class binary_rpc_client
+{
+public:
+    explicit binary_rpc_client(const fc::http::websocket_connection_ptr& c);
+    ~binary_rpc_client();
+
+    /// Switches the connection to binary RPC, returns the version accepted by the server
+    uint32_t negotiate(uint32_t version = binary_rpc_version);
+
+    template <typename R, typename... Args> R call(const std::string& api, const std::string& method, const Args&... args)
+    {
+        binary_rpc_request request;
+        request.api = api;
+        request.method = method;
+        (void)std::initializer_list<int>{ (detail::append_binary_rpc_param(request.params, args), 0)... };
+
+        return detail::binary_rpc_result<R>::unpack(send(request));
+    }
+
+private:
+    std::vector<char> send(binary_rpc_request& request);
+    void on_message(const std::string& message);
+
+    fc::http::websocket_connection_ptr _connection;
+
+    std::mutex _mutex;
+    uint64_t _next_id = 1;
+    std::map<uint64_t, fc::promise<binary_rpc_response>::ptr> _awaiting_responses;
+};
+}
+}
+
+FC_REFLECT(deip::app::binary_rpc_request, (id)(api)(method)(params))
+FC_REFLECT(deip::app::binary_rpc_response, (id)(result)(error))
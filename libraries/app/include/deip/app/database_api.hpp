@@ -72,6 +72,12 @@ public:
 
     void set_block_applied_callback(std::function<void(const variant& block_header)> cb);
 
+    /**
+     *  Streams a chain::block_changeset once per applied block: the (type, id, change)
+     *  of every object the block touched, with packed values for types that have a packer.
+     */
+    void set_changed_objects_callback(std::function<void(const variant& changeset)> cb);
+
     /**
      *  This API is a short-cut for returning all of the state required for a particular URL
      *  with a single query.
@@ -390,7 +396,8 @@ public:
     vector<funding_opportunity_api_obj> get_funding_opportunity_announcements_listing(const uint16_t& page, const uint16_t& limit) const;
 
 
-    // These methods are just for ECI debugging purposes, for actual values use 'eci_per_discipline' field
+    // Research and research content ECI are served from the 'eci_per_discipline' evaluations maintained by the chain,
+    // review weight is calculated on request for debugging purposes
     std::map<discipline_id_type, share_type> calculate_research_eci(const research_id_type& research_id) const;
     std::map<discipline_id_type, share_type> calculate_research_content_eci(const research_content_id_type& research_content_id) const;
     std::map<discipline_id_type, share_type> calculate_review_weight(const review_id_type& review_id) const;
@@ -482,6 +489,7 @@ FC_REFLECT_ENUM( deip::app::withdraw_route_type, (incoming)(outgoing)(all) )
 FC_API(deip::app::database_api,
    // Subscriptions
    (set_block_applied_callback)
+   (set_changed_objects_callback)
 
    //blocks
    (get_block)
@@ -58,7 +58,8 @@ struct account_api_obj
 {
     account_api_obj(const chain::account_object& a,
                     const chain::account_authority_object& auth,
-                    const account_balance_refs_type account_balances)
+                    const account_balance_refs_type account_balances,
+                    const std::map<asset_symbol_type, share_type>& pending_license_revenue = {})
         : id(a.id)
         , name(a.name)
         , memo_key(a.memo_key)
@@ -99,7 +100,9 @@ struct account_api_obj
 
         for (const account_balance_object& account_balance : account_balances)
         {
-            balances.push_back(asset(account_balance.amount, account_balance.symbol));
+            const auto itr = pending_license_revenue.find(account_balance.symbol);
+            const share_type pending = itr != pending_license_revenue.end() ? itr->second : share_type(0);
+            balances.push_back(asset(account_balance.amount + pending, account_balance.symbol));
         }
 
     }
@@ -555,6 +558,16 @@ struct expert_token_api_obj
         , amount(d.amount)
     {}
 
+    // implicit token of the default expertise, the id is reserved for its object
+    expert_token_api_obj(const chain::expert_token_id_type& id, const account_name_type& account, const chain::discipline_object& discipline, const share_type& amount)
+        : id(id._id)
+        , account_name(account)
+        , discipline_id(discipline.id._id)
+        , discipline_external_id(discipline.external_id)
+        , discipline_name(fc::to_string(discipline.name))
+        , amount(amount)
+    {}
+
     // because fc::variant require for temporary object
     expert_token_api_obj()
     {
@@ -1063,12 +1076,12 @@ struct asset_api_obj
 
 struct account_balance_api_obj
 {
-    account_balance_api_obj(const chain::account_balance_object& ab_o)
+    account_balance_api_obj(const chain::account_balance_object& ab_o, const share_type& pending_license_revenue = 0)
         : id(ab_o.id._id)
         , asset_id(ab_o.asset_id._id)
         , asset_symbol(fc::to_string(ab_o.string_symbol))
         , owner(ab_o.owner)
-        , amount(ab_o.to_asset())
+        , amount(ab_o.amount + pending_license_revenue, ab_o.symbol)
     {
         if (ab_o.tokenized_research.valid())
         {
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <deip/chain/database/database.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <string>
+
+namespace deip {
+namespace app {
+
+/**
+ *  Retention policy of a history plugin. Entries older than max_age_blocks block intervals and
+ *  the oldest entries beyond max_objects are pruned after each applied block, at most
+ *  batch_size of them per block so that pruning does not hold up block application. Limits of
+ *  0 keep entries regardless of their age or count.
+ *
+ *  Entries are pruned oldest first, in the order of their ids. Pruning is done in the block's
+ *  undo session, so it is undone with the block. History APIs report requests which reach back
+ *  before the oldest retained entry as pruned, instead of returning a partial result.
+ */
+struct history_retention
+{
+    uint32_t max_age_blocks = 0;
+    uint32_t max_objects = 0;
+    uint32_t batch_size = 1000;
+
+    bool enabled() const
+    {
+        return max_age_blocks != 0 || max_objects != 0;
+    }
+
+    /// Entries with an earlier timestamp are out of the age window
+    fc::time_point_sec age_cutoff(const chain::database& db) const;
+
+    /// Adds the <prefix>-retention-blocks, <prefix>-retention-objects and <prefix>-prune-batch options
+    static void add_program_options(boost::program_options::options_description& cfg, const std::string& prefix);
+
+    static history_retention from_options(const boost::program_options::variables_map& options,
+                                          const std::string& prefix);
+};
+
+/**
+ *  Removes the oldest objects of the index which are out of the retention window, at most budget
+ *  of them. on_remove is called for each object before it is removed. Returns the number of
+ *  removed objects.
+ */
+template <typename IndexType, typename TimeOf, typename OnRemove>
+uint32_t prune_history(chain::database& db,
+                       const history_retention& retention,
+                       uint32_t budget,
+                       TimeOf time_of,
+                       OnRemove on_remove)
+{
+    const auto& idx = db.get_index<IndexType>().indices().template get<chain::by_id>();
+    const fc::time_point_sec cutoff = retention.age_cutoff(db);
+
+    uint32_t removed = 0;
+    while (removed < budget && !idx.empty())
+    {
+        const auto& obj = *idx.begin();
+
+        const bool over_count = retention.max_objects != 0 && idx.size() > retention.max_objects;
+        const bool over_age = retention.max_age_blocks != 0 && time_of(obj) < cutoff;
+        if (!over_count && !over_age)
+            break;
+
+        on_remove(obj);
+        db.remove(obj);
+        ++removed;
+    }
+
+    return removed;
+}
+
+template <typename IndexType, typename TimeOf>
+uint32_t prune_history(chain::database& db, const history_retention& retention, uint32_t budget, TimeOf time_of)
+{
+    typedef typename IndexType::value_type object_type;
+    return prune_history<IndexType>(db, retention, budget, time_of, [](const object_type&) {});
+}
+
+/// Ids start at 0 and only pruning removes the oldest objects
+template <typename IndexType> bool is_pruned(const chain::database& db)
+{
+    const auto& idx = db.get_index<IndexType>().indices().template get<chain::by_id>();
+    return !idx.empty() && idx.begin()->id._id > 0;
+}
+
+/// Throws if objects of the index from the given id on have been pruned
+template <typename IndexType> void check_retained(const chain::database& db, int64_t id, const std::string& what)
+{
+    if (!is_pruned<IndexType>(db))
+        return;
+
+    const auto& first = *db.get_index<IndexType>().indices().template get<chain::by_id>().begin();
+    FC_ASSERT(id >= first.id._id, "${w} before ${first} has been pruned on this node",
+              ("w", what)("first", first.id._id));
+}
+
+/// Throws if objects of the index since the given time may have been pruned
+template <typename IndexType>
+void check_retained_since(const chain::database& db, const fc::time_point_sec& from, const std::string& what)
+{
+    if (!is_pruned<IndexType>(db))
+        return;
+
+    const auto& first = *db.get_index<IndexType>().indices().template get<chain::by_id>().begin();
+    FC_ASSERT(from >= first.timestamp, "${w} before ${first} has been pruned on this node",
+              ("w", what)("first", first.timestamp));
+}
+}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <fc/network/http/server.hpp>
+#include <fc/network/ip.hpp>
+
+#include <memory>
+
+namespace deip {
+namespace app {
+
+/**
+ *  Serves the metrics registry of the process in the Prometheus text format at /metrics.
+ *
+ *  The endpoint has no access control, it is meant for a scraper on the same host and should
+ *  not be reachable from outside of it.
+ */
+class metrics_server
+{
+public:
+    explicit metrics_server(const fc::ip::endpoint& endpoint);
+
+    fc::ip::endpoint get_local_endpoint() const;
+
+private:
+    std::shared_ptr<fc::http::server> _server;
+};
+}
+}
@@ -0,0 +1,34 @@
+#include <deip/app/metrics_server.hpp>
+
+#include <graphene/utilities/metrics.hpp>
+
+namespace deip {
+namespace app {
+
+metrics_server::metrics_server(const fc::ip::endpoint& endpoint)
+    : _server(std::make_shared<fc::http::server>())
+{
+    _server->listen(endpoint);
+    _server->on_request([](const fc::http::request& req, const fc::http::server::response& resp) {
+        const std::string path = req.path.substr(0, req.path.find('?'));
+        if (req.method != "GET" || path != "/metrics")
+        {
+            resp.set_status(fc::http::reply::NotFound);
+            resp.set_length(0);
+            return;
+        }
+
+        const std::string body = graphene::utilities::metrics().to_prometheus();
+        resp.set_status(fc::http::reply::OK);
+        resp.add_header("Content-Type", "text/plain; version=0.0.4");
+        resp.set_length(body.size());
+        resp.write(body.c_str(), body.size());
+    });
+}
+
+fc::ip::endpoint metrics_server::get_local_endpoint() const
+{
+    return _server->get_local_endpoint();
+}
+}
+}
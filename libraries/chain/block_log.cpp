@@ -2,79 +2,322 @@
 #include <fstream>
 #include <fc/io/raw.hpp>
 
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 #define LOG_READ (std::ios::in | std::ios::binary)
-#define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
 
 namespace deip {
 namespace chain {
 
 namespace detail {
+
+namespace {
+
+/**
+ * Returns the end of the block starting at pos, including the position which follows it, or
+ * block_log::npos if there is no complete block at pos.
+ */
+uint64_t block_end(std::ifstream& log, uint64_t pos)
+{
+    try
+    {
+        log.clear();
+        log.seekg(pos);
+
+        signed_block b;
+        fc::raw::unpack(log, b);
+
+        uint64_t block_pos;
+        log.read((char*)&block_pos, sizeof(block_pos));
+        if (block_pos != pos)
+            return block_log::npos;
+
+        return uint64_t(log.tellg());
+    }
+    catch (...)
+    {
+        return block_log::npos;
+    }
+}
+
+void sync_file(int fd, const fc::path& file)
+{
+#ifdef __APPLE__
+    FC_ASSERT(::fsync(fd) == 0, "Cannot sync ${f}: ${e}", ("f", file)("e", std::strerror(errno)));
+#else
+    FC_ASSERT(::fdatasync(fd) == 0, "Cannot sync ${f}: ${e}", ("f", file)("e", std::strerror(errno)));
+#endif
+}
+}
+
+struct queued_block
+{
+    uint32_t block_num = 0;
+    uint64_t pos = 0;
+
+    /// packed block followed by its position
+    std::vector<char> data;
+};
+
 class block_log_impl
 {
 public:
+    block_log_impl()
+    {
+        block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+        index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+    }
+
+    ~block_log_impl()
+    {
+        stop_writer();
+    }
+
     optional<signed_block> head;
     block_id_type head_id;
+
+    // readers only, the files are written by the writer thread through the descriptors
     std::fstream block_stream;
     std::fstream index_stream;
     fc::path block_file;
     fc::path index_file;
-    bool block_write;
-    bool index_write;
+    int block_fd = -1;
+    int index_fd = -1;
+
+    uint32_t max_queue_size = 1024;
+    std::atomic<uint64_t> crash_after{ std::numeric_limits<uint64_t>::max() };
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable queue_changed;
+    std::condition_variable written;
+    std::deque<queued_block> queue;
+    bool stopping = false;
+    std::string error;
+
+    // end of the main file once the queued blocks are written
+    uint64_t end_pos = 0;
+    // last block and end of the main file written and synced to disk
+    uint32_t written_num = 0;
+    uint64_t written_end = 0;
+
+    int open_file(const fc::path& file)
+    {
+        int fd = ::open(file.generic_string().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        FC_ASSERT(fd >= 0, "Cannot open ${f}: ${e}", ("f", file)("e", std::strerror(errno)));
+        return fd;
+    }
+
+    void truncate_file(int fd, const fc::path& file, uint64_t size)
+    {
+        FC_ASSERT(::ftruncate(fd, size) == 0, "Cannot truncate ${f}: ${e}", ("f", file)("e", std::strerror(errno)));
+        sync_file(fd, file);
+    }
 
-    inline void check_block_read()
+    void write_file(int fd, const fc::path& file, const char* data, size_t size)
     {
-        try
+        const size_t allowed = std::min<uint64_t>(size, crash_after);
+
+        size_t done = 0;
+        while (done < allowed)
         {
-            if (block_write)
-            {
-                block_stream.close();
-                block_stream.open(block_file.generic_string().c_str(), LOG_READ);
-                block_write = false;
-            }
+            const ssize_t n = ::write(fd, data + done, allowed - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            FC_ASSERT(n >= 0, "Cannot write ${f}: ${e}", ("f", file)("e", std::strerror(errno)));
+            done += n;
         }
-        FC_LOG_AND_RETHROW()
+
+        if (crash_after != std::numeric_limits<uint64_t>::max())
+            crash_after -= allowed;
+        FC_ASSERT(allowed == size, "Block log writer crashed");
     }
 
-    inline void check_block_write()
+    /**
+     * Blocks first, index entries after the blocks are on disk, so that the index never points
+     * past the durable end of the main file.
+     */
+    void write_batch(const std::deque<queued_block>& batch)
     {
-        try
+        std::vector<uint64_t> positions;
+        positions.reserve(batch.size());
+
+        for (const auto& b : batch)
         {
-            if (!block_write)
-            {
-                block_stream.close();
-                block_stream.open(block_file.generic_string().c_str(), LOG_WRITE);
-                block_write = true;
-            }
+            write_file(block_fd, block_file, b.data.data(), b.data.size());
+            positions.push_back(b.pos);
         }
-        FC_LOG_AND_RETHROW()
+        sync_file(block_fd, block_file);
+
+        write_file(index_fd, index_file, (const char*)positions.data(), positions.size() * sizeof(uint64_t));
+        sync_file(index_fd, index_file);
     }
 
-    inline void check_index_read()
+    void write_loop()
     {
-        try
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
         {
-            if (index_write)
+            queue_changed.wait(lock, [&]() { return !queue.empty() || stopping; });
+            if (queue.empty())
+                return;
+
+            // everything queued while the previous batch was written goes with one sync
+            std::deque<queued_block> batch;
+            batch.swap(queue);
+            written.notify_all();
+            lock.unlock();
+
+            std::string failure;
+            try
             {
-                index_stream.close();
-                index_stream.open(index_file.generic_string().c_str(), LOG_READ);
-                index_write = false;
+                write_batch(batch);
             }
+            catch (const fc::exception& e)
+            {
+                failure = e.to_string();
+            }
+            catch (const std::exception& e)
+            {
+                failure = e.what();
+            }
+
+            lock.lock();
+            if (!failure.empty())
+            {
+                elog("Block log writer stopped: ${e}", ("e", failure));
+                error = failure;
+                written.notify_all();
+                return;
+            }
+
+            written_num = batch.back().block_num;
+            written_end = batch.back().pos + batch.back().data.size();
+            written.notify_all();
+        }
+    }
+
+    void start_writer()
+    {
+        writer = std::thread([this]() { write_loop(); });
+    }
+
+    /// Writes the queued blocks unless the writer failed
+    void stop_writer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
         }
-        FC_LOG_AND_RETHROW()
+        queue_changed.notify_all();
+
+        if (writer.joinable())
+            writer.join();
+
+        if (block_fd >= 0)
+            ::close(block_fd);
+        if (index_fd >= 0)
+            ::close(index_fd);
+        block_fd = -1;
+        index_fd = -1;
+    }
+
+    void wait_for_block(uint32_t block_num)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        written.wait(lock, [&]() { return written_num >= block_num || !error.empty(); });
+        FC_ASSERT(written_num >= block_num, "Block log writer failed: ${e}", ("e", error));
     }
 
-    inline void check_index_write()
+    void wait_for_pos(uint64_t pos)
     {
-        try
+        std::unique_lock<std::mutex> lock(mutex);
+        written.wait(lock, [&]() { return written_end > pos || written_end == end_pos || !error.empty(); });
+        FC_ASSERT(written_end > pos || written_end == end_pos, "Block log writer failed: ${e}", ("e", error));
+    }
+
+    void wait_for_all()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        written.wait(lock, [&]() { return written_end == end_pos || !error.empty(); });
+        FC_ASSERT(written_end == end_pos, "Block log writer failed: ${e}", ("e", error));
+    }
+
+    /**
+     * Cuts off what the writer left of a block it did not finish, and the partial entry it left
+     * in the index. The blocks before are complete, the main file is synced before the index.
+     */
+    void truncate_torn_tail()
+    {
+        uint64_t index_size = fc::file_size(index_file);
+        if (index_size % sizeof(uint64_t))
         {
-            if (!index_write)
+            wlog("Index has a partial entry, truncating it");
+            index_size -= index_size % sizeof(uint64_t);
+            truncate_file(index_fd, index_file, index_size);
+        }
+
+        const uint64_t log_size = fc::file_size(block_file);
+        if (!log_size)
+            return;
+
+        std::ifstream log(block_file.generic_string().c_str(), LOG_READ);
+        log.exceptions(std::fstream::failbit | std::fstream::badbit);
+
+        auto read_pos = [](std::ifstream& stream, uint64_t offset) -> uint64_t {
+            uint64_t pos = block_log::npos;
+            try
+            {
+                stream.clear();
+                stream.seekg(offset);
+                stream.read((char*)&pos, sizeof(pos));
+            }
+            catch (...)
             {
-                index_stream.close();
-                index_stream.open(index_file.generic_string().c_str(), LOG_WRITE);
-                index_write = true;
+                pos = block_log::npos;
             }
+            return pos;
+        };
+
+        // the usual case, the last position of the file points at a complete head block
+        if (log_size >= sizeof(uint64_t))
+        {
+            const uint64_t head_pos = read_pos(log, log_size - sizeof(uint64_t));
+            if (head_pos < log_size && block_end(log, head_pos) == log_size)
+                return;
+        }
+
+        // blocks are complete up to the last indexed one
+        uint64_t pos = 0;
+        if (index_size)
+        {
+            std::ifstream index(index_file.generic_string().c_str(), LOG_READ);
+            index.exceptions(std::fstream::failbit | std::fstream::badbit);
+
+            const uint64_t index_pos = read_pos(index, index_size - sizeof(uint64_t));
+            if (index_pos < log_size && block_end(log, index_pos) <= log_size)
+                pos = index_pos;
+        }
+
+        uint64_t good_end = 0;
+        for (uint64_t end = block_end(log, pos); end <= log_size; end = block_end(log, pos))
+        {
+            good_end = end;
+            pos = end;
         }
-        FC_LOG_AND_RETHROW()
+
+        wlog("Block log has a torn tail, truncating it from ${s} to ${e} bytes", ("s", log_size)("e", good_end));
+        truncate_file(block_fd, block_file, good_end);
     }
 };
 }
@@ -82,29 +325,28 @@ public:
 block_log::block_log()
     : my(new detail::block_log_impl())
 {
-    my->block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
-    my->index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
 }
 
 block_log::~block_log()
 {
-    flush();
+    my->stop_writer();
 }
 
 void block_log::open(const fc::path& file)
 {
-    if (my->block_stream.is_open())
-        my->block_stream.close();
-    if (my->index_stream.is_open())
-        my->index_stream.close();
+    close();
 
     my->block_file = file;
     my->index_file = fc::path(file.generic_string() + ".index");
+    my->max_queue_size = _max_queue_size;
+
+    my->block_fd = my->open_file(my->block_file);
+    my->index_fd = my->open_file(my->index_file);
+
+    my->truncate_torn_tail();
 
-    my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
-    my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-    my->block_write = true;
-    my->index_write = true;
+    my->block_stream.open(my->block_file.generic_string().c_str(), LOG_READ);
+    my->index_stream.open(my->index_file.generic_string().c_str(), LOG_READ);
 
     /* On startup of the block log, there are several states the log file and the index file can be
      * in relation to eachother.
@@ -127,6 +369,9 @@ void block_log::open(const fc::path& file)
     auto log_size = fc::file_size(my->block_file);
     auto index_size = fc::file_size(my->index_file);
 
+    my->end_pos = log_size;
+    my->written_end = log_size;
+
     if (log_size)
     {
         ilog("Log is nonempty");
@@ -135,9 +380,6 @@ void block_log::open(const fc::path& file)
 
         if (index_size)
         {
-            my->check_block_read();
-            my->check_index_read();
-
             ilog("Index is nonempty");
             uint64_t block_pos;
             my->block_stream.seekg(-sizeof(uint64_t), std::ios::end);
@@ -163,15 +405,16 @@ void block_log::open(const fc::path& file)
             ilog("Index is empty");
             construct_index();
         }
+
+        my->written_num = my->head->block_num();
     }
     else if (index_size)
     {
         ilog("Index is nonempty, remove and recreate it");
-        my->index_stream.close();
-        fc::remove_all(my->index_file);
-        my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-        my->index_write = true;
+        my->truncate_file(my->index_fd, my->index_file, 0);
     }
+
+    my->start_writer();
 }
 
 void block_log::close()
@@ -188,19 +431,30 @@ uint64_t block_log::append(const signed_block& b)
 {
     try
     {
-        my->check_block_write();
-        my->check_index_write();
-
-        uint64_t pos = my->block_stream.tellp();
-        FC_ASSERT((uint64_t)my->index_stream.tellp()
-                      == (std::fstream::streampos)sizeof(uint64_t) * ((uint64_t)b.block_num() - 1),
-                  "Append to index file occuring at wrong position.",
-                  ("position", (uint64_t)my->index_stream.tellp())("expected",
-                                                                   ((uint64_t)b.block_num() - 1) * sizeof(uint64_t)));
-        auto data = fc::raw::pack(b);
-        my->block_stream.write(data.data(), data.size());
-        my->block_stream.write((char*)&pos, sizeof(pos));
-        my->index_stream.write((char*)&pos, sizeof(pos));
+        const uint32_t head_num = my->head.valid() ? protocol::block_header::num_from_id(my->head_id) : 0;
+        FC_ASSERT(b.block_num() == head_num + 1, "Append to index file occuring at wrong position.",
+                  ("position", uint64_t(head_num) * sizeof(uint64_t))(
+                      "expected", ((uint64_t)b.block_num() - 1) * sizeof(uint64_t)));
+
+        uint64_t pos;
+        detail::queued_block queued;
+        queued.block_num = b.block_num();
+        queued.data = fc::raw::pack(b);
+
+        {
+            std::unique_lock<std::mutex> lock(my->mutex);
+            my->written.wait(lock, [&]() { return my->queue.size() < my->max_queue_size || !my->error.empty(); });
+            FC_ASSERT(my->error.empty(), "Block log writer failed: ${e}", ("e", my->error));
+
+            pos = my->end_pos;
+            queued.pos = pos;
+            queued.data.insert(queued.data.end(), (const char*)&queued.pos,
+                               (const char*)&queued.pos + sizeof(queued.pos));
+            my->end_pos += queued.data.size();
+            my->queue.push_back(std::move(queued));
+        }
+        my->queue_changed.notify_one();
+
         my->head = b;
         my->head_id = b.id();
 
@@ -211,15 +465,31 @@ uint64_t block_log::append(const signed_block& b)
 
 void block_log::flush()
 {
-    my->block_stream.flush();
-    my->index_stream.flush();
+    my->wait_for_all();
+}
+
+void block_log::set_max_queue_size(uint32_t max_queue_size)
+{
+    FC_ASSERT(max_queue_size > 0, "Block log queue must hold at least one block");
+    _max_queue_size = max_queue_size;
+}
+
+void block_log::crash_writer_after(uint64_t bytes)
+{
+    my->crash_after = bytes;
+}
+
+uint32_t block_log::written_block_num() const
+{
+    std::lock_guard<std::mutex> lock(my->mutex);
+    return my->written_num;
 }
 
 std::pair<signed_block, uint64_t> block_log::read_block(uint64_t pos) const
 {
     try
     {
-        my->check_block_read();
+        my->wait_for_pos(pos);
 
         my->block_stream.seekg(pos);
         std::pair<signed_block, uint64_t> result;
@@ -251,10 +521,11 @@ uint64_t block_log::get_block_pos(uint32_t block_num) const
 {
     try
     {
-        my->check_index_read();
-
         if (!(my->head.valid() && block_num <= protocol::block_header::num_from_id(my->head_id) && block_num > 0))
             return npos;
+
+        my->wait_for_block(block_num);
+
         my->index_stream.seekg(sizeof(uint64_t) * (block_num - 1));
         uint64_t pos;
         my->index_stream.read((char*)&pos, sizeof(pos));
@@ -267,7 +538,7 @@ signed_block block_log::read_head() const
 {
     try
     {
-        my->check_block_read();
+        my->wait_for_all();
 
         uint64_t pos;
         my->block_stream.seekg(-sizeof(pos), std::ios::end);
@@ -287,14 +558,10 @@ void block_log::construct_index()
     try
     {
         ilog("Reconstructing Block Log Index...");
-        my->index_stream.close();
-        fc::remove_all(my->index_file);
-        my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-        my->index_write = true;
+        my->truncate_file(my->index_fd, my->index_file, 0);
 
         uint64_t pos = 0;
         uint64_t end_pos;
-        my->check_block_read();
 
         my->block_stream.seekg(-sizeof(uint64_t), std::ios::end);
         my->block_stream.read((char*)&end_pos, sizeof(end_pos));
@@ -302,12 +569,25 @@ void block_log::construct_index()
 
         my->block_stream.seekg(pos);
 
+        std::vector<uint64_t> positions;
+        auto write_positions = [&]() {
+            my->write_file(my->index_fd, my->index_file, (const char*)positions.data(),
+                           positions.size() * sizeof(uint64_t));
+            positions.clear();
+        };
+
         while (pos < end_pos)
         {
             fc::raw::unpack(my->block_stream, tmp);
             my->block_stream.read((char*)&pos, sizeof(pos));
-            my->index_stream.write((char*)&pos, sizeof(pos));
+            positions.push_back(pos);
+
+            if (positions.size() == 4096)
+                write_positions();
         }
+
+        write_positions();
+        detail::sync_file(my->index_fd, my->index_file);
     }
     FC_LOG_AND_RETHROW()
 }
@@ -0,0 +1,78 @@
+#include <deip/chain/database/authority_cache.hpp>
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/schema/account_object.hpp>
+
+namespace deip {
+namespace chain {
+
+authority_cache::authority_cache(const database& db)
+    : _db(db)
+{
+}
+
+authority authority_cache::get_active(const account_name_type& account)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return resolve(account).active;
+}
+
+authority authority_cache::get_owner(const account_name_type& account)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return resolve(account).owner;
+}
+
+fc::optional<authority> authority_cache::get_active_override(const account_name_type& account, uint16_t op_tag)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    fc::optional<authority> result;
+    const auto& overrides = resolve(account).active_overrides;
+    auto itr = overrides.find(op_tag);
+    if (itr != overrides.end())
+    {
+        result = itr->second;
+    }
+    return result;
+}
+
+void authority_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+size_t authority_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+const authority_cache::resolved_authority& authority_cache::resolve(const account_name_type& account)
+{
+    const uint64_t mutation_count = _db.get_index<account_authority_index>().mutation_count();
+    if (mutation_count != _mutation_count)
+    {
+        _entries.clear();
+        _mutation_count = mutation_count;
+    }
+
+    auto itr = _entries.find(account);
+    if (itr != _entries.end())
+        return itr->second;
+
+    const auto& auth = _db.get<account_authority_object, by_account>(account);
+
+    resolved_authority entry;
+    entry.active = authority(auth.active);
+    entry.owner = authority(auth.owner);
+    for (const auto& item : auth.active_overrides)
+    {
+        entry.active_overrides.emplace(item.first, authority(item.second));
+    }
+
+    return _entries.emplace(account, std::move(entry)).first->second;
+}
+}
+}
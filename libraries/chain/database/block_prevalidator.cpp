@@ -0,0 +1,88 @@
+#include <deip/chain/database/block_prevalidator.hpp>
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/schema/witness_objects.hpp>
+
+namespace deip {
+namespace chain {
+
+block_prevalidator::block_prevalidator(uint32_t num_threads)
+{
+    FC_ASSERT(num_threads > 0, "At least one verification thread is required");
+
+    _thread_pool.resize(num_threads);
+    for (uint32_t i = 0; i < num_threads; ++i)
+        _thread_pool[i] = std::make_shared<fc::thread>("block_prevalidator");
+}
+
+block_prevalidator::~block_prevalidator()
+{
+    _pending.clear();
+    for (const auto& thread : _thread_pool)
+        thread->quit();
+}
+
+void block_prevalidator::schedule(const signed_block& block)
+{
+    const block_id_type id = block.id();
+    if (_pending.find(id) != _pending.end())
+        return;
+
+    auto& thread = _thread_pool[_next_thread++ % _thread_pool.size()];
+    _pending[id] = thread->async([block]() { return verify(block); }, "verify sync block");
+}
+
+uint32_t block_prevalidator::get_skip_flags(database& db, const signed_block& block)
+{
+    auto itr = _pending.find(block.id());
+    if (itr == _pending.end())
+        return database::skip_nothing;
+
+    verification_result result;
+    try
+    {
+        result = itr->second.wait();
+    }
+    catch (const fc::exception& e)
+    {
+        wlog("Sync block verification failed: ${e}", ("e", e.to_detail_string()));
+    }
+
+    _pending.erase(_pending.begin(), ++itr);
+
+    return db.with_read_lock([&]() {
+        uint32_t skip = database::skip_nothing;
+
+        if (block.previous != db.head_block_id())
+            return skip;
+
+        if (result.merkle_root_valid)
+            skip |= database::skip_merkle_check;
+
+        const witness_object* witness = db.find<witness_object, by_name>(block.witness);
+        if (result.signee.valid() && witness != nullptr && witness->signing_key == *result.signee)
+            skip |= database::skip_witness_signature;
+
+        return skip;
+    });
+}
+
+block_prevalidator::verification_result block_prevalidator::verify(const signed_block& block)
+{
+    verification_result result;
+
+    try
+    {
+        result.signee = public_key_type(block.signee());
+    }
+    catch (const fc::exception&)
+    {
+        // malformed signature, leave the check to push_block
+    }
+
+    result.merkle_root_valid = block.calculate_merkle_root() == block.transaction_merkle_root;
+
+    return result;
+}
+}
+}
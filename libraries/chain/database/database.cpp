@@ -55,6 +55,8 @@
 #include <fc/io/fstream.hpp>
 #include <fc/io/json.hpp>
 
+#include <graphene/utilities/metrics.hpp>
+
 #include <cstdint>
 #include <deque>
 #include <fstream>
@@ -106,6 +108,62 @@ namespace chain {
 
 using boost::container::flat_set;
 
+namespace {
+
+using graphene::utilities::counter;
+using graphene::utilities::gauge;
+using graphene::utilities::histogram;
+using graphene::utilities::metrics;
+
+/// Metrics of the chain, shared by the databases of the process
+struct chain_metrics
+{
+    chain_metrics()
+        : block_apply_seconds(metrics().get_histogram("deip_block_apply_seconds", "Time to apply a block",
+                                                      histogram::exponential_bounds(0.0005, 2, 16)))
+        , blocks_applied(metrics().get_counter("deip_blocks_applied_total", "Blocks applied, including replayed and forked ones"))
+        , transactions_applied(metrics().get_counter("deip_transactions_applied_total", "Transactions of applied blocks"))
+        , head_block_num(metrics().get_gauge("deip_head_block_num", "Number of the head block"))
+        , last_irreversible_block_num(metrics().get_gauge("deip_last_irreversible_block_num", "Number of the last irreversible block"))
+        , block_log_queued_blocks(metrics().get_gauge("deip_block_log_queued_blocks", "Irreversible blocks waiting to be written to the block log"))
+        , fork_db_size(metrics().get_gauge("deip_fork_db_size", "Blocks in the fork database"))
+        , pending_transactions(metrics().get_gauge("deip_pending_transactions", "Transactions waiting for a block"))
+        , shared_memory_free_bytes(metrics().get_gauge("deip_shared_memory_free_bytes", "Free bytes of the shared memory file"))
+        , write_locks(metrics().get_counter("deip_chain_write_locks_total", "Write locks of the chain state"))
+        , write_lock_wait_us(metrics().get_counter("deip_chain_write_lock_wait_microseconds_total", "Time writers waited for the chain state lock"))
+        , max_write_lock_wait_us(metrics().get_gauge("deip_chain_max_write_lock_wait_microseconds", "Longest wait of a writer for the chain state lock"))
+        , read_locks(metrics().get_counter("deip_chain_read_locks_total", "Read locks of the chain state"))
+        , read_lock_hold_us(metrics().get_counter("deip_chain_read_lock_hold_microseconds_total", "Time readers held the chain state lock"))
+        , max_read_lock_hold_us(metrics().get_gauge("deip_chain_max_read_lock_hold_microseconds", "Longest hold of the chain state lock by a reader"))
+    {
+    }
+
+    histogram& block_apply_seconds;
+    counter& blocks_applied;
+    counter& transactions_applied;
+
+    gauge& head_block_num;
+    gauge& last_irreversible_block_num;
+    gauge& block_log_queued_blocks;
+    gauge& fork_db_size;
+    gauge& pending_transactions;
+    gauge& shared_memory_free_bytes;
+
+    counter& write_locks;
+    counter& write_lock_wait_us;
+    gauge& max_write_lock_wait_us;
+    counter& read_locks;
+    counter& read_lock_hold_us;
+    gauge& max_read_lock_hold_us;
+};
+
+chain_metrics& get_chain_metrics()
+{
+    static chain_metrics m;
+    return m;
+}
+}
+
 class database_impl
 {
 public:
@@ -125,6 +183,7 @@ database::database()
     : chainbase::database()
     , dbservice(*this)
     , _my(new database_impl(*this))
+    , _authority_cache(*this)
 {
 }
 
@@ -143,11 +202,22 @@ void database::open(const fc::path& data_dir,
     {
         chainbase::database::open(shared_mem_dir, chainbase_flags, shared_file_size);
 
+        // objects may be half written, this assertion should be caught and a reindex should occur
+        FC_ASSERT(!(chainbase_flags & chainbase::database::read_write) || !interrupted_write(),
+                  "The node was killed while it changed the chain state. Please reindex blockchain.");
+
         initialize_indexes();
         initialize_evaluators();
 
         if (chainbase_flags & chainbase::database::read_write)
         {
+            // the journal is marked as open before the state is written
+            _state_checkpointer.open(*this, fc::path(shared_mem_dir) / "shared_memory.checkpoint");
+
+            // the synced files may be torn, this assertion should be caught and a reindex should occur
+            FC_ASSERT(!_state_checkpointer.state_may_be_torn(),
+                      "The host restarted while the node had the chain state open. Please reindex blockchain.");
+
             if (!find<dynamic_global_property_object>())
                 with_write_lock([&]() { init_genesis(genesis_state); });
 
@@ -156,8 +226,6 @@ void database::open(const fc::path& data_dir,
 
             _block_log.open(data_dir / "block_log");
 
-            auto log_head = _block_log.head();
-
             // Rewind all undo state. This should return us to the state at the last irreversible block.
             with_write_lock([&]() {
                 undo_all();
@@ -166,6 +234,20 @@ void database::open(const fc::path& data_dir,
 
                 validate_invariants();
             });
+            _committed_block_num = head_block_num();
+
+            const auto checkpoint = _state_checkpointer.last();
+            if (checkpoint && checkpoint->block_num)
+            {
+                // committed undo states are never brought back, a state behind its checkpoint lost writes
+                FC_ASSERT(head_block_num() >= checkpoint->block_num,
+                          "Chain state is behind its checkpoint at block ${n}. Please reindex blockchain.",
+                          ("n", checkpoint->block_num)("head_block", head_block_num()));
+
+                auto checkpoint_block = _block_log.read_block_by_num(checkpoint->block_num);
+                FC_ASSERT(checkpoint_block.valid() && checkpoint_block->id() == checkpoint->block_id,
+                          "Chain state checkpoint does not match block log. Please reindex blockchain.");
+            }
 
             if (head_block_num())
             {
@@ -173,14 +255,27 @@ void database::open(const fc::path& data_dir,
                 // This assertion should be caught and a reindex should occur
                 FC_ASSERT(head_block.valid() && head_block->id() == head_block_id(),
                           "Chain state does not match block log. Please reindex blockchain.");
-
-                _fork_db.start_block(*head_block);
             }
         }
 
         with_read_lock([&]() {
             init_hardforks(genesis_state.initial_timestamp); // Writes to local state, but reads from db
         });
+
+        if (chainbase_flags & chainbase::database::read_write)
+        {
+            // blocks written to the block log after the last committed undo state
+            auto log_head = _block_log.head();
+            if (log_head && log_head->block_num() > head_block_num())
+            {
+                ilog("Replaying blocks ${f} to ${l} of the block log",
+                     ("f", head_block_num() + 1)("l", log_head->block_num()));
+                replay_block_log(head_block_num() + 1);
+            }
+
+            if (head_block_num())
+                _fork_db.start_block(*_block_log.read_block_by_num(head_block_num()));
+        }
     }
     FC_CAPTURE_LOG_AND_RETHROW((data_dir)(shared_mem_dir)(shared_file_size))
 }
@@ -193,52 +288,53 @@ void database::reindex(const fc::path& data_dir,
     try
     {
         ilog("Reindexing Blockchain");
+        auto start = fc::time_point::now();
         wipe(data_dir, shared_mem_dir, false);
-        open(data_dir, shared_mem_dir, shared_file_size, chainbase::database::read_write, genesis_state);
-        _fork_db.reset(); // override effect of _fork_db.start_block() call in open()
 
-        auto start = fc::time_point::now();
+        // open replays the whole block log onto the wiped state
+        open(data_dir, shared_mem_dir, shared_file_size, chainbase::database::read_write, genesis_state);
         DEIP_ASSERT(_block_log.head(), block_log_exception, "No blocks in block log. Cannot reindex an empty chain.");
 
-        ilog("Replaying blocks...");
-
-        uint64_t skip_flags = skip_witness_signature | skip_transaction_signatures | skip_transaction_dupe_check
-            | skip_tapos_check | skip_merkle_check | skip_witness_schedule_check | skip_authority_check | skip_validate
-            | /// no need to validate operations
-            skip_validate_invariants | skip_block_log;
+        auto end = fc::time_point::now();
+        ilog("Done reindexing, elapsed time: ${t} sec", ("t", double((end - start).count()) / 1000000.0));
+    }
+    FC_CAPTURE_AND_RETHROW((data_dir)(shared_mem_dir))
+}
 
-        with_write_lock([&]() {
-            auto itr = _block_log.read_block(0);
-            auto last_block_num = _block_log.head()->block_num();
+void database::replay_block_log(uint32_t first_block_num)
+{
+    uint64_t skip_flags = skip_witness_signature | skip_transaction_signatures | skip_transaction_dupe_check
+        | skip_tapos_check | skip_merkle_check | skip_witness_schedule_check | skip_authority_check | skip_validate
+        | /// no need to validate operations
+        skip_validate_invariants | skip_block_log;
 
-            while (itr.first.block_num() != last_block_num)
-            {
-                auto cur_block_num = itr.first.block_num();
-                if (cur_block_num % 100000 == 0)
-                    std::cerr << "   " << double(cur_block_num * 100) / last_block_num << "%   " << cur_block_num
-                              << " of " << last_block_num << "   (" << (get_free_memory() / (1024 * 1024))
-                              << "M free)\n";
-                apply_block(itr.first, skip_flags);
-                itr = _block_log.read_block(itr.second);
-            }
+    with_write_lock([&]() {
+        auto itr = _block_log.read_block(_block_log.get_block_pos(first_block_num));
+        auto last_block_num = _block_log.head()->block_num();
 
+        while (itr.first.block_num() != last_block_num)
+        {
+            auto cur_block_num = itr.first.block_num();
+            if (cur_block_num % 100000 == 0)
+                std::cerr << "   " << double(cur_block_num * 100) / last_block_num << "%   " << cur_block_num
+                          << " of " << last_block_num << "   (" << (get_free_memory() / (1024 * 1024))
+                          << "M free)\n";
             apply_block(itr.first, skip_flags);
-            set_revision(head_block_num());
-        });
+            itr = _block_log.read_block(itr.second);
+        }
 
-        if (_block_log.head()->block_num())
-            _fork_db.start_block(*_block_log.head());
+        apply_block(itr.first, skip_flags);
+        set_revision(head_block_num());
+    });
 
-        auto end = fc::time_point::now();
-        ilog("Done reindexing, elapsed time: ${t} sec", ("t", double((end - start).count()) / 1000000.0));
-    }
-    FC_CAPTURE_AND_RETHROW((data_dir)(shared_mem_dir))
+    _committed_block_num = head_block_num();
 }
 
 void database::wipe(const fc::path& data_dir, const fc::path& shared_mem_dir, bool include_blocks)
 {
     close();
     chainbase::database::wipe(shared_mem_dir);
+    fc::remove_all(fc::path(shared_mem_dir) / "shared_memory.checkpoint");
     if (include_blocks)
     {
         fc::remove_all(data_dir / "block_log");
@@ -255,6 +351,33 @@ void database::close()
         // DB state (issue #336).
         clear_pending();
 
+        if (_block_log.is_open())
+        {
+            // undo states kept until the block log writer had written their blocks
+            _block_log.flush();
+            with_write_lock([&]() {
+                if (find<dynamic_global_property_object>())
+                    commit_irreversible(std::min(get_dynamic_global_properties().last_irreversible_block_num,
+                                                 _block_log.written_block_num()));
+            });
+        }
+
+        if (_state_checkpointer.is_open())
+        {
+            // the last checkpoint is of the state which is closed, nothing is written while it is synced,
+            // a state which may be torn keeps its journal open
+            if (!_state_checkpointer.state_may_be_torn())
+            {
+                auto checkpoint = get_committed_checkpoint();
+                if (checkpoint)
+                {
+                    checkpoint->closed = true;
+                    _state_checkpointer.take(*checkpoint);
+                }
+            }
+            _state_checkpointer.close();
+        }
+
         chainbase::database::flush();
         chainbase::database::close();
 
@@ -373,11 +496,31 @@ const signed_transaction database::get_recent_transaction(const transaction_id_t
         auto& index = get_index<transaction_index>().indices().get<by_trx_id>();
         auto itr = index.find(trx_id);
         FC_ASSERT(itr != index.end());
-        signed_transaction trx;
-        fc::raw::unpack(itr->packed_trx, trx);
-        return trx;
+
+        const block_id_type block_id
+            = itr->block_num <= head_block_num() ? find_block_id_for_num(itr->block_num) : block_id_type();
+        if (block_id != block_id_type())
+        {
+            const auto block = fetch_block_by_id(block_id);
+            if (block.valid())
+            {
+                for (const auto& trx : block->transactions)
+                {
+                    if (trx.id() == trx_id)
+                        return trx;
+                }
+            }
+        }
+
+        for (const auto& trx : _pending_tx)
+        {
+            if (trx.id() == trx_id)
+                return trx;
+        }
+
+        FC_THROW("Transaction ${id} is neither in block ${n} nor pending", ("id", trx_id)("n", itr->block_num));
     }
-    FC_CAPTURE_AND_RETHROW()
+    FC_CAPTURE_AND_RETHROW((trx_id))
 }
 
 std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const
@@ -526,6 +669,7 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
                 }
                 FC_CAPTURE_AND_RETHROW((new_block))
             });
+            get_chain_metrics().pending_transactions.set(_pending_tx.size());
         });
     });
 
@@ -691,10 +835,11 @@ void database::_push_transaction(const signed_transaction& trx)
     _apply_transaction(trx);
     _pending_tx.push_back(trx);
 
-    notify_changed_objects();
     // The transaction applied successfully. Merge its changes into the pending block session.
     temp_session.squash();
 
+    get_chain_metrics().pending_transactions.set(_pending_tx.size());
+
     // notify anyone listening to pending transactions
     notify_on_pending_transaction(trx);
 }
@@ -871,9 +1016,46 @@ void database::pop_block()
         optional<signed_block> head_block = fetch_block_by_id(head_id);
         DEIP_ASSERT(head_block.valid(), pop_empty_chain, "there are no blocks to pop");
 
+        std::vector<chainbase::object_change> changes;
+        if (!changed_objects.empty())
+            get_head_changes(changes);
+
+        block_changeset reverted;
+        reverted.block_num = head_block_num();
+        reverted.block_id = head_id;
+        reverted.reverted = true;
+
+        // objects created by the block are removed by undo, they are packed while they exist
+        for (const auto& change : changes)
+        {
+            if (change.type == chainbase::object_change::created)
+            {
+                reverted.objects.emplace_back(change);
+                pack_changed_object(reverted.objects.back());
+                reverted.objects.back().type = chainbase::object_change::removed;
+            }
+        }
+
         _fork_db.pop_block();
         undo();
 
+        // objects modified or removed by the block are back at their previous values
+        for (const auto& change : changes)
+        {
+            if (change.type != chainbase::object_change::created)
+            {
+                reverted.objects.emplace_back(change);
+                if (change.type == chainbase::object_change::removed)
+                    reverted.objects.back().type = chainbase::object_change::created;
+                pack_changed_object(reverted.objects.back());
+            }
+        }
+
+        if (!changes.empty())
+        {
+            DEIP_TRY_NOTIFY(changed_objects, reverted)
+        }
+
         _popped_tx.insert(_popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end());
     }
     FC_CAPTURE_AND_RETHROW()
@@ -898,11 +1080,20 @@ void database::notify_pre_apply_operation(operation_notification& note)
     note.op_in_trx = _current_op_in_trx;
 
     DEIP_TRY_NOTIFY(pre_apply_operation, note)
+    DEIP_TRY_NOTIFY(pre_apply_operation_dispatcher, note)
 }
 
 void database::notify_post_apply_operation(const operation_notification& note)
 {
     DEIP_TRY_NOTIFY(post_apply_operation, note)
+    DEIP_TRY_NOTIFY(post_apply_operation_dispatcher, note)
+}
+
+bool database::is_operation_observed(int op_tag) const
+{
+    return !pre_apply_operation.empty() || !post_apply_operation.empty()
+        || pre_apply_operation_dispatcher.has_subscribers(op_tag)
+        || post_apply_operation_dispatcher.has_subscribers(op_tag);
 }
 
 void database::push_virtual_operation(const operation& op)
@@ -912,6 +1103,10 @@ void database::push_virtual_operation(const operation& op)
 #endif
 
     FC_ASSERT(is_virtual_operation(op));
+
+    if (!is_operation_observed(op.which()))
+        return;
+
     operation_notification note(op);
     notify_pre_apply_operation(note);
     notify_post_apply_operation(note);
@@ -1189,6 +1384,7 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
     dbs_review_vote& review_votes_service = obtain_service<dbs_review_vote>();
     dbs_expert_token& expert_tokens_service = obtain_service<dbs_expert_token>();
     const fc::time_point_sec now = head_block_time();
+    const bool is_account_eci_history_observed = is_virtual_operation_observed<account_eci_history_operation>();
 
     const auto& altered_contributions = expertise_contributions_service.get_altered_expertise_contributions_in_block();
     flat_map<int64_t, std::vector<eci_diff>> disciplines_contributions;
@@ -1257,20 +1453,23 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id, 
                       reviewer_expertise_reward);
 
-                    const eci_diff upvoter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias);
-
-                    push_virtual_operation(account_eci_history_operation(
-                        upvoter.second, 
-                        expertise_contribution.discipline_id._id,
-                        static_cast<uint16_t>(reward_recipient_type::reviewer),
-                        upvoter_eci_diff)
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff upvoter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias);
+
+                        push_virtual_operation(account_eci_history_operation(
+                            upvoter.second, 
+                            expertise_contribution.discipline_id._id,
+                            static_cast<uint16_t>(reward_recipient_type::reviewer),
+                            upvoter_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& downvoter : downvoters)
@@ -1285,20 +1484,23 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id, 
                       -reviewer_expertise_penalty);
 
-                    const eci_diff downvoter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias);
-
-                    push_virtual_operation(account_eci_history_operation(
-                        downvoter.second, 
-                        expertise_contribution.discipline_id._id,
-                        static_cast<uint16_t>(reward_recipient_type::reviewer),
-                        downvoter_eci_diff)
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff downvoter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias);
+
+                        push_virtual_operation(account_eci_history_operation(
+                            downvoter.second, 
+                            expertise_contribution.discipline_id._id,
+                            static_cast<uint16_t>(reward_recipient_type::reviewer),
+                            downvoter_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& author : research_content.authors)
@@ -1314,21 +1516,24 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                         author_expertise_reward
                     );
 
-                    const eci_diff author_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff author_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias
+                        );
 
-                    push_virtual_operation(account_eci_history_operation(
-                        author, 
-                        expertise_contribution.discipline_id._id,
-                        static_cast<uint16_t>(reward_recipient_type::author),
-                        author_eci_diff)
-                    );
+                        push_virtual_operation(account_eci_history_operation(
+                            author, 
+                            expertise_contribution.discipline_id._id,
+                            static_cast<uint16_t>(reward_recipient_type::author),
+                            author_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& upvoter_supporter : upvoters_supporters)
@@ -1360,20 +1565,23 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id, 
                       review_supporter_expertise_reward);
 
-                    const eci_diff upvoter_supporter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias);
-
-                    push_virtual_operation(account_eci_history_operation(
-                      upvoter_supporter.first, 
-                      expertise_contribution.discipline_id._id,
-                      static_cast<uint16_t>(reward_recipient_type::review_supporter),
-                      upvoter_supporter_eci_diff)
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff upvoter_supporter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias);
+
+                        push_virtual_operation(account_eci_history_operation(
+                          upvoter_supporter.first, 
+                          expertise_contribution.discipline_id._id,
+                          static_cast<uint16_t>(reward_recipient_type::review_supporter),
+                          upvoter_supporter_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& downvoter_supporter : downvoters_supporters)
@@ -1405,20 +1613,23 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id, 
                       -review_supporter_expertise_penalty);
 
-                    const eci_diff downvoter_supporter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias);
-
-                    push_virtual_operation(account_eci_history_operation(
-                      downvoter_supporter.first, 
-                      expertise_contribution.discipline_id._id,
-                      static_cast<uint16_t>(reward_recipient_type::review_supporter),
-                      downvoter_supporter_eci_diff)
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff downvoter_supporter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias);
+
+                        push_virtual_operation(account_eci_history_operation(
+                          downvoter_supporter.first, 
+                          expertise_contribution.discipline_id._id,
+                          static_cast<uint16_t>(reward_recipient_type::review_supporter),
+                          downvoter_supporter_eci_diff)
+                        );
+                    }
                 }
             }
 
@@ -1439,21 +1650,24 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id,
                       -reviewer_expertise_penalty);
 
-                    const eci_diff upvoter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff upvoter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias
+                        );
 
-                    push_virtual_operation(account_eci_history_operation(
-                        upvoter.second, 
-                        expertise_contribution.discipline_id._id,
-                        static_cast<uint16_t>(reward_recipient_type::reviewer),
-                        upvoter_eci_diff)
-                    );
+                        push_virtual_operation(account_eci_history_operation(
+                            upvoter.second, 
+                            expertise_contribution.discipline_id._id,
+                            static_cast<uint16_t>(reward_recipient_type::reviewer),
+                            upvoter_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& downvoter : downvoters)
@@ -1468,21 +1682,24 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id,
                       reviewer_expertise_reward);
 
-                    const eci_diff downvoter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff downvoter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias
+                        );
 
-                    push_virtual_operation(account_eci_history_operation(
-                        downvoter.second, 
-                        expertise_contribution.discipline_id._id,
-                        static_cast<uint16_t>(reward_recipient_type::reviewer),
-                        downvoter_eci_diff)
-                    );
+                        push_virtual_operation(account_eci_history_operation(
+                            downvoter.second, 
+                            expertise_contribution.discipline_id._id,
+                            static_cast<uint16_t>(reward_recipient_type::reviewer),
+                            downvoter_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& author : research_content.authors)
@@ -1497,21 +1714,24 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id,
                       -author_expertise_penalty);
 
-                    const eci_diff author_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff author_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias
+                        );
 
-                    push_virtual_operation(account_eci_history_operation(
-                        author, 
-                        expertise_contribution.discipline_id._id,
-                        static_cast<uint16_t>(reward_recipient_type::author),
-                        author_eci_diff)
-                    );
+                        push_virtual_operation(account_eci_history_operation(
+                            author, 
+                            expertise_contribution.discipline_id._id,
+                            static_cast<uint16_t>(reward_recipient_type::author),
+                            author_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& upvoter_supporter : upvoters_supporters)
@@ -1543,20 +1763,23 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id, 
                       -review_supporter_expertise_penalty);
 
-                    const eci_diff upvoter_supporter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias);
-
-                    push_virtual_operation(account_eci_history_operation(
-                      upvoter_supporter.first, 
-                      expertise_contribution.discipline_id._id,
-                      static_cast<uint16_t>(reward_recipient_type::review_supporter),
-                      upvoter_supporter_eci_diff)
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff upvoter_supporter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias);
+
+                        push_virtual_operation(account_eci_history_operation(
+                          upvoter_supporter.first, 
+                          expertise_contribution.discipline_id._id,
+                          static_cast<uint16_t>(reward_recipient_type::review_supporter),
+                          upvoter_supporter_eci_diff)
+                        );
+                    }
                 }
 
                 for (auto& downvoter_supporter : downvoters_supporters)
@@ -1588,20 +1811,23 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                       expertise_contribution.discipline_id, 
                       review_supporter_expertise_reward);
 
-                    const eci_diff downvoter_supporter_eci_diff = eci_diff(
-                      std::get<0>(exp_token_diff),
-                      std::get<1>(exp_token_diff),
-                      now,
-                      diff.contribution_type,
-                      diff.contribution_id,
-                      expertise_contribution.assessment_criterias);
-
-                    push_virtual_operation(account_eci_history_operation(
-                      downvoter_supporter.first, 
-                      expertise_contribution.discipline_id._id,
-                      static_cast<uint16_t>(reward_recipient_type::review_supporter),
-                      downvoter_supporter_eci_diff)
-                    );
+                    if (is_account_eci_history_observed)
+                    {
+                        const eci_diff downvoter_supporter_eci_diff = eci_diff(
+                          std::get<0>(exp_token_diff),
+                          std::get<1>(exp_token_diff),
+                          now,
+                          diff.contribution_type,
+                          diff.contribution_id,
+                          expertise_contribution.assessment_criterias);
+
+                        push_virtual_operation(account_eci_history_operation(
+                          downvoter_supporter.first, 
+                          expertise_contribution.discipline_id._id,
+                          static_cast<uint16_t>(reward_recipient_type::review_supporter),
+                          downvoter_supporter_eci_diff)
+                        );
+                    }
                 }
             }
             else
@@ -1615,21 +1841,24 @@ asset database::distribute_reward(const asset& reward, const share_type& experti
                           expertise_contribution.discipline_id,
                           share_type(0));
 
-                        const eci_diff author_eci_diff = eci_diff(
-                          std::get<0>(exp_token_diff),
-                          std::get<1>(exp_token_diff),
-                          now,
-                          diff.contribution_type,
-                          diff.contribution_id,
-                          expertise_contribution.assessment_criterias
-                        );
-
-                        push_virtual_operation(account_eci_history_operation(
-                          author, 
-                          expertise_contribution.discipline_id._id,
-                          static_cast<uint16_t>(reward_recipient_type::author),
-                          author_eci_diff)
-                        );
+                        if (is_account_eci_history_observed)
+                        {
+                            const eci_diff author_eci_diff = eci_diff(
+                              std::get<0>(exp_token_diff),
+                              std::get<1>(exp_token_diff),
+                              now,
+                              diff.contribution_type,
+                              diff.contribution_id,
+                              expertise_contribution.assessment_criterias
+                            );
+
+                            push_virtual_operation(account_eci_history_operation(
+                              author, 
+                              expertise_contribution.discipline_id._id,
+                              static_cast<uint16_t>(reward_recipient_type::author),
+                              author_eci_diff)
+                            );
+                        }
                     }
                 }
             }
@@ -1770,52 +1999,53 @@ void database::initialize_evaluators()
 
 void database::initialize_indexes()
 {
-    add_index<dynamic_global_property_index>();
-    add_index<chain_property_index>();
-    add_index<account_index>();
-    add_index<account_authority_index>();
-    add_index<witness_index>();
-    add_index<transaction_index>();
-    add_index<block_summary_index>();
-    add_index<witness_schedule_index>();
-    add_index<witness_vote_index>();
-    add_index<hardfork_property_index>();
-    add_index<withdraw_common_tokens_route_index>();
-    add_index<owner_authority_history_index>();
-    add_index<account_recovery_request_index>();
-    add_index<change_recovery_account_request_index>();
-    add_index<discipline_supply_index>();
-    add_index<proposal_index>();
-    add_index<recent_entity_index>();
-    add_index<discipline_index>();
-    add_index<research_discipline_relation_index>();
-    add_index<research_index>();
-    add_index<research_content_index>();
-    add_index<expert_token_index>();
-    add_index<research_token_sale_index>();
-    add_index<research_token_sale_contribution_index>();
-    add_index<expertise_contribution_index>();
-    add_index<review_index>();
-    add_index<review_vote_index>();
-    add_index<vesting_balance_index>();
-    add_index<reward_pool_index>();
-    add_index<expertise_allocation_proposal_index>();
-    add_index<expertise_allocation_proposal_vote_index>();
-    add_index<grant_application_index>();
-    add_index<grant_application_review_index>();
-    add_index<funding_opportunity_index>();
-    add_index<account_balance_index>();
-    add_index<asset_index>();
-    add_index<award_index>();
-    add_index<award_recipient_index>();
-    add_index<award_withdrawal_request_index>();
-    add_index<nda_contract_index>();
-    add_index<nda_contract_content_access_index>();
-    add_index<assessment_index>();
-    add_index<assessment_stage_index>();
-    add_index<assessment_stage_phase_index>();
-    add_index<research_license_index>();
-    add_index<contract_agreement_index>();
+    add_core_index<dynamic_global_property_index>();
+    add_core_index<chain_property_index>();
+    add_core_index<account_index>();
+    add_core_index<account_authority_index>();
+    add_core_index<witness_index>();
+    add_core_index<transaction_index>();
+    add_core_index<block_summary_index>();
+    add_core_index<witness_schedule_index>();
+    add_core_index<witness_vote_index>();
+    add_core_index<hardfork_property_index>();
+    add_core_index<withdraw_common_tokens_route_index>();
+    add_core_index<owner_authority_history_index>();
+    add_core_index<account_recovery_request_index>();
+    add_core_index<change_recovery_account_request_index>();
+    add_core_index<discipline_supply_index>();
+    add_core_index<proposal_index>();
+    add_core_index<recent_entity_index>();
+    add_core_index<discipline_index>();
+    add_core_index<research_discipline_relation_index>();
+    add_core_index<research_index>();
+    add_core_index<research_content_index>();
+    add_core_index<expert_token_index>();
+    add_core_index<research_token_sale_index>();
+    add_core_index<research_token_sale_contribution_index>();
+    add_core_index<research_token_sale_settlement_index>();
+    add_core_index<expertise_contribution_index>();
+    add_core_index<review_index>();
+    add_core_index<review_vote_index>();
+    add_core_index<vesting_balance_index>();
+    add_core_index<reward_pool_index>();
+    add_core_index<expertise_allocation_proposal_index>();
+    add_core_index<expertise_allocation_proposal_vote_index>();
+    add_core_index<grant_application_index>();
+    add_core_index<grant_application_review_index>();
+    add_core_index<funding_opportunity_index>();
+    add_core_index<account_balance_index>();
+    add_core_index<asset_index>();
+    add_core_index<award_index>();
+    add_core_index<award_recipient_index>();
+    add_core_index<award_withdrawal_request_index>();
+    add_core_index<nda_contract_index>();
+    add_core_index<nda_contract_content_access_index>();
+    add_core_index<assessment_index>();
+    add_core_index<assessment_stage_index>();
+    add_core_index<assessment_stage_phase_index>();
+    add_core_index<research_license_index>();
+    add_core_index<contract_agreement_index>();
 
     _plugin_index_signal();
 }
@@ -1894,43 +2124,72 @@ void database::notify_changed_objects()
 {
     try
     {
-        /*vector< graphene::chainbase::generic_id > ids;
-        get_changed_ids( ids );
-        DEIP_TRY_NOTIFY( changed_objects, ids )*/
-        /*
-        if( _undo_db.enabled() )
+        if (changed_objects.empty())
+            return;
+
+        std::vector<chainbase::object_change> changes;
+        get_head_changes(changes);
+
+        block_changeset changeset;
+        changeset.block_num = head_block_num();
+        changeset.block_id = head_block_id();
+        changeset.objects.reserve(changes.size());
+
+        for (const auto& change : changes)
         {
-           const auto& head_undo = _undo_db.head();
-           vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
-           for( const auto& item : head_undo.old_values ) changed_ids.push_back(item.first);
-           for( const auto& item : head_undo.new_ids ) changed_ids.push_back(item);
-           vector<const object*> removed;
-           removed.reserve( head_undo.removed.size() );
-           for( const auto& item : head_undo.removed )
-           {
-              changed_ids.push_back( item.first );
-              removed.emplace_back( item.second.get() );
-           }
-           DEIP_TRY_NOTIFY( changed_objects, changed_ids )
+            changeset.objects.emplace_back(change);
+            pack_changed_object(changeset.objects.back());
         }
-        */
+
+        DEIP_TRY_NOTIFY(changed_objects, changeset)
     }
     FC_CAPTURE_AND_RETHROW()
 }
 
+void database::pack_changed_object(changed_object& obj) const
+{
+    if (obj.type_id < _changed_object_packers.size() && _changed_object_packers[obj.type_id])
+        _changed_object_packers[obj.type_id](obj, obj.data);
+}
+
 void database::set_flush_interval(uint32_t flush_blocks)
 {
     _flush_blocks = flush_blocks;
     _next_flush_block = 0;
 }
 
+fc::optional<state_checkpoint> database::get_committed_checkpoint() const
+{
+    fc::optional<state_checkpoint> checkpoint;
+
+    // the journal is checked against the block log on open
+    if (_committed_block_num <= _block_log.written_block_num())
+    {
+        checkpoint = state_checkpoint();
+        checkpoint->block_num = _committed_block_num;
+        checkpoint->block_id = find_block_id_for_num(_committed_block_num);
+    }
+
+    return checkpoint;
+}
+
+void database::set_block_log_queue_size(uint32_t max_queue_size)
+{
+    _block_log.set_max_queue_size(max_queue_size);
+}
+
+void database::set_transaction_verification_threads(uint32_t num_threads)
+{
+    _transaction_verifier.reset(num_threads > 0 ? new parallel_transaction_verifier(num_threads) : nullptr);
+}
+
 //////////////////// private methods ////////////////////
 
 void database::apply_block(const signed_block& next_block, uint32_t skip)
 {
     try
     {
-        // fc::time_point begin_time = fc::time_point::now();
+        const fc::time_point begin_time = fc::time_point::now();
 
         auto block_num = next_block.block_num();
         if (_checkpoints.size() && _checkpoints.rbegin()->second != block_id_type())
@@ -1951,6 +2210,11 @@ void database::apply_block(const signed_block& next_block, uint32_t skip)
 
         detail::with_skip_flags(*this, skip, [&]() { _apply_block(next_block); });
 
+        chain_metrics& m = get_chain_metrics();
+        m.block_apply_seconds.observe((fc::time_point::now() - begin_time).count() / 1000000.0);
+        m.blocks_applied.inc();
+        m.transactions_applied.inc(next_block.transactions.size());
+
         /*try
         {
         /// check invariants
@@ -1982,13 +2246,26 @@ void database::apply_block(const signed_block& next_block, uint32_t skip)
 
             if (_next_flush_block == block_num)
             {
-                _next_flush_block = 0;
-                // ilog( "Flushing database shared memory at block ${b}", ("b", block_num) );
-                chainbase::database::flush();
+                // the checkpoint thread syncs the state, a checkpoint still in progress is waited out
+                // block by block
+                if (_state_checkpointer.is_open() && !(skip & skip_block_log))
+                {
+                    const auto checkpoint = get_committed_checkpoint();
+                    if (checkpoint && _state_checkpointer.start(*checkpoint))
+                        _next_flush_block = 0;
+                    else
+                        ++_next_flush_block;
+                }
+                else
+                {
+                    _next_flush_block = 0;
+                    chainbase::database::flush();
+                }
             }
         }
 
         show_free_memory(false);
+        report_metrics();
     }
     FC_CAPTURE_AND_RETHROW((next_block))
 }
@@ -2015,6 +2292,32 @@ void database::show_free_memory(bool force)
 #endif
 }
 
+void database::report_metrics()
+{
+    chain_metrics& m = get_chain_metrics();
+
+    const auto& dpo = get_dynamic_global_properties();
+    m.head_block_num.set(dpo.head_block_number);
+    m.last_irreversible_block_num.set(dpo.last_irreversible_block_num);
+    if (!(get_node_properties().skip_flags & skip_block_log))
+    {
+        const uint32_t written = _block_log.written_block_num();
+        m.block_log_queued_blocks.set(dpo.last_irreversible_block_num > written ? dpo.last_irreversible_block_num - written : 0);
+    }
+    m.fork_db_size.set(_fork_db.size());
+    m.shared_memory_free_bytes.set(get_free_memory());
+
+    // lock usage since the previous block, the totals are of this database
+    const chainbase::lock_stats stats = get_lock_stats();
+    m.write_locks.inc(stats.write_locks - _reported_lock_stats.write_locks);
+    m.write_lock_wait_us.inc(stats.write_wait_us - _reported_lock_stats.write_wait_us);
+    m.read_locks.inc(stats.read_locks - _reported_lock_stats.read_locks);
+    m.read_lock_hold_us.inc(stats.read_hold_us - _reported_lock_stats.read_hold_us);
+    m.max_write_lock_wait_us.set(std::max<double>(m.max_write_lock_wait_us.value(), stats.max_write_wait_us));
+    m.max_read_lock_hold_us.set(std::max<double>(m.max_read_lock_hold_us.value(), stats.max_read_hold_us));
+    _reported_lock_stats = stats;
+}
+
 void database::_apply_block(const signed_block& next_block)
 {
     try
@@ -2054,6 +2357,8 @@ void database::_apply_block(const signed_block& next_block)
 
         const witness_object& signing_witness = validate_block_header(skip, next_block);
 
+        _authority_cache.clear();
+
         _current_block_num = next_block_num;
         _current_trx_in_block = 0;
 
@@ -2075,18 +2380,34 @@ void database::_apply_block(const signed_block& next_block)
                   "Block produced by witness that is not running current hardfork",
                   ("witness", witness)("next_block.witness", next_block.witness)("hardfork_state", hardfork_state));
 
-        for (const auto& trx : next_block.transactions)
+        try
         {
-            /* We do not need to push the undo state for each transaction
-             * because they either all apply and are valid or the
-             * entire block fails to apply.  We only need an "undo" state
-             * for transactions when validating broadcast transactions or
-             * when building a block.
-             */
-            apply_transaction(trx, skip);
-            ++_current_trx_in_block;
+            if (_transaction_verifier && next_block.transactions.size() > 1)
+                _transaction_verifier->verify(*this, next_block, skip);
+
+            for (const auto& trx : next_block.transactions)
+            {
+                /* We do not need to push the undo state for each transaction
+                 * because they either all apply and are valid or the
+                 * entire block fails to apply.  We only need an "undo" state
+                 * for transactions when validating broadcast transactions or
+                 * when building a block.
+                 */
+                apply_transaction(trx, skip);
+                ++_current_trx_in_block;
+            }
+        }
+        catch (...)
+        {
+            // otherwise the results of the failed block would authorize its transactions when pushed alone
+            if (_transaction_verifier)
+                _transaction_verifier->clear();
+            throw;
         }
 
+        if (_transaction_verifier)
+            _transaction_verifier->clear();
+
         update_global_dynamic_data(next_block);
         update_signing_witness(signing_witness, next_block);
 
@@ -2181,7 +2502,12 @@ void database::_apply_transaction(const signed_transaction& trx)
 
         uint32_t skip = get_node_properties().skip_flags;
 
-        if (!(skip & skip_validate)) /* issue #505 explains why this skip_flag is disabled */
+        // steps already done by the verifier while this transaction's block is applied
+        const parallel_transaction_verifier::verified_transaction verified = _transaction_verifier
+            ? _transaction_verifier->get_result(*this, trx)
+            : parallel_transaction_verifier::verified_transaction();
+
+        if (!(skip & skip_validate) && !verified.validated) /* issue #505 explains why this skip_flag is disabled */
             trx.validate();
 
         auto& trx_idx = get_index<transaction_index>();
@@ -2190,26 +2516,20 @@ void database::_apply_transaction(const signed_transaction& trx)
         FC_ASSERT((skip & skip_transaction_dupe_check) || trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end(),
           "Duplicate transaction check failed", ("trx_ix", trx_id));
 
-        if (!(skip & (skip_transaction_signatures | skip_authority_check)))
+        if (!(skip & (skip_transaction_signatures | skip_authority_check)) && !verified.authorized)
         {
             try
             {
                 auto get_active = [&](const string& name) { 
-                    return authority(get<account_authority_object, by_account>(name).active); 
+                    return _authority_cache.get_active(name); 
                 };
 
                 auto get_owner = [&](const string& name) { 
-                    return authority(get<account_authority_object, by_account>(name).owner); 
+                    return _authority_cache.get_owner(name); 
                 };
 
                 auto get_active_overrides = [&](const string& name, const uint16_t& op_tag) {
-                    fc::optional<authority> result;
-                    const auto& auth = get<account_authority_object, by_account>(name);
-                    if (auth.active_overrides.find(op_tag) != auth.active_overrides.end())
-                    {
-                        result = auth.active_overrides.at(op_tag);
-                    }
-                    return result;
+                    return _authority_cache.get_active_override(name, op_tag);
                 };
 
                 trx.verify_authority(
@@ -2282,7 +2602,7 @@ void database::_apply_transaction(const signed_transaction& trx)
             create<transaction_object>([&](transaction_object& transaction) {
                 transaction.trx_id = trx_id;
                 transaction.expiration = trx.expiration;
-                fc::raw::pack(transaction.packed_trx, trx);
+                transaction.block_num = head_block_num() + 1;
             });
         }
 
@@ -2308,12 +2628,31 @@ void database::_apply_transaction(const signed_transaction& trx)
 
 void database::apply_operation(const operation& op)
 {
+    settle_license_revenue(op);
+
     operation_notification note(op);
     notify_pre_apply_operation(note);
     _my->_evaluator_registry.get_evaluator(op).apply(op);
     notify_post_apply_operation(note);
 }
 
+void database::settle_license_revenue(const operation& op)
+{
+    // license revenue is distributed lazily, accounts which may spend in this operation
+    // get their pending revenue first
+    flat_set<account_name_type> required_active;
+    flat_set<account_name_type> required_owner;
+    vector<authority> other;
+    operation_get_required_authorities(op, required_active, required_owner, other);
+
+    auto& account_balance_service = obtain_service<dbs_account_balance>();
+    for (const auto& account : required_active)
+        account_balance_service.settle_license_revenue(account);
+    for (const auto& account : required_owner)
+        if (required_active.find(account) == required_active.end())
+            account_balance_service.settle_license_revenue(account);
+}
+
 const witness_object& database::validate_block_header(uint32_t skip, const signed_block& next_block) const
 {
     try
@@ -2479,8 +2818,6 @@ void database::update_last_irreversible_block()
             }
         }
 
-        commit(dpo.last_irreversible_block_num);
-
         if (!(get_node_properties().skip_flags & skip_block_log))
         {
             // output to block log based on new last irreverisible block num
@@ -2499,9 +2836,15 @@ void database::update_last_irreversible_block()
                     _block_log.append(block->data);
                     log_head_num++;
                 }
-
-                _block_log.flush();
             }
+
+            // blocks are written by the block log writer, undo states are kept until the blocks are
+            // on disk so that the state can be rewound to the block log head after the node is killed
+            commit_irreversible(std::min(dpo.last_irreversible_block_num, _block_log.written_block_num()));
+        }
+        else
+        {
+            commit_irreversible(dpo.last_irreversible_block_num);
         }
 
         _fork_db.set_max_size(dpo.head_block_number - dpo.last_irreversible_block_num + 1);
@@ -2509,6 +2852,12 @@ void database::update_last_irreversible_block()
     FC_CAPTURE_AND_RETHROW()
 }
 
+void database::commit_irreversible(uint32_t block_num)
+{
+    commit(block_num);
+    _committed_block_num = std::max(_committed_block_num, block_num);
+}
+
 void database::clear_expired_transactions()
 {
     // Look for expired transactions in the deduplication list, and remove them.
@@ -2745,6 +3094,14 @@ void database::validate_invariants() const
             total_supply += itr->amount;
         }
 
+        const auto& asset_idx = get_index<asset_index, by_id>();
+        for (auto itr = asset_idx.begin(); itr != asset_idx.end(); ++itr)
+        {
+            const auto revenue_itr = itr->license_revenue.find(DEIP_SYMBOL);
+            if (revenue_itr != itr->license_revenue.end())
+                total_supply += asset(revenue_itr->second.undistributed, DEIP_SYMBOL);
+        }
+
         total_supply += gpo.common_tokens_fund;
 
         FC_ASSERT(gpo.current_supply == total_supply, "",
@@ -0,0 +1,264 @@
+#include <deip/chain/database/parallel_transaction_verifier.hpp>
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/schema/account_object.hpp>
+
+#include <graphene/utilities/metrics.hpp>
+
+#include <algorithm>
+
+namespace deip {
+namespace chain {
+
+namespace {
+
+graphene::utilities::counter& verification_counter(const std::string& result)
+{
+    return graphene::utilities::metrics().get_counter("deip_transaction_verifications_total",
+                                                      "Authority checks of block transactions by their optimistic result",
+                                                      { { "result", result } });
+}
+}
+
+parallel_transaction_verifier::parallel_transaction_verifier(uint32_t num_threads)
+{
+    FC_ASSERT(num_threads > 0, "At least one verification thread is required");
+
+    _threads.reserve(num_threads);
+    for (uint32_t i = 0; i < num_threads; ++i)
+        _threads.emplace_back([this]() { run_worker(); });
+}
+
+parallel_transaction_verifier::~parallel_transaction_verifier()
+{
+    {
+        std::lock_guard<std::mutex> lock(_jobs_mutex);
+        _quit = true;
+    }
+    _jobs_added.notify_all();
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void parallel_transaction_verifier::run_worker()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_jobs_mutex);
+            _jobs_added.wait(lock, [this]() { return _quit || !_jobs.empty(); });
+            if (_quit)
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(_jobs_mutex);
+            --_pending_jobs;
+        }
+        _jobs_done.notify_all();
+    }
+}
+
+void parallel_transaction_verifier::verify(database& db, const signed_block& block, uint32_t skip)
+{
+    _results.clear();
+
+    const bool validate = !(skip & database::skip_validate);
+    const bool authorize = !(skip & (database::skip_transaction_signatures | database::skip_authority_check));
+    if (!validate && !authorize)
+        return;
+
+    const auto& transactions = block.transactions;
+    const chain_id_type chain_id = db.get_chain_id();
+    _mutation_count = db.get_index<account_authority_index>().mutation_count();
+
+    // every job takes every n-th transaction, transactions of one account are usually spread over the block
+    const size_t num_jobs = std::min(_threads.size(), transactions.size());
+    std::vector<result> results(transactions.size());
+    {
+        std::lock_guard<std::mutex> lock(_jobs_mutex);
+        for (size_t j = 0; j < num_jobs; ++j)
+        {
+            _jobs.push_back([&, j]() {
+                for (size_t i = j; i < transactions.size(); i += num_jobs)
+                    results[i] = verify_transaction(db, chain_id, transactions[i], skip);
+            });
+        }
+        _pending_jobs += num_jobs;
+    }
+    _jobs_added.notify_all();
+
+    {
+        std::unique_lock<std::mutex> lock(_jobs_mutex);
+        _jobs_done.wait(lock, [this]() { return _pending_jobs == 0; });
+    }
+
+    for (size_t i = 0; i < transactions.size(); ++i)
+        _results[transactions[i].merkle_digest()] = std::move(results[i]);
+}
+
+parallel_transaction_verifier::verified_transaction parallel_transaction_verifier::get_result(database& db,
+                                                                                               const signed_transaction& trx)
+{
+    verified_transaction verified;
+    if (_results.empty())
+        return verified;
+
+    auto itr = _results.find(trx.merkle_digest());
+    if (itr == _results.end())
+        return verified;
+
+    const result& r = itr->second;
+    verified.validated = r.validated;
+
+    static graphene::utilities::counter& failed_metric = verification_counter("failed");
+    static graphene::utilities::counter& conflicts_metric = verification_counter("conflict");
+    static graphene::utilities::counter& verified_metric = verification_counter("verified");
+
+    std::lock_guard<std::mutex> lock(_counters_mutex);
+    if (!r.authorized)
+    {
+        ++_counters.failed;
+        failed_metric.inc();
+    }
+    else if (db.get_index<account_authority_index>().mutation_count() != _mutation_count && !is_unchanged(db, r.reads))
+    {
+        ++_counters.conflicts;
+        conflicts_metric.inc();
+    }
+    else
+    {
+        ++_counters.verified;
+        verified_metric.inc();
+        verified.authorized = true;
+    }
+
+    return verified;
+}
+
+void parallel_transaction_verifier::clear()
+{
+    _results.clear();
+}
+
+parallel_transaction_verifier::counters parallel_transaction_verifier::get_counters() const
+{
+    std::lock_guard<std::mutex> lock(_counters_mutex);
+    return _counters;
+}
+
+parallel_transaction_verifier::result parallel_transaction_verifier::verify_transaction(database& db,
+                                                                                       const chain_id_type& chain_id,
+                                                                                       const signed_transaction& trx,
+                                                                                       uint32_t skip)
+{
+    result r;
+
+    if (!(skip & database::skip_validate))
+    {
+        try
+        {
+            trx.validate();
+            r.validated = true;
+        }
+        catch (...)
+        {
+            // reported by _apply_transaction
+        }
+    }
+
+    if (skip & (database::skip_transaction_signatures | database::skip_authority_check))
+        return r;
+
+    // the same checks as _apply_transaction, recording what they read
+    authority_cache& cache = db.get_authority_cache();
+
+    auto get_active = [&](const std::string& name) {
+        authority auth = cache.get_active(name);
+        r.reads.active[name] = auth;
+        return auth;
+    };
+
+    auto get_owner = [&](const std::string& name) {
+        authority auth = cache.get_owner(name);
+        r.reads.owner[name] = auth;
+        return auth;
+    };
+
+    auto get_active_overrides = [&](const std::string& name, const uint16_t& op_tag) {
+        fc::optional<authority> auth = cache.get_active_override(name, op_tag);
+        r.reads.active_overrides[std::make_pair(account_name_type(name), op_tag)] = auth;
+        return auth;
+    };
+
+    auto get_tenant = [&](const std::string& name) {
+        authority tenant;
+
+        for (const auto& item : get_active(name).key_auths)
+        {
+            tenant.add_authority(item.first, item.second);
+        }
+
+        for (const auto& item : get_owner(name).key_auths)
+        {
+            tenant.add_authority(item.first, item.second);
+        }
+
+        return tenant;
+    };
+
+    try
+    {
+        trx.verify_authority(chain_id, get_active, get_owner, get_active_overrides);
+        trx.verify_tenant_authority(chain_id, get_tenant);
+        r.authorized = true;
+    }
+    catch (...)
+    {
+        // verified again by _apply_transaction, which reports the failure
+    }
+
+    return r;
+}
+
+bool parallel_transaction_verifier::is_unchanged(database& db, const read_set& reads)
+{
+    authority_cache& cache = db.get_authority_cache();
+
+    try
+    {
+        for (const auto& read : reads.active)
+        {
+            if (!(cache.get_active(read.first) == read.second))
+                return false;
+        }
+
+        for (const auto& read : reads.owner)
+        {
+            if (!(cache.get_owner(read.first) == read.second))
+                return false;
+        }
+
+        for (const auto& read : reads.active_overrides)
+        {
+            const fc::optional<authority> auth = cache.get_active_override(read.first.first, read.first.second);
+            if (auth.valid() != read.second.valid() || (auth.valid() && !(*auth == *read.second)))
+                return false;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    return true;
+}
+}
+}
@@ -0,0 +1,276 @@
+#include <deip/chain/database/state_checkpointer.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/log/logger.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace deip {
+namespace chain {
+
+namespace detail {
+
+namespace {
+
+void sync_file(int fd, const fc::path& file)
+{
+    FC_ASSERT(::fsync(fd) == 0, "Cannot sync ${f}: ${e}", ("f", file)("e", std::strerror(errno)));
+}
+
+/**
+ * The new journal is written and synced to a temporary file which then replaces the previous one,
+ * the directory is synced so that the rename is durable as well.
+ */
+void write_journal(const fc::path& journal_file, const state_checkpoint& checkpoint, bool crash_before_replaced)
+{
+    const fc::path temp_file = fc::path(journal_file.generic_string() + ".tmp");
+    const std::vector<char> data = fc::raw::pack(checkpoint);
+
+    int fd = ::open(temp_file.generic_string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    FC_ASSERT(fd >= 0, "Cannot open ${f}: ${e}", ("f", temp_file)("e", std::strerror(errno)));
+
+    try
+    {
+        size_t done = 0;
+        while (done < data.size())
+        {
+            const ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            FC_ASSERT(n >= 0, "Cannot write ${f}: ${e}", ("f", temp_file)("e", std::strerror(errno)));
+            done += n;
+        }
+        sync_file(fd, temp_file);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+
+    FC_ASSERT(!crash_before_replaced, "State checkpoint crashed before the journal was replaced");
+
+    FC_ASSERT(::rename(temp_file.generic_string().c_str(), journal_file.generic_string().c_str()) == 0,
+              "Cannot replace ${f}: ${e}", ("f", journal_file)("e", std::strerror(errno)));
+
+    const fc::path dir = journal_file.parent_path();
+    int dir_fd = ::open(dir.generic_string().c_str(), O_RDONLY);
+    FC_ASSERT(dir_fd >= 0, "Cannot open ${f}: ${e}", ("f", dir)("e", std::strerror(errno)));
+    try
+    {
+        sync_file(dir_fd, dir);
+    }
+    catch (...)
+    {
+        ::close(dir_fd);
+        throw;
+    }
+    ::close(dir_fd);
+}
+}
+
+class state_checkpointer_impl
+{
+public:
+    ~state_checkpointer_impl()
+    {
+        join();
+    }
+
+    chainbase::database* state = nullptr;
+    fc::path journal_file;
+    fc::sha256 boot_id;
+    bool state_may_be_torn = false;
+
+    std::thread checkpoint_thread;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> crash_before_replaced{ false };
+
+    std::mutex mutex;
+    fc::optional<state_checkpoint> last;
+    std::string error;
+
+    void run(state_checkpoint checkpoint)
+    {
+        checkpoint.boot_id = boot_id;
+
+        std::string failure;
+        try
+        {
+            state->sync();
+            write_journal(journal_file, checkpoint, crash_before_replaced.exchange(false));
+        }
+        catch (const fc::exception& e)
+        {
+            failure = e.to_string();
+        }
+        catch (const std::exception& e)
+        {
+            failure = e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failure.empty())
+            {
+                last = checkpoint;
+            }
+            else
+            {
+                elog("State checkpoint at block ${b} failed: ${e}", ("b", checkpoint.block_num)("e", failure));
+                error = failure;
+            }
+        }
+
+        running = false;
+    }
+
+    void join()
+    {
+        if (checkpoint_thread.joinable())
+            checkpoint_thread.join();
+    }
+};
+}
+
+state_checkpointer::state_checkpointer()
+    : my(new detail::state_checkpointer_impl())
+{
+}
+
+state_checkpointer::~state_checkpointer()
+{
+}
+
+void state_checkpointer::open(chainbase::database& state, const fc::path& journal_file)
+{
+    close();
+
+    // left by a checkpoint which did not complete
+    fc::remove_all(fc::path(journal_file.generic_string() + ".tmp"));
+
+    my->last = read_journal(journal_file);
+    my->journal_file = journal_file;
+    my->state = &state;
+    my->boot_id = current_boot_id();
+    my->state_may_be_torn = my->last && !my->last->closed && my->last->boot_id != my->boot_id;
+
+    // a torn state keeps its journal until it is replayed
+    if (!my->state_may_be_torn)
+    {
+        state_checkpoint opened = my->last ? *my->last : state_checkpoint();
+        opened.boot_id = my->boot_id;
+        opened.closed = false;
+        write_journal(journal_file, opened, false);
+        my->last = opened;
+    }
+}
+
+void state_checkpointer::close()
+{
+    my->join();
+    my.reset(new detail::state_checkpointer_impl());
+}
+
+bool state_checkpointer::is_open() const
+{
+    return my->state != nullptr;
+}
+
+fc::optional<state_checkpoint> state_checkpointer::last() const
+{
+    std::lock_guard<std::mutex> lock(my->mutex);
+    return my->last;
+}
+
+bool state_checkpointer::state_may_be_torn() const
+{
+    return my->state_may_be_torn;
+}
+
+bool state_checkpointer::start(const state_checkpoint& checkpoint)
+{
+    FC_ASSERT(is_open(), "State checkpoints are not open");
+
+    if (my->running)
+        return false;
+
+    my->join();
+    my->running = true;
+    my->checkpoint_thread = std::thread([this, checkpoint]() { my->run(checkpoint); });
+
+    return true;
+}
+
+void state_checkpointer::wait()
+{
+    my->join();
+
+    std::string failure;
+    {
+        std::lock_guard<std::mutex> lock(my->mutex);
+        failure.swap(my->error);
+    }
+    FC_ASSERT(failure.empty(), "State checkpoint failed: ${e}", ("e", failure));
+}
+
+void state_checkpointer::take(const state_checkpoint& checkpoint)
+{
+    FC_ASSERT(is_open(), "State checkpoints are not open");
+
+    // a failure of the checkpoint in progress has been logged
+    my->join();
+    {
+        std::lock_guard<std::mutex> lock(my->mutex);
+        my->error.clear();
+    }
+
+    my->running = true;
+    my->run(checkpoint);
+    wait();
+}
+
+void state_checkpointer::crash_before_journal_replaced()
+{
+    my->crash_before_replaced = true;
+}
+
+fc::optional<state_checkpoint> state_checkpointer::read_journal(const fc::path& journal_file)
+{
+    fc::optional<state_checkpoint> result;
+    if (!fc::exists(journal_file))
+        return result;
+
+    std::string data;
+    fc::read_file_contents(journal_file, data);
+    FC_ASSERT(data.size() == fc::raw::pack_size(state_checkpoint()), "State checkpoint journal ${f} is damaged",
+              ("f", journal_file));
+
+    result = fc::raw::unpack<state_checkpoint>(std::vector<char>(data.begin(), data.end()));
+    return result;
+}
+
+fc::sha256 state_checkpointer::current_boot_id()
+{
+    // the size of the file is not known up front
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string boot_id;
+    if (!file || !std::getline(file, boot_id) || boot_id.empty())
+        return fc::sha256();
+
+    return fc::sha256::hash(boot_id);
+}
+}
+}
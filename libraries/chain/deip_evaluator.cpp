@@ -188,6 +188,13 @@ void create_account_evaluator::do_apply(const create_account_operation& op)
 
     if (op.is_user_account())
     {
+        expert_token_service.grant_default_expertise(op.new_account_name);
+
+        if (!_db.is_virtual_operation_observed<account_eci_history_operation>())
+        {
+            return;
+        }
+
         const auto& disciplines = discipline_service.lookup_disciplines(discipline_id_type(0), DEIP_API_BULK_FETCH_LIMIT);
         for (const discipline_object& discipline : disciplines)
         {
@@ -198,12 +205,6 @@ void create_account_evaluator::do_apply(const create_account_operation& op)
 
             const share_type& amount = share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT);
 
-            expert_token_service.create_expert_token(
-              op.new_account_name, 
-              discipline.id,
-              amount, 
-              true);
-
             flat_map<uint16_t, assessment_criteria_value> assessment_criterias;
             const eci_diff account_eci_diff = eci_diff(
               share_type(0), 
@@ -506,7 +507,7 @@ void vote_for_review_evaluator::do_apply(const vote_for_review_operation& op)
     const auto& review = review_service.get_review(op.review_external_id);
     const auto& discipline = discipline_service.get_discipline(op.discipline_external_id);
 
-    const auto& expert_token = expert_token_service.get_expert_token_by_account_and_discipline(op.voter, discipline.id);
+    const auto& expert_token = expert_token_service.materialize_expert_token(op.voter, discipline.id);
     const auto& research_content = research_content_service.get_research_content(review.research_content_id);
     const auto& research = research_service.get_research(research_content.research_id);
 
@@ -712,7 +713,6 @@ void update_proposal_evaluator::do_apply(const update_proposal_operation& op)
 {
     auto& proposals_service = _db.obtain_service<dbs_proposal>();
     const auto& block_time = _db.head_block_time();
-    chainbase::database& db = _db._temporary_public_impl();
 
     FC_ASSERT(proposals_service.proposal_exists(op.external_id),
       "Proposal ${1} does not exist", ("1", op.external_id));
@@ -775,7 +775,7 @@ void update_proposal_evaluator::do_apply(const update_proposal_operation& op)
     // Proposals with a review period may never be executed except at their expiration.
     if (proposal.review_period_time.valid()) return;
 
-    if (proposal.is_authorized_to_execute(db))
+    if (proposal.is_authorized_to_execute(_db.get_authority_cache()))
     {
         // All required approvals are satisfied. Execute!
         try 
@@ -846,9 +846,9 @@ void create_review_evaluator::do_apply(const create_review_operation& op)
       "${1} has reviewed research content ${2} already", 
       ("1", op.author)("2", research_content.id));
 
-    const auto& expertise_tokens = expertise_token_service.get_expert_tokens_by_account_name(op.author);
     const auto& research_disciplines_relations = research_discipline_service.get_research_discipline_relations_by_research(research_content.research_id);
     
+    std::set<discipline_id_type> review_discipline_ids;
     for (const auto& external_id : op.disciplines)
     {
         const auto& discipline = disciplines_service.get_discipline(external_id);
@@ -856,44 +856,39 @@ void create_review_evaluator::do_apply(const create_review_operation& op)
         FC_ASSERT(std::any_of(research_disciplines_relations.begin(), research_disciplines_relations.end(),
           [&](const research_discipline_relation_object& relation) { return relation.discipline_id == discipline.id; }));
 
-        FC_ASSERT(std::any_of(expertise_tokens.begin(), expertise_tokens.end(),
-          [&](const expert_token_object& exp) { return exp.discipline_id == discipline.id; }));
+        FC_ASSERT(expertise_token_service.expert_token_exists_by_account_and_discipline(op.author, discipline.id));
+
+        review_discipline_ids.insert(discipline.id);
     }
 
 
     std::map<discipline_id_type, share_type> review_used_expertise_by_disciplines;
-    for (auto& wrap : expertise_tokens)
+    for (const auto& discipline_id : review_discipline_ids)
     {
-        const auto& expert_token = wrap.get();
-
-        if (std::any_of(op.disciplines.begin(), op.disciplines.end(),
-            [&](const external_id_type& discipline_exernal_id) {
-                return discipline_exernal_id == expert_token.discipline_external_id;
-            }))
-        {
-            const int64_t elapsed_seconds = (now - expert_token.last_vote_time).to_seconds();
-            const int64_t regenerated_power_percent = (DEIP_100_PERCENT * elapsed_seconds) / DEIP_VOTE_REGENERATION_SECONDS;
-            const int64_t current_power_percent = std::min(int64_t(expert_token.voting_power + regenerated_power_percent), int64_t(DEIP_100_PERCENT));
-            // FC_ASSERT(current_power_percent > 0, 
-            //         "${1} does not have power for ${2} expertise currently to make the review. The available power is ${3} %", 
-            //         ("1", op.author)("2", expert_token.discipline_id)("3", current_power_percent / DEIP_1_PERCENT));
-
-            const int64_t review_applied_power_percent = op.weight.amount.value;
-            const int64_t used_power_percent = (DEIP_REVIEW_REQUIRED_POWER_PERCENT * review_applied_power_percent) / DEIP_100_PERCENT;
-            // FC_ASSERT(used_power_percent <= current_power_percent,
-            //         "${1} does not have enough power for ${2} expertise to make the review with ${3} % of power. The available power is ${4} %",
-            //         ("1", op.author)("2", expert_token.discipline_id)("3", review_applied_power_percent / DEIP_1_PERCENT)("4", current_power_percent / DEIP_1_PERCENT));
-
-            const uint64_t used_expert_token_amount = ((uint128_t(expert_token.amount.value) * current_power_percent) / (DEIP_100_PERCENT)).to_uint64();
-            // FC_ASSERT(used_expert_token_amount > 0, "Account does not have enough power to make the review.");
-
-            _db._temporary_public_impl().modify(expert_token, [&](expert_token_object& exp) {
-                exp.voting_power = current_power_percent - used_power_percent;
-                exp.last_vote_time = now;
-            });
+        const auto& expert_token = expertise_token_service.materialize_expert_token(op.author, discipline_id);
+
+        const int64_t elapsed_seconds = (now - expert_token.last_vote_time).to_seconds();
+        const int64_t regenerated_power_percent = (DEIP_100_PERCENT * elapsed_seconds) / DEIP_VOTE_REGENERATION_SECONDS;
+        const int64_t current_power_percent = std::min(int64_t(expert_token.voting_power + regenerated_power_percent), int64_t(DEIP_100_PERCENT));
+        // FC_ASSERT(current_power_percent > 0, 
+        //         "${1} does not have power for ${2} expertise currently to make the review. The available power is ${3} %", 
+        //         ("1", op.author)("2", expert_token.discipline_id)("3", current_power_percent / DEIP_1_PERCENT));
+
+        const int64_t review_applied_power_percent = op.weight.amount.value;
+        const int64_t used_power_percent = (DEIP_REVIEW_REQUIRED_POWER_PERCENT * review_applied_power_percent) / DEIP_100_PERCENT;
+        // FC_ASSERT(used_power_percent <= current_power_percent,
+        //         "${1} does not have enough power for ${2} expertise to make the review with ${3} % of power. The available power is ${4} %",
+        //         ("1", op.author)("2", expert_token.discipline_id)("3", review_applied_power_percent / DEIP_1_PERCENT)("4", current_power_percent / DEIP_1_PERCENT));
+
+        const uint64_t used_expert_token_amount = ((uint128_t(expert_token.amount.value) * current_power_percent) / (DEIP_100_PERCENT)).to_uint64();
+        // FC_ASSERT(used_expert_token_amount > 0, "Account does not have enough power to make the review.");
+
+        _db._temporary_public_impl().modify(expert_token, [&](expert_token_object& exp) {
+            exp.voting_power = current_power_percent - used_power_percent;
+            exp.last_vote_time = now;
+        });
 
-            review_used_expertise_by_disciplines.insert(std::make_pair(expert_token.discipline_id, used_expert_token_amount));
-        }
+        review_used_expertise_by_disciplines.insert(std::make_pair(expert_token.discipline_id, used_expert_token_amount));
     }
 
     FC_ASSERT(review_used_expertise_by_disciplines.size() != 0, 
@@ -1151,12 +1146,12 @@ void vote_for_expertise_allocation_proposal_evaluator::do_apply(const vote_for_e
       "Expertise token ${1} for ${2} does not exist", 
       ("1", op.voter)("2", proposal.discipline_id));
 
-    auto& expert_token = expert_token_service.get_expert_token_by_account_and_discipline(op.voter, proposal.discipline_id);
+    const share_type expertise = expert_token_service.get_expertise_amount(op.voter, proposal.discipline_id);
 
     if (op.voting_power == DEIP_100_PERCENT)
-        expertise_allocation_proposal_service.upvote(proposal, op.voter, expert_token.amount);
+        expertise_allocation_proposal_service.upvote(proposal, op.voter, expertise);
     else if (op.voting_power == -DEIP_100_PERCENT)
-        expertise_allocation_proposal_service.downvote(proposal, op.voter, expert_token.amount);
+        expertise_allocation_proposal_service.downvote(proposal, op.voter, expertise);
 
 }
 
@@ -1326,22 +1321,15 @@ void create_review_for_application_evaluator::do_apply(const create_review_for_a
     const auto& application = grant_application_service.get_grant_application(op.grant_application_id);
     const auto& research = research_service.get_research(application.research_id);
 
-    auto expertise_tokens = expertise_token_service.get_expert_tokens_by_account_name(op.author);
     const auto& research_disciplines_relations = research_discipline_service.get_research_discipline_relations_by_research(application.research_id);
 
     std::set<discipline_id_type> disciplines_ids;
-    for (auto& wrap : expertise_tokens)
+    for (const research_discipline_relation_object& relation : research_disciplines_relations)
     {
-        const auto& expert_token = wrap.get();
-
-        if (std::any_of(research_disciplines_relations.begin(), research_disciplines_relations.end(),
-                        [&](const std::reference_wrapper<const research_discipline_relation_object> rel_wrap) {
-                            const research_discipline_relation_object& relation = rel_wrap.get();
-                            return relation.discipline_id == expert_token.discipline_id;
-                        }))
+        if (expertise_token_service.expert_token_exists_by_account_and_discipline(op.author, relation.discipline_id))
         {
             // TODO: decide what to do with expertise tokens
-            disciplines_ids.insert(expert_token.discipline_id);
+            disciplines_ids.insert(relation.discipline_id);
         }
     }
 
@@ -2116,8 +2104,8 @@ void create_research_content_evaluator::do_apply(const create_research_content_o
         );
     }
 
-    const auto previous_research_content_eci = research_content_service.get_eci_evaluation(research_content.id);
-    const auto previous_research_eci = research_service.get_eci_evaluation(research.id);
+    const auto previous_research_content_eci = research_content.eci_per_discipline;
+    const auto previous_research_eci = research.eci_per_discipline;
 
     const research_content_object& updated_research_content = research_content_service.update_eci_evaluation(research_content.id);
     const research_object& updated_research = research_service.update_eci_evaluation(research.id);
@@ -2332,26 +2320,11 @@ void create_research_license_evaluator::do_apply(const create_research_license_o
                 beneficiary_shares.insert(std::make_pair(sym, share));
             }
 
+            // holders are paid lazily, when their balances are settled
             for (const auto& beneficiary_share : beneficiary_shares)
             {
                 const auto& security_token = asset_service.get_asset_by_string_symbol(beneficiary_share.first);
-                const auto& security_token_balances = account_balance_service.get_accounts_balances_by_symbol(security_token.symbol);
-                const auto& beneficiary_revenue = beneficiary_share.second;
-
-                for (const account_balance_object& security_token_balance : security_token_balances)
-                {
-                    const asset revenue = util::calculate_share(beneficiary_revenue, security_token_balance.amount, security_token.current_supply);
-                    const auto& account_revenue_balance = account_balance_service.adjust_account_balance(security_token_balance.owner, revenue);
-                    
-                    _db.push_virtual_operation(account_revenue_income_history_operation(
-                        security_token_balance.owner, 
-                        security_token_balance.to_asset(),
-                        revenue,
-                        now)
-                    );
-
-                    total_revenue += revenue;
-                }
+                total_revenue += asset_service.distribute_license_revenue(security_token, beneficiary_share.second);
             }
 
             FC_ASSERT(total_revenue <= fee, "Total revenue amount ${1} is more than fee amount ${2}", ("1", total_revenue)("2", fee));
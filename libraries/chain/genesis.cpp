@@ -1,5 +1,6 @@
 #include <deip/chain/database/database.hpp>
 #include <deip/chain/genesis_state.hpp>
+#include <deip/chain/genesis_reader.hpp>
 #include <fc/io/json.hpp>
 
 #include <deip/chain/schema/account_object.hpp>
@@ -56,6 +57,31 @@ void generate_default_genesis_state(genesis_state_type& genesis)
 
 } // namespace utils
 
+namespace {
+
+/**
+ *  Calls f for every record of a genesis record array. The records are read one by one from the
+ *  genesis reader when the state was loaded by one, so both ways of loading run the same code.
+ */
+template <typename T, typename F>
+void for_each_genesis_record(const genesis_state_type& genesis_state,
+                             const std::vector<T> genesis_state_type::*records,
+                             const std::string& section,
+                             F&& f)
+{
+    if (genesis_state.reader)
+    {
+        FC_ASSERT((genesis_state.*records).empty(), "Genesis ${s} are read from the genesis reader", ("s", section));
+        genesis_state.reader->for_each<T>(section, std::function<void(const T&)>(f));
+    }
+    else
+    {
+        for (const T& record : genesis_state.*records)
+            f(record);
+    }
+}
+}
+
 //////////////////////////////////////////////////////////////////////////
 fc::time_point_sec database::get_genesis_time() const
 {
@@ -121,7 +147,6 @@ void database::init_genesis_accounts(const genesis_state_type& genesis_state)
     auto& account_service = obtain_service<dbs_account>();
 
     const genesis_state_type::registrar_account_type& registrar = genesis_state.registrar_account;
-    const vector<genesis_state_type::account_type>& accounts = genesis_state.accounts;
 
     FC_ASSERT(!registrar.name.empty(), "Registrar account 'name' should not be empty.");
     FC_ASSERT(is_valid_account_name(registrar.name), "Registrar account name ${n} is invalid", ("n", registrar.name));
@@ -147,8 +172,7 @@ void database::init_genesis_accounts(const genesis_state_type& genesis_state)
         auth.active = auth.owner;
     });
 
-    for (auto& account : accounts)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::accounts, "accounts", [&](const genesis_state_type::account_type& account) {
         FC_ASSERT(!account.name.empty(), "Account 'name' should not be empty.");
         FC_ASSERT(is_valid_account_name(account.name), "Account name ${n} is invalid", ("n", account.name));
 
@@ -174,7 +198,7 @@ void database::init_genesis_accounts(const genesis_state_type& genesis_state)
         );
 
         push_virtual_operation(create_genesis_account_operation(account.name));
-    }
+    });
 }
 
 
@@ -184,10 +208,8 @@ void database::init_genesis_research_content_reviews(const genesis_state_type& g
     auto& research_content_service = obtain_service<dbs_research_content>();
     auto& disciplines_service = obtain_service<dbs_discipline>();
 
-    const vector<genesis_state_type::research_content_review_type>& research_contents_reviews = genesis_state.research_contents_reviews;
-
-    for (const auto& research_content_review : research_contents_reviews)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::research_contents_reviews, "research_contents_reviews",
+                            [&](const genesis_state_type::research_content_review_type& research_content_review) {
         const auto& research_content = research_content_service.get_research_content(research_content_review.research_content_external_id);
 
         const int32_t& assessment_model_type = 1;
@@ -226,7 +248,7 @@ void database::init_genesis_research_content_reviews(const genesis_state_type& g
           assessment_model_type,
           assessment_criterias
         );
-    }
+    });
 } 
 
 
@@ -235,16 +257,16 @@ void database::init_genesis_assets(const genesis_state_type& genesis_state)
     auto& asset_service = obtain_service<dbs_asset>();
 
     const vector<genesis_state_type::asset_type>& assets = genesis_state.assets;
-    const vector<genesis_state_type::account_balance_type>& account_balances = genesis_state.account_balances;
     const genesis_state_type::registrar_account_type& registrar = genesis_state.registrar_account;
 
-    const share_type liquid_total_supply = std::accumulate(
-      account_balances.begin(), account_balances.end(), share_type(0),
-      [&](share_type acc, const genesis_state_type::account_balance_type& account_balance) {
-        return account_balance.symbol == asset(0, DEIP_SYMBOL).symbol_name() 
-          ? share_type(account_balance.amount) + acc
-          : acc;
-      });
+    // supplies of all assets in one pass, there may be too many balances to go through per asset
+    std::map<std::string, share_type> total_supplies;
+    for_each_genesis_record(genesis_state, &genesis_state_type::account_balances, "account_balances",
+                            [&](const genesis_state_type::account_balance_type& account_balance) {
+        total_supplies[account_balance.symbol] += account_balance.amount;
+    });
+
+    const share_type liquid_total_supply = total_supplies[asset(0, DEIP_SYMBOL).symbol_name()];
 
     FC_ASSERT(liquid_total_supply.value == genesis_state.init_supply - registrar.common_tokens_amount,
       "Total supply (${total}) is not equal to inited supply (${inited}) for ${s} asset",
@@ -268,13 +290,7 @@ void database::init_genesis_assets(const genesis_state_type& genesis_state)
         const std::string string_asset = "0." + fc::to_string(p).erase(0, 1) + " " + asset.symbol;
         const protocol::asset a = asset::from_string(string_asset);
 
-        const share_type asset_total_supply = std::accumulate(
-          account_balances.begin(), account_balances.end(), share_type(0),
-          [&](share_type acc, const genesis_state_type::account_balance_type& account_balance) {
-              return account_balance.symbol == a.symbol_name()
-                ? share_type(account_balance.amount) + acc
-                : acc;
-          });
+        const share_type asset_total_supply = total_supplies[a.symbol_name()];
 
         FC_ASSERT(asset_total_supply.value == asset.current_supply,
           "Total supply (${total}) is not equal to inited supply (${inited}) for ${s} asset",
@@ -301,12 +317,11 @@ void database::init_genesis_account_balances(const genesis_state_type& genesis_s
     const auto& assets_service = obtain_service<dbs_asset>();
     auto& account_balances_service = obtain_service<dbs_account_balance>();
 
-    const vector<genesis_state_type::account_balance_type>& account_balances = genesis_state.account_balances;
-    for (const auto& account_balance : account_balances)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::account_balances, "account_balances",
+                            [&](const genesis_state_type::account_balance_type& account_balance) {
         const auto& asset_o = assets_service.get_asset_by_string_symbol(account_balance.symbol);
         account_balances_service.adjust_account_balance(account_balance.owner, asset(account_balance.amount, asset_o.symbol));
-    }
+    });
 }
 
 void database::init_genesis_witnesses(const genesis_state_type& genesis_state)
@@ -352,10 +367,9 @@ void database::init_genesis_global_property_object(const genesis_state_type& gen
 void database::init_genesis_disciplines(const genesis_state_type& genesis_state)
 {
     dbs_discipline& disciplines_service = obtain_service<dbs_discipline>();
-    const vector<genesis_state_type::discipline_type>& disciplines = genesis_state.disciplines;
 
-    for (auto& discipline : disciplines)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::disciplines, "disciplines",
+                            [&](const genesis_state_type::discipline_type& discipline) {
         FC_ASSERT(!discipline.name.empty(), "Discipline 'name' should not be empty.");
 
         if (discipline.parent_external_id != "")
@@ -376,13 +390,18 @@ void database::init_genesis_disciplines(const genesis_state_type& genesis_state)
                 fc::from_string(d_o.name, discipline.name);
             });
         }
-    }
+    });
 }
 
 
 void database::init_genesis_expert_tokens(const genesis_state_type& genesis_state)
 {
-    const vector<genesis_state_type::expert_token_type>& expert_tokens = genesis_state.expert_tokens;
+    // the first amount given for an account and discipline, looked up for every pair below
+    std::map<std::pair<std::string, external_id_type>, int64_t> expert_token_amounts;
+    for_each_genesis_record(genesis_state, &genesis_state_type::expert_tokens, "expert_tokens",
+                            [&](const genesis_state_type::expert_token_type& expert_token) {
+        expert_token_amounts.emplace(std::make_pair(expert_token.account, expert_token.discipline_external_id), expert_token.amount);
+    });
 
     dbs_expert_token& expert_token_service = obtain_service<dbs_expert_token>();
     dbs_discipline& discipline_service = obtain_service<dbs_discipline>();
@@ -392,6 +411,8 @@ void database::init_genesis_expert_tokens(const genesis_state_type& genesis_stat
     const auto& accounts = accounts_service.lookup_user_accounts(account_name_type("a"), DEIP_API_BULK_FETCH_LIMIT);
     for (const account_object& account : accounts)
     {
+        expert_token_service.grant_default_expertise(account.name);
+
         const auto& disciplines = discipline_service.lookup_disciplines(discipline_id_type(0), DEIP_API_BULK_FETCH_LIMIT);
         for (const discipline_object& discipline : disciplines)
         {
@@ -400,20 +421,19 @@ void database::init_genesis_expert_tokens(const genesis_state_type& genesis_stat
                 continue;
             }
 
-            const auto& exp_itr = std::find_if(expert_tokens.begin(), expert_tokens.end(),
-              [&](const genesis_state_type::expert_token_type& exp) { 
-                  return exp.account == account.name && exp.discipline_external_id == discipline.external_id; 
-            });
+            const auto& exp_itr = expert_token_amounts.find(std::make_pair(std::string(account.name), external_id_type(discipline.external_id)));
 
-            const share_type& amount = exp_itr != expert_tokens.end()
-              ? share_type((*exp_itr).amount)
+            const share_type& amount = exp_itr != expert_token_amounts.end()
+              ? share_type(exp_itr->second)
               : share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT);
 
-            expert_token_service.create_expert_token(
-              account.name, 
-              discipline.id,
-              amount, 
-              true);
+            if (amount != share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT))
+            {
+                expert_token_service.adjust_expert_token(
+                  account.name, 
+                  discipline.id,
+                  amount - share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT));
+            }
 
             flat_map<uint16_t, assessment_criteria_value> assessment_criterias;
             const eci_diff account_eci_diff = eci_diff(
@@ -442,10 +462,8 @@ void database::init_genesis_research(const genesis_state_type& genesis_state)
     dbs_discipline& disciplines_service = obtain_service<dbs_discipline>();
     dbs_account& accounts_service = obtain_service<dbs_account>();
 
-    const vector<genesis_state_type::research_type>& researches = genesis_state.researches;
-
-    for (auto& research : researches)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::researches, "researches",
+                            [&](const genesis_state_type::research_type& research) {
         FC_ASSERT(!research.description.empty(), "Research 'description' is required");
 
         std::set<discipline_id_type> disciplines;
@@ -478,12 +496,11 @@ void database::init_genesis_research(const genesis_state_type& genesis_state)
           is_default,
           genesis_time
         );
-    }
+    });
 }
 
 void database::init_genesis_research_content(const genesis_state_type& genesis_state)
 {
-    const vector<genesis_state_type::research_content_type>& research_contents = genesis_state.research_contents;
     auto& expert_tokens_service = obtain_service<dbs_expert_token>();
     auto& research_service = obtain_service<dbs_research>();
     auto& research_content_service = obtain_service<dbs_research_content>();
@@ -494,8 +511,8 @@ void database::init_genesis_research_content(const genesis_state_type& genesis_s
     flat_map<int64_t, std::vector<eci_diff>> disciplines_contributions;
     const time_point_sec timestamp = get_genesis_time();
 
-    for (auto& research_content : research_contents)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::research_contents, "research_contents",
+                            [&](const genesis_state_type::research_content_type& research_content) {
         FC_ASSERT(!research_content.description.empty(), "Research content 'description' is required");
         FC_ASSERT(!research_content.content.empty(), "Research content payload is require");
         FC_ASSERT(research_content.authors.size() > 0, "Research group should contain at least 1 member");
@@ -538,8 +555,8 @@ void database::init_genesis_research_content(const genesis_state_type& genesis_s
             ));
         }
 
-        const auto previous_research_content_eci = research_content_service.get_eci_evaluation(created_research_content.id);
-        const auto previous_research_eci = research_service.get_eci_evaluation(research.id);
+        const auto previous_research_content_eci = created_research_content.eci_per_discipline;
+        const auto previous_research_eci = research.eci_per_discipline;
 
         const research_content_object& updated_research_content = research_content_service.update_eci_evaluation(created_research_content.id);
         const research_object& updated_research = research_service.update_eci_evaluation(research.id);
@@ -589,8 +606,7 @@ void database::init_genesis_research_content(const genesis_state_type& genesis_s
 
             for (const auto& author : updated_research_content.authors)
             {
-                const auto& expert_token_opt = expert_tokens_service.get_expert_token_by_account_and_discipline_if_exists(author, rel.discipline_id._id);
-                const auto& exp = expert_token_opt.valid() ? (*expert_token_opt).get().amount : share_type(0);
+                const auto& exp = expert_tokens_service.get_expertise_amount(author, rel.discipline_id._id);
                 const eci_diff account_eci_diff = eci_diff(
                   exp, 
                   exp,
@@ -620,18 +636,17 @@ void database::init_genesis_research_content(const genesis_state_type& genesis_s
                 disciplines_contributions.insert(std::make_pair(expertise_contribution.discipline_id._id, v));
             }
         }
-    }
+    });
 
     push_virtual_operation(disciplines_eci_history_operation(disciplines_contributions, timestamp));
 }
 
 void database::init_genesis_research_groups(const genesis_state_type& genesis_state)
 {
-    const vector<genesis_state_type::research_group_type>& research_groups = genesis_state.research_groups;
-    for (auto& research_group : research_groups)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::research_groups, "research_groups",
+                            [&](const genesis_state_type::research_group_type& research_group) {
         init_genesis_research_group(research_group);
-    }
+    });
 }
 
 void database::init_genesis_research_group(const genesis_state_type::research_group_type& research_group)
@@ -705,10 +720,8 @@ void database::init_genesis_research_group(const genesis_state_type::research_gr
 
 void database::init_genesis_vesting_balances(const genesis_state_type& genesis_state)
 {
-    const vector<genesis_state_type::vesting_balance_type>& vesting_balances = genesis_state.vesting_balances;
-
-    for (auto& vesting_balance : vesting_balances)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::vesting_balances, "vesting_balances",
+                            [&](const genesis_state_type::vesting_balance_type& vesting_balance) {
 
         FC_ASSERT(vesting_balance.balance > 0, "Deposit balance must be greater than 0");
         FC_ASSERT(vesting_balance.vesting_duration_seconds > 0, "Vesting duration must be longer than 0");
@@ -732,17 +745,16 @@ void database::init_genesis_vesting_balances(const genesis_state_type& genesis_s
             v.period_duration_seconds = vesting_balance.period_duration_seconds;
             v.start_timestamp = get_genesis_time();
         });
-    }
+    });
 }
 
 void database::init_genesis_proposals(const genesis_state_type& genesis_state)
 {
-    const vector<genesis_state_type::proposal_type>& proposals = genesis_state.proposals;
     auto& proposal_service = obtain_service<dbs_proposal>();
     const auto& genesis_time = get_genesis_time();
 
-    for (const auto& p : proposals)
-    {
+    for_each_genesis_record(genesis_state, &genesis_state_type::proposals, "proposals",
+                            [&](const genesis_state_type::proposal_type& p) {
         FC_ASSERT(p.expiration_time > genesis_time, "Proposal ${1} is expired on creation", ("1", p.external_id));
         
         std::stringstream ss;
@@ -793,7 +805,7 @@ void database::init_genesis_proposals(const genesis_state_type& genesis_state)
           p.owner_approvals,
           p.key_approvals
         ));
-    }
+    });
 }
 
 
@@ -0,0 +1,220 @@
+#include <deip/chain/genesis_reader.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <set>
+
+namespace deip {
+namespace chain {
+
+namespace detail {
+
+const char* skip_json_whitespace(const char* begin, const char* end)
+{
+    while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\n' || *begin == '\r'))
+        ++begin;
+    return begin;
+}
+
+namespace {
+
+/// Returns the end of the string starting at the opening quote
+const char* scan_json_string(const char* begin, const char* end)
+{
+    for (const char* p = begin + 1; p != end; ++p)
+    {
+        if (*p == '\\')
+        {
+            if (++p == end)
+                break;
+        }
+        else if (*p == '"')
+        {
+            return p + 1;
+        }
+    }
+    FC_THROW_EXCEPTION(fc::parse_error_exception, "Unterminated string in genesis JSON");
+}
+}
+
+const char* scan_json_value(const char* begin, const char* end)
+{
+    const char* p = skip_json_whitespace(begin, end);
+    FC_ASSERT(p != end, "Unexpected end of genesis JSON");
+
+    if (*p == '"')
+        return scan_json_string(p, end);
+
+    if (*p == '{' || *p == '[')
+    {
+        uint32_t depth = 0;
+        while (p != end)
+        {
+            switch (*p)
+            {
+            case '"':
+                p = scan_json_string(p, end);
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0)
+                    return p + 1;
+                break;
+            default:
+                break;
+            }
+            ++p;
+        }
+        FC_THROW_EXCEPTION(fc::parse_error_exception, "Unterminated object or array in genesis JSON");
+    }
+
+    // number, true, false or null
+    const char* value_begin = p;
+    while (p != end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+        ++p;
+    FC_ASSERT(p != value_begin, "Unexpected character '${c}' in genesis JSON", ("c", std::string(1, *p)));
+    return p;
+}
+
+} // namespace detail
+
+class genesis_reader::mapping
+{
+public:
+    explicit mapping(const fc::path& path)
+        : file(path.generic_string().c_str(), boost::interprocess::read_only)
+        , region(file, boost::interprocess::read_only)
+    {
+        // records are read front to back once
+        region.advise(boost::interprocess::mapped_region::advice_sequential);
+    }
+
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+};
+
+genesis_reader::genesis_reader(const fc::path& path)
+{
+    FC_ASSERT(fc::exists(path), "Genesis file ${p} does not exist", ("p", path));
+    FC_ASSERT(fc::file_size(path) > 0, "Genesis file ${p} is empty", ("p", path));
+
+    _mapping.reset(new mapping(path));
+    _begin = static_cast<const char*>(_mapping->region.get_address());
+    _end = _begin + _mapping->region.get_size();
+
+    index();
+}
+
+genesis_reader::genesis_reader(std::string json)
+    : _json(std::move(json))
+{
+    _begin = _json.data();
+    _end = _begin + _json.size();
+
+    index();
+}
+
+genesis_reader::~genesis_reader()
+{
+}
+
+chain_id_type genesis_reader::chain_id() const
+{
+    return fc::sha256::hash(_begin, uint32_t(_end - _begin));
+}
+
+bool genesis_reader::is_streamed_section(const std::string& section)
+{
+    static const std::set<std::string> streamed_sections = { "accounts",
+                                                             "account_balances",
+                                                             "disciplines",
+                                                             "expert_tokens",
+                                                             "research_groups",
+                                                             "researches",
+                                                             "research_contents",
+                                                             "vesting_balances",
+                                                             "research_contents_reviews",
+                                                             "proposals" };
+
+    return streamed_sections.count(section) != 0;
+}
+
+genesis_state_type genesis_reader::header() const
+{
+    fc::mutable_variant_object header;
+    for (const auto& section : _sections)
+    {
+        if (is_streamed_section(section.first))
+            continue;
+
+        header(section.first, fc::json::from_string(std::string(section.second.first, section.second.second)));
+    }
+
+    genesis_state_type genesis_state = fc::variant(header).as<genesis_state_type>();
+    genesis_state.reader = shared_from_this();
+    return genesis_state;
+}
+
+void genesis_reader::index()
+{
+    const char* p = detail::skip_json_whitespace(_begin, _end);
+    FC_ASSERT(p != _end && *p == '{', "Genesis JSON must be an object");
+    p = detail::skip_json_whitespace(p + 1, _end);
+
+    while (p != _end && *p != '}')
+    {
+        FC_ASSERT(*p == '"', "Expected a key in genesis JSON");
+        const char* key_end = detail::scan_json_value(p, _end);
+        const std::string key = fc::json::from_string(std::string(p, key_end)).as_string();
+
+        p = detail::skip_json_whitespace(key_end, _end);
+        FC_ASSERT(p != _end && *p == ':', "Expected ':' after key ${k} in genesis JSON", ("k", key));
+
+        const char* value_begin = detail::skip_json_whitespace(p + 1, _end);
+        const char* value_end = detail::scan_json_value(value_begin, _end);
+
+        // like fc::json, the last of duplicate keys wins
+        _sections[key] = range_type(value_begin, value_end);
+
+        p = detail::skip_json_whitespace(value_end, _end);
+        if (p != _end && *p == ',')
+            p = detail::skip_json_whitespace(p + 1, _end);
+    }
+
+    FC_ASSERT(p != _end, "Unterminated genesis JSON object");
+}
+
+void genesis_reader::for_each_element(const std::string& section,
+                                      const std::function<void(const char*, const char*)>& f) const
+{
+    auto itr = _sections.find(section);
+    if (itr == _sections.end())
+        return;
+
+    const char* p = itr->second.first;
+    const char* end = itr->second.second;
+    FC_ASSERT(*p == '[', "Genesis section ${s} must be an array", ("s", section));
+
+    p = detail::skip_json_whitespace(p + 1, end);
+    while (p != end && *p != ']')
+    {
+        const char* element_end = detail::scan_json_value(p, end);
+        f(p, element_end);
+
+        p = detail::skip_json_whitespace(element_end, end);
+        if (p != end && *p == ',')
+            p = detail::skip_json_whitespace(p + 1, end);
+    }
+}
+
+} // namespace chain
+} // namespace deip
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deip/chain/schema/deip_object_types.hpp>
+
+#include <fc/reflect/reflect.hpp>
+
+#include <vector>
+
+namespace deip {
+namespace chain {
+
+/**
+ *  A chain object created, modified or removed by a block.
+ *
+ *  `data` holds the packed object (its last value for removed objects). Every chain
+ *  object type has a packer, plugin objects have one when their plugin registers it
+ *  with database::register_changed_object_packer, otherwise `data` is empty and
+ *  observers should re-read the object by id.
+ */
+struct changed_object
+{
+    changed_object()
+    {
+    }
+
+    changed_object(const chainbase::object_change& change)
+        : type_id(change.type_id)
+        , id(change.id)
+        , type(change.type)
+    {
+    }
+
+    uint16_t type_id = 0;
+    int64_t id = 0;
+    chainbase::object_change::change_type type = chainbase::object_change::created;
+    std::vector<char> data;
+};
+
+/**
+ *  All objects touched by a single applied block.
+ *
+ *  A reverted changeset is emitted when the block is popped, on a fork switch for example.
+ *  Its objects are the ones of the block as undo left them: objects the block created are
+ *  removed, objects it removed are created again and modified objects have their previous values.
+ */
+struct block_changeset
+{
+    uint32_t block_num = 0;
+    block_id_type block_id;
+    bool reverted = false;
+    std::vector<changed_object> objects;
+};
+}
+}
+
+FC_REFLECT_ENUM(chainbase::object_change::change_type, (created)(modified)(removed))
+FC_REFLECT(deip::chain::changed_object, (type_id)(id)(type)(data))
+FC_REFLECT(deip::chain::block_changeset, (block_num)(block_id)(reverted)(objects))
@@ -34,6 +34,13 @@ class block_log_impl;
  *
  * The main file is the only file that needs to persist. The index file can be reconstructed during a
  * linear scan of the main file.
+ *
+ * Appended blocks are serialized by append and written by a writer thread, so that block application
+ * does not wait for the disk. The writer takes all queued blocks at once, writes and syncs them to the
+ * main file and only then writes and syncs their positions to the index file: an index entry never
+ * points at a block which is not on disk. Reads of queued blocks wait for the writer. If the process
+ * is killed while the writer is busy, open truncates the torn tail of the main file and the index
+ * is reconciled with it.
  */
 
 class block_log
@@ -46,8 +53,28 @@ public:
     void close();
     bool is_open() const;
 
+    /**
+     * Queues the block to be written and returns its position in the file. Waits while the queue
+     * holds the maximum number of blocks.
+     */
     uint64_t append(const signed_block& b);
+
+    /// Waits until all appended blocks are written and synced to disk
     void flush();
+
+    /// Number of the last block written and synced to disk
+    uint32_t written_block_num() const;
+
+    /// Maximum number of blocks waiting for the writer, takes effect on open
+    void set_max_queue_size(uint32_t max_queue_size);
+
+    /**
+     * For crash recovery tests only: the writer stops after writing the given number of further
+     * bytes to the files, as if the process was killed, possibly in the middle of a block or an
+     * index entry. Blocks which are not written by then are lost and flush throws.
+     */
+    void crash_writer_after(uint64_t bytes);
+
     std::pair<signed_block, uint64_t> read_block(uint64_t file_pos) const;
     optional<signed_block> read_block_by_num(uint32_t block_num) const;
 
@@ -64,6 +91,7 @@ private:
     void construct_index();
 
     std::unique_ptr<detail::block_log_impl> my;
+    uint32_t _max_queue_size = 1024;
 };
 }
 }
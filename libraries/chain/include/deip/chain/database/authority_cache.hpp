@@ -0,0 +1,62 @@
+#pragma once
+
+#include <deip/protocol/authority.hpp>
+
+#include <fc/optional.hpp>
+
+#include <map>
+#include <mutex>
+
+namespace deip {
+namespace chain {
+
+using deip::protocol::account_name_type;
+using deip::protocol::authority;
+
+class database;
+
+/**
+ *  Keeps account authorities resolved from account_authority_object, so that signature
+ *  checks of transactions and proposals touching the same accounts (busy research groups
+ *  and their members in particular) do not look up and convert the shared memory
+ *  authorities again on every recursion step of sign_state.
+ *
+ *  An entry is resolved on first use. Every entry is dropped as soon as any
+ *  account_authority_object is modified or removed, by an operation or by undo (including
+ *  popped blocks and fork switches), and the database drops all of them before each block.
+ *
+ *  The getters match protocol::authority_getter and override_authority_getter. They are
+ *  safe to use from concurrent readers holding the database read lock.
+ */
+class authority_cache
+{
+public:
+    explicit authority_cache(const database& db);
+
+    authority get_active(const account_name_type& account);
+    authority get_owner(const account_name_type& account);
+    fc::optional<authority> get_active_override(const account_name_type& account, uint16_t op_tag);
+
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct resolved_authority
+    {
+        authority active;
+        authority owner;
+        std::map<uint16_t, authority> active_overrides;
+    };
+
+    const resolved_authority& resolve(const account_name_type& account);
+
+    const database& _db;
+
+    std::map<account_name_type, resolved_authority> _entries;
+    uint64_t _mutation_count = 0;
+
+    mutable std::mutex _mutex;
+};
+}
+}
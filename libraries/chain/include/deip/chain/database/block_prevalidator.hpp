@@ -0,0 +1,73 @@
+#pragma once
+
+#include <deip/protocol/block.hpp>
+
+#include <fc/optional.hpp>
+#include <fc/thread/future.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace deip {
+namespace chain {
+
+using deip::protocol::block_id_type;
+using deip::protocol::public_key_type;
+using deip::protocol::signed_block;
+
+class database;
+
+/**
+ *  Verifies the block local parts of sync blocks (witness signature recovery and the
+ *  transaction merkle root) on a pool of worker threads, while earlier blocks are still
+ *  being applied by the chain.
+ *
+ *  Workers do not touch chain state. The recovered signee is matched against the witness
+ *  signing key by get_skip_flags() right before the block is pushed, and only when the
+ *  block extends the current head: otherwise push_block could switch forks and apply
+ *  other blocks with the same skip flags.
+ */
+class block_prevalidator
+{
+public:
+    explicit block_prevalidator(uint32_t num_threads);
+    ~block_prevalidator();
+
+    /**
+     *  Starts verification of the block unless it is already scheduled. Does not block.
+     */
+    void schedule(const signed_block& block);
+
+    /**
+     *  Waits for the verification of the block and returns the validation steps push_block
+     *  may skip for it. Blocks which were not scheduled or failed verification get
+     *  skip_nothing, so that push_block reports the failure itself.
+     *
+     *  Verifications of this and all older blocks are released.
+     */
+    uint32_t get_skip_flags(database& db, const signed_block& block);
+
+    size_t pending_count() const
+    {
+        return _pending.size();
+    }
+
+private:
+    struct verification_result
+    {
+        fc::optional<public_key_type> signee;
+        bool merkle_root_valid = false;
+    };
+
+    static verification_result verify(const signed_block& block);
+
+    std::vector<std::shared_ptr<fc::thread>> _thread_pool;
+    size_t _next_thread = 0;
+
+    // ordered by block id, i.e. by block number first
+    std::map<block_id_type, fc::future<verification_result>> _pending;
+};
+}
+}
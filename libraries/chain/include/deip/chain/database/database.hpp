@@ -7,8 +7,13 @@
 #include <deip/chain/hardfork.hpp>
 #include <deip/chain/schema/node_property_object.hpp>
 #include <deip/chain/database/fork_database.hpp>
+#include <deip/chain/database/authority_cache.hpp>
+#include <deip/chain/database/parallel_transaction_verifier.hpp>
+#include <deip/chain/database/state_checkpointer.hpp>
 #include <deip/chain/block_log.hpp>
 #include <deip/chain/operation_notification.hpp>
+#include <deip/chain/operation_dispatcher.hpp>
+#include <deip/chain/block_changeset.hpp>
 
 #include <deip/protocol/protocol.hpp>
 
@@ -168,6 +173,14 @@ public:
     const witness_schedule_object& get_witness_schedule_object() const override;
     const hardfork_property_object& get_hardfork_property_object() const;
 
+    /**
+     *  Resolved account authorities for signature checks, see authority_cache
+     */
+    authority_cache& get_authority_cache() const override
+    {
+        return _authority_cache;
+    }
+
     /**
      *  Deducts fee from the account and the share supply
      */
@@ -216,7 +229,14 @@ public:
     void notify_pre_apply_operation(operation_notification& note);
     void notify_post_apply_operation(const operation_notification& note);
 
+    /**
+     *  @return true if any plugin observes operations with the given tag, either through the broadcast
+     *  signals or through the per-tag dispatchers.
+     */
+    bool is_operation_observed(int op_tag) const override;
+
     // vops are not needed for low mem. Force will push them on low mem.
+    // vops which are not observed by any plugin are dropped.
     void push_virtual_operation(const operation& op) override;
     void push_hf_operation(const operation& op);
 
@@ -231,6 +251,14 @@ public:
     fc::signal<void(const operation_notification&)> pre_apply_operation;
     fc::signal<void(const operation_notification&)> post_apply_operation;
 
+    /**
+     *  Same as pre_apply_operation/post_apply_operation, but handlers are keyed by operation tag
+     *  and invoked only for the operations they subscribed to. Plugins which handle a fixed set
+     *  of operations should prefer these over the broadcast signals.
+     */
+    operation_dispatcher pre_apply_operation_dispatcher;
+    operation_dispatcher post_apply_operation_dispatcher;
+
     /**
      *  This signal is emitted after all operations and virtual operation for a
      *  block have been applied but before the get_applied_operations() are cleared.
@@ -260,15 +288,12 @@ public:
     fc::signal<void(const signed_transaction&)> on_applied_transaction;
 
     /**
-     *  Emitted After a block has been applied and committed.  The callback
-     *  should not yield and should execute quickly.
-     */
-    // fc::signal<void(const vector< graphene::db2::generic_id >&)> changed_objects;
-
-    /** this signal is emitted any time an object is removed and contains a
-     * pointer to the last value of every object that was removed.
+     *  Emitted after a block has been applied with every object the block created,
+     *  modified or removed, and after a block has been popped with the same objects as
+     *  undo restored them (see block_changeset::reverted). Nothing is emitted while undo
+     *  is disabled (i.e. on reindex). The callback should not yield and should execute quickly.
      */
-    // fc::signal<void(const vector<const object*>&)>  removed_objects;
+    fc::signal<void(const block_changeset&)> changed_objects;
 
     //////////////////// db_witness_schedule.cpp ////////////////////
 
@@ -363,9 +388,34 @@ public:
      * @}
      */
 
+    /// Checkpoints the shared memory state about every flush_blocks blocks, so that a killed node resumes
+    /// without a reindex. A node whose host crashed is reindexed, see state_checkpointer
     void set_flush_interval(uint32_t flush_blocks);
+
+    state_checkpointer& get_state_checkpointer()
+    {
+        return _state_checkpointer;
+    }
+
+    /// Maximum number of irreversible blocks waiting to be written to the block log
+    void set_block_log_queue_size(uint32_t max_queue_size);
+
     void show_free_memory(bool force);
 
+    /// Updates the chain metrics which are sampled after each applied block
+    void report_metrics();
+
+    /**
+     *  Verifies the transactions of each applied block on the given number of threads ahead
+     *  of their application, see parallel_transaction_verifier. 0 verifies them serially.
+     */
+    void set_transaction_verification_threads(uint32_t num_threads);
+
+    const parallel_transaction_verifier* get_transaction_verifier() const
+    {
+        return _transaction_verifier.get();
+    }
+
     // witness_schedule
 
     void update_witness_schedule();
@@ -377,7 +427,36 @@ public:
         _plugin_index_signal.connect([this]() { this->add_index<MultiIndexType>(); });
     }
 
+    /**
+     *  Makes changed_objects carry packed values of ObjectType. The type has to be
+     *  fc::raw serializable. Chain objects are registered by initialize_indexes,
+     *  plugins call it for the objects of their own indexes.
+     */
+    template <typename ObjectType> void register_changed_object_packer()
+    {
+        typedef typename chainbase::get_index_type<ObjectType>::type index_type;
+
+        if (_changed_object_packers.size() <= ObjectType::type_id)
+            _changed_object_packers.resize(ObjectType::type_id + 1);
+
+        _changed_object_packers[ObjectType::type_id] = [this](const changed_object& change, std::vector<char>& data) {
+            const typename ObjectType::id_type id(change.id);
+            const ObjectType* obj = change.type == chainbase::object_change::removed
+                ? get_index<index_type>().find_head_removed(id)
+                : find<ObjectType>(id);
+
+            if (obj != nullptr)
+                data = fc::raw::pack(*obj);
+        };
+    }
+
 private:
+    template <typename MultiIndexType> void add_core_index()
+    {
+        add_index<MultiIndexType>();
+        register_changed_object_packer<typename MultiIndexType::value_type>();
+    }
+
     void _reset_virtual_schedule_time();
 
     void _update_median_witness_props();
@@ -389,6 +468,7 @@ protected:
     // Mark pop_undo() as protected -- we do not want outside calling pop_undo(); it should call pop_block() instead
     // void pop_undo() { object_database::pop_undo(); }
     void notify_changed_objects();
+    void pack_changed_object(changed_object& obj) const;
 
     void set_producing(bool p)
     {
@@ -396,10 +476,15 @@ protected:
     }
 
     void apply_block(const signed_block& next_block, uint32_t skip = skip_nothing);
+    /// Applies the blocks of the block log from first_block_num on, as on reindex
+    void replay_block_log(uint32_t first_block_num);
+    /// Checkpoint of the last committed block, if the block is in the block log already
+    fc::optional<state_checkpoint> get_committed_checkpoint() const;
     void apply_transaction(const signed_transaction& trx, uint32_t skip = skip_nothing);
     void _apply_block(const signed_block& next_block);
     void _apply_transaction(const signed_transaction& trx);
     void apply_operation(const operation& op);
+    void settle_license_revenue(const operation& op);
 
     /// Steps involved in applying a new block
     ///@{
@@ -410,6 +495,7 @@ protected:
     void update_global_dynamic_data(const signed_block& b);
     void update_signing_witness(const witness_object& signing_witness, const signed_block& new_block);
     void update_last_irreversible_block();
+    void commit_irreversible(uint32_t block_num);
     void clear_expired_transactions();
     void process_content_activity_windows();
     void process_header_extensions(const signed_block& next_block);
@@ -445,13 +531,20 @@ private:
 
     vector<signed_transaction> _pending_tx;
     fork_database _fork_db;
+    mutable authority_cache _authority_cache;
+    std::unique_ptr<parallel_transaction_verifier> _transaction_verifier;
     fc::time_point_sec _hardfork_times[DEIP_NUM_HARDFORKS + 1];
     protocol::hardfork_version _hardfork_versions[DEIP_NUM_HARDFORKS + 1];
 
     block_log _block_log;
+    state_checkpointer _state_checkpointer;
+    /// the state can be rewound to this block but not before
+    uint32_t _committed_block_num = 0;
 
     fc::signal<void()> _plugin_index_signal;
 
+    std::vector<std::function<void(const changed_object&, std::vector<char>&)>> _changed_object_packers;
+
     // TODO: move these to trx_context
     transaction_id_type _current_trx_id;
     uint16_t _current_trx_ref_block_num;
@@ -474,6 +567,7 @@ private:
     uint32_t _next_flush_block = 0;
 
     uint32_t _last_free_gb_printed = 0;
+    chainbase::lock_stats _reported_lock_stats;
     fc::time_point_sec _const_genesis_time; // should be const
 };
 } // namespace chain
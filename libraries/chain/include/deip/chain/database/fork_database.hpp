@@ -104,6 +104,12 @@ public:
 
     void set_max_size(uint32_t s);
 
+    /// number of blocks linked to the head's branches
+    size_t size() const
+    {
+        return _index.size();
+    }
+
 private:
     /** @return a pointer to the newly pushed item */
     void _push_block(const item_ptr& b);
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <deip/protocol/block.hpp>
+
+#include <fc/optional.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace deip {
+namespace chain {
+
+using deip::protocol::account_name_type;
+using deip::protocol::authority;
+using deip::protocol::chain_id_type;
+using deip::protocol::digest_type;
+using deip::protocol::signed_block;
+using deip::protocol::signed_transaction;
+
+class database;
+
+/**
+ *  Verifies the transactions of a block on a pool of worker threads before the block is
+ *  applied: transaction validation, signature recovery and the authority checks, which are
+ *  most of the cost of applying a typical transaction.
+ *
+ *  Every transaction is verified optimistically against the state before the block, and the
+ *  authorities read by its checks are recorded as its read set. When the transaction is
+ *  applied, the optimistic result is used only if every authority of the read set still
+ *  resolves to the same value, i.e. if no earlier transaction of the block wrote to it.
+ *  Otherwise, and whenever the optimistic check failed, the transaction is verified again by
+ *  _apply_transaction in block order, as without the verifier. Both checks are functions of
+ *  the transaction and the authorities they read, so the result is the one of serial
+ *  verification either way.
+ *
+ *  Operations are still evaluated serially: chainbase has a single writer and object ids
+ *  are assigned in order of creation.
+ *
+ *  The workers are plain threads and verify() blocks on a condition variable rather than an
+ *  fc::future, so the fc task holding the write lock does not yield while it waits.
+ */
+class parallel_transaction_verifier
+{
+public:
+    struct counters
+    {
+        /// authority checks taken from the optimistic result
+        uint64_t verified = 0;
+        /// authority checks done again since an earlier transaction changed their read set
+        uint64_t conflicts = 0;
+        /// authority checks done again since the optimistic check failed
+        uint64_t failed = 0;
+    };
+
+    /// steps of _apply_transaction already done for a transaction
+    struct verified_transaction
+    {
+        bool validated = false;
+        bool authorized = false;
+    };
+
+    explicit parallel_transaction_verifier(uint32_t num_threads);
+    ~parallel_transaction_verifier();
+
+    /**
+     *  Verifies the transactions of the block against the current state and waits for all of
+     *  them. Must be called with the write lock held, before any transaction of the block is
+     *  applied; the workers only read the state.
+     *
+     *  Steps the skip flags exclude are not done. Results of the previous block are released.
+     */
+    void verify(database& db, const signed_block& block, uint32_t skip);
+
+    /**
+     *  Steps the transaction may skip. Authorization is granted only if the read set of the
+     *  transaction is unchanged in the current state.
+     */
+    verified_transaction get_result(database& db, const signed_transaction& trx);
+
+    void clear();
+
+    counters get_counters() const;
+
+    uint32_t num_threads() const
+    {
+        return _threads.size();
+    }
+
+private:
+    struct read_set
+    {
+        std::map<account_name_type, authority> active;
+        std::map<account_name_type, authority> owner;
+        std::map<std::pair<account_name_type, uint16_t>, fc::optional<authority>> active_overrides;
+    };
+
+    struct result
+    {
+        bool validated = false;
+        bool authorized = false;
+        read_set reads;
+    };
+
+    static result verify_transaction(database& db,
+                                     const chain_id_type& chain_id,
+                                     const signed_transaction& trx,
+                                     uint32_t skip);
+
+    static bool is_unchanged(database& db, const read_set& reads);
+
+    void run_worker();
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _jobs_mutex;
+    std::condition_variable _jobs_added;
+    std::condition_variable _jobs_done;
+    std::deque<std::function<void()>> _jobs;
+    size_t _pending_jobs = 0;
+    bool _quit = false;
+
+    // by signed transaction digest, so that only the very same transaction gets the result
+    std::map<digest_type, result> _results;
+
+    // account_authority_index mutation count the results were verified at
+    uint64_t _mutation_count = 0;
+
+    counters _counters;
+    mutable std::mutex _counters_mutex;
+};
+}
+}
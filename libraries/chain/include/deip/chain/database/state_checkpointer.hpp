@@ -0,0 +1,104 @@
+#pragma once
+
+#include <deip/protocol/types.hpp>
+
+#include <chainbase/chainbase.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/optional.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <memory>
+
+namespace deip {
+namespace chain {
+
+namespace detail {
+class state_checkpointer_impl;
+}
+
+/// Block the chain state can at least be rewound to, as recorded by a checkpoint
+struct state_checkpoint
+{
+    uint32_t block_num = 0;
+    protocol::block_id_type block_id;
+
+    /// Boot of the host the checkpoint was taken in
+    fc::sha256 boot_id;
+
+    /// The state was closed when it was synced, so nothing was written to it meanwhile
+    bool closed = false;
+};
+
+/**
+ *  Checkpoints of the shared memory state which do not hold up block application. They let a
+ *  node whose process was killed resume without a reindex, they do not survive a crash of the
+ *  host.
+ *
+ *  A checkpoint syncs the mapped files to disk with msync on a checkpoint thread while blocks keep
+ *  being applied, then records in a small journal next to the state the block whose undo state was
+ *  the last one committed when the checkpoint started. Undo states are kept in the state itself
+ *  and are only ever committed forwards, so a state which has been synced can always be rewound
+ *  at least to the journal's block. The journal is replaced with a rename and holds one complete
+ *  checkpoint at any time.
+ *
+ *  A killed process leaves the mapped state in the page cache as it was, unless it was killed in
+ *  the middle of a change, which chainbase reports as an interrupted write. Such a state has to be
+ *  replayed from the block log. Any other state is rewound to its last committed block, which has
+ *  to be consistent with the journal, and only the blocks of the block log after it are replayed.
+ *
+ *  The files on disk hold a consistent state only if nothing was written while they were synced,
+ *  which is the case for the checkpoint taken when the state is closed. Other checkpoints may
+ *  sync pages of different blocks, so after an OS crash or a power loss the files may hold a torn
+ *  state. Opening the state marks the journal as open until the state is closed again, and a state
+ *  which was open when its host restarted is reported as possibly torn; it has to be replayed
+ *  from the block log as well. Hosts without a boot id cannot tell a restart.
+ */
+class state_checkpointer
+{
+public:
+    state_checkpointer();
+    ~state_checkpointer();
+
+    /// Marks the journal as open, unless the state may be torn
+    void open(chainbase::database& state, const fc::path& journal_file);
+
+    /// Waits for the checkpoint in progress
+    void close();
+    bool is_open() const;
+
+    /// Last checkpoint recorded in the journal
+    fc::optional<state_checkpoint> last() const;
+
+    /// Whether the host restarted while the state was open, so that the files may hold a torn state
+    bool state_may_be_torn() const;
+
+    /// Starts a checkpoint unless one is in progress, returns whether it was started
+    bool start(const state_checkpoint& checkpoint);
+
+    /// Waits for the checkpoint in progress, throws if it failed
+    void wait();
+
+    /// Takes a checkpoint on the calling thread once the one in progress is done, throws if it fails
+    void take(const state_checkpoint& checkpoint);
+
+    /**
+     *  For crash recovery tests only: the next checkpoint stops after syncing the state and
+     *  writing the new journal, before it replaces the previous one, as if the process was
+     *  killed in between. The checkpoint fails.
+     */
+    void crash_before_journal_replaced();
+
+    static fc::optional<state_checkpoint> read_journal(const fc::path& journal_file);
+
+    /// Identifies the current boot of the host, empty if the host does not tell
+    static fc::sha256 current_boot_id();
+
+private:
+    std::unique_ptr<detail::state_checkpointer_impl> my;
+};
+}
+}
+
+FC_REFLECT(deip::chain::state_checkpoint, (block_num)(block_id)(boot_id)(closed))
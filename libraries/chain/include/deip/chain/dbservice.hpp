@@ -13,6 +13,8 @@ class database; // for _temporary_public_imp only
 namespace deip {
 namespace chain {
 
+class authority_cache;
+
 class dbservice : public dbservice_dbs_factory
 {
     typedef dbservice_dbs_factory _base_type;
@@ -50,10 +52,19 @@ public:
 
     virtual fc::time_point_sec get_genesis_time() const = 0;
     
+    virtual bool is_operation_observed(int op_tag) const = 0;
+
+    template <typename VirtualOperation> bool is_virtual_operation_observed() const
+    {
+        return is_operation_observed(protocol::operation::tag<VirtualOperation>::value);
+    }
+
     virtual void push_virtual_operation(const protocol::operation& op) = 0;
 
     virtual void push_proposal(const proposal_object& proposal) = 0;
 
+    virtual authority_cache& get_authority_cache() const = 0;
+
     // for TODO only:
     chainbase::database& _temporary_public_impl();
 };
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <deip/chain/genesis_state.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/json.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace deip {
+namespace chain {
+
+/**
+ *  Reads a genesis JSON document one record at a time, so that importing a large genesis state
+ *  does not need the whole document parsed into memory.
+ *
+ *  The document is mapped, not read, and indexed once by its top level keys. The record arrays
+ *  (see is_streamed_section) are left out of header() and parsed element by element by
+ *  for_each, everything else is small and parsed by header().
+ *
+ *  Must be owned by a shared_ptr, the genesis state returned by header() keeps a reference.
+ */
+class genesis_reader : public std::enable_shared_from_this<genesis_reader>
+{
+public:
+    /// Maps the genesis JSON file
+    explicit genesis_reader(const fc::path& path);
+
+    /// Reads a genesis JSON document held in memory, like the embedded genesis
+    explicit genesis_reader(std::string json);
+
+    ~genesis_reader();
+
+    /// Hash of the document, the same chain id as computed from the whole genesis JSON text
+    chain_id_type chain_id() const;
+
+    /**
+     *  Genesis state without the streamed record arrays, which are read by for_each. The result
+     *  refers back to this reader.
+     */
+    genesis_state_type header() const;
+
+    template <typename T> void for_each(const std::string& section, const std::function<void(const T&)>& f) const
+    {
+        for_each_element(section, [&](const char* begin, const char* end) {
+            f(fc::json::from_string(std::string(begin, end)).as<T>());
+        });
+    }
+
+    static bool is_streamed_section(const std::string& section);
+
+private:
+    typedef std::pair<const char*, const char*> range_type;
+
+    void index();
+    void for_each_element(const std::string& section, const std::function<void(const char*, const char*)>& f) const;
+
+    class mapping;
+    std::unique_ptr<mapping> _mapping;
+    std::string _json;
+
+    const char* _begin = nullptr;
+    const char* _end = nullptr;
+
+    /// top level keys and the text of their values
+    std::map<std::string, range_type> _sections;
+};
+
+namespace detail {
+
+/// Returns the end of the JSON value starting at begin, after skipping leading whitespace
+const char* scan_json_value(const char* begin, const char* end);
+
+const char* skip_json_whitespace(const char* begin, const char* end);
+
+} // namespace detail
+} // namespace chain
+} // namespace deip
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -12,6 +13,8 @@
 namespace deip {
 namespace chain {
 
+class genesis_reader;
+
 struct genesis_state_type
 {
     struct registrar_account_type
@@ -157,6 +160,9 @@ struct genesis_state_type
     std::vector<proposal_type> proposals;
 
     chain_id_type initial_chain_id;
+
+    /// when set, the record arrays above are empty and database::init_genesis reads them from here one by one
+    std::shared_ptr<const genesis_reader> reader;
 };
 
 namespace utils {
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deip/chain/operation_notification.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace deip {
+namespace chain {
+
+/**
+ *  Routes operation notifications to the handlers registered for the operation tag.
+ *
+ *  Unlike the broadcast pre_apply_operation/post_apply_operation signals, a handler
+ *  subscribed here is invoked only for the operation types it has asked for, so
+ *  observers of a few operations do not pay for visiting every applied operation.
+ */
+class operation_dispatcher
+{
+public:
+    typedef std::function<void(const operation_notification&)> handler_type;
+
+    operation_dispatcher()
+        : _handlers(operation::count())
+    {
+    }
+
+    template <typename... Operations> void subscribe(const handler_type& handler)
+    {
+        const int tags[] = { operation::tag<Operations>::value... };
+        for (const int tag : tags)
+            subscribe(tag, handler);
+    }
+
+    void subscribe(int tag, const handler_type& handler)
+    {
+        FC_ASSERT(tag >= 0 && size_t(tag) < _handlers.size(), "Unknown operation tag ${t}", ("t", tag));
+        _handlers[tag].push_back(handler);
+    }
+
+    bool has_subscribers(int tag) const
+    {
+        return !_handlers[tag].empty();
+    }
+
+    void operator()(const operation_notification& note) const
+    {
+        for (const auto& handler : _handlers[note.op.which()])
+            handler(note);
+    }
+
+private:
+    std::vector<std::vector<handler_type>> _handlers;
+};
+}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "deip_object_types.hpp"
 #include <boost/multi_index/composite_key.hpp>
+#include <fc/uint128.hpp>
 
 namespace deip {
 namespace chain {
@@ -9,6 +10,9 @@ using fc::shared_string;
 using deip::protocol::asset;
 using deip::protocol::external_id_type;
 
+typedef allocator<std::pair<const asset_symbol_type, fc::uint128>> revenue_per_unit_allocator_type;
+typedef chainbase::bip::map<asset_symbol_type, fc::uint128, std::less<asset_symbol_type>, revenue_per_unit_allocator_type> revenue_per_unit_map;
+
 class account_balance_object : public object<account_balance_object_type, account_balance_object>
 {
     account_balance_object() = delete;
@@ -17,6 +21,8 @@ public:
     template <typename Constructor, typename Allocator>
     account_balance_object(Constructor&& c, allocator<Allocator> a)
         : string_symbol(a)
+        , settled_revenue_per_unit(a)
+        , settled_revenue_remainder(a)
     {
         c(*this);
     }
@@ -33,6 +39,14 @@ public:
 
     optional<external_id_type> tokenized_research;
 
+    /// security token balances only: license_revenue_accumulator::revenue_per_unit by revenue asset
+    /// at the last settlement of this balance
+    revenue_per_unit_map settled_revenue_per_unit;
+
+    /// security token balances only: revenue below one unit left over by the settlements of this balance,
+    /// scaled by DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION, by revenue asset
+    revenue_per_unit_map settled_revenue_remainder;
+
     const asset to_asset() const 
     {
         return asset(amount, symbol);
@@ -93,5 +107,5 @@ typedef multi_index_container<account_balance_object,
     }
 }
 
-FC_REFLECT(deip::chain::account_balance_object, (id)(asset_id)(symbol)(string_symbol)(owner)(amount)(frozen_amount)(tokenized_research))
+FC_REFLECT(deip::chain::account_balance_object, (id)(asset_id)(symbol)(string_symbol)(owner)(amount)(frozen_amount)(tokenized_research)(settled_revenue_per_unit)(settled_revenue_remainder))
 CHAINBASE_SET_INDEX_TYPE( deip::chain::account_balance_object, deip::chain::account_balance_index )
\ No newline at end of file
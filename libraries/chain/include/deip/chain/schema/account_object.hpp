@@ -49,6 +49,8 @@ public:
     bool can_vote = true;
 
     bool is_research_group;
+    bool has_default_expertise = false; ///< holds DEIP_DEFAULT_EXPERTISE_AMOUNT in every discipline without an expert token, see dbs_expert_token
+    expert_token_id_type default_expert_tokens_id; ///< first of the expert token ids reserved for the default expertise, one per discipline in discipline order
 
     share_type expertise_tokens_balance = 0; ///< total expertise tokens held by this account
     share_type common_tokens_balance = 0; ///< total common tokens held by this account
@@ -171,6 +173,7 @@ struct by_deip_balance;
 struct by_ct_balance;
 struct by_vote_count;
 struct by_research_group;
+struct by_default_expertise;
 
 /**
  * @ingroup object_index
@@ -250,6 +253,26 @@ typedef multi_index_container<account_object,
           std::less<account_id_type>
         >
     >,
+    ordered_unique<
+      tag<by_default_expertise>,
+        composite_key<account_object,
+          member<
+            account_object,
+            bool,
+            &account_object::has_default_expertise
+          >,
+          member<
+            account_object,
+            expert_token_id_type,
+            &account_object::default_expert_tokens_id
+          >,
+          member<
+            account_object,
+            account_id_type,
+            &account_object::id
+          >
+        >
+    >,
     ordered_unique<
       tag<by_vote_count>,
         composite_key<account_object,
@@ -408,7 +431,7 @@ FC_REFLECT( deip::chain::account_object,
              (id)(name)(memo_key)(json_metadata)(proxy)(last_account_update)
              (created)(mined)
              (recovery_account)(last_account_recovery)
-             (lifetime_vote_count)(can_vote)(is_research_group)
+             (lifetime_vote_count)(can_vote)(is_research_group)(has_default_expertise)(default_expert_tokens_id)
              (common_tokens_withdraw_rate)(next_common_tokens_withdrawal)
              (withdrawn)(to_withdraw)(withdraw_routes)
              (expertise_tokens_balance)
@@ -3,6 +3,7 @@
 #include <boost/multi_index/composite_key.hpp>
 #include <deip/protocol/protocol.hpp>
 #include <fc/shared_string.hpp>
+#include <fc/uint128.hpp>
 
 namespace deip {
 namespace chain {
@@ -19,6 +20,20 @@ enum class asset_type : uint8_t
     research_security_token = 2
 };
 
+/**
+ *  License revenue of a security token in one revenue asset, distributed lazily: holders
+ *  are owed (holding * (revenue_per_unit - revenue_per_unit at their last settlement)) /
+ *  DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION and receive it when their balance is settled.
+ */
+struct license_revenue_accumulator
+{
+    fc::uint128 revenue_per_unit; ///< cumulative, scaled by DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION
+    share_type undistributed = 0; ///< revenue not paid to holders yet
+};
+
+typedef allocator<std::pair<const asset_symbol_type, license_revenue_accumulator>> license_revenue_accumulator_allocator_type;
+typedef chainbase::bip::map<asset_symbol_type, license_revenue_accumulator, std::less<asset_symbol_type>, license_revenue_accumulator_allocator_type> license_revenue_accumulator_map;
+
 class asset_object : public object<asset_object_type, asset_object>
 {
     asset_object() = delete;
@@ -26,7 +41,7 @@ class asset_object : public object<asset_object_type, asset_object>
 public:
 
     template <typename Constructor, typename Allocator>
-    asset_object(Constructor&& c, allocator<Allocator> a) : string_symbol(a), description(a)
+    asset_object(Constructor&& c, allocator<Allocator> a) : string_symbol(a), description(a), license_revenue(a)
     {
         c(*this);
     }
@@ -48,6 +63,8 @@ public:
     share_type max_supply = DEIP_MAX_SHARE_SUPPLY;
     share_type current_supply = 0;
     bool is_default = false;
+
+    license_revenue_accumulator_map license_revenue; ///< by revenue asset, for research security tokens only
 };
 
 struct by_symbol;
@@ -91,7 +108,8 @@ typedef multi_index_container<asset_object,
 }
 }
 
-FC_REFLECT( deip::chain::asset_object, (id)(symbol)(string_symbol)(precision)(issuer)(description)(type)(tokenized_research)(license_revenue_holders_share)(max_supply)(current_supply)(is_default))
+FC_REFLECT( deip::chain::license_revenue_accumulator, (revenue_per_unit)(undistributed))
+FC_REFLECT( deip::chain::asset_object, (id)(symbol)(string_symbol)(precision)(issuer)(description)(type)(tokenized_research)(license_revenue_holders_share)(max_supply)(current_supply)(is_default)(license_revenue))
 CHAINBASE_SET_INDEX_TYPE( deip::chain::asset_object, deip::chain::asset_index )
 
 FC_REFLECT_ENUM(deip::chain::asset_type,
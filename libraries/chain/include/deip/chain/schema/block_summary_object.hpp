@@ -29,13 +29,8 @@ public:
     block_id_type block_id;
 };
 
-typedef multi_index_container<block_summary_object,
-                              indexed_by<ordered_unique<tag<by_id>,
-                                                        member<block_summary_object,
-                                                               block_summary_object::id_type,
-                                                               &block_summary_object::id>>>,
-                              allocator<block_summary_object>>
-    block_summary_index;
+/// one slot per ref_block_num, addressed by block_num & 0xffff
+typedef chainbase::ring_container<block_summary_object, 0x10000> block_summary_index;
 }
 } // deip::chain
 
@@ -49,10 +49,11 @@ typedef multi_index_container<contract_agreement_object,
                                                         member<contract_agreement_object,
                                                                 contract_agreement_id_type,
                                                                &contract_agreement_object::id>>,
-                                         ordered_unique<tag<by_external_id>,
+                                         hashed_unique<tag<by_external_id>,
                                                         member<contract_agreement_object,
                                                                external_id_type,
-                                                               &contract_agreement_object::external_id>>,
+                                                               &contract_agreement_object::external_id>,
+                                                        chainbase::fixed_width_hash<external_id_type>>,
                                          ordered_non_unique<tag<by_creator>,
                                                         member<contract_agreement_object,
                                                                 account_name_type,
@@ -7,6 +7,8 @@
 
 #include <fc/shared_string.hpp>
 #include <chainbase/chainbase.hpp>
+#include <chainbase/hashed_index.hpp>
+#include <chainbase/ring_index.hpp>
 
 #include <deip/protocol/types.hpp>
 #include <deip/protocol/authority.hpp>
@@ -84,7 +86,8 @@ enum object_type
     assessment_stage_object_type,
     assessment_stage_phase_object_type,
     research_license_object_type,
-    contract_agreement_object_type
+    contract_agreement_object_type,
+    research_token_sale_settlement_object_type
 };
 
 class dynamic_global_property_object;
@@ -115,6 +118,7 @@ class research_content_object;
 class expert_token_object;
 class research_token_sale_object;
 class research_token_sale_contribution_object;
+class research_token_sale_settlement_object;
 class review_object;
 class review_vote_object;
 class vesting_balance_object;
@@ -165,6 +169,7 @@ typedef oid<research_content_object> research_content_id_type;
 typedef oid<expert_token_object> expert_token_id_type;
 typedef oid<research_token_sale_object> research_token_sale_id_type;
 typedef oid<research_token_sale_contribution_object> research_token_sale_contribution_id_type;
+typedef oid<research_token_sale_settlement_object> research_token_sale_settlement_id_type;
 typedef oid<review_object> review_id_type;
 typedef oid<review_vote_object> review_vote_id_type;
 typedef oid<vesting_balance_object> vesting_balance_id_type;
@@ -260,6 +265,7 @@ FC_REFLECT_ENUM( deip::chain::object_type,
                  (assessment_stage_phase_object_type)
                  (research_license_object_type)
                  (contract_agreement_object_type)
+                 (research_token_sale_settlement_object_type)
 )
 
 
@@ -35,6 +35,10 @@ public:
     external_id_type parent_external_id;
     fc::shared_string name;
 
+    // maintained by dbs_expertise_contribution to weight discipline supply payouts
+    share_type contributions_eci = 0;
+    share_type final_results_eci = 0;
+
     const bool is_common() const {
         return id == discipline_id_type(0);
     }
@@ -62,10 +66,11 @@ typedef multi_index_container<discipline_object,
                            fc::shared_string,
                            &discipline_object::name>>,
 
-            ordered_unique<tag<by_external_id>,
+            hashed_unique<tag<by_external_id>,
                     member<discipline_object,
                            external_id_type,
-                           &discipline_object::external_id>>,
+                           &discipline_object::external_id>,
+                    chainbase::fixed_width_hash<external_id_type>>,
 
             ordered_non_unique<tag<by_parent_external_id>,
                     member<discipline_object,
@@ -83,6 +88,8 @@ FC_REFLECT( deip::chain::discipline_object,
   (external_id)
   (parent_external_id)
   (name)
+  (contributions_eci)
+  (final_results_eci)
 )
 
 CHAINBASE_SET_INDEX_TYPE( deip::chain::discipline_object, deip::chain::discipline_index )
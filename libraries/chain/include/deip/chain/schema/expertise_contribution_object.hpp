@@ -61,6 +61,8 @@ public:
     research_content_id_type research_content_id;
     discipline_id_type discipline_id;
     share_type eci;
+    bool is_final_result = false;
+    bool is_supply_recipient = false;
     bool has_eci_current_block_diffs;
     share_type eci_current_block_delta;
     eci_diff_type_vector eci_current_block_diffs;
@@ -70,6 +72,7 @@ public:
 struct by_discipline_id;
 struct by_research_id;
 struct by_research_content_id;
+struct by_discipline_supply_recipient;
 struct by_research_and_discipline;
 struct by_research_content_and_discipline;
 struct by_eci_current_block_delta;
@@ -152,6 +155,20 @@ typedef multi_index_container<expertise_contribution_object,
           research_content_id_type,
           &expertise_contribution_object::research_content_id
         >
+      >,
+    ordered_non_unique<
+      tag<by_discipline_supply_recipient>,
+        composite_key<expertise_contribution_object,
+          member<
+            expertise_contribution_object,
+            discipline_id_type,
+            &expertise_contribution_object::discipline_id>,
+          member<
+            expertise_contribution_object,
+            bool,
+            &expertise_contribution_object::is_supply_recipient
+          >
+        >
       >
     >,
     allocator<expertise_contribution_object>>
@@ -180,6 +197,8 @@ FC_REFLECT( deip::chain::expertise_contribution_object,
   (research_content_id)
   (discipline_id)
   (eci)
+  (is_final_result)
+  (is_supply_recipient)
   (has_eci_current_block_diffs)
   (eci_current_block_delta)
   (eci_current_block_diffs)
@@ -45,10 +45,11 @@ typedef multi_index_container<nda_contract_object,
                                                         member<nda_contract_object,
                                                                 nda_contract_id_type,
                                                                &nda_contract_object::id>>,
-                                         ordered_unique<tag<by_external_id>,
+                                         hashed_unique<tag<by_external_id>,
                                                         member<nda_contract_object,
                                                                external_id_type,
-                                                               &nda_contract_object::external_id>>,
+                                                               &nda_contract_object::external_id>,
+                                                        chainbase::fixed_width_hash<external_id_type>>,
                                          ordered_non_unique<tag<by_creator>,
                                                         member<nda_contract_object,
                                                                 account_name_type,
@@ -14,6 +14,8 @@ namespace chain {
 using fc::shared_string;
 using fc::time_point_sec;
 
+class authority_cache;
+
 enum class proposal_status : uint8_t
 {
     pending = 1,
@@ -51,9 +53,9 @@ public:
 
       time_point_sec                  created_at;
       
-      bool is_authorized_to_execute(chainbase::database& db) const;
+      bool is_authorized_to_execute(authority_cache& authorities) const;
 
-      bool is_authorized_to_execute(chainbase::database& db,
+      bool is_authorized_to_execute(authority_cache& authorities,
                                     const flat_set<account_name_type>& active_approvals_checklist,
                                     const flat_set<account_name_type>& owner_approvals_checklist) const;
 };
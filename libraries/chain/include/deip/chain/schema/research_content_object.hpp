@@ -113,13 +113,14 @@ typedef multi_index_container<research_content_object,
         >
     >,
 
-    ordered_unique<
+    hashed_unique<
       tag<by_external_id>,
         member<
           research_content_object,
           external_id_type,
           &research_content_object::external_id
-        >
+        >,
+        chainbase::fixed_width_hash<external_id_type>
     >,
 
     ordered_non_unique<
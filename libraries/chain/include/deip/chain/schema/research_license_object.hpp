@@ -77,13 +77,14 @@ typedef multi_index_container<research_license_object,
         >
     >,
 
-    ordered_unique<
+    hashed_unique<
       tag<by_external_id>,
         member<
           research_license_object,
           external_id_type,
           &research_license_object::external_id
-        >
+        >,
+        chainbase::fixed_width_hash<external_id_type>
     >,
 
     ordered_non_unique<
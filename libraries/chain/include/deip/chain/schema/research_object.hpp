@@ -72,10 +72,11 @@ typedef multi_index_container<
                 research_id_type, 
                 &research_object::id>>,
 
-        ordered_unique<tag<by_external_id>, 
+        hashed_unique<tag<by_external_id>, 
             member<research_object,
                 external_id_type, 
-                &research_object::external_id>>,
+                &research_object::external_id>, 
+            chainbase::fixed_width_hash<external_id_type>>,
 
         ordered_non_unique<tag<is_finished>, 
             member<research_object, 
@@ -71,11 +71,34 @@ public:
     fc::time_point_sec contribution_time;
 };
 
+/**
+ *  Queue entry of an ended sale whose contributions are still to be settled. Sales are settled in
+ *  the order they ended, at most DEIP_MAX_TOKEN_SALE_SETTLEMENTS_PER_BLOCK contributions per block.
+ *  A contribution is removed once it is settled, so the remaining contributions of the sale are the
+ *  cursor of its settlement.
+ */
+class research_token_sale_settlement_object : public object<research_token_sale_settlement_object_type, research_token_sale_settlement_object>
+{
+    research_token_sale_settlement_object() = delete;
+public:
+    template <typename Constructor, typename Allocator> research_token_sale_settlement_object(Constructor&& c, allocator<Allocator> a)
+    {
+        c(*this);
+    }
+
+    research_token_sale_settlement_id_type id;
+    research_token_sale_id_type research_token_sale_id;
+    uint16_t status; // finished: the security tokens are distributed, expired: the contributions are refunded
+    flat_map<asset_symbol_type, share_type> distributed_security_tokens; // the last contributor gets the rest
+};
+
 struct by_external_id;
 struct by_research_id;
 struct by_research;
 struct by_end_time;
 struct by_research_id_and_status;
+struct by_status_and_start_time;
+struct by_status_and_end_time;
 
 typedef multi_index_container<research_token_sale_object,
         indexed_by<ordered_unique<tag<by_id>,
@@ -105,7 +128,29 @@ typedef multi_index_container<research_token_sale_object,
                                &research_token_sale_object::research_id>,
                         member<research_token_sale_object,
                                uint16_t,
-                               &research_token_sale_object::status>>>>,
+                               &research_token_sale_object::status>>>,
+                ordered_unique<tag<by_status_and_start_time>,
+                composite_key<research_token_sale_object,
+                        member<research_token_sale_object,
+                               uint16_t,
+                               &research_token_sale_object::status>,
+                        member<research_token_sale_object,
+                               fc::time_point_sec,
+                               &research_token_sale_object::start_time>,
+                        member<research_token_sale_object,
+                               research_token_sale_id_type,
+                               &research_token_sale_object::id>>>,
+                ordered_unique<tag<by_status_and_end_time>,
+                composite_key<research_token_sale_object,
+                        member<research_token_sale_object,
+                               uint16_t,
+                               &research_token_sale_object::status>,
+                        member<research_token_sale_object,
+                               fc::time_point_sec,
+                               &research_token_sale_object::end_time>,
+                        member<research_token_sale_object,
+                               research_token_sale_id_type,
+                               &research_token_sale_object::id>>>>,
         allocator<research_token_sale_object>>
         research_token_sale_index;
 
@@ -142,6 +187,18 @@ typedef multi_index_container<research_token_sale_contribution_object,
         allocator<research_token_sale_contribution_object>>
         research_token_sale_contribution_index;
 
+typedef multi_index_container<research_token_sale_settlement_object,
+        indexed_by<ordered_unique<tag<by_id>,
+                member<research_token_sale_settlement_object,
+                        research_token_sale_settlement_id_type,
+                        &research_token_sale_settlement_object::id>>,
+                ordered_unique<tag<by_research_token_sale_id>,
+                        member<research_token_sale_settlement_object,
+                                research_token_sale_id_type,
+                                &research_token_sale_settlement_object::research_token_sale_id>>>,
+        allocator<research_token_sale_settlement_object>>
+        research_token_sale_settlement_index;
+
 } // namespace chain
 } // namespace deip
 
@@ -158,4 +215,8 @@ CHAINBASE_SET_INDEX_TYPE(deip::chain::research_token_sale_object, deip::chain::r
 
 FC_REFLECT(deip::chain::research_token_sale_contribution_object, (id)(research_token_sale)(research_token_sale_id)(owner)(amount)(contribution_time))
 
-CHAINBASE_SET_INDEX_TYPE(deip::chain::research_token_sale_contribution_object, deip::chain::research_token_sale_contribution_index)
\ No newline at end of file
+CHAINBASE_SET_INDEX_TYPE(deip::chain::research_token_sale_contribution_object, deip::chain::research_token_sale_contribution_index)
+
+FC_REFLECT(deip::chain::research_token_sale_settlement_object, (id)(research_token_sale_id)(status)(distributed_security_tokens))
+
+CHAINBASE_SET_INDEX_TYPE(deip::chain::research_token_sale_settlement_object, deip::chain::research_token_sale_settlement_index)
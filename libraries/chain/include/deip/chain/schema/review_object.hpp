@@ -68,10 +68,11 @@ typedef multi_index_container<review_object,
                               review_id_type,
                               &review_object::id>>,
 
-                ordered_unique<tag<by_external_id>,
+                hashed_unique<tag<by_external_id>,
                         member<review_object,
                               external_id_type,
-                              &review_object::external_id>>,
+                              &review_object::external_id>,
+                        chainbase::fixed_width_hash<external_id_type>>,
                 
                 ordered_non_unique<tag<by_research_external_id>,
                         member<review_object,
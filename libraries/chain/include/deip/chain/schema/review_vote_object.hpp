@@ -60,10 +60,11 @@ typedef multi_index_container<review_vote_object,
                               review_vote_id_type,
                               &review_vote_object::id>>,
 
-                ordered_unique<tag<by_external_id>,
+                hashed_unique<tag<by_external_id>,
                         member<review_vote_object,
                               external_id_type,
-                              &review_vote_object::external_id>>,
+                              &review_vote_object::external_id>,
+                        chainbase::fixed_width_hash<external_id_type>>,
 
                 ordered_non_unique<tag<by_discipline_id>,
                         member<review_vote_object,
@@ -14,6 +14,9 @@ using deip::protocol::signed_transaction;
  * The purpose of this object is to enable the detection of duplicate transactions. When a transaction is included
  * in a block a transaction_object is added. At the end of block processing all transaction_objects that have
  * expired can be removed from the index.
+ *
+ * Only the id is kept, the transaction itself is read back from the block it was applied in, see
+ * database::get_recent_transaction.
  */
 class transaction_object : public object<transaction_object_type, transaction_object>
 {
@@ -22,16 +25,17 @@ class transaction_object : public object<transaction_object_type, transaction_ob
 public:
     template <typename Constructor, typename Allocator>
     transaction_object(Constructor&& c, allocator<Allocator> a)
-        : packed_trx(a)
     {
         c(*this);
     }
 
     id_type id;
 
-    bip::vector<char, allocator<char>> packed_trx;
     transaction_id_type trx_id;
     time_point_sec expiration;
+
+    /// number of the block the transaction was applied in, the upcoming one for pending transactions
+    uint32_t block_num = 0;
 };
 
 struct by_expiration;
@@ -54,5 +58,5 @@ typedef multi_index_container<transaction_object,
 }
 } // deip::chain
 
-FC_REFLECT(deip::chain::transaction_object, (id)(packed_trx)(trx_id)(expiration))
+FC_REFLECT(deip::chain::transaction_object, (id)(trx_id)(expiration)(block_num))
 CHAINBASE_SET_INDEX_TYPE(deip::chain::transaction_object, deip::chain::transaction_index)
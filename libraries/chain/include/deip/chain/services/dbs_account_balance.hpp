@@ -2,6 +2,9 @@
 
 #include "dbs_base_impl.hpp"
 #include <deip/chain/schema/account_balance_object.hpp>
+#include <deip/chain/schema/asset_object.hpp>
+
+#include <map>
 
 namespace deip {
 namespace chain {
@@ -49,6 +52,27 @@ public:
     const account_balance_object& unfreeze_account_balance(const account_name_type& account, const asset& amount);
 
     void remove_account_balance(const account_balance_object& balance);
+
+    /**
+     * Pays the license revenue accrued on a security token balance since its last settlement.
+     * Balances are settled before their holding changes and whenever their owner authorizes
+     * an operation, so owners always spend from up to date balances.
+     */
+    void settle_license_revenue(const account_balance_object& security_token_balance);
+
+    void settle_license_revenue(const account_name_type& owner);
+
+    /**
+     * License revenue accrued on owner's security token balances and not settled yet, by revenue asset
+     */
+    const std::map<asset_symbol_type, share_type> get_pending_license_revenue(const account_name_type& owner) const;
+
+private:
+    /// Revenue owed to the balance scaled by DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION, with the remainder of its
+    /// past settlements
+    const fc::uint128 get_owed_license_revenue(const account_balance_object& security_token_balance,
+                                               const asset_symbol_type& revenue_symbol,
+                                               const license_revenue_accumulator& accumulator) const;
 };
 
 } // namespace chain
@@ -55,6 +55,15 @@ public:
 
     const asset_object& adjust_asset_current_supply(const asset_object& asset_o, const asset& delta);
 
+    /**
+     * Credits revenue to all holders of the security token in O(1) by raising its revenue per
+     * unit accumulator. Holders receive it when their balances are settled
+     * (see dbs_account_balance::settle_license_revenue).
+     *
+     * @return the part of revenue owed to holders, the rest is rounding remainder
+     */
+    const asset distribute_license_revenue(const asset_object& security_token, const asset& revenue);
+
     const asset_refs_type lookup_assets(const string& lower_bound_symbol, uint32_t limit) const;
 
     const asset_refs_type get_assets_by_type(const asset_type& type) const;
@@ -11,6 +11,16 @@
 namespace deip {
     namespace chain {
 
+/* Expert token of the default expertise that has no object yet,
+ * the id is reserved for the object by dbs_expert_token::grant_default_expertise
+*/
+struct implicit_expert_token
+{
+    expert_token_id_type id;
+    account_name_type account_name;
+    discipline_id_type discipline_id;
+};
+
 ///** DB service for operations with expert_token_object
 // *  --------------------------------------------
 // */
@@ -26,6 +36,7 @@ public:
 
     using expert_token_refs_type = std::vector<std::reference_wrapper<const expert_token_object>>;
     using expert_token_optional_ref_type = fc::optional<std::reference_wrapper<const expert_token_object>>;
+    using implicit_expert_tokens_type = std::vector<implicit_expert_token>;
 
     const expert_token_object& create_expert_token(const account_name_type& account, 
                                                    const discipline_id_type& discipline_id,
@@ -60,8 +71,51 @@ public:
 
     const expert_token_refs_type get_expert_tokens_by_discipline(const external_id_type& discipline_external_id) const;
 
+    /* Check expert token existence, including the implicit tokens of the default expertise
+    */
     const bool expert_token_exists_by_account_and_discipline(const account_name_type& account, const discipline_id_type& discipline_id) const;
 
+    /* Grant the default expertise to the account in every discipline except the common one.
+     * No expert tokens are created: lookups answer with DEIP_DEFAULT_EXPERTISE_AMOUNT
+     * until the token is materialized by its first modification. The token ids are reserved
+     * here, so they are the same as if the tokens were created with the account
+    */
+    void grant_default_expertise(const account_name_type& account);
+
+    /* Check if the account holds the default expertise in the discipline without an expert token object
+    */
+    const bool has_implicit_expert_token(const account_name_type& account, const discipline_id_type& discipline_id) const;
+
+    /* Get expertise amount of the account in the discipline
+     * @returns token amount, the default expertise amount for implicit tokens or 0
+    */
+    const share_type get_expertise_amount(const account_name_type& account, const discipline_id_type& discipline_id) const;
+
+    /* Get the id reserved for the default expertise token of the account in the discipline
+    */
+    const expert_token_id_type get_implicit_expert_token_id(const account_object& account, const discipline_id_type& discipline_id) const;
+
+    /* Get the implicit token the id is reserved for
+     * @returns nothing if the id is not reserved or its token has an object already
+    */
+    const fc::optional<implicit_expert_token> get_implicit_expert_token_if_exists(const expert_token_id_type& id) const;
+
+    /* Get the implicit tokens of the discipline
+     * @returns implicit tokens ordered by id
+    */
+    const implicit_expert_tokens_type get_implicit_expert_tokens_by_discipline(const discipline_id_type& discipline_id) const;
+
+    /* Get the implicit tokens of the account
+     * @returns implicit tokens ordered by id
+    */
+    const implicit_expert_tokens_type get_implicit_expert_tokens_by_account_name(const account_name_type& account_name) const;
+
+    /* Get expert token by account name & discipline, creating the object for an implicit token
+     * @returns expert token to be modified
+    */
+    const expert_token_object& materialize_expert_token(const account_name_type& account,
+                                                        const discipline_id_type& discipline_id);
+
     const std::tuple<share_type, share_type> adjust_expert_token( const account_name_type& account,
                                                                   const discipline_id_type& discipline_id,
                                                                   const share_type& amount);
@@ -59,6 +59,14 @@ public:
     expertise_contributions_refs_type get_increased_expertise_contributions_in_block() const;
 
     expertise_contributions_refs_type get_decreased_expertise_contributions_in_block() const;
+
+    /** Contributions of active non final results with non zero ECI in the discipline,
+     *  the ones discipline supplies are distributed to.
+     */
+    expertise_contributions_refs_type get_discipline_supply_recipients(const discipline_id_type& discipline_id) const;
+
+private:
+    void adjust_discipline_eci(const expertise_contribution_object& expertise_contribution, const share_type& delta);
 };
 } // namespace chain
 } // namespace deip
@@ -74,11 +74,32 @@ public:
 
     const research_token_sale_contribution_refs_type get_research_token_sale_contributions_by_contributor(const account_name_type& owner) const;
 
+    /**
+     *  Pays the collected funds to the research group and queues the contributors for the
+     *  distribution of the security tokens, which stay frozen until then.
+     */
     void finish_research_token_sale(const research_token_sale_id_type& research_token_sale_id);
 
+    /**
+     *  Unfreezes the security tokens on sale and queues the contributions for refund.
+     */
     void refund_research_token_sale(const research_token_sale_id_type research_token_sale_id);
 
     void process_research_token_sales();
+
+    /**
+     *  Settles up to max_contributions queued contributions of ended sales, in the order the
+     *  sales ended. Returns the number of contributions settled.
+     */
+    uint32_t settle_research_token_sales(const uint32_t max_contributions);
+
+private:
+    void settle_research_token_sale_contribution(const research_token_sale_settlement_object& settlement,
+                                                 const research_token_sale_contribution_object& contribution,
+                                                 const bool is_last_contribution);
+
+    void create_research_token_sale_settlement(const research_token_sale_id_type& research_token_sale_id,
+                                               const research_token_sale_status& status);
 };
 
 } // namespace chain
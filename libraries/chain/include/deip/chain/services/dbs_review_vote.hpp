@@ -51,6 +51,8 @@ public:
 
     review_vote_refs_type get_review_votes_by_review_and_discipline(const review_id_type &review_id, const discipline_id_type &discipline_id) const;
 
+    size_t get_review_votes_count_by_review_and_discipline(const review_id_type& review_id, const discipline_id_type& discipline_id) const;
+
     review_vote_refs_type get_review_votes_by_discipline(const discipline_id_type &discipline_id) const;
 
     review_vote_refs_type get_review_votes_by_researh_content(const research_content_id_type& research_content_id) const;
@@ -1,29 +1,22 @@
-#include <deip/chain/database/database.hpp>
+#include <deip/chain/database/authority_cache.hpp>
 #include <deip/protocol/authority.hpp>
 #include <deip/chain/schema/proposal_object.hpp>
-#include <deip/chain/schema/account_object.hpp>
 
 namespace deip {
 namespace chain {
 
-bool proposal_object::is_authorized_to_execute(chainbase::database& db) const
+bool proposal_object::is_authorized_to_execute(authority_cache& authorities) const
 {
     auto get_active = [&](const string& name) { 
-        return authority(db.get<account_authority_object, by_account>(name).active); 
+        return authorities.get_active(name); 
     };
     
     auto get_owner = [&](const string& name) { 
-        return authority(db.get<account_authority_object, by_account>(name).owner); 
+        return authorities.get_owner(name); 
     };
 
     auto get_active_overrides = [&](const string& name, const uint16_t& op_tag) {
-        fc::optional<authority> result;
-        const auto& auth = db.get<account_authority_object, by_account>(name);
-        if (auth.active_overrides.find(op_tag) != auth.active_overrides.end())
-        {
-            result = auth.active_overrides.at(op_tag);
-        }
-        return result;
+        return authorities.get_active_override(name, op_tag);
     };
 
     try
@@ -46,26 +39,20 @@ bool proposal_object::is_authorized_to_execute(chainbase::database& db) const
    return true;
 }
 
-bool proposal_object::is_authorized_to_execute(chainbase::database& db,
+bool proposal_object::is_authorized_to_execute(authority_cache& authorities,
                                                const flat_set<account_name_type>& active_approvals_checklist,
                                                const flat_set<account_name_type>& owner_approvals_checklist) const
 {
     auto get_active = [&](const string& name) { 
-      return authority(db.get<account_authority_object, by_account>(name).active); 
+      return authorities.get_active(name); 
     };
 
     auto get_owner = [&](const string& name) { 
-      return authority(db.get<account_authority_object, by_account>(name).owner); 
+      return authorities.get_owner(name); 
     };
 
     auto get_active_overrides = [&](const string& name, const uint16_t& op_tag) {
-        fc::optional<authority> result;
-        const auto& auth = db.get<account_authority_object, by_account>(name);
-        if (auth.active_overrides.find(op_tag) != auth.active_overrides.end())
-        {
-            result = auth.active_overrides.at(op_tag);
-        }
-        return result;
+        return authorities.get_active_override(name, op_tag);
     };
 
     try
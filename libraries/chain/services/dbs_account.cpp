@@ -707,13 +707,27 @@ dbs_account::accounts_refs_type dbs_account::get_accounts_by_expert_discipline(c
 
     dbs_expert_token& expert_token_service = db_impl().obtain_service<dbs_expert_token>();
 
-    accounts_refs_type ret;
+    // holders in token id order, implicit tokens have their ids reserved
+    std::vector<std::pair<expert_token_id_type, account_name_type>> holders;
     auto expert_tokens = expert_token_service.get_expert_tokens_by_discipline(discipline_id);
 
     for (auto expert_token : expert_tokens)
     {
         auto &token = expert_token.get();
-        ret.push_back(std::cref(get_account(token.account_name)));
+        holders.push_back(std::make_pair(token.id, token.account_name));
+    }
+
+    for (const auto& implicit_token : expert_token_service.get_implicit_expert_tokens_by_discipline(discipline_id))
+    {
+        holders.push_back(std::make_pair(implicit_token.id, implicit_token.account_name));
+    }
+
+    std::sort(holders.begin(), holders.end());
+
+    accounts_refs_type ret;
+    for (const auto& holder : holders)
+    {
+        ret.push_back(std::cref(get_account(holder.second)));
     }
 
     return ret;
@@ -30,6 +30,10 @@ const account_balance_object& dbs_account_balance::create_account_balance(const
         if (static_cast<asset_type>(asset.type) == asset_type::research_security_token)
         {
             account_balance.tokenized_research = *asset.tokenized_research;
+
+            // new holders are owed only the revenue distributed from now on
+            for (const auto& revenue : asset.license_revenue)
+                account_balance.settled_revenue_per_unit.emplace(revenue.first, revenue.second.revenue_per_unit);
         }
     });
 
@@ -169,6 +173,8 @@ const account_balance_object& dbs_account_balance::adjust_account_balance(const
 
     const auto& balance = get_account_balance_by_owner_and_asset(owner, delta.symbol);
 
+    settle_license_revenue(balance);
+
     if (delta.amount < 0)
     {
         FC_ASSERT(balance.amount >= abs(delta.amount.value),
@@ -213,5 +219,120 @@ const account_balance_object& dbs_account_balance::unfreeze_account_balance(cons
     return balance;
 }
 
+void dbs_account_balance::settle_license_revenue(const account_balance_object& security_token_balance)
+{
+    if (!security_token_balance.tokenized_research.valid())
+        return;
+
+    const auto& security_token = db_impl().get<asset_object>(security_token_balance.asset_id);
+    const bool is_revenue_income_history_observed = db_impl().is_virtual_operation_observed<account_revenue_income_history_operation>();
+    const auto now = db_impl().head_block_time();
+
+    for (const auto& revenue : security_token.license_revenue)
+    {
+        const asset_symbol_type revenue_symbol = revenue.first;
+        const license_revenue_accumulator accumulator = revenue.second;
+
+        const auto settled = security_token_balance.settled_revenue_per_unit.find(revenue_symbol);
+        const fc::uint128 settled_per_unit = settled != security_token_balance.settled_revenue_per_unit.end() ? settled->second : fc::uint128(0);
+        if (settled_per_unit == accumulator.revenue_per_unit)
+            continue;
+
+        // the remainder below one unit is carried, so that the balance is always settled before its holding changes
+        const fc::uint128 precision(DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION);
+        const fc::uint128 owed = get_owed_license_revenue(security_token_balance, revenue_symbol, accumulator);
+        const share_type pending = share_type((owed / precision).to_uint64());
+        const fc::uint128 remainder = owed % precision;
+
+        db_impl().modify(security_token_balance, [&](account_balance_object& ab_o) {
+            ab_o.settled_revenue_per_unit[revenue_symbol] = accumulator.revenue_per_unit;
+            if (remainder != 0)
+                ab_o.settled_revenue_remainder[revenue_symbol] = remainder;
+            else
+                ab_o.settled_revenue_remainder.erase(revenue_symbol);
+        });
+
+        if (pending == 0)
+            continue;
+
+        FC_ASSERT(accumulator.undistributed >= pending,
+          "Security token ${1} undistributed revenue ${2} is less than pending revenue ${3} of ${4}",
+          ("1", security_token.symbol)("2", asset(accumulator.undistributed, revenue_symbol))("3", asset(pending, revenue_symbol))("4", security_token_balance.owner));
+
+        db_impl().modify(security_token, [&](asset_object& a_o) {
+            a_o.license_revenue.at(revenue_symbol).undistributed -= pending;
+        });
+
+        const asset income = asset(pending, revenue_symbol);
+        adjust_account_balance(security_token_balance.owner, income);
+
+        if (is_revenue_income_history_observed)
+        {
+            db_impl().push_virtual_operation(account_revenue_income_history_operation(
+                security_token_balance.owner,
+                security_token_balance.to_asset(),
+                income,
+                now)
+            );
+        }
+    }
+}
+
+void dbs_account_balance::settle_license_revenue(const account_name_type& owner)
+{
+    const auto& idx = db_impl()
+      .get_index<account_balance_index>()
+      .indicies()
+      .get<by_owner>();
+
+    for (auto itr = idx.lower_bound(owner); itr != idx.end() && itr->owner == owner; ++itr)
+    {
+        settle_license_revenue(*itr);
+    }
+}
+
+const std::map<asset_symbol_type, share_type> dbs_account_balance::get_pending_license_revenue(const account_name_type& owner) const
+{
+    std::map<asset_symbol_type, share_type> result;
+
+    const auto& idx = db_impl()
+      .get_index<account_balance_index>()
+      .indicies()
+      .get<by_owner>();
+
+    for (auto itr = idx.lower_bound(owner); itr != idx.end() && itr->owner == owner; ++itr)
+    {
+        if (!itr->tokenized_research.valid())
+            continue;
+
+        const auto& security_token = db_impl().get<asset_object>(itr->asset_id);
+        for (const auto& revenue : security_token.license_revenue)
+        {
+            const share_type pending = share_type(
+                (get_owed_license_revenue(*itr, revenue.first, revenue.second) / DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION)
+                    .to_uint64());
+            if (pending > 0)
+                result[revenue.first] += pending;
+        }
+    }
+
+    return result;
+}
+
+const fc::uint128 dbs_account_balance::get_owed_license_revenue(const account_balance_object& security_token_balance,
+                                                                const asset_symbol_type& revenue_symbol,
+                                                                const license_revenue_accumulator& accumulator) const
+{
+    const auto itr = security_token_balance.settled_revenue_per_unit.find(revenue_symbol);
+    const fc::uint128 settled = itr != security_token_balance.settled_revenue_per_unit.end() ? itr->second : fc::uint128(0);
+
+    const auto remainder_itr = security_token_balance.settled_revenue_remainder.find(revenue_symbol);
+    const fc::uint128 remainder = remainder_itr != security_token_balance.settled_revenue_remainder.end() ? remainder_itr->second : fc::uint128(0);
+
+    // frozen security tokens earn revenue as well, they still belong to the owner
+    const fc::uint128 holding((security_token_balance.amount + security_token_balance.frozen_amount).value);
+    return holding * (accumulator.revenue_per_unit - settled) + remainder;
+}
+
 } //namespace chain
 } //namespace deip
\ No newline at end of file
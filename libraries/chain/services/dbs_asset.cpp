@@ -162,6 +162,37 @@ const asset_object& dbs_asset::adjust_asset_current_supply(const asset_object& a
     return asset_o;
 }
 
+const asset dbs_asset::distribute_license_revenue(const asset_object& security_token, const asset& revenue)
+{
+    FC_ASSERT(static_cast<asset_type>(security_token.type) == asset_type::research_security_token,
+      "Asset ${1} is not a security token",
+      ("1", security_token.symbol));
+    FC_ASSERT(revenue.amount >= 0, "Revenue ${1} must not be negative", ("1", revenue));
+
+    if (revenue.amount == 0 || security_token.current_supply == 0)
+        return asset(0, revenue.symbol);
+
+    const fc::uint128 precision(DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION);
+    const fc::uint128 supply(security_token.current_supply.value);
+    const fc::uint128 revenue_per_unit = (fc::uint128(revenue.amount.value) * precision) / supply;
+
+    // rounded up: it covers what holders are owed, however their settlements round down
+    // (revenue_per_unit * supply <= revenue * precision, so it never exceeds revenue)
+    const fc::uint128 owed = revenue_per_unit * supply;
+    const share_type distributed = ((owed + precision - 1) / precision).to_uint64();
+
+    db_impl().modify(security_token, [&](asset_object& a_o) {
+        auto itr = a_o.license_revenue.find(revenue.symbol);
+        if (itr == a_o.license_revenue.end())
+            itr = a_o.license_revenue.emplace(revenue.symbol, license_revenue_accumulator()).first;
+
+        itr->second.revenue_per_unit += revenue_per_unit;
+        itr->second.undistributed += distributed;
+    });
+
+    return asset(distributed, revenue.symbol);
+}
+
 const asset_object& dbs_asset::get_asset_by_string_symbol(const string& string_symbol) const
 {
     const auto& idx = db_impl()
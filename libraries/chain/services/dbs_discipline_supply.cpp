@@ -217,58 +217,30 @@ share_type dbs_discipline_supply::supply_researches_in_discipline(const discipli
                                                                   const share_type& grant)
 {
     dbs_discipline& discipline_service = db_impl().obtain_service<dbs_discipline>();
-    dbs_research_content& research_content_service = db_impl().obtain_service<dbs_research_content>();
     dbs_expertise_contribution& expertise_contribution_service = db_impl().obtain_service<dbs_expertise_contribution>();
     dbs_research& research_service = db_impl().obtain_service<dbs_research>();
     dbs_account& account_service = db_impl().obtain_service<dbs_account>();
     dbs_account_balance& account_balance_service = db_impl().obtain_service<dbs_account_balance>();
 
-    auto expertise_contributions = expertise_contribution_service.get_expertise_contributions_by_discipline(discipline_id);
-    share_type total_eci_amount = std::accumulate(expertise_contributions.begin(), expertise_contributions.end(), share_type(0),
-      [&](share_type acc, const expertise_contribution_object& exp) { return acc + exp.eci; });
-
     const auto& discipline = discipline_service.get_discipline(discipline_id);
-    if (total_eci_amount == 0)
+    if (discipline.contributions_eci == 0)
         return 0;
 
     share_type used_grant = 0;
-    share_type total_research_weight = total_eci_amount;
-
-    std::map<account_id_type, share_type> grant_shares_per_research;
-
-    // Exclude final results from share calculation and discipline_supply distribution
-    const auto& final_results_idx
-        = db_impl().get_index<expertise_contribution_index>().indices().get<by_discipline_id>();
-    auto research_content_itr_pair = final_results_idx.equal_range(discipline.id);
-    auto& research_content_itr = research_content_itr_pair.first;
-    const auto& research_content_end = research_content_itr_pair.second;
 
-    while (research_content_itr != research_content_end)
-    {
-        const auto& research_content = research_content_service.get_research_content(research_content_itr->research_content_id);
-        if (research_content.type == research_content_type::final_result && research_content.activity_state == research_content_activity_state::active)
-        {
-            total_research_weight -= research_content_itr->eci;
-        }
-        ++research_content_itr;
-    }
+    // Final results are excluded from share calculation and discipline_supply distribution
+    const share_type total_research_weight = discipline.contributions_eci - discipline.final_results_eci;
 
+    const auto expertise_contributions = expertise_contribution_service.get_discipline_supply_recipients(discipline_id);
     for (auto& wrap : expertise_contributions)
     {
         auto& expertise_contribution = wrap.get();
-        const auto& research_content = research_content_service.get_research_content(expertise_contribution.research_content_id);
+        const auto share = util::calculate_share(grant, expertise_contribution.eci, total_research_weight);
+        const auto& research = research_service.get_research(expertise_contribution.research_id);
+        const auto& research_group = account_service.get_account(research.research_group);
+        account_balance_service.adjust_account_balance(research_group.name, asset(share, DEIP_SYMBOL));
 
-        if (research_content.type != research_content_type::final_result && 
-            research_content.activity_state == research_content_activity_state::active && 
-            expertise_contribution.eci != 0)
-        {
-            const auto share = util::calculate_share(grant, expertise_contribution.eci, total_research_weight);
-            const auto& research = research_service.get_research(expertise_contribution.research_id);
-            const auto& research_group = account_service.get_account(research.research_group);
-            account_balance_service.adjust_account_balance(research_group.name, asset(share, DEIP_SYMBOL));
-
-            used_grant += share;
-        }
+        used_grant += share;
     }
 
     if (used_grant > grant)
@@ -27,6 +27,9 @@ const expert_token_object& dbs_expert_token::create_expert_token(
     const auto& account = account_service.get_account(name);
 
     FC_ASSERT(discipline_id != 0, "Expertise token can not be created for the common discipline");
+    FC_ASSERT(!has_implicit_expert_token(name, discipline_id),
+      "Expert token for ${1} in ${2} discipline already exists",
+      ("1", name)("2", discipline_id));
 
     const auto& discipline = discipline_service.get_discipline(discipline_id);
 
@@ -175,7 +178,270 @@ const bool dbs_expert_token::expert_token_exists_by_account_and_discipline(
       .indices()
       .get<by_account_and_discipline>();
 
-    return idx.find(std::make_tuple(account, discipline_id)) != idx.end();
+    return idx.find(std::make_tuple(account, discipline_id)) != idx.end() 
+      || has_implicit_expert_token(account, discipline_id);
+}
+
+void dbs_expert_token::grant_default_expertise(const account_name_type& name)
+{
+    auto& account_service = db_impl().obtain_service<dbs_account>();
+    const auto& discipline_service = db_impl().obtain_service<dbs_discipline>();
+
+    const auto& account = account_service.get_account(name);
+    FC_ASSERT(!account.has_default_expertise, "${1} has default expertise already", ("1", name));
+
+    const auto& idx = db_impl()
+      .get_index<expert_token_index>()
+      .indices()
+      .get<by_account_and_discipline>();
+
+    int64_t tokens_count = 0;
+    const auto& disciplines = discipline_service.lookup_disciplines(discipline_id_type(0), DEIP_API_BULK_FETCH_LIMIT);
+    for (const discipline_object& discipline : disciplines)
+    {
+        if (discipline.external_id == DEIP_COMMON_DISCIPLINE_ID)
+        {
+            continue;
+        }
+
+        FC_ASSERT(idx.find(std::make_tuple(name, discipline.id)) == idx.end(),
+          "Expert token for ${1} in ${2} discipline already exists",
+          ("1", name)("2", discipline.id));
+
+        ++tokens_count;
+    }
+
+    const auto first_id = db_impl().get_mutable_index<expert_token_index>().reserve_ids(tokens_count);
+
+    db_impl().modify(account, [&](account_object& a) {
+        a.has_default_expertise = true;
+        a.default_expert_tokens_id = first_id;
+    });
+
+    account_service.adjust_expertise_tokens_throughput(account, share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT) * tokens_count);
+}
+
+const bool dbs_expert_token::has_implicit_expert_token(const account_name_type& name,
+                                                       const discipline_id_type& discipline_id) const
+{
+    if (discipline_id == 0)
+    {
+        return false;
+    }
+
+    const auto* account = db_impl().find<account_object, by_name>(name);
+    if (account == nullptr || !account->has_default_expertise)
+    {
+        return false;
+    }
+
+    const auto* discipline = db_impl().find<discipline_object>(discipline_id);
+    if (discipline == nullptr || discipline->external_id == DEIP_COMMON_DISCIPLINE_ID)
+    {
+        return false;
+    }
+
+    const auto& idx = db_impl()
+      .get_index<expert_token_index>()
+      .indices()
+      .get<by_account_and_discipline>();
+
+    return idx.find(std::make_tuple(name, discipline_id)) == idx.end();
+}
+
+const share_type dbs_expert_token::get_expertise_amount(const account_name_type& account,
+                                                        const discipline_id_type& discipline_id) const
+{
+    const auto& expert_token_opt = get_expert_token_by_account_and_discipline_if_exists(account, discipline_id);
+    if (expert_token_opt.valid())
+    {
+        return (*expert_token_opt).get().amount;
+    }
+
+    return has_implicit_expert_token(account, discipline_id)
+      ? share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT)
+      : share_type(0);
+}
+
+const expert_token_id_type dbs_expert_token::get_implicit_expert_token_id(const account_object& account,
+                                                                         const discipline_id_type& discipline_id) const
+{
+    const auto& idx = db_impl()
+      .get_index<discipline_index>()
+      .indices()
+      .get<by_id>();
+
+    // ids are reserved in discipline order skipping the common discipline
+    int64_t ordinal = 0;
+    for (auto itr = idx.begin(); itr != idx.end() && itr->id < discipline_id; ++itr)
+    {
+        if (itr->external_id != DEIP_COMMON_DISCIPLINE_ID)
+        {
+            ++ordinal;
+        }
+    }
+
+    return expert_token_id_type(account.default_expert_tokens_id._id + ordinal);
+}
+
+const fc::optional<implicit_expert_token> dbs_expert_token::get_implicit_expert_token_if_exists(const expert_token_id_type& id) const
+{
+    fc::optional<implicit_expert_token> ret;
+
+    const auto& accounts_idx = db_impl()
+      .get_index<account_index>()
+      .indices()
+      .get<by_default_expertise>();
+
+    // the holder with the last range of reserved ids starting at or before the id
+    auto itr = accounts_idx.upper_bound(std::make_tuple(true, id));
+    if (itr == accounts_idx.begin())
+    {
+        return ret;
+    }
+    --itr;
+    if (!itr->has_default_expertise)
+    {
+        return ret;
+    }
+
+    const auto& tokens_idx = db_impl()
+      .get_index<expert_token_index>()
+      .indices()
+      .get<by_account_and_discipline>();
+
+    const auto& disciplines_idx = db_impl()
+      .get_index<discipline_index>()
+      .indices()
+      .get<by_id>();
+
+    const int64_t ordinal = id._id - itr->default_expert_tokens_id._id;
+    int64_t discipline_ordinal = 0;
+    for (const auto& discipline : disciplines_idx)
+    {
+        if (discipline.external_id == DEIP_COMMON_DISCIPLINE_ID)
+        {
+            continue;
+        }
+
+        if (discipline_ordinal == ordinal)
+        {
+            if (tokens_idx.find(std::make_tuple(itr->name, discipline.id)) == tokens_idx.end())
+            {
+                ret = implicit_expert_token{ id, itr->name, discipline.id };
+            }
+            break;
+        }
+
+        ++discipline_ordinal;
+    }
+
+    return ret;
+}
+
+const dbs_expert_token::implicit_expert_tokens_type dbs_expert_token::get_implicit_expert_tokens_by_discipline(const discipline_id_type& discipline_id) const
+{
+    implicit_expert_tokens_type ret;
+
+    const auto* discipline = db_impl().find<discipline_object>(discipline_id);
+    if (discipline_id == 0 || discipline == nullptr || discipline->external_id == DEIP_COMMON_DISCIPLINE_ID)
+    {
+        return ret;
+    }
+
+    const auto& tokens_idx = db_impl()
+      .get_index<expert_token_index>()
+      .indices()
+      .get<by_account_and_discipline>();
+
+    const auto& accounts_idx = db_impl()
+      .get_index<account_index>()
+      .indices()
+      .get<by_default_expertise>();
+
+    // holders come in the order of their reserved ids
+    auto itr = accounts_idx.lower_bound(std::make_tuple(true));
+    if (itr == accounts_idx.end())
+    {
+        return ret;
+    }
+
+    const int64_t ordinal = get_implicit_expert_token_id(*itr, discipline_id)._id - itr->default_expert_tokens_id._id;
+    for (; itr != accounts_idx.end(); ++itr)
+    {
+        if (tokens_idx.find(std::make_tuple(itr->name, discipline_id)) == tokens_idx.end())
+        {
+            ret.push_back({ expert_token_id_type(itr->default_expert_tokens_id._id + ordinal), itr->name, discipline_id });
+        }
+    }
+
+    return ret;
+}
+
+const dbs_expert_token::implicit_expert_tokens_type dbs_expert_token::get_implicit_expert_tokens_by_account_name(const account_name_type& account_name) const
+{
+    implicit_expert_tokens_type ret;
+
+    const auto* account = db_impl().find<account_object, by_name>(account_name);
+    if (account == nullptr || !account->has_default_expertise)
+    {
+        return ret;
+    }
+
+    const auto& tokens_idx = db_impl()
+      .get_index<expert_token_index>()
+      .indices()
+      .get<by_account_and_discipline>();
+
+    const auto& disciplines_idx = db_impl()
+      .get_index<discipline_index>()
+      .indices()
+      .get<by_id>();
+
+    int64_t ordinal = 0;
+    for (const auto& discipline : disciplines_idx)
+    {
+        if (discipline.external_id == DEIP_COMMON_DISCIPLINE_ID)
+        {
+            continue;
+        }
+
+        if (tokens_idx.find(std::make_tuple(account_name, discipline.id)) == tokens_idx.end())
+        {
+            ret.push_back({ expert_token_id_type(account->default_expert_tokens_id._id + ordinal), account_name, discipline.id });
+        }
+
+        ++ordinal;
+    }
+
+    return ret;
+}
+
+const expert_token_object& dbs_expert_token::materialize_expert_token(const account_name_type& name,
+                                                                      const discipline_id_type& discipline_id)
+{
+    const auto& expert_token_opt = get_expert_token_by_account_and_discipline_if_exists(name, discipline_id);
+    if (expert_token_opt.valid())
+    {
+        return (*expert_token_opt).get();
+    }
+
+    FC_ASSERT(has_implicit_expert_token(name, discipline_id),
+      "Expert token for ${1} in ${2} discipline does not exist",
+      ("1", name)("2", discipline_id));
+
+    const auto& account = db_impl().get<account_object, by_name>(name);
+    const auto& discipline = db_impl().get<discipline_object>(discipline_id);
+
+    // the amount is accounted in the throughput since grant_default_expertise
+    const auto id = get_implicit_expert_token_id(account, discipline_id);
+    return db_impl().get_mutable_index<expert_token_index>().emplace_reserved(id, [&](expert_token_object& exp_o) {
+        exp_o.account_name = name;
+        exp_o.discipline_id = discipline_id;
+        exp_o.amount = share_type(DEIP_DEFAULT_EXPERTISE_AMOUNT);
+        exp_o.discipline_external_id = discipline.external_id;
+        exp_o.last_vote_time = account.created;
+    });
 }
 
 const std::tuple<share_type, share_type> dbs_expert_token::adjust_expert_token( 
@@ -188,7 +454,7 @@ const std::tuple<share_type, share_type> dbs_expert_token::adjust_expert_token(
 
     if (expert_token_exists_by_account_and_discipline(name, discipline_id))
     {
-        const expert_token_object& exp = get_expert_token_by_account_and_discipline(account.name, discipline_id);
+        const expert_token_object& exp = materialize_expert_token(account.name, discipline_id);
         share_type previous = exp.amount;
         db_impl().modify(exp, [&](expert_token_object& exp_o) {
             exp_o.amount += delta;
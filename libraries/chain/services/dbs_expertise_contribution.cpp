@@ -1,5 +1,6 @@
 #include <deip/chain/services/dbs_expertise_contribution.hpp>
 #include <deip/chain/database/database.hpp>
+#include <deip/chain/schema/discipline_object.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <tuple>
 
@@ -21,6 +22,8 @@ const expertise_contribution_object& dbs_expertise_contribution::adjust_expertis
     if (expertise_contribution_exists(research_content_id, discipline_id))
     {
         const expertise_contribution_object& expertise_contribution = get_expertise_contribution_by_research_content_and_discipline(research_content_id, discipline_id);
+        adjust_discipline_eci(expertise_contribution, diff.current() - expertise_contribution.eci);
+
         db_impl().modify(expertise_contribution, [&](expertise_contribution_object& ec_o) {
             ec_o.eci_current_block_delta += diff.diff();
             ec_o.eci = diff.current();
@@ -39,11 +42,17 @@ const expertise_contribution_object& dbs_expertise_contribution::adjust_expertis
 
     else 
     {
+        const auto& research_content = db_impl().get<research_content_object>(research_content_id);
+        const bool is_active = research_content.activity_state == research_content_activity_state::active;
+        const bool is_final_result = research_content.type == research_content_type::final_result;
+
         const expertise_contribution_object& expertise_contribution
             = db_impl().create<expertise_contribution_object>([&](expertise_contribution_object& ec_o) {
                   ec_o.discipline_id = discipline_id;
                   ec_o.research_id = research_id;
                   ec_o.research_content_id = research_content_id;
+                  ec_o.is_final_result = is_active && is_final_result;
+                  ec_o.is_supply_recipient = is_active && !is_final_result;
                   ec_o.eci_current_block_delta = diff.current();
                   ec_o.eci = diff.current();
                   ec_o.eci_current_block_diffs.push_back(diff);
@@ -64,10 +73,46 @@ const expertise_contribution_object& dbs_expertise_contribution::adjust_expertis
                   }
               });
 
+        adjust_discipline_eci(expertise_contribution, expertise_contribution.eci);
+
         return expertise_contribution;
     } 
 }
 
+void dbs_expertise_contribution::adjust_discipline_eci(const expertise_contribution_object& expertise_contribution,
+                                                       const share_type& delta)
+{
+    const auto& discipline = db_impl().get<discipline_object>(expertise_contribution.discipline_id);
+    db_impl().modify(discipline, [&](discipline_object& d_o) {
+        d_o.contributions_eci += delta;
+        if (expertise_contribution.is_final_result)
+            d_o.final_results_eci += delta;
+    });
+}
+
+dbs_expertise_contribution::expertise_contributions_refs_type dbs_expertise_contribution::get_discipline_supply_recipients(
+  const discipline_id_type& discipline_id) const
+{
+    expertise_contributions_refs_type ret;
+
+    const auto& idx = db_impl()
+      .get_index<expertise_contribution_index>()
+      .indicies()
+      .get<by_discipline_supply_recipient>();
+
+    auto it_pair = idx.equal_range(std::make_tuple(discipline_id, true));
+    auto it = it_pair.first;
+    const auto it_end = it_pair.second;
+    while (it != it_end)
+    {
+        if (it->eci != 0)
+            ret.push_back(std::cref(*it));
+        ++it;
+    }
+
+    return ret;
+}
+
 const expertise_contribution_object& dbs_expertise_contribution::get_expertise_contribution(
   const expertise_contribution_id_type& id) const
 {
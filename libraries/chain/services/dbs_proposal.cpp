@@ -178,7 +178,7 @@ void dbs_proposal::clear_expired_proposals()
         const external_id_type proposal_id = proposal.external_id;
         try
         {
-            if (proposal.is_authorized_to_execute(db_impl()))
+            if (proposal.is_authorized_to_execute(db_impl().get_authority_cache()))
             {
                 db_impl().push_proposal(proposal);
                 // TODO: Do something with result so plugins can process it.
@@ -37,6 +37,10 @@ const research_object& dbs_research::create_research(const account_object& accou
         r_o.created_at = created_at;
         r_o.last_update_time = created_at;
         r_o.review_share_last_update = created_at;
+        for (const auto& discipline_id : disciplines)
+        {
+            r_o.eci_per_discipline[discipline_id] = 0;
+        }
     });
 
     for (auto& discipline_id : disciplines)
@@ -186,9 +190,10 @@ const std::map<discipline_id_type, share_type> dbs_research::get_eci_evaluation(
             })
         : std::set<account_name_type>();
 
-    const std::map<discipline_id_type, share_type> final_result_weight = research.is_finished
-        ? research_content_service.get_eci_evaluation(final_result->id)
-        : std::map<discipline_id_type, share_type>();
+    // the final result evaluation is always updated before the research one
+    const flat_map<discipline_id_type, share_type> final_result_weight = research.is_finished
+        ? final_result->eci_per_discipline
+        : flat_map<discipline_id_type, share_type>();
 
     std::map<discipline_id_type, std::map<account_name_type, std::pair<share_type, share_type>>> max_and_min_reviewer_weight_by_discipline;
     for (const research_content_object& research_content : research_contents)
@@ -207,12 +212,7 @@ const std::map<discipline_id_type, share_type> dbs_research::get_eci_evaluation(
 
             for (discipline_id_type discipline_id: milestone_review.disciplines)
             {
-                const auto& milestone_review_votes = review_votes_service.get_review_votes(milestone_review.id);
-                const double milestone_review_votes_count = (double)std::count_if(
-                    milestone_review_votes.begin(), milestone_review_votes.end(),
-                    [&](const review_vote_object& rw_vote) {
-                        return rw_vote.review_id == milestone_review.id && rw_vote.discipline_id == discipline_id;
-                    });
+                const double milestone_review_votes_count = (double)review_votes_service.get_review_votes_count_by_review_and_discipline(milestone_review.id, discipline_id);
 
                 if (max_and_min_reviewer_weight_by_discipline.find(discipline_id) == max_and_min_reviewer_weight_by_discipline.end()) {
                     std::map<account_name_type, std::pair<share_type, share_type>> author_max_and_min_weights;
@@ -25,6 +25,9 @@ const research_content_object& dbs_research_content::create_research_content(
   const fc::time_point_sec& timestamp) 
 {
     auto& dgp_service = db_impl().obtain_service<dbs_dynamic_global_properties>();
+    const dbs_research_discipline_relation& research_discipline_relation_service = db_impl().obtain_service<dbs_research_discipline_relation>();
+
+    const auto& research_discipline_relations = research_discipline_relation_service.get_research_discipline_relations_by_research(research.id);
 
     const auto& research_content = db_impl().create<research_content_object>([&](research_content_object& rc_o) {
         rc_o.research_id = research.id;
@@ -42,6 +45,11 @@ const research_content_object& dbs_research_content::create_research_content(
         rc_o.activity_state = research_content_activity_state::active;
         rc_o.activity_window_start = timestamp;
         rc_o.activity_window_end = time_point_sec::maximum();
+
+        for (const research_discipline_relation_object& relation : research_discipline_relations)
+        {
+            rc_o.eci_per_discipline[relation.discipline_id] = 0;
+        }
     });
 
     db_impl().modify(research, [&](research_object& r_o) { 
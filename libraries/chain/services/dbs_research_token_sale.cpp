@@ -321,137 +321,194 @@ void dbs_research_token_sale::finish_research_token_sale(const research_token_sa
 {
     dbs_research& research_service = db_impl().obtain_service<dbs_research>();
     dbs_account& account_service = db_impl().obtain_service<dbs_account>();
-    dbs_asset& asset_service = db_impl().obtain_service<dbs_asset>();
     dbs_account_balance& account_balance_service = db_impl().obtain_service<dbs_account_balance>();
 
-    const auto& idx = db_impl()
-      .get_index<research_token_sale_contribution_index>()
-      .indicies()
-      .get<by_research_token_sale_id>()
-      .equal_range(research_token_sale_id);
-
     const auto& research_token_sale = get_research_token_sale_by_id(research_token_sale_id);
     const auto& research = research_service.get_research(research_token_sale.research_id);
     const auto& research_group = account_service.get_account(research.research_group);
 
+    create_research_token_sale_settlement(research_token_sale_id, research_token_sale_status::finished);
+
+    account_balance_service.adjust_account_balance(research_group.name, research_token_sale.total_amount);
+}
+
+void dbs_research_token_sale::refund_research_token_sale(const research_token_sale_id_type research_token_sale_id)
+{
+    dbs_account_balance& account_balance_service = db_impl().obtain_service<dbs_account_balance>();
+    dbs_research& research_service = db_impl().obtain_service<dbs_research>();
+
+    const auto& research_token_sale = get_research_token_sale_by_id(research_token_sale_id);
+    const auto& research = research_service.get_research(research_token_sale.research_id);
+
     for (const auto& security_token_on_sale : research_token_sale.security_tokens_on_sale)
     {
         account_balance_service.unfreeze_account_balance(research.research_group, security_token_on_sale);
     }
-    
-    for (const auto& security_token_on_sale : research_token_sale.security_tokens_on_sale)
-    {
-        share_type total_security_token_amount = 0;
 
-        auto itr = idx.first;
-        const auto itr_end = idx.second;
+    create_research_token_sale_settlement(research_token_sale_id, research_token_sale_status::expired);
+}
 
-        while (itr != itr_end)
-        {
-            const account_name_type contributor = itr->owner;
-            const asset contribution = itr->amount;
+void dbs_research_token_sale::create_research_token_sale_settlement(const research_token_sale_id_type& research_token_sale_id,
+                                                                    const research_token_sale_status& status)
+{
+    db_impl().create<research_token_sale_settlement_object>([&](research_token_sale_settlement_object& rtss_o) {
+        rtss_o.research_token_sale_id = research_token_sale_id;
+        rtss_o.status = static_cast<uint16_t>(status);
+    });
+}
 
-            const auto& security_token = asset_service.get_asset_by_symbol(security_token_on_sale.symbol);
-            const auto& percent_share = percent(share_type(std::round((((double(contribution.amount.value) / double(research_token_sale.total_amount.amount.value)) * double(100)) * DEIP_1_PERCENT))));
-            const auto& security_token_amount = util::calculate_share(security_token_on_sale, percent_share);
+void dbs_research_token_sale::process_research_token_sales()
+{
+    const auto now = db_impl().head_block_time();
+    const uint16_t active = static_cast<uint16_t>(research_token_sale_status::active);
+    const uint16_t inactive = static_cast<uint16_t>(research_token_sale_status::inactive);
 
-            const auto& rg_balance = account_balance_service.adjust_account_balance(research.research_group, -security_token_amount);
-            account_balance_service.adjust_account_balance(contributor, security_token_amount);
+    const auto& end_time_idx = db_impl()
+      .get_index<research_token_sale_index>()
+      .indices()
+      .get<by_status_and_end_time>();
 
-            total_security_token_amount += security_token_amount.amount;
+    // the status change moves the sale out of the active range, so look the range up again
+    for (auto itr = end_time_idx.lower_bound(boost::make_tuple(active));
+         itr != end_time_idx.end() && itr->status == active && itr->end_time <= now;
+         itr = end_time_idx.lower_bound(boost::make_tuple(active)))
+    {
+        const research_token_sale_id_type research_token_sale_id = itr->id;
 
-            auto current = itr++;
-            if (itr == itr_end)
-            {
-                const asset& rest = asset(security_token_on_sale.amount - total_security_token_amount, security_token_on_sale.symbol);
-                if (rest.amount != share_type(0)) // precision
-                {
-                    account_balance_service.adjust_account_balance(contributor, rest);
-                    account_balance_service.adjust_account_balance(research.research_group, -rest);
-                }
-            }
+        if (itr->total_amount < itr->soft_cap)
+        {
+            update_status(research_token_sale_id, research_token_sale_status::expired);
+            refund_research_token_sale(research_token_sale_id);
+        }
+        else
+        {
+            update_status(research_token_sale_id, research_token_sale_status::finished);
+            finish_research_token_sale(research_token_sale_id);
         }
     }
 
-    auto itr = idx.first;
-    const auto itr_end = idx.second;
+    const auto& start_time_idx = db_impl()
+      .get_index<research_token_sale_index>()
+      .indices()
+      .get<by_status_and_start_time>();
+
+    std::vector<research_token_sale_id_type> started_research_token_sales;
 
-    while (itr != itr_end)
+    auto itr = start_time_idx.lower_bound(boost::make_tuple(inactive));
+    const auto itr_end = start_time_idx.upper_bound(boost::make_tuple(inactive, now));
+    for (; itr != itr_end; ++itr)
     {
-        auto current = itr++;
-        db_impl().remove(*current);
+        // sales which ended before they were started are never activated
+        if (itr->end_time > now)
+        {
+            started_research_token_sales.push_back(itr->id);
+        }
     }
 
-    account_balance_service.adjust_account_balance(research_group.name, research_token_sale.total_amount);
+    for (const auto& research_token_sale_id : started_research_token_sales)
+    {
+        update_status(research_token_sale_id, research_token_sale_status::active);
+    }
+
+    settle_research_token_sales(DEIP_MAX_TOKEN_SALE_SETTLEMENTS_PER_BLOCK);
 }
 
-void dbs_research_token_sale::refund_research_token_sale(const research_token_sale_id_type research_token_sale_id)
+uint32_t dbs_research_token_sale::settle_research_token_sales(const uint32_t max_contributions)
 {
-    dbs_account_balance& account_balance_service = db_impl().obtain_service<dbs_account_balance>();
-    dbs_research& research_service = db_impl().obtain_service<dbs_research>();
-
-    const auto& research_token_sale = get_research_token_sale_by_id(research_token_sale_id);
-    const auto& research = research_service.get_research(research_token_sale.research_id);
+    const auto& settlement_idx = db_impl()
+      .get_index<research_token_sale_settlement_index>()
+      .indices()
+      .get<by_id>();
 
-    const auto& idx = db_impl()
+    const auto& contribution_idx = db_impl()
       .get_index<research_token_sale_contribution_index>()
-      .indicies()
-      .get<by_research_token_sale_id>()
-      .equal_range(research_token_sale_id);
+      .indices()
+      .get<by_research_token_sale_id>();
 
-    for (const auto& security_token_on_sale : research_token_sale.security_tokens_on_sale)
+    uint32_t settled = 0;
+
+    while (settled < max_contributions && !settlement_idx.empty())
     {
-        account_balance_service.unfreeze_account_balance(research.research_group, security_token_on_sale);
-    }
+        const research_token_sale_settlement_object& settlement = *settlement_idx.begin();
+        const research_token_sale_id_type research_token_sale_id = settlement.research_token_sale_id;
+
+        auto itr = contribution_idx.lower_bound(research_token_sale_id);
+        if (itr == contribution_idx.end() || itr->research_token_sale_id != research_token_sale_id)
+        {
+            db_impl().remove(settlement);
+            continue;
+        }
 
-    auto itr = idx.first;
-    const auto itr_end = idx.second;
+        const auto next = std::next(itr);
+        const bool is_last_contribution = next == contribution_idx.end() || next->research_token_sale_id != research_token_sale_id;
 
-    while (itr != itr_end)
-    {
-        account_balance_service.adjust_account_balance(itr->owner, itr->amount);
+        settle_research_token_sale_contribution(settlement, *itr, is_last_contribution);
+        ++settled;
 
-        auto current = itr++;
-        db_impl().remove(*current);
+        if (is_last_contribution)
+        {
+            db_impl().remove(settlement);
+        }
     }
-}
 
+    return settled;
+}
 
-void dbs_research_token_sale::process_research_token_sales()
+void dbs_research_token_sale::settle_research_token_sale_contribution(const research_token_sale_settlement_object& settlement,
+                                                                      const research_token_sale_contribution_object& contribution,
+                                                                      const bool is_last_contribution)
 {
-    const auto& idx = db_impl()
-      .get_index<research_token_sale_index>()
-      .indices()
-      .get<by_end_time>();
+    dbs_research& research_service = db_impl().obtain_service<dbs_research>();
+    dbs_account_balance& account_balance_service = db_impl().obtain_service<dbs_account_balance>();
 
-    auto itr = idx.begin();
-    const auto now = db_impl().head_block_time();
+    const auto& research_token_sale = get_research_token_sale_by_id(settlement.research_token_sale_id);
+    const account_name_type contributor = contribution.owner;
 
-    while (itr != idx.end()) // TODO add index by status to decrease iteration time
+    token_sale_contribution_settled_operation settled_op(research_token_sale.external_id, contributor, contribution.amount, settlement.status);
+
+    if (settlement.status == static_cast<uint16_t>(research_token_sale_status::finished))
     {
-        if (itr->end_time <= now && itr->status == static_cast<uint16_t>(research_token_sale_status::active))
+        const auto& research = research_service.get_research(research_token_sale.research_id);
+        flat_map<asset_symbol_type, share_type> distributed_security_tokens = settlement.distributed_security_tokens;
+
+        for (const auto& security_token_on_sale : research_token_sale.security_tokens_on_sale)
         {
-            if (itr->total_amount < itr->soft_cap)
-            {
-                update_status(itr->id, research_token_sale_status::expired);
-                refund_research_token_sale(itr->id);
-            }
-            else if (itr->total_amount >= itr->soft_cap)
+            share_type& distributed = distributed_security_tokens[security_token_on_sale.symbol];
+            const share_type remaining = security_token_on_sale.amount - distributed;
+
+            share_type security_token_amount = remaining;
+            if (!is_last_contribution)
             {
-                update_status(itr->id, research_token_sale_status::finished);
-                finish_research_token_sale(itr->id);
+                const auto& percent_share = percent(share_type(std::round((((double(contribution.amount.amount.value) / double(research_token_sale.total_amount.amount.value)) * double(100)) * DEIP_1_PERCENT))));
+                security_token_amount = std::min(util::calculate_share(security_token_on_sale, percent_share).amount, remaining);
             }
+
+            if (security_token_amount <= share_type(0))
+                continue;
+
+            const asset security_token(security_token_amount, security_token_on_sale.symbol);
+            account_balance_service.unfreeze_account_balance(research.research_group, security_token);
+            account_balance_service.adjust_account_balance(research.research_group, -security_token);
+            account_balance_service.adjust_account_balance(contributor, security_token);
+
+            distributed += security_token_amount;
+            settled_op.security_tokens.push_back(security_token);
         }
-        else if (itr->end_time > now)
+
+        if (!is_last_contribution)
         {
-            if (now >= itr->start_time && itr->status == static_cast<uint16_t>(research_token_sale_status::inactive))
-            {
-                update_status(itr->id, research_token_sale_status::active);
-            }
+            db_impl().modify(settlement, [&](research_token_sale_settlement_object& rtss_o) {
+                rtss_o.distributed_security_tokens = distributed_security_tokens;
+            });
         }
-
-        itr++;
     }
+    else
+    {
+        account_balance_service.adjust_account_balance(contributor, contribution.amount);
+    }
+
+    db_impl().remove(contribution);
+    db_impl().push_virtual_operation(settled_op);
 }
 
 } // namespace chain
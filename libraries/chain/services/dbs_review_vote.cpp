@@ -152,6 +152,13 @@ dbs_review_vote::review_vote_refs_type dbs_review_vote::get_review_votes_by_revi
     return ret;
 }
 
+size_t dbs_review_vote::get_review_votes_count_by_review_and_discipline(const review_id_type& review_id,
+                                                                      const discipline_id_type& discipline_id) const
+{
+    return db_impl().get_index<review_vote_index>().indicies().get<by_review_and_discipline>()
+            .count(std::make_tuple(review_id, discipline_id));
+}
+
 dbs_review_vote::review_vote_refs_type dbs_review_vote::get_review_votes_by_discipline(const discipline_id_type &discipline_id) const
 {
     review_vote_refs_type ret;
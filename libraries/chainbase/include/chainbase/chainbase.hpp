@@ -22,9 +22,11 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 #include <typeindex>
 #include <typeinfo>
 
@@ -99,6 +101,30 @@ public:
     int64_t revision = 0;
 };
 
+/**
+ *  Describes how an object was touched within an undo state.
+ */
+struct object_change
+{
+    enum change_type
+    {
+        created,
+        modified,
+        removed
+    };
+
+    object_change(uint16_t t, int64_t i, change_type c)
+        : type_id(t)
+        , id(i)
+        , type(c)
+    {
+    }
+
+    uint16_t type_id;
+    int64_t id;
+    change_type type;
+};
+
 /**
  * The code we want to implement is this:
  *
@@ -129,6 +155,189 @@ private:
     int32_t& _target;
 };
 
+/**
+ *  Lives in the shared memory file and is set while a writer holds the write lock. The kernel
+ *  writes the mapping back after the process dies, so a marker found set on open means that the
+ *  previous writer was killed in the middle of a change and objects may be half written. Such a
+ *  marker stays set until the database is wiped.
+ */
+struct write_marker
+{
+    bool writing = false;
+};
+
+class write_marker_scope
+{
+public:
+    write_marker_scope(write_marker* marker)
+        : _marker(marker)
+    {
+        if (_marker)
+        {
+            _previous = _marker->writing;
+            _marker->writing = true;
+        }
+    }
+    ~write_marker_scope()
+    {
+        if (_marker)
+            _marker->writing = _previous;
+    }
+
+private:
+    write_marker* _marker;
+    bool _previous = false;
+};
+
+/**
+ *  Lock usage of a database: how long writers waited for the lock and how long readers held it.
+ */
+struct lock_stats
+{
+    uint64_t write_locks = 0;
+    uint64_t write_wait_us = 0;
+    uint64_t max_write_wait_us = 0;
+
+    uint64_t read_locks = 0;
+    uint64_t read_hold_us = 0;
+    uint64_t max_read_hold_us = 0;
+};
+
+class lock_duration_counter
+{
+public:
+    void add(uint64_t us)
+    {
+        ++_count;
+        _total += us;
+
+        uint64_t max = _max.load();
+        while (us > max && !_max.compare_exchange_weak(max, us))
+        {
+        }
+    }
+
+    uint64_t count() const
+    {
+        return _count.load();
+    }
+
+    uint64_t total() const
+    {
+        return _total.load();
+    }
+
+    uint64_t max() const
+    {
+        return _max.load();
+    }
+
+private:
+    std::atomic<uint64_t> _count{ 0 };
+    std::atomic<uint64_t> _total{ 0 };
+    std::atomic<uint64_t> _max{ 0 };
+};
+
+/**
+ *  Adds the time from construction to destruction to the counter.
+ */
+class lock_duration_timer
+{
+public:
+    lock_duration_timer(lock_duration_counter& counter)
+        : _counter(counter)
+        , _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~lock_duration_timer()
+    {
+        _counter.add(elapsed_us(_start));
+    }
+
+    static uint64_t elapsed_us(const std::chrono::steady_clock::time_point& since)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since).count();
+    }
+
+private:
+    lock_duration_counter& _counter;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+/**
+ *  Undo session of a single index: undoes the changes made since it was started when it goes out
+ *  of scope, unless it was pushed or squashed.
+ */
+template <typename Index> class index_session
+{
+public:
+    index_session(index_session&& mv)
+        : _index(mv._index)
+        , _apply(mv._apply)
+    {
+        mv._apply = false;
+    }
+
+    ~index_session()
+    {
+        if (_apply)
+        {
+            _index.undo();
+        }
+    }
+
+    /** leaves the UNDO state on the stack when session goes out of scope */
+    void push()
+    {
+        _apply = false;
+    }
+    /** combines this session with the prior session */
+    void squash()
+    {
+        if (_apply)
+            _index.squash();
+        _apply = false;
+    }
+    void undo()
+    {
+        if (_apply)
+            _index.undo();
+        _apply = false;
+    }
+
+    index_session& operator=(index_session&& mv)
+    {
+        if (this == &mv)
+            return *this;
+        if (_apply)
+            _index.undo();
+        _apply = mv._apply;
+        mv._apply = false;
+        return *this;
+    }
+
+    int64_t revision() const
+    {
+        return _revision;
+    }
+
+private:
+    friend Index;
+
+    index_session(Index& idx, int64_t revision)
+        : _index(idx)
+        , _revision(revision)
+    {
+        if (revision == -1)
+            _apply = false;
+    }
+
+    Index& _index;
+    bool _apply = true;
+    int64_t _revision = 0;
+};
+
 /**
  *  The value_type stored in the multiindex container must have a integer field with the name 'id'.  This will
  *  be the primary key and it will be assigned and managed by generic_index.
@@ -184,9 +393,46 @@ public:
         return *insert_result.first;
     }
 
+    /**
+     * Skips count IDs, which are left for objects constructed later by emplace_reserved().
+     * Returns the first of them.
+     */
+    typename value_type::id_type reserve_ids(int64_t count)
+    {
+        auto first_id = _next_id;
+        _next_id = typename value_type::id_type(_next_id._id + count);
+        return first_id;
+    }
+
+    /**
+     * Construct a new element with an ID returned by reserve_ids(), _next_id is left as it is.
+     */
+    template <typename Constructor> const value_type& emplace_reserved(typename value_type::id_type id, Constructor&& c)
+    {
+        if (id >= _next_id)
+            BOOST_THROW_EXCEPTION(std::logic_error("could not insert object, the id is not reserved"));
+
+        auto constructor = [&](value_type& v) {
+            c(v);
+            v.id = id;
+        };
+
+        auto insert_result = _indices.emplace(constructor, _indices.get_allocator());
+
+        if (!insert_result.second)
+        {
+            BOOST_THROW_EXCEPTION(
+                std::logic_error("could not insert object, most likely a uniqueness constraint was violated"));
+        }
+
+        on_create(*insert_result.first);
+        return *insert_result.first;
+    }
+
     template <typename Modifier> void modify(const value_type& obj, Modifier&& m)
     {
         on_modify(obj);
+        ++_mutation_count;
         auto ok = _indices.modify(_indices.iterator_to(obj), m);
         if (!ok)
             BOOST_THROW_EXCEPTION(
@@ -196,6 +442,7 @@ public:
     void remove(const value_type& obj)
     {
         on_remove(obj);
+        ++_mutation_count;
         _indices.erase(_indices.iterator_to(obj));
     }
 
@@ -220,74 +467,7 @@ public:
         return _indices;
     }
 
-    class session
-    {
-    public:
-        session(session&& mv)
-            : _index(mv._index)
-            , _apply(mv._apply)
-        {
-            mv._apply = false;
-        }
-
-        ~session()
-        {
-            if (_apply)
-            {
-                _index.undo();
-            }
-        }
-
-        /** leaves the UNDO state on the stack when session goes out of scope */
-        void push()
-        {
-            _apply = false;
-        }
-        /** combines this session with the prior session */
-        void squash()
-        {
-            if (_apply)
-                _index.squash();
-            _apply = false;
-        }
-        void undo()
-        {
-            if (_apply)
-                _index.undo();
-            _apply = false;
-        }
-
-        session& operator=(session&& mv)
-        {
-            if (this == &mv)
-                return *this;
-            if (_apply)
-                _index.undo();
-            _apply = mv._apply;
-            mv._apply = false;
-            return *this;
-        }
-
-        int64_t revision() const
-        {
-            return _revision;
-        }
-
-    private:
-        friend class generic_index;
-
-        session(generic_index& idx, int64_t revision)
-            : _index(idx)
-            , _revision(revision)
-        {
-            if (revision == -1)
-                _apply = false;
-        }
-
-        generic_index& _index;
-        bool _apply = true;
-        int64_t _revision = 0;
-    };
+    typedef index_session<generic_index> session;
 
     session start_undo_session(bool enabled)
     {
@@ -313,6 +493,55 @@ public:
         return _revision;
     }
 
+    /**
+     *  Grows whenever an existing object is modified or removed, directly or by undo. Lets
+     *  process local caches of derived values detect that they went stale; objects which are
+     *  only created do not count, since nothing can have been derived from them yet.
+     */
+    uint64_t mutation_count() const
+    {
+        return _mutation_count;
+    }
+
+    /**
+     *  Appends the changes recorded by the head undo state, i.e. everything which happened
+     *  since the most recent session was started (including the sessions squashed into it).
+     *  Nothing is reported when undo is disabled.
+     */
+    void get_head_changes(std::vector<object_change>& changes) const
+    {
+        if (!enabled())
+            return;
+
+        const auto& head = _stack.back();
+        const uint16_t type_id = value_type::type_id;
+
+        for (const auto& id : head.new_ids)
+            changes.emplace_back(type_id, id._id, object_change::created);
+
+        for (const auto& item : head.old_values)
+            changes.emplace_back(type_id, item.first._id, object_change::modified);
+
+        for (const auto& item : head.removed_values)
+            changes.emplace_back(type_id, item.first._id, object_change::removed);
+    }
+
+    /**
+     *  Returns the last value of an object removed within the head undo state, nullptr if the
+     *  object was not removed there.
+     */
+    const value_type* find_head_removed(const typename value_type::id_type& id) const
+    {
+        if (!enabled())
+            return nullptr;
+
+        const auto& removed = _stack.back().removed_values;
+        auto itr = removed.find(id);
+        if (itr == removed.end())
+            return nullptr;
+        return &itr->second;
+    }
+
     /**
      *  Restores the state to how it was prior to the current session discarding all changes
      *  made between the last revision and the current revision.
@@ -323,6 +552,7 @@ public:
             return;
 
         const auto& head = _stack.back();
+        ++_mutation_count;
 
         for (auto& item : head.old_values)
         {
@@ -569,6 +799,7 @@ private:
      *  Commit will discard all revisions prior to the committed revision.
      */
     int64_t _revision = 0;
+    uint64_t _mutation_count = 0;
     typename value_type::id_type _next_id = 0;
     index_type _indices;
     uint32_t _size_of_value_type = 0;
@@ -646,6 +877,7 @@ public:
     virtual void commit(int64_t revision) const = 0;
     virtual void undo_all() const = 0;
     virtual uint32_t type_id() const = 0;
+    virtual void get_head_changes(std::vector<object_change>& changes) const = 0;
 
     virtual void remove_object(int64_t id) = 0;
 
@@ -710,6 +942,10 @@ public:
     {
         return BaseIndex::value_type::type_id;
     }
+    virtual void get_head_changes(std::vector<object_change>& changes) const override
+    {
+        _base.get_head_changes(changes);
+    }
 
     virtual void remove_object(int64_t id) override
     {
@@ -785,6 +1021,16 @@ public:
     void close();
     void flush();
     void wipe(const bfs::path& dir);
+
+    /// Writes the mapped files to disk and waits for the writes, may run while another thread writes
+    void sync();
+
+    /// Whether a writer of the database was killed while it held the write lock
+    bool interrupted_write() const
+    {
+        return _interrupted_write;
+    }
+
     void set_require_locking(bool enable_require_locking);
 
     void require_lock_fail(const char* method, const char* lock_type, const char* tname) const;
@@ -871,6 +1117,11 @@ public:
     void commit(int64_t revision);
     void undo_all();
 
+    /**
+     *  Collects the changes of the head undo state across all indices.
+     */
+    void get_head_changes(std::vector<object_change>& changes) const;
+
     void set_revision(int64_t revision)
     {
         CHAINBASE_REQUIRE_WRITE_LOCK("set_revision", int64_t);
@@ -1054,9 +1305,22 @@ public:
         return get_mutable_index<index_type>().emplace(std::forward<Constructor>(con));
     }
 
+    /**
+     *  Locks are writer preferring: while a writer of this process waits for the lock, new readers wait
+     *  for it to finish instead of joining the readers it waits for. Readers still give up after wait_micro.
+     */
     template <typename Lambda>
     auto with_read_lock(Lambda&& callback, uint64_t wait_micro = 1000000) -> decltype((*(Lambda*)nullptr)())
     {
+        const auto start = std::chrono::steady_clock::now();
+
+        while (_writers_waiting.load() > 0)
+        {
+            if (wait_micro && lock_duration_timer::elapsed_us(start) >= wait_micro)
+                BOOST_THROW_EXCEPTION(std::runtime_error("unable to acquire lock"));
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
         read_lock lock(_rw_manager->current_lock(), bip::defer_lock_type());
         BOOST_ATTRIBUTE_UNUSED
         int_incrementer ii(_read_lock_count);
@@ -1067,11 +1331,16 @@ public:
         }
         else
         {
+            const uint64_t waited = lock_duration_timer::elapsed_us(start);
+            const uint64_t remaining = waited < wait_micro ? wait_micro - waited : 0;
             if (!lock.timed_lock(boost::posix_time::microsec_clock::universal_time()
-                                 + boost::posix_time::microseconds(wait_micro)))
+                                 + boost::posix_time::microseconds(remaining)))
                 BOOST_THROW_EXCEPTION(std::runtime_error("unable to acquire lock"));
         }
 
+        BOOST_ATTRIBUTE_UNUSED
+        lock_duration_timer hold_timer(_read_hold);
+
         return callback();
     }
 
@@ -1081,28 +1350,36 @@ public:
         if (_read_only)
             BOOST_THROW_EXCEPTION(std::logic_error("cannot acquire write lock on read-only process"));
 
-        write_lock lock(_rw_manager->current_lock(), boost::defer_lock_t());
-        BOOST_ATTRIBUTE_UNUSED
-        int_incrementer ii(_write_lock_count);
-
-        if (!wait_micro)
+        read_write_mutex* mutex = nullptr;
         {
-            lock.lock();
-        }
-        else
-        {
-            while (!lock.timed_lock(boost::posix_time::microsec_clock::universal_time()
-                                    + boost::posix_time::microseconds(wait_micro)))
+            BOOST_ATTRIBUTE_UNUSED
+            lock_duration_timer wait_timer(_write_wait);
+            ++_writers_waiting;
+
+            try
             {
-                _rw_manager->next_lock();
-                std::cerr << "Lock timeout, moving to lock " << _rw_manager->current_lock_num() << std::endl;
-                lock = write_lock(_rw_manager->current_lock(), boost::defer_lock_t());
+                mutex = &acquire_write_lock(wait_micro);
             }
+            catch (...)
+            {
+                --_writers_waiting;
+                throw;
+            }
+
+            --_writers_waiting;
         }
 
+        write_lock lock(*mutex, boost::adopt_lock_t());
+        BOOST_ATTRIBUTE_UNUSED
+        int_incrementer ii(_write_lock_count);
+        BOOST_ATTRIBUTE_UNUSED
+        write_marker_scope marker(_write_marker);
+
         return callback();
     }
 
+    lock_stats get_lock_stats() const;
+
     template <typename IndexExtensionType, typename Lambda> void for_each_index_extension(Lambda&& callback) const
     {
         for (const abstract_index* idx : _index_list)
@@ -1118,9 +1395,13 @@ public:
     }
 
 private:
+    read_write_mutex& acquire_write_lock(uint64_t wait_micro);
+
     std::unique_ptr<bip::managed_mapped_file> _segment;
     std::unique_ptr<bip::managed_mapped_file> _meta;
     read_write_mutex_manager* _rw_manager = nullptr;
+    write_marker* _write_marker = nullptr;
+    bool _interrupted_write = false;
     bool _read_only = false;
     bip::file_lock _flock;
 
@@ -1138,6 +1419,10 @@ private:
 
     int32_t _read_lock_count = 0;
     int32_t _write_lock_count = 0;
+
+    std::atomic<uint32_t> _writers_waiting{ 0 };
+    lock_duration_counter _write_wait;
+    lock_duration_counter _read_hold;
     bool _enable_require_locking = false;
 };
 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <boost/multi_index/hashed_index.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chainbase {
+
+/**
+ *  Hash over the raw bytes of a fixed width key, for keys which compare equal exactly
+ *  when their bytes are equal (fc::fixed_string, integers, PODs of those).
+ *
+ *  Intended for hashed_unique point lookup indices next to (or instead of) an
+ *  ordered_unique one:
+ *
+ *  @code
+ *  hashed_unique<tag<by_external_id>,
+ *      member<research_object, external_id_type, &research_object::external_id>,
+ *      chainbase::fixed_width_hash<external_id_type>>
+ *  @endcode
+ *
+ *  The bucket array is allocated from the segment like the nodes, and generic_index keeps
+ *  every index of the container in sync on emplace/modify/remove and on undo, so such an
+ *  index is shared memory safe and undo aware. Its iteration order is not deterministic
+ *  though: use it for find()/count() only, never to walk objects in consensus code.
+ */
+template <typename Key> struct fixed_width_hash
+{
+    std::size_t operator()(const Key& key) const
+    {
+        // FNV-1a
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key);
+
+        uint64_t hash = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < sizeof(Key); ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+} // namespace chainbase
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <chainbase/chainbase.hpp>
+
+#include <boost/interprocess/containers/vector.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace chainbase {
+
+/**
+ *  Fixed capacity table of objects addressed by id, for tables which are created once with all
+ *  of their objects and afterwards only modified, like a ring buffer indexed by a sequence
+ *  number modulo Capacity.
+ *
+ *  Used as the index type of an object in place of a multi_index_container:
+ *
+ *  @code
+ *  typedef chainbase::ring_container<block_summary_object, 0x10000> block_summary_index;
+ *  @endcode
+ *
+ *  Objects live in one array in the segment, so a lookup by id is an array access and there are
+ *  no tree nodes. Objects are created in id order, up to Capacity of them, and cannot be removed.
+ *  Undo restores them by assignment, so they must be copy assignable and must not own segment
+ *  memory.
+ */
+template <typename Object, uint32_t Capacity> class ring_container
+{
+public:
+    typedef Object value_type;
+    typedef const value_type* const_iterator;
+    typedef const_iterator iterator;
+    typedef allocator<value_type> allocator_type;
+
+    ring_container(const allocator_type& a)
+        : _slots(a)
+    {
+        _slots.reserve(Capacity);
+    }
+
+    const_iterator begin() const
+    {
+        return _slots.data();
+    }
+
+    const_iterator end() const
+    {
+        return _slots.data() + _slots.size();
+    }
+
+    const_iterator find(const typename value_type::id_type& id) const
+    {
+        if (id._id < 0 || id._id >= int64_t(_slots.size()))
+            return end();
+        return begin() + id._id;
+    }
+
+    size_t size() const
+    {
+        return _slots.size();
+    }
+
+    bool empty() const
+    {
+        return _slots.empty();
+    }
+
+    allocator_type get_allocator() const
+    {
+        return _slots.get_allocator();
+    }
+
+    /**
+     *  There is only the id index, every tag names it. Lets find<ObjectType, by_id> work as it
+     *  does for multi_index_container.
+     */
+    template <typename Tag> const ring_container& get() const
+    {
+        return *this;
+    }
+
+private:
+    template <typename> friend class generic_index;
+
+    bip::vector<value_type, allocator_type> _slots;
+};
+
+/**
+ *  Undo state of a ring_container: the slots created since the state was started are the ones
+ *  past old_size, the modified ones have their value from before the first modification in
+ *  old_values.
+ */
+template <typename value_type> class ring_undo_state
+{
+public:
+    struct old_value
+    {
+        old_value(uint32_t s, int64_t p, const value_type& v)
+            : slot(s)
+            , previous_record(p)
+            , value(v)
+        {
+        }
+
+        uint32_t slot;
+
+        /// revision of the undo state which held the slot's old value before this one
+        int64_t previous_record;
+        value_type value;
+    };
+
+    typedef bip::vector<old_value, allocator<old_value>> old_value_vector;
+
+    template <typename T>
+    ring_undo_state(allocator<T> al)
+        : old_values(allocator<old_value>(al.get_segment_manager()))
+    {
+    }
+
+    old_value_vector old_values;
+    uint32_t old_size = 0;
+    int64_t revision = 0;
+};
+
+/**
+ *  generic_index for a ring_container. Every slot remembers the revision of the newest undo
+ *  state holding its old value, so recording a modification is a comparison and an append
+ *  instead of a map lookup, and squash merges states without searching them.
+ */
+template <typename Object, uint32_t Capacity> class generic_index<ring_container<Object, Capacity>>
+{
+public:
+    typedef bip::managed_mapped_file::segment_manager segment_manager_type;
+    typedef ring_container<Object, Capacity> index_type;
+    typedef Object value_type;
+    typedef bip::allocator<generic_index, segment_manager_type> allocator_type;
+    typedef ring_undo_state<value_type> undo_state_type;
+    typedef index_session<generic_index> session;
+
+    generic_index(allocator<value_type> a)
+        : _stack(a)
+        , _indices(a)
+        , _records(a)
+        , _size_of_value_type(sizeof(value_type))
+        , _size_of_this(sizeof(*this))
+    {
+        _records.reserve(Capacity);
+    }
+
+    void validate() const
+    {
+        if (sizeof(value_type) != _size_of_value_type || sizeof(*this) != _size_of_this)
+            BOOST_THROW_EXCEPTION(std::runtime_error("content of memory does not match data expected by executable"));
+    }
+
+    template <typename Constructor> const value_type& emplace(Constructor&& c)
+    {
+        if (_indices._slots.size() >= Capacity)
+            BOOST_THROW_EXCEPTION(std::logic_error("could not insert object, the ring index is full"));
+
+        const typename value_type::id_type new_id = _indices._slots.size();
+
+        auto constructor = [&](value_type& v) {
+            v.id = new_id;
+            c(v);
+        };
+
+        _indices._slots.emplace_back(constructor, _indices.get_allocator());
+        _records.push_back(int64_t(no_record));
+        return _indices._slots.back();
+    }
+
+    template <typename Modifier> void modify(const value_type& obj, Modifier&& m)
+    {
+        const uint32_t slot = slot_of(obj);
+
+        on_modify(slot);
+        ++_mutation_count;
+
+        value_type& v = _indices._slots[slot];
+        m(v);
+
+        if (v.id != obj.id)
+            BOOST_THROW_EXCEPTION(std::logic_error("Could not modify object, the id of a ring index object cannot change"));
+    }
+
+    void remove(const value_type&)
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error("ring index objects cannot be removed"));
+    }
+
+    template <typename CompatibleKey> const value_type* find(CompatibleKey&& key) const
+    {
+        auto itr = _indices.find(std::forward<CompatibleKey>(key));
+        if (itr != _indices.end())
+            return &*itr;
+        return nullptr;
+    }
+
+    template <typename CompatibleKey> const value_type& get(CompatibleKey&& key) const
+    {
+        auto ptr = find(key);
+        if (!ptr)
+            BOOST_THROW_EXCEPTION(std::out_of_range("key not found"));
+        return *ptr;
+    }
+
+    const index_type& indices() const
+    {
+        return _indices;
+    }
+
+    const index_type& indicies() const
+    {
+        return _indices;
+    }
+
+    session start_undo_session(bool enabled)
+    {
+        if (enabled)
+        {
+            _stack.emplace_back(_indices.get_allocator());
+            _stack.back().old_size = _indices.size();
+            _stack.back().revision = ++_revision;
+            return session(*this, _revision);
+        }
+        else
+        {
+            return session(*this, -1);
+        }
+    }
+
+    int64_t revision() const
+    {
+        return _revision;
+    }
+
+    uint64_t mutation_count() const
+    {
+        return _mutation_count;
+    }
+
+    void get_head_changes(std::vector<object_change>& changes) const
+    {
+        if (!enabled())
+            return;
+
+        const auto& head = _stack.back();
+        const uint16_t type_id = value_type::type_id;
+
+        for (size_t slot = head.old_size; slot < _indices.size(); ++slot)
+            changes.emplace_back(type_id, int64_t(slot), object_change::created);
+
+        for (const auto& item : head.old_values)
+            changes.emplace_back(type_id, int64_t(item.slot), object_change::modified);
+    }
+
+    const value_type* find_head_removed(const typename value_type::id_type&) const
+    {
+        return nullptr;
+    }
+
+    void undo()
+    {
+        if (!enabled())
+            return;
+
+        const auto& head = _stack.back();
+        ++_mutation_count;
+
+        for (const auto& item : head.old_values)
+        {
+            _indices._slots[item.slot] = item.value;
+            _records[item.slot] = item.previous_record;
+        }
+
+        _indices._slots.erase(_indices._slots.begin() + head.old_size, _indices._slots.end());
+        _records.erase(_records.begin() + head.old_size, _records.end());
+
+        _stack.pop_back();
+        --_revision;
+    }
+
+    /**
+     *  Merges the head undo state into the previous one, see generic_index::squash. Of a slot
+     *  modified in both states the previous state keeps its older value, a slot created in the
+     *  previous state needs no old value at all.
+     */
+    void squash()
+    {
+        if (!enabled())
+            return;
+        if (_stack.size() == 1)
+        {
+            _stack.pop_front();
+            return;
+        }
+
+        auto& state = _stack.back();
+        auto& prev_state = _stack[_stack.size() - 2];
+
+        for (auto& item : state.old_values)
+        {
+            if (item.slot >= prev_state.old_size || item.previous_record == prev_state.revision)
+            {
+                _records[item.slot] = item.previous_record;
+                continue;
+            }
+
+            _records[item.slot] = prev_state.revision;
+            prev_state.old_values.push_back(std::move(item));
+        }
+
+        _stack.pop_back();
+        --_revision;
+    }
+
+    void commit(int64_t revision)
+    {
+        while (_stack.size() && _stack[0].revision <= revision)
+        {
+            _stack.pop_front();
+        }
+    }
+
+    void undo_all()
+    {
+        while (enabled())
+            undo();
+    }
+
+    void set_revision(int64_t revision)
+    {
+        if (_stack.size() != 0)
+            BOOST_THROW_EXCEPTION(std::logic_error("cannot set revision while there is an existing undo stack"));
+        _revision = revision;
+
+        // records of discarded states could collide with the revisions of new ones
+        std::fill(_records.begin(), _records.end(), int64_t(no_record));
+    }
+
+    void remove_object(int64_t)
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error("ring index objects cannot be removed"));
+    }
+
+private:
+    static constexpr int64_t no_record = std::numeric_limits<int64_t>::min();
+
+    bool enabled() const
+    {
+        return _stack.size();
+    }
+
+    uint32_t slot_of(const value_type& obj) const
+    {
+        const auto itr = _indices.find(obj.id);
+        if (itr != &obj)
+            BOOST_THROW_EXCEPTION(std::logic_error("object does not belong to this ring index"));
+        return uint32_t(obj.id._id);
+    }
+
+    void on_modify(uint32_t slot)
+    {
+        if (!enabled())
+            return;
+
+        auto& head = _stack.back();
+
+        if (slot >= head.old_size || _records[slot] == head.revision)
+            return;
+
+        head.old_values.emplace_back(slot, _records[slot], _indices._slots[slot]);
+        _records[slot] = head.revision;
+    }
+
+    boost::interprocess::deque<undo_state_type, allocator<undo_state_type>> _stack;
+
+    int64_t _revision = 0;
+    uint64_t _mutation_count = 0;
+    index_type _indices;
+
+    /// revision of the newest undo state holding the old value of each slot
+    bip::vector<int64_t, allocator<int64_t>> _records;
+
+    uint32_t _size_of_value_type = 0;
+    uint32_t _size_of_this = 0;
+};
+
+} // namespace chainbase
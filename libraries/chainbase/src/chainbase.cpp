@@ -1,8 +1,14 @@
 #include <chainbase/chainbase.hpp>
 #include <boost/array.hpp>
 
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
 namespace chainbase {
 
 struct environment_check
@@ -89,6 +95,14 @@ void database::open(const bfs::path& dir, uint32_t flags, uint64_t shared_file_s
         _segment->find_or_construct<environment_check>("environment")();
     }
 
+    _interrupted_write = false;
+    _write_marker = nullptr;
+    if (write)
+    {
+        _write_marker = _segment->find_or_construct<write_marker>("write_marker")();
+        _interrupted_write = _write_marker->writing;
+    }
+
     abs_path = bfs::absolute(dir / "shared_memory.meta");
 
     if (bfs::exists(abs_path))
@@ -123,8 +137,23 @@ void database::flush()
         _meta->flush();
 }
 
+void database::sync()
+{
+#ifdef WIN32
+    flush();
+#else
+    for (const auto* file : { _segment.get(), _meta.get() })
+    {
+        if (file && ::msync(file->get_address(), file->get_size(), MS_SYNC) != 0)
+            BOOST_THROW_EXCEPTION(
+                std::runtime_error("could not sync database file in " + _data_dir.native() + ": " + std::strerror(errno)));
+    }
+#endif
+}
+
 void database::close()
 {
+    _write_marker = nullptr;
     _segment.reset();
     _meta.reset();
     _data_dir = bfs::path();
@@ -132,6 +161,7 @@ void database::close()
 
 void database::wipe(const bfs::path& dir)
 {
+    _write_marker = nullptr;
     _segment.reset();
     _meta.reset();
     bfs::remove_all(dir / "shared_memory.bin");
@@ -141,6 +171,42 @@ void database::wipe(const bfs::path& dir)
     _index_map.clear();
 }
 
+read_write_mutex& database::acquire_write_lock(uint64_t wait_micro)
+{
+    read_write_mutex* mutex = &_rw_manager->current_lock();
+
+    if (!wait_micro)
+    {
+        mutex->lock();
+        return *mutex;
+    }
+
+    while (!mutex->timed_lock(boost::posix_time::microsec_clock::universal_time()
+                              + boost::posix_time::microseconds(wait_micro)))
+    {
+        _rw_manager->next_lock();
+        std::cerr << "Lock timeout, moving to lock " << _rw_manager->current_lock_num() << std::endl;
+        mutex = &_rw_manager->current_lock();
+    }
+
+    return *mutex;
+}
+
+lock_stats database::get_lock_stats() const
+{
+    lock_stats stats;
+
+    stats.write_locks = _write_wait.count();
+    stats.write_wait_us = _write_wait.total();
+    stats.max_write_wait_us = _write_wait.max();
+
+    stats.read_locks = _read_hold.count();
+    stats.read_hold_us = _read_hold.total();
+    stats.max_read_hold_us = _read_hold.max();
+
+    return stats;
+}
+
 void database::set_require_locking(bool enable_require_locking)
 {
     _enable_require_locking = enable_require_locking;
@@ -186,6 +252,14 @@ void database::undo_all()
     }
 }
 
+void database::get_head_changes(std::vector<object_change>& changes) const
+{
+    for (const auto& item : _index_list)
+    {
+        item->get_head_changes(changes);
+    }
+}
+
 database::session database::start_undo_session(bool enabled)
 {
     if (enabled)
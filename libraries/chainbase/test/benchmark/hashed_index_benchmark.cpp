@@ -0,0 +1,153 @@
+/**
+ *  Compares point lookup throughput of an ordered_unique and a hashed_unique index over
+ *  40 byte fixed string keys (the layout of deip external ids) held in chainbase.
+ *
+ *  usage: chainbase_hashed_index_benchmark [objects=1000000] [lookups=1000000]
+ *
+ *  Prints one "name value unit" line per measurement.
+ */
+
+#include <chainbase/chainbase.hpp>
+#include <chainbase/hashed_index.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/fixed_string.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace boost::multi_index;
+
+typedef fc::fixed_string_40 key_type;
+
+struct by_key;
+
+struct ordered_entry : public chainbase::object<0, ordered_entry>
+{
+    template <typename Constructor, typename Allocator> ordered_entry(Constructor&& c, Allocator&&)
+    {
+        c(*this);
+    }
+
+    id_type id;
+    key_type key;
+};
+
+struct hashed_entry : public chainbase::object<1, hashed_entry>
+{
+    template <typename Constructor, typename Allocator> hashed_entry(Constructor&& c, Allocator&&)
+    {
+        c(*this);
+    }
+
+    id_type id;
+    key_type key;
+};
+
+typedef multi_index_container<ordered_entry,
+                              indexed_by<ordered_unique<member<ordered_entry, ordered_entry::id_type, &ordered_entry::id>>,
+                                         ordered_unique<tag<by_key>, member<ordered_entry, key_type, &ordered_entry::key>>>,
+                              chainbase::allocator<ordered_entry>>
+    ordered_entry_index;
+
+typedef multi_index_container<hashed_entry,
+                              indexed_by<ordered_unique<member<hashed_entry, hashed_entry::id_type, &hashed_entry::id>>,
+                                         hashed_unique<tag<by_key>,
+                                                       member<hashed_entry, key_type, &hashed_entry::key>,
+                                                       chainbase::fixed_width_hash<key_type>>>,
+                              chainbase::allocator<hashed_entry>>
+    hashed_entry_index;
+
+CHAINBASE_SET_INDEX_TYPE(ordered_entry, ordered_entry_index)
+CHAINBASE_SET_INDEX_TYPE(hashed_entry, hashed_entry_index)
+
+namespace {
+
+class benchmark_database : public chainbase::database
+{
+};
+
+key_type make_key(uint64_t n)
+{
+    // external ids are hex digests
+    return key_type(fc::ripemd160::hash(std::to_string(n)).str());
+}
+
+template <typename Index>
+double measure_lookups(const chainbase::database& db, const std::vector<key_type>& probes, uint64_t& found)
+{
+    const auto& idx = db.get_index<Index>().indices().template get<by_key>();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& key : probes)
+        found += idx.count(key);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const uint64_t objects = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const uint64_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        benchmark_database db;
+        db.open(temp, chainbase::database::read_write, 1024ull * 1024 * 1024 * 2);
+        db.add_index<ordered_entry_index>();
+        db.add_index<hashed_entry_index>();
+
+        for (uint64_t i = 0; i < objects; ++i)
+        {
+            const key_type key = make_key(i);
+            db.create<ordered_entry>([&](ordered_entry& e) { e.key = key; });
+            db.create<hashed_entry>([&](hashed_entry& e) { e.key = key; });
+        }
+
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<uint64_t> pick(0, objects - 1);
+
+        std::vector<key_type> probes;
+        probes.reserve(lookups);
+        for (uint64_t i = 0; i < lookups; ++i)
+            probes.push_back(make_key(pick(rng)));
+
+        uint64_t ordered_found = 0;
+        uint64_t hashed_found = 0;
+        const double ordered_sec = measure_lookups<ordered_entry_index>(db, probes, ordered_found);
+        const double hashed_sec = measure_lookups<hashed_entry_index>(db, probes, hashed_found);
+
+        if (ordered_found != lookups || hashed_found != lookups)
+        {
+            std::cerr << "lookup mismatch: ordered " << ordered_found << ", hashed " << hashed_found << "\n";
+            chainbase::bfs::remove_all(temp);
+            return 1;
+        }
+
+        std::cout << "objects " << objects << " count\n";
+        std::cout << "lookups " << lookups << " count\n";
+        std::cout << "ordered_unique_lookup " << lookups / ordered_sec << " ops/s\n";
+        std::cout << "hashed_unique_lookup " << lookups / hashed_sec << " ops/s\n";
+        std::cout << "speedup " << ordered_sec / hashed_sec << " x\n";
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+
+    chainbase::bfs::remove_all(temp);
+    return 0;
+}
@@ -2,12 +2,25 @@
 
 #include <boost/test/unit_test.hpp>
 #include <chainbase/chainbase.hpp>
+#include <chainbase/hashed_index.hpp>
+#include <chainbase/ring_index.hpp>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/member.hpp>
 
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using namespace boost::multi_index;
 
@@ -35,6 +48,63 @@ typedef multi_index_container<book,
 
 CHAINBASE_SET_INDEX_TYPE(book, book_index)
 
+struct by_isbn;
+
+struct catalog_entry : public chainbase::object<1, catalog_entry>
+{
+    template <typename Constructor, typename Allocator> catalog_entry(Constructor&& c, Allocator&& a)
+    {
+        c(*this);
+    }
+
+    id_type id;
+    uint64_t isbn = 0;
+};
+
+typedef multi_index_container<catalog_entry,
+                              indexed_by<ordered_unique<member<catalog_entry, catalog_entry::id_type, &catalog_entry::id>>,
+                                         hashed_unique<tag<by_isbn>,
+                                                       member<catalog_entry, uint64_t, &catalog_entry::isbn>,
+                                                       chainbase::fixed_width_hash<uint64_t>>>,
+                              chainbase::allocator<catalog_entry>>
+    catalog_entry_index;
+
+CHAINBASE_SET_INDEX_TYPE(catalog_entry, catalog_entry_index)
+
+struct ring_slot : public chainbase::object<2, ring_slot>
+{
+    template <typename Constructor, typename Allocator> ring_slot(Constructor&& c, Allocator&& a)
+    {
+        c(*this);
+    }
+
+    id_type id;
+    uint64_t value = 0;
+};
+
+typedef chainbase::ring_container<ring_slot, 16> ring_slot_index;
+
+CHAINBASE_SET_INDEX_TYPE(ring_slot, ring_slot_index)
+
+/// same table in an ordinary index, to check ring_slot_index against
+struct shadow_slot : public chainbase::object<3, shadow_slot>
+{
+    template <typename Constructor, typename Allocator> shadow_slot(Constructor&& c, Allocator&& a)
+    {
+        c(*this);
+    }
+
+    id_type id;
+    uint64_t value = 0;
+};
+
+typedef multi_index_container<shadow_slot,
+                              indexed_by<ordered_unique<member<shadow_slot, shadow_slot::id_type, &shadow_slot::id>>>,
+                              chainbase::allocator<shadow_slot>>
+    shadow_slot_index;
+
+CHAINBASE_SET_INDEX_TYPE(shadow_slot, shadow_slot_index)
+
 class moc_database : public chainbase::database
 {
     typedef chainbase::database _Base;
@@ -151,4 +221,486 @@ BOOST_AUTO_TEST_CASE(open_and_create)
     }
 }
 
+BOOST_AUTO_TEST_CASE(head_changes)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        moc_database db;
+        db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+        db.add_index<book_index>();
+
+        const auto& kept = db.create<book>([](book& b) { b.a = 1; });
+        const auto& removed = db.create<book>([](book& b) { b.a = 2; });
+        const book::id_type removed_id = removed.id;
+
+        std::vector<chainbase::object_change> changes;
+        db.get_head_changes(changes);
+        BOOST_REQUIRE(changes.empty()); ///< nothing is tracked without a session
+
+        {
+            auto session = db.start_undo_session(true);
+            db.modify(kept, [](book& b) { b.a = 3; });
+            db.remove(removed);
+            const auto& added = db.create<book>([](book& b) { b.a = 4; });
+            db.modify(added, [](book& b) { b.a = 5; });
+
+            db.get_head_changes(changes);
+            BOOST_REQUIRE_EQUAL(changes.size(), 3u);
+
+            BOOST_CHECK(changes[0].type == chainbase::object_change::created);
+            BOOST_CHECK_EQUAL(changes[0].id, added.id._id);
+            BOOST_CHECK(changes[1].type == chainbase::object_change::modified);
+            BOOST_CHECK_EQUAL(changes[1].id, kept.id._id);
+            BOOST_CHECK(changes[2].type == chainbase::object_change::removed);
+            BOOST_CHECK_EQUAL(changes[2].id, removed_id._id);
+
+            const auto& idx = db.get_index<book_index>();
+            const book* last_value = idx.find_head_removed(removed_id);
+            BOOST_REQUIRE(last_value != nullptr);
+            BOOST_CHECK_EQUAL(last_value->a, 2);
+            BOOST_CHECK(idx.find_head_removed(kept.id) == nullptr);
+        }
+
+        chainbase::bfs::remove_all(temp);
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reserved_ids)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        moc_database db;
+        db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+        db.add_index<book_index>();
+        auto& idx = db.get_mutable_index<book_index>();
+
+        db.create<book>([](book& b) { b.a = 0; });
+        BOOST_CHECK_EQUAL(idx.reserve_ids(3)._id, 1);
+        BOOST_CHECK_EQUAL(db.create<book>([](book& b) { b.a = 4; }).id._id, 4);
+
+        {
+            auto session = db.start_undo_session(true);
+
+            const auto& reserved = idx.emplace_reserved(book::id_type(2), [](book& b) { b.a = 2; });
+            BOOST_CHECK_EQUAL(reserved.id._id, 2);
+            BOOST_CHECK_EQUAL(reserved.a, 2);
+            BOOST_CHECK_EQUAL(db.create<book>([](book& b) { b.a = 5; }).id._id, 5);
+
+            BOOST_CHECK_THROW(idx.emplace_reserved(book::id_type(2), [](book& b) {}), std::logic_error);
+            BOOST_CHECK_THROW(idx.emplace_reserved(book::id_type(6), [](book& b) {}), std::logic_error);
+        }
+
+        BOOST_CHECK(db.find(book::id_type(2)) == nullptr);
+        BOOST_CHECK_EQUAL(db.create<book>([](book& b) { b.a = 5; }).id._id, 5);
+
+        chainbase::bfs::remove_all(temp);
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hashed_index_undo)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        moc_database db;
+        db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+        db.add_index<catalog_entry_index>();
+
+        const auto& first = db.create<catalog_entry>([](catalog_entry& e) { e.isbn = 100; });
+        const auto& second = db.create<catalog_entry>([](catalog_entry& e) { e.isbn = 200; });
+
+        const auto& idx = db.get_index<catalog_entry_index>().indices().get<by_isbn>();
+        BOOST_CHECK_THROW(db.create<catalog_entry>([](catalog_entry& e) { e.isbn = 100; }), std::logic_error);
+
+        {
+            auto session = db.start_undo_session(true);
+            db.modify(first, [](catalog_entry& e) { e.isbn = 101; });
+            db.remove(second);
+            db.create<catalog_entry>([](catalog_entry& e) { e.isbn = 300; });
+
+            BOOST_CHECK_EQUAL(idx.count(100), 0u);
+            BOOST_CHECK_EQUAL(idx.count(101), 1u);
+            BOOST_CHECK_EQUAL(idx.count(200), 0u);
+            BOOST_CHECK_EQUAL(idx.count(300), 1u);
+        }
+
+        BOOST_CHECK_EQUAL(idx.size(), 2u);
+        BOOST_CHECK(idx.find(100) != idx.end());
+        BOOST_CHECK(idx.find(101) == idx.end());
+        BOOST_CHECK_EQUAL(idx.find(200)->id._id, 1);
+        BOOST_CHECK(idx.find(300) == idx.end());
+
+        chainbase::bfs::remove_all(temp);
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(writer_preferring_lock_stress)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        moc_database db;
+        db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+        db.add_index<book_index>();
+
+        db.with_write_lock([&]() { db.create<book>([](book& b) { b.a = b.b = 0; }); });
+        const auto& shelf = db.get(book::id_type(0));
+
+        const int readers_count = 8;
+        const int writes_count = 200;
+
+        std::atomic<bool> done(false);
+        std::atomic<int> torn_reads(0);
+        std::atomic<uint64_t> reads(0);
+
+        std::vector<std::thread> readers;
+        for (int i = 0; i < readers_count; ++i)
+        {
+            readers.emplace_back([&]() {
+                while (!done.load())
+                {
+                    db.with_read_lock([&]() {
+                        const int a = shelf.a;
+                        std::this_thread::sleep_for(std::chrono::microseconds(200));
+                        if (a != shelf.b)
+                            ++torn_reads;
+                    });
+                    ++reads;
+                }
+            });
+        }
+
+        std::thread writer([&]() {
+            for (int i = 0; i < writes_count; ++i)
+            {
+                db.with_write_lock([&]() {
+                    db.modify(shelf, [](book& b) { ++b.a; });
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    db.modify(shelf, [](book& b) { ++b.b; });
+                });
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+
+        writer.join();
+        done = true;
+        for (auto& reader : readers)
+            reader.join();
+
+        BOOST_CHECK_EQUAL(shelf.a, writes_count);
+        BOOST_CHECK_EQUAL(shelf.b, writes_count);
+        BOOST_CHECK_EQUAL(torn_reads.load(), 0);
+
+        const chainbase::lock_stats stats = db.get_lock_stats();
+        BOOST_TEST_MESSAGE("reads: " << reads.load() << ", max write wait: " << stats.max_write_wait_us
+                                     << "us, max read hold: " << stats.max_read_hold_us << "us");
+
+        BOOST_CHECK_EQUAL(stats.write_locks, uint64_t(writes_count + 1));
+        BOOST_CHECK_EQUAL(stats.read_locks, reads.load());
+        BOOST_CHECK_GE(stats.max_read_hold_us, 200u);
+
+        // readers arriving after the writer wait for it, so it only waits out the reads in progress
+        // and never runs into the lock timeout
+        BOOST_CHECK_LT(stats.max_write_wait_us, 500000u);
+
+        chainbase::bfs::remove_all(temp);
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+}
+
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(killed_writer_is_detected)
+{
+    const int kills = 20;
+    std::mt19937 rng(7);
+
+    int interrupted = 0;
+    int clean = 0;
+
+    for (int kill = 0; kill < kills; ++kill)
+    {
+        boost::filesystem::path temp = boost::filesystem::unique_path();
+        try
+        {
+            int ready[2];
+            BOOST_REQUIRE_EQUAL(::pipe(ready), 0);
+
+            const pid_t pid = ::fork();
+            BOOST_REQUIRE(pid >= 0);
+            if (pid == 0)
+            {
+                // each write adds a book and then moves both counters of the first one, a write cut
+                // short leaves the counters apart. The file is synced all along, as by checkpoints.
+                moc_database db;
+                db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+                db.add_index<book_index>();
+                db.with_write_lock([&]() { db.create<book>([](book& b) { b.a = b.b = 0; }); });
+                const auto& counters = db.get(book::id_type(0));
+
+                std::thread syncer([&]() {
+                    for (;;)
+                        db.sync();
+                });
+                syncer.detach();
+
+                ::close(ready[0]);
+                const char c = 0;
+                if (::write(ready[1], &c, 1) != 1)
+                    ::_exit(1);
+
+                for (int i = 1;; ++i)
+                {
+                    db.with_write_lock([&]() {
+                        db.create<book>([&](book& b) { b.a = b.b = i; });
+                        db.modify(counters, [](book& b) { ++b.a; });
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                        db.modify(counters, [](book& b) { ++b.b; });
+                    });
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+
+            ::close(ready[1]);
+            char c = 0;
+            BOOST_REQUIRE_EQUAL(::read(ready[0], &c, 1), 1);
+            ::close(ready[0]);
+
+            const int delay_us = std::uniform_int_distribution<int>(1000, 20000)(rng);
+            std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+            ::kill(pid, SIGKILL);
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+
+            {
+                moc_database db;
+                db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+                db.add_index<book_index>();
+
+                const bool was_interrupted = db.interrupted_write();
+                if (was_interrupted)
+                {
+                    ++interrupted;
+                }
+                else
+                {
+                    ++clean;
+                    const auto& counters = db.get(book::id_type(0));
+                    BOOST_CHECK_EQUAL(counters.a, counters.b);
+                    BOOST_CHECK_EQUAL(db.get_index<book_index>().indices().size(), size_t(counters.a + 1));
+                }
+
+                // the marker stays until the database is wiped
+                db.close();
+                db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+                BOOST_CHECK_EQUAL(db.interrupted_write(), was_interrupted);
+
+                db.wipe(temp);
+                db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+                BOOST_CHECK(!db.interrupted_write());
+            }
+
+            chainbase::bfs::remove_all(temp);
+        }
+        catch (...)
+        {
+            chainbase::bfs::remove_all(temp);
+            throw;
+        }
+    }
+
+    BOOST_TEST_MESSAGE("kills in a write: " << interrupted << ", between writes: " << clean);
+    BOOST_CHECK_GT(interrupted, 0);
+    BOOST_CHECK_GT(clean, 0);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(ring_index_undo)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        moc_database db;
+        db.open(temp, chainbase::database::read_write, 1024 * 1024 * 8);
+        db.add_index<ring_slot_index>();
+
+        for (uint64_t i = 0; i < 8; ++i)
+            db.create<ring_slot>([&](ring_slot& s) { s.value = i; });
+
+        const auto& idx = db.get_index<ring_slot_index>().indices();
+        const auto& first = db.get(ring_slot::id_type(0));
+        const auto& second = db.get(ring_slot::id_type(1));
+
+        BOOST_CHECK_EQUAL(idx.size(), 8u);
+        BOOST_CHECK(idx.find(ring_slot::id_type(8)) == idx.end());
+        BOOST_CHECK_THROW(db.remove(first), std::logic_error);
+
+        {
+            auto block = db.start_undo_session(true);
+            db.modify(first, [](ring_slot& s) { s.value = 100; });
+
+            {
+                auto trx = db.start_undo_session(true);
+                db.modify(first, [](ring_slot& s) { s.value = 101; });
+                db.modify(second, [](ring_slot& s) { s.value = 200; });
+                const auto& created = db.create<ring_slot>([](ring_slot& s) { s.value = 800; });
+                db.modify(created, [](ring_slot& s) { s.value = 801; });
+
+                std::vector<chainbase::object_change> changes;
+                db.get_head_changes(changes);
+                BOOST_REQUIRE_EQUAL(changes.size(), 3u);
+                BOOST_CHECK(changes[0].type == chainbase::object_change::created);
+                BOOST_CHECK_EQUAL(changes[0].id, 8);
+                BOOST_CHECK(changes[1].type == chainbase::object_change::modified);
+                BOOST_CHECK_EQUAL(changes[1].id, 0);
+                BOOST_CHECK(changes[2].type == chainbase::object_change::modified);
+                BOOST_CHECK_EQUAL(changes[2].id, 1);
+
+                trx.squash();
+            }
+
+            BOOST_CHECK_EQUAL(first.value, 101u);
+            BOOST_CHECK_EQUAL(second.value, 200u);
+            BOOST_CHECK_EQUAL(idx.size(), 9u);
+
+            {
+                auto trx = db.start_undo_session(true);
+                db.modify(second, [](ring_slot& s) { s.value = 201; });
+            }
+
+            BOOST_CHECK_EQUAL(second.value, 200u);
+        }
+
+        // undoing the squashed session restores the values from before the first modification
+        BOOST_CHECK_EQUAL(first.value, 0u);
+        BOOST_CHECK_EQUAL(second.value, 1u);
+        BOOST_CHECK_EQUAL(idx.size(), 8u);
+
+        for (uint64_t i = 8; i < 16; ++i)
+            db.create<ring_slot>([&](ring_slot& s) { s.value = i; });
+        BOOST_CHECK_THROW(db.create<ring_slot>([](ring_slot&) {}), std::logic_error);
+
+        chainbase::bfs::remove_all(temp);
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ring_index_matches_generic_index)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    try
+    {
+        moc_database db;
+        db.open(temp, chainbase::database::read_write, 1024 * 1024 * 32);
+        db.add_index<ring_slot_index>();
+        db.add_index<shadow_slot_index>();
+
+        for (uint64_t i = 0; i < 12; ++i)
+        {
+            db.create<ring_slot>([&](ring_slot& s) { s.value = i; });
+            db.create<shadow_slot>([&](shadow_slot& s) { s.value = i; });
+        }
+
+        auto check_equal = [&]() {
+            const auto& ring = db.get_index<ring_slot_index>().indices();
+            const auto& shadow = db.get_index<shadow_slot_index>().indices();
+            BOOST_REQUIRE_EQUAL(ring.size(), shadow.size());
+
+            auto shadow_itr = shadow.begin();
+            for (const ring_slot& s : ring)
+            {
+                BOOST_REQUIRE_EQUAL(s.id._id, shadow_itr->id._id);
+                BOOST_REQUIRE_EQUAL(s.value, shadow_itr->value);
+                ++shadow_itr;
+            }
+        };
+
+        // blocks of transactions: modifications and the remaining creations in nested sessions
+        // which are squashed, undone or pushed and committed in random order
+        std::mt19937 rng(42);
+        std::deque<chainbase::database::session> sessions;
+
+        for (uint32_t step = 0; step < 5000; ++step)
+        {
+            const uint32_t action = rng() % 10;
+            if (action < 5)
+            {
+                const int64_t id = rng() % db.get_index<ring_slot_index>().indices().size();
+                const uint64_t value = rng();
+                db.modify(db.get(ring_slot::id_type(id)), [&](ring_slot& s) { s.value = value; });
+                db.modify(db.get(shadow_slot::id_type(id)), [&](shadow_slot& s) { s.value = value; });
+            }
+            else if (action == 5 && db.get_index<ring_slot_index>().indices().size() < 16)
+            {
+                const uint64_t value = rng();
+                db.create<ring_slot>([&](ring_slot& s) { s.value = value; });
+                db.create<shadow_slot>([&](shadow_slot& s) { s.value = value; });
+            }
+            else if (action == 6 && sessions.size() < 4)
+            {
+                sessions.emplace_back(db.start_undo_session(true));
+            }
+            else if (action == 7 && !sessions.empty())
+            {
+                sessions.back().squash();
+                sessions.pop_back();
+            }
+            else if (action == 8 && !sessions.empty())
+            {
+                sessions.back().undo();
+                sessions.pop_back();
+            }
+            else if (action == 9 && !sessions.empty())
+            {
+                const int64_t revision = sessions.front().revision();
+                sessions.front().push();
+                sessions.pop_front();
+                if (rng() % 2)
+                    db.commit(revision);
+            }
+
+            check_equal();
+        }
+
+        while (!sessions.empty())
+        {
+            sessions.back().undo();
+            sessions.pop_back();
+        }
+        db.undo_all();
+        check_equal();
+
+        chainbase::bfs::remove_all(temp);
+    }
+    catch (...)
+    {
+        chainbase::bfs::remove_all(temp);
+        throw;
+    }
+}
+
 // BOOST_AUTO_TEST_SUITE_END()
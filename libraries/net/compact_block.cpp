@@ -0,0 +1,59 @@
+#include <graphene/net/compact_block.hpp>
+
+namespace graphene {
+namespace net {
+
+compact_block_builder::compact_block_builder(const compact_block_message& compact_block,
+                                             const transaction_lookup_type& find_transaction)
+{
+    static_cast<signed_block_header&>(_block) = compact_block.header;
+
+    const auto& short_ids = compact_block.short_transaction_ids;
+    _block.transactions.resize(short_ids.size());
+    for (uint32_t i = 0; i < short_ids.size(); ++i)
+    {
+        fc::optional<signed_transaction> trx = find_transaction(short_ids[i]);
+        if (trx)
+            _block.transactions[i] = std::move(*trx);
+        else
+            _missing_transaction_indexes.push_back(i);
+    }
+
+    _fetched_all_transactions = _missing_transaction_indexes.size() == short_ids.size();
+
+    if (is_complete())
+        verify_merkle_root();
+}
+
+get_block_transactions_message compact_block_builder::get_missing_transactions() const
+{
+    return get_block_transactions_message(get_block_id(), _missing_transaction_indexes);
+}
+
+bool compact_block_builder::add_transactions(const block_transactions_message& block_transactions)
+{
+    const auto& transactions = block_transactions.transactions;
+    if (block_transactions.block_id != get_block_id() || transactions.size() != _missing_transaction_indexes.size())
+        return false;
+
+    for (size_t i = 0; i < transactions.size(); ++i)
+        _block.transactions[_missing_transaction_indexes[i]] = transactions[i];
+
+    _missing_transaction_indexes.clear();
+    verify_merkle_root();
+    return true;
+}
+
+void compact_block_builder::verify_merkle_root()
+{
+    // all transactions came from the peer, a mismatch is for the block check to reject
+    if (_fetched_all_transactions || _block.calculate_merkle_root() == _block.transaction_merkle_root)
+        return;
+
+    // short id collision, don't trust anything from our cache
+    for (uint32_t i = 0; i < _block.transactions.size(); ++i)
+        _missing_transaction_indexes.push_back(i);
+    _fetched_all_transactions = true;
+}
+}
+} // graphene::net
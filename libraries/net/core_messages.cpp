@@ -28,6 +28,10 @@ namespace net {
 
 const core_message_type_enum trx_message::type = core_message_type_enum::trx_message_type;
 const core_message_type_enum block_message::type = core_message_type_enum::block_message_type;
+const core_message_type_enum compact_block_message::type = core_message_type_enum::compact_block_message_type;
+const core_message_type_enum get_block_transactions_message::type
+    = core_message_type_enum::get_block_transactions_message_type;
+const core_message_type_enum block_transactions_message::type = core_message_type_enum::block_transactions_message_type;
 const core_message_type_enum item_ids_inventory_message::type = core_message_type_enum::item_ids_inventory_message_type;
 const core_message_type_enum blockchain_item_ids_inventory_message::type
     = core_message_type_enum::blockchain_item_ids_inventory_message_type;
@@ -53,5 +57,37 @@ const core_message_type_enum get_current_connections_request_message::type
     = core_message_type_enum::get_current_connections_request_message_type;
 const core_message_type_enum get_current_connections_reply_message::type
     = core_message_type_enum::get_current_connections_reply_message_type;
+
+compact_block_message::compact_block_message(const signed_block& blk)
+    : header(blk)
+{
+    short_transaction_ids.reserve(blk.transactions.size());
+    for (const auto& trx : blk.transactions)
+        short_transaction_ids.push_back(get_short_transaction_id(trx.id()));
+}
+
+block_transactions_message::block_transactions_message(const signed_block& blk,
+                                                       const std::vector<uint32_t>& transaction_indexes)
+    : block_id(blk.id())
+{
+    for (uint32_t index : transaction_indexes)
+    {
+        if (index >= blk.transactions.size())
+            break;
+        transactions.push_back(blk.transactions[index]);
+    }
+}
+
+short_transaction_id_type compact_block_message::get_short_transaction_id(const transaction_id_type& trx_id)
+{
+    // byte order independent, peers must agree on it
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(trx_id.data());
+
+    short_transaction_id_type short_id = 0;
+    for (size_t i = 0; i < sizeof(short_transaction_id_type); ++i)
+        short_id = (short_id << 8) | bytes[i];
+
+    return short_id;
+}
 }
 } // graphene::net
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <graphene/net/core_messages.hpp>
+
+#include <fc/optional.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace graphene {
+namespace net {
+
+/**
+ *  Rebuilds a block from a compact_block_message and the transactions the node already
+ *  holds, see compact_block_message.
+ *
+ *  Transactions the lookup can't provide are requested from the sending peer with
+ *  get_missing_transactions(). Once every transaction is in place the block is checked
+ *  against the header's merkle root. On a mismatch (a short id collision with a cached
+ *  transaction) nothing from the cache is trusted anymore and all transactions are
+ *  requested again, so the block is rebuilt as if it was fetched in full.
+ */
+class compact_block_builder
+{
+public:
+    typedef std::function<fc::optional<signed_transaction>(short_transaction_id_type)> transaction_lookup_type;
+
+    compact_block_builder(const compact_block_message& compact_block, const transaction_lookup_type& find_transaction);
+
+    /// the rebuilt block, valid once is_complete()
+    const signed_block& get_block() const
+    {
+        return _block;
+    }
+
+    block_id_type get_block_id() const
+    {
+        return _block.id();
+    }
+
+    bool is_complete() const
+    {
+        return _missing_transaction_indexes.empty();
+    }
+
+    get_block_transactions_message get_missing_transactions() const;
+
+    /**
+     *  Fills in the transactions the peer sent for get_missing_transactions().
+     *  Returns false if they don't answer that request, the block is left unchanged then.
+     */
+    bool add_transactions(const block_transactions_message& block_transactions);
+
+private:
+    void verify_merkle_root();
+
+    signed_block _block;
+    std::vector<uint32_t> _missing_transaction_indexes;
+    bool _fetched_all_transactions = false;
+};
+}
+} // graphene::net
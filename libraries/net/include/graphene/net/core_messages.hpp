@@ -44,6 +44,7 @@ using deip::protocol::signed_transaction;
 using deip::protocol::block_id_type;
 using deip::protocol::transaction_id_type;
 using deip::protocol::signed_block;
+using deip::protocol::signed_block_header;
 
 typedef fc::ecc::public_key_data node_id_t;
 typedef fc::ripemd160 item_hash_t;
@@ -83,6 +84,9 @@ enum core_message_type_enum
     check_firewall_reply_message_type = 5015,
     get_current_connections_request_message_type = 5016,
     get_current_connections_reply_message_type = 5017,
+    compact_block_message_type = 5018,
+    get_block_transactions_message_type = 5019,
+    block_transactions_message_type = 5020,
     core_message_type_last = 5099
 };
 
@@ -115,6 +119,57 @@ struct block_message
     block_id_type block_id;
 };
 
+typedef uint64_t short_transaction_id_type;
+
+/**
+ *  A block as it is relayed to peers which announced compact block support: the signed
+ *  header and a short id for each transaction. Peers have almost always received the
+ *  transactions already as trx_messages and rebuild the block from their message cache,
+ *  asking only for the missing ones with a get_block_transactions_message.
+ *
+ *  Short ids are not collision free. A rebuilt block whose merkle root doesn't match the
+ *  header is fetched again transaction by transaction before it is pushed.
+ */
+struct compact_block_message
+{
+    static const core_message_type_enum type;
+
+    compact_block_message() {}
+    compact_block_message(const signed_block& blk);
+
+    static short_transaction_id_type get_short_transaction_id(const transaction_id_type& trx_id);
+
+    signed_block_header header;
+    std::vector<short_transaction_id_type> short_transaction_ids;
+};
+
+struct get_block_transactions_message
+{
+    static const core_message_type_enum type;
+
+    get_block_transactions_message() {}
+    get_block_transactions_message(const block_id_type& block_id, const std::vector<uint32_t>& transaction_indexes)
+        : block_id(block_id)
+        , transaction_indexes(transaction_indexes)
+    {
+    }
+
+    block_id_type block_id;
+    std::vector<uint32_t> transaction_indexes;
+};
+
+struct block_transactions_message
+{
+    static const core_message_type_enum type;
+
+    block_transactions_message() {}
+    /// answers a get_block_transactions_message, stops at the first index out of the block
+    block_transactions_message(const signed_block& blk, const std::vector<uint32_t>& transaction_indexes);
+
+    block_id_type block_id;
+    std::vector<signed_transaction> transactions; ///< in the order of the requested indexes
+};
+
 struct item_ids_inventory_message
 {
     static const core_message_type_enum type;
@@ -443,10 +498,16 @@ FC_REFLECT_ENUM(
         (check_firewall_reply_message_type)
         (get_current_connections_request_message_type)
         (get_current_connections_reply_message_type)
+        (compact_block_message_type)
+        (get_block_transactions_message_type)
+        (block_transactions_message_type)
         (core_message_type_last))
 
 FC_REFLECT(graphene::net::trx_message, (trx))
 FC_REFLECT(graphene::net::block_message, (block)(block_id))
+FC_REFLECT(graphene::net::compact_block_message, (header)(short_transaction_ids))
+FC_REFLECT(graphene::net::get_block_transactions_message, (block_id)(transaction_indexes))
+FC_REFLECT(graphene::net::block_transactions_message, (block_id)(transactions))
 
 FC_REFLECT(graphene::net::item_id, (item_type)(item_hash))
 FC_REFLECT(graphene::net::item_ids_inventory_message, (item_type)(item_hashes_available))
@@ -81,6 +81,13 @@ public:
         std::vector<fc::uint160_t>& contained_transaction_message_ids)
         = 0;
 
+    /**
+     *  @brief Called as soon as a block arrives through the sync process, before it waits in
+     *         the backlog for handle_block. Lets the client start block local verification
+     *         ahead of application. Must not block.
+     */
+    virtual void prevalidate_sync_block(const graphene::net::block_message& blk_msg) = 0;
+
     /**
      *  @brief Called when a new transaction comes in from the network
      *
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <graphene/net/node.hpp>
+#include <graphene/net/compact_block.hpp>
 #include <graphene/net/peer_database.hpp>
 #include <graphene/net/message_oriented_connection.hpp>
 #include <graphene/net/stcp_socket.hpp>
@@ -274,6 +275,10 @@ public:
 
     item_to_time_map_type items_requested_from_peer; /// items we've requested from this peer during normal operation.
     /// fetch from another peer if this peer disconnects
+
+    bool supports_compact_blocks; /// the peer announced it can rebuild blocks from compact_block_messages
+    std::map<block_id_type, compact_block_builder>
+        compact_blocks_in_progress; /// compact blocks from this peer waiting for a block_transactions_message
     /// @}
 
     // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
@@ -315,6 +320,8 @@ public:
 
     uint64_t get_total_bytes_sent() const;
     uint64_t get_total_bytes_received() const;
+    /// bytes of the messages waiting to be sent to the peer
+    size_t get_queued_messages_size() const;
 
     fc::time_point get_last_message_sent_time() const;
     fc::time_point get_last_message_received_time() const;
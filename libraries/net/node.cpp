@@ -78,6 +78,8 @@
 #include <graphene/net/config.hpp>
 #include <graphene/net/exceptions.hpp>
 
+#include <graphene/utilities/metrics.hpp>
+
 #include <deip/protocol/config.hpp>
 
 #include <fc/git_revision.hpp>
@@ -144,6 +146,9 @@ private:
     struct block_clock_index
     {
     };
+    struct short_transaction_id_index
+    {
+    };
     struct message_info
     {
         message_hash_type message_hash;
@@ -154,17 +159,20 @@ private:
         message_propagation_data propagation_data;
         fc::uint160_t message_contents_hash; // hash of whatever the message contains (if it's a transaction, this is
         // the transaction id, if it's a block, it's the block_id)
+        short_transaction_id_type short_transaction_id; // for transactions only, used to rebuild compact blocks
 
         message_info(const message_hash_type& message_hash,
                      const message& message_body,
                      uint32_t block_clock_when_received,
                      const message_propagation_data& propagation_data,
-                     fc::uint160_t message_contents_hash)
+                     fc::uint160_t message_contents_hash,
+                     short_transaction_id_type short_transaction_id)
             : message_hash(message_hash)
             , message_body(message_body)
             , block_clock_when_received(block_clock_when_received)
             , propagation_data(propagation_data)
             , message_contents_hash(message_contents_hash)
+            , short_transaction_id(short_transaction_id)
         {
         }
     };
@@ -183,7 +191,12 @@ private:
                                                                      bmi::member<message_info,
                                                                                  uint32_t,
                                                                                  &message_info::
-                                                                                     block_clock_when_received>>>>
+                                                                                     block_clock_when_received>>,
+                                             bmi::ordered_non_unique<bmi::tag<short_transaction_id_index>,
+                                                                     bmi::member<message_info,
+                                                                                 short_transaction_id_type,
+                                                                                 &message_info::
+                                                                                     short_transaction_id>>>>
             message_cache_container;
 
     message_cache_container _message_cache;
@@ -199,8 +212,11 @@ public:
     void cache_message(const message& message_to_cache,
                        const message_hash_type& hash_of_message_to_cache,
                        const message_propagation_data& propagation_data,
-                       const fc::uint160_t& message_content_hash);
+                       const fc::uint160_t& message_content_hash,
+                       short_transaction_id_type short_transaction_id = 0);
     message get_message(const message_hash_type& hash_of_message_to_lookup);
+    fc::optional<message> find_message_by_contents_hash(const fc::uint160_t& hash_of_message_contents_to_lookup) const;
+    fc::optional<signed_transaction> find_transaction(short_transaction_id_type short_transaction_id) const;
     message_propagation_data
     get_message_propagation_data(const fc::uint160_t& hash_of_message_contents_to_lookup) const;
     size_t size() const
@@ -221,10 +237,11 @@ void blockchain_tied_message_cache::block_accepted()
 void blockchain_tied_message_cache::cache_message(const message& message_to_cache,
                                                   const message_hash_type& hash_of_message_to_cache,
                                                   const message_propagation_data& propagation_data,
-                                                  const fc::uint160_t& message_content_hash)
+                                                  const fc::uint160_t& message_content_hash,
+                                                  short_transaction_id_type short_transaction_id)
 {
-    _message_cache.insert(
-        message_info(hash_of_message_to_cache, message_to_cache, block_clock, propagation_data, message_content_hash));
+    _message_cache.insert(message_info(hash_of_message_to_cache, message_to_cache, block_clock, propagation_data,
+                                       message_content_hash, short_transaction_id));
 }
 
 message blockchain_tied_message_cache::get_message(const message_hash_type& hash_of_message_to_lookup)
@@ -236,6 +253,28 @@ message blockchain_tied_message_cache::get_message(const message_hash_type& hash
     FC_THROW_EXCEPTION(fc::key_not_found_exception, "Requested message not in cache");
 }
 
+fc::optional<message>
+blockchain_tied_message_cache::find_message_by_contents_hash(const fc::uint160_t& hash_of_message_contents_to_lookup) const
+{
+    auto iter = _message_cache.get<message_contents_hash_index>().find(hash_of_message_contents_to_lookup);
+    if (iter != _message_cache.get<message_contents_hash_index>().end())
+        return iter->message_body;
+    return fc::optional<message>();
+}
+
+fc::optional<signed_transaction>
+blockchain_tied_message_cache::find_transaction(short_transaction_id_type short_transaction_id) const
+{
+    // blocks are cached with a zero short id
+    if (short_transaction_id == 0)
+        return fc::optional<signed_transaction>();
+
+    auto iter = _message_cache.get<short_transaction_id_index>().find(short_transaction_id);
+    if (iter != _message_cache.get<short_transaction_id_index>().end())
+        return iter->message_body.as<trx_message>().trx;
+    return fc::optional<signed_transaction>();
+}
+
 message_propagation_data blockchain_tied_message_cache::get_message_propagation_data(
     const fc::uint160_t& hash_of_message_contents_to_lookup) const
 {
@@ -326,6 +365,7 @@ private:
 #define NODE_DELEGATE_METHOD_NAMES (has_item) \
                                    (handle_message) \
                                    (handle_block) \
+                                   (prevalidate_sync_block) \
                                    (handle_transaction) \
                                    (get_block_ids) \
                                    (get_item) \
@@ -428,6 +468,7 @@ public:
     bool handle_block(const graphene::net::block_message& block_message,
                       bool sync_mode,
                       std::vector<fc::uint160_t>& contained_transaction_message_ids) override;
+    void prevalidate_sync_block(const graphene::net::block_message& block_message) override;
     void handle_transaction(const graphene::net::trx_message& transaction_message) override;
     std::vector<item_hash_t> get_block_ids(const std::vector<item_hash_t>& blockchain_synopsis,
                                            uint32_t& remaining_item_count,
@@ -674,6 +715,7 @@ public:
     void fetch_updated_peer_lists_loop();
     void update_bandwidth_data(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second);
     void bandwidth_monitor_loop();
+    void report_metrics(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second);
     void dump_node_status_task();
 
     bool is_accepting_new_connections();
@@ -726,6 +768,19 @@ public:
     void on_closing_connection_message(peer_connection* originating_peer,
                                        const closing_connection_message& closing_connection_message_received);
 
+    void on_compact_block_message(peer_connection* originating_peer,
+                                  const compact_block_message& compact_block_message_received);
+
+    void on_get_block_transactions_message(peer_connection* originating_peer,
+                                           const get_block_transactions_message& get_block_transactions_message_received);
+
+    void on_block_transactions_message(peer_connection* originating_peer,
+                                       const block_transactions_message& block_transactions_message_received);
+
+    void request_missing_transactions(peer_connection* originating_peer, compact_block_builder&& builder);
+
+    void process_compact_block(peer_connection* originating_peer, const signed_block& rebuilt_block);
+
     void on_current_time_request_message(peer_connection* originating_peer,
                                          const current_time_request_message& current_time_request_message_received);
 
@@ -1773,11 +1828,52 @@ void node_impl::bandwidth_monitor_loop()
     update_bandwidth_data(bytes_read_this_second, bytes_written_this_second);
     _bandwidth_monitor_last_update_time = current_time;
 
+    report_metrics(bytes_read_this_second, bytes_written_this_second);
+
     if (!_node_is_shutting_down && !_bandwidth_monitor_loop_done.canceled())
         _bandwidth_monitor_loop_done = fc::schedule([=]() { bandwidth_monitor_loop(); },
                                                     fc::time_point::now() + fc::seconds(1), "bandwidth_monitor_loop");
 }
 
+void node_impl::report_metrics(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second)
+{
+    VERIFY_CORRECT_THREAD();
+    using graphene::utilities::metrics;
+
+    static graphene::utilities::gauge& active_connections
+        = metrics().get_gauge("deip_p2p_active_connections", "Number of peers the node exchanges items with");
+    static graphene::utilities::gauge& handshaking_connections
+        = metrics().get_gauge("deip_p2p_handshaking_connections", "Number of peers in the connection handshake");
+    static graphene::utilities::gauge& items_to_fetch
+        = metrics().get_gauge("deip_p2p_items_to_fetch", "Number of items waiting to be fetched from peers");
+    static graphene::utilities::gauge& new_inventory
+        = metrics().get_gauge("deip_p2p_new_inventory", "Number of received items not yet advertised to peers");
+    static graphene::utilities::gauge& sync_items
+        = metrics().get_gauge("deip_p2p_sync_items", "Number of received sync blocks waiting to be processed");
+    static graphene::utilities::gauge& message_calls
+        = metrics().get_gauge("deip_p2p_message_calls_in_progress", "Number of messages being handled by the node");
+    static graphene::utilities::gauge& send_queue_bytes
+        = metrics().get_gauge("deip_p2p_send_queue_bytes", "Bytes of messages queued to be sent to active peers");
+    static graphene::utilities::gauge& read_rate
+        = metrics().get_gauge("deip_p2p_read_bytes_per_second", "Bytes read from peers in the last second");
+    static graphene::utilities::gauge& write_rate
+        = metrics().get_gauge("deip_p2p_write_bytes_per_second", "Bytes written to peers in the last second");
+
+    size_t queued_bytes = 0;
+    for (const peer_connection_ptr& peer : _active_connections)
+        queued_bytes += peer->get_queued_messages_size();
+
+    active_connections.set(_active_connections.size());
+    handshaking_connections.set(_handshaking_connections.size());
+    items_to_fetch.set(_items_to_fetch.size());
+    new_inventory.set(_new_inventory.size());
+    sync_items.set(_received_sync_items.size() + _new_received_sync_items.size());
+    message_calls.set(_handle_message_calls_in_progress.size());
+    send_queue_bytes.set(queued_bytes);
+    read_rate.set(bytes_read_this_second);
+    write_rate.set(bytes_written_this_second);
+}
+
 void node_impl::dump_node_status_task()
 {
     VERIFY_CORRECT_THREAD();
@@ -1997,6 +2093,15 @@ void node_impl::on_message(peer_connection* originating_peer, const message& rec
     case core_message_type_enum::block_message_type:
         process_block_message(originating_peer, received_message, message_hash);
         break;
+    case core_message_type_enum::compact_block_message_type:
+        on_compact_block_message(originating_peer, received_message.as<compact_block_message>());
+        break;
+    case core_message_type_enum::get_block_transactions_message_type:
+        on_get_block_transactions_message(originating_peer, received_message.as<get_block_transactions_message>());
+        break;
+    case core_message_type_enum::block_transactions_message_type:
+        on_block_transactions_message(originating_peer, received_message.as<block_transactions_message>());
+        break;
     case core_message_type_enum::current_time_request_message_type:
         on_current_time_request_message(originating_peer, received_message.as<current_time_request_message>());
         break;
@@ -2060,6 +2165,7 @@ fc::variant_object node_impl::generate_hello_user_data()
         user_data["last_known_fork_block_number"] = _hard_fork_block_numbers.back();
 
     user_data["chain_id"] = _chain_id;
+    user_data["compact_blocks"] = true;
 
     return user_data;
 }
@@ -2088,6 +2194,8 @@ void node_impl::parse_hello_user_data_for_peer(peer_connection* originating_peer
         originating_peer->last_known_fork_block_number = user_data["last_known_fork_block_number"].as<uint32_t>();
     if (user_data.contains("chain_id"))
         originating_peer->chain_id = user_data["chain_id"].as<deip::protocol::chain_id_type>();
+    if (user_data.contains("compact_blocks"))
+        originating_peer->supports_compact_blocks = user_data["compact_blocks"].as_bool();
 }
 
 void node_impl::on_hello_message(peer_connection* originating_peer, const hello_message& hello_message_received)
@@ -3017,9 +3125,18 @@ void node_impl::on_fetch_items_message(peer_connection* originating_peer,
             message requested_message = _message_cache.get_message(item_hash);
             dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
                  ("endpoint", originating_peer->get_remote_endpoint())("id", requested_message.id()));
-            reply_messages.push_back(requested_message);
             if (fetch_items_message_received.item_type == block_message_type)
+            {
                 last_block_message_sent = requested_message;
+                // a recent block, the peer most likely has its transactions already
+                if (originating_peer->supports_compact_blocks)
+                {
+                    reply_messages.push_back(
+                        compact_block_message(requested_message.as<graphene::net::block_message>().block));
+                    continue;
+                }
+            }
+            reply_messages.push_back(requested_message);
             continue;
         }
         catch (fc::key_not_found_exception&)
@@ -3065,6 +3182,99 @@ void node_impl::on_fetch_items_message(peer_connection* originating_peer,
     }
 }
 
+void node_impl::on_compact_block_message(peer_connection* originating_peer,
+                                         const compact_block_message& compact_block_message_received)
+{
+    VERIFY_CORRECT_THREAD();
+    compact_block_builder builder(compact_block_message_received, [this](short_transaction_id_type short_id) {
+        return _message_cache.find_transaction(short_id);
+    });
+
+    if (builder.is_complete())
+    {
+        process_compact_block(originating_peer, builder.get_block());
+        return;
+    }
+
+    request_missing_transactions(originating_peer, std::move(builder));
+}
+
+void node_impl::request_missing_transactions(peer_connection* originating_peer, compact_block_builder&& builder)
+{
+    VERIFY_CORRECT_THREAD();
+    const get_block_transactions_message request = builder.get_missing_transactions();
+    dlog("missing ${count} transactions of compact block ${id} from peer ${endpoint}",
+         ("count", request.transaction_indexes.size())("id", request.block_id)(
+             "endpoint", originating_peer->get_remote_endpoint()));
+
+    auto& blocks_in_progress = originating_peer->compact_blocks_in_progress;
+    blocks_in_progress.erase(request.block_id);
+    // ordered by block number, drop blocks the peer never answered for
+    while (blocks_in_progress.size() >= GRAPHENE_NET_MESSAGE_CACHE_DURATION_IN_BLOCKS)
+        blocks_in_progress.erase(blocks_in_progress.begin());
+
+    originating_peer->send_message(request);
+    blocks_in_progress.emplace(request.block_id, std::move(builder));
+}
+
+void node_impl::on_get_block_transactions_message(
+    peer_connection* originating_peer, const get_block_transactions_message& get_block_transactions_message_received)
+{
+    VERIFY_CORRECT_THREAD();
+    block_transactions_message reply;
+    reply.block_id = get_block_transactions_message_received.block_id;
+
+    // we only send compact blocks for blocks in our message cache
+    fc::uint160_t hash_of_block;
+    hash_of_block = get_block_transactions_message_received.block_id;
+    fc::optional<message> cached_block = _message_cache.find_message_by_contents_hash(hash_of_block);
+    if (cached_block)
+        reply = block_transactions_message(cached_block->as<graphene::net::block_message>().block,
+                                           get_block_transactions_message_received.transaction_indexes);
+    else
+        dlog("peer ${endpoint} asked for transactions of block ${id} which is no longer in my cache",
+             ("endpoint", originating_peer->get_remote_endpoint())("id", reply.block_id));
+
+    originating_peer->send_message(reply);
+}
+
+void node_impl::on_block_transactions_message(peer_connection* originating_peer,
+                                              const block_transactions_message& block_transactions_message_received)
+{
+    VERIFY_CORRECT_THREAD();
+    auto iter = originating_peer->compact_blocks_in_progress.find(block_transactions_message_received.block_id);
+    if (iter == originating_peer->compact_blocks_in_progress.end())
+    {
+        wlog("received transactions of block ${id} I didn't ask for from peer ${endpoint}",
+             ("id", block_transactions_message_received.block_id)("endpoint", originating_peer->get_remote_endpoint()));
+        return;
+    }
+
+    compact_block_builder builder = std::move(iter->second);
+    originating_peer->compact_blocks_in_progress.erase(iter);
+
+    if (!builder.add_transactions(block_transactions_message_received))
+    {
+        // the block request will time out and be fetched again
+        wlog("peer ${endpoint} couldn't provide the missing transactions of block ${id}",
+             ("endpoint", originating_peer->get_remote_endpoint())("id", block_transactions_message_received.block_id));
+        return;
+    }
+
+    if (builder.is_complete())
+        process_compact_block(originating_peer, builder.get_block());
+    else
+        request_missing_transactions(originating_peer, std::move(builder));
+}
+
+void node_impl::process_compact_block(peer_connection* originating_peer, const signed_block& rebuilt_block)
+{
+    VERIFY_CORRECT_THREAD();
+    // the rebuilt block_message is identical to the one the peer advertised, so it hashes to the requested item
+    message message_to_process = graphene::net::block_message(rebuilt_block);
+    process_block_message(originating_peer, message_to_process, message_to_process.id());
+}
+
 void node_impl::on_item_not_available_message(peer_connection* originating_peer,
                                               const item_not_available_message& item_not_available_message_received)
 {
@@ -3661,6 +3871,16 @@ void node_impl::process_block_during_sync(peer_connection* originating_peer,
     VERIFY_CORRECT_THREAD();
     dlog("received a sync block from peer ${endpoint}", ("endpoint", originating_peer->get_remote_endpoint()));
 
+    // let the client verify it while the blocks before it are still in the backlog
+    try
+    {
+        _delegate->prevalidate_sync_block(block_message_to_process);
+    }
+    catch (const fc::exception& e)
+    {
+        wlog("Unable to prevalidate sync block: ${e}", ("e", e));
+    }
+
     // add it to the front of _received_sync_items, then process _received_sync_items to try to
     // pass as many messages as possible to the client.
     _new_received_sync_items.push_front(block_message_to_process);
@@ -5300,6 +5520,7 @@ void node_impl::broadcast(const message& item_to_broadcast, const message_propag
 {
     VERIFY_CORRECT_THREAD();
     fc::uint160_t hash_of_message_contents;
+    short_transaction_id_type short_transaction_id = 0;
     if (item_to_broadcast.msg_type == graphene::net::block_message_type)
     {
         graphene::net::block_message block_message_to_broadcast = item_to_broadcast.as<graphene::net::block_message>();
@@ -5310,13 +5531,15 @@ void node_impl::broadcast(const message& item_to_broadcast, const message_propag
     {
         graphene::net::trx_message transaction_message_to_broadcast
             = item_to_broadcast.as<graphene::net::trx_message>();
-        hash_of_message_contents = transaction_message_to_broadcast.trx.id(); // for debugging
+        const transaction_id_type trx_id = transaction_message_to_broadcast.trx.id();
+        hash_of_message_contents = trx_id; // for debugging
+        short_transaction_id = compact_block_message::get_short_transaction_id(trx_id);
         dlog("broadcasting trx: ${trx}", ("trx", transaction_message_to_broadcast));
     }
     message_hash_type hash_of_item_to_broadcast = item_to_broadcast.id();
 
     _message_cache.cache_message(item_to_broadcast, hash_of_item_to_broadcast, propagation_data,
-                                 hash_of_message_contents);
+                                 hash_of_message_contents, short_transaction_id);
     _new_inventory.insert(item_id(item_to_broadcast.msg_type, hash_of_item_to_broadcast));
     trigger_advertise_inventory_loop();
 }
@@ -5874,6 +6097,12 @@ bool statistics_gathering_node_delegate_wrapper::handle_block(
     INVOKE_AND_COLLECT_STATISTICS(handle_block, block_message, sync_mode, contained_transaction_message_ids);
 }
 
+void statistics_gathering_node_delegate_wrapper::prevalidate_sync_block(
+    const graphene::net::block_message& block_message)
+{
+    INVOKE_AND_COLLECT_STATISTICS(prevalidate_sync_block, block_message);
+}
+
 void statistics_gathering_node_delegate_wrapper::handle_transaction(
     const graphene::net::trx_message& transaction_message)
 {
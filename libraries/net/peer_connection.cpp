@@ -88,6 +88,7 @@ peer_connection::peer_connection(peer_connection_delegate* delegate)
     , peer_needs_sync_items_from_us(true)
     , we_need_sync_items_from_peer(true)
     , inhibit_fetching_sync_blocks(false)
+    , supports_compact_blocks(false)
     , transaction_fetching_inhibited_until(fc::time_point::min())
     , last_known_fork_block_number(0)
     , firewall_check_state(nullptr)
@@ -444,6 +445,12 @@ uint64_t peer_connection::get_total_bytes_received() const
     return _message_connection.get_total_bytes_received();
 }
 
+size_t peer_connection::get_queued_messages_size() const
+{
+    VERIFY_CORRECT_THREAD();
+    return _total_queued_messages_size;
+}
+
 fc::time_point peer_connection::get_last_message_sent_time() const
 {
     VERIFY_CORRECT_THREAD();
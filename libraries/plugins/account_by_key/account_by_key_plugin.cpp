@@ -335,8 +335,21 @@ void account_by_key_plugin::plugin_initialize(const boost::program_options::vari
         ilog("Initializing account_by_key plugin");
         chain::database& db = database();
 
-        db.pre_apply_operation.connect([&](const operation_notification& o) { my->pre_operation(o); });
-        db.post_apply_operation.connect([&](const operation_notification& o) { my->post_operation(o); });
+        db.pre_apply_operation_dispatcher.subscribe<create_genesis_account_operation,
+                                                    create_account_operation,
+                                                    update_account_operation,
+                                                    join_research_contract_operation,
+                                                    leave_research_contract_operation,
+                                                    recover_account_operation>(
+            [&](const operation_notification& o) { my->pre_operation(o); });
+        db.post_apply_operation_dispatcher.subscribe<create_genesis_account_operation,
+                                                     create_account_operation,
+                                                     update_account_operation,
+                                                     join_research_contract_operation,
+                                                     leave_research_contract_operation,
+                                                     recover_account_operation,
+                                                     hardfork_operation>(
+            [&](const operation_notification& o) { my->post_operation(o); });
 
         db.add_plugin_index<key_lookup_index>();
         db.add_plugin_index<team_lookup_index>();
@@ -36,36 +36,41 @@ std::shared_ptr<deip::plugin::block_info::block_info_plugin> block_info_api_impl
 
 void block_info_api_impl::get_block_info(const get_block_info_args& args, std::vector<block_info>& result)
 {
-    const std::vector<block_info>& _block_info = get_plugin()->_block_info;
+    const auto plugin = get_plugin();
+    const chain::database& db = plugin->database();
 
     FC_ASSERT(args.start_block_num > 0);
     FC_ASSERT(args.count <= 10000);
-    uint32_t n = std::min(uint32_t(_block_info.size()), args.start_block_num + args.count);
-    for (uint32_t block_num = args.start_block_num; block_num < n; block_num++)
-        result.emplace_back(_block_info[block_num]);
-    return;
+    uint32_t n = std::min(db.head_block_num() + 1, args.start_block_num + args.count);
+    plugin->_block_info.read(args.start_block_num, n, result);
 }
 
 void block_info_api_impl::get_blocks_with_info(const get_block_info_args& args, std::vector<block_with_info>& result)
 {
-    const std::vector<block_info>& _block_info = get_plugin()->_block_info;
-    const chain::database& db = get_plugin()->database();
+    const auto plugin = get_plugin();
+    const chain::database& db = plugin->database();
 
     FC_ASSERT(args.start_block_num > 0);
     FC_ASSERT(args.count <= 10000);
-    uint32_t n = std::min(uint32_t(_block_info.size()), args.start_block_num + args.count);
+    uint32_t n = std::min(db.head_block_num() + 1, args.start_block_num + args.count);
+
+    std::vector<block_info> infos;
+    plugin->_block_info.read(args.start_block_num, n, infos);
+
     uint64_t total_size = 0;
-    for (uint32_t block_num = args.start_block_num; block_num < n; block_num++)
+    for (const block_info& info : infos)
     {
-        uint64_t new_size = total_size + _block_info[block_num].block_size;
-        if ((new_size > 8 * 1024 * 1024) && (block_num != args.start_block_num))
+        uint64_t new_size = total_size + info.block_size;
+        if ((new_size > 8 * 1024 * 1024) && !result.empty())
             break;
+        auto block = db.fetch_block_by_id(info.block_id);
+        if (!block.valid())
+            continue;
         total_size = new_size;
         result.emplace_back();
-        result.back().block = *db.fetch_block_by_number(block_num);
-        result.back().info = _block_info[block_num];
+        result.back().block = *block;
+        result.back().info = info;
     }
-    return;
 }
 
 } // detail
@@ -6,6 +6,8 @@
 #include <deip/plugins/block_info/block_info_api.hpp>
 #include <deip/plugins/block_info/block_info_plugin.hpp>
 
+#include <boost/filesystem/path.hpp>
+
 #include <string>
 
 namespace deip {
@@ -25,10 +27,27 @@ std::string block_info_plugin::plugin_name() const
     return "block_info";
 }
 
+void block_info_plugin::plugin_set_program_options(boost::program_options::options_description& cli,
+                                                   boost::program_options::options_description& cfg)
+{
+    cli.add_options()("block-info-file", boost::program_options::value<boost::filesystem::path>(),
+                      "File to keep block info in (default: <data-dir>/blockchain/block_info.bin)");
+    cfg.add(cli);
+}
+
 void block_info_plugin::plugin_initialize(const boost::program_options::variables_map& options)
 {
     chain::database& db = database();
 
+    fc::path file;
+    if (options.count("block-info-file"))
+        file = options.at("block-info-file").as<boost::filesystem::path>();
+    else
+        file = app().data_dir() / "blockchain" / "block_info.bin";
+
+    // records are written by block number, so a replay refills the file from the block log
+    _block_info.open(file);
+
     _applied_block_conn = db.applied_block.connect([this](const chain::signed_block& b) { on_applied_block(b); });
 }
 
@@ -39,24 +58,22 @@ void block_info_plugin::plugin_startup()
 
 void block_info_plugin::plugin_shutdown()
 {
+    _applied_block_conn.disconnect();
+    _block_info.close();
 }
 
 void block_info_plugin::on_applied_block(const chain::signed_block& b)
 {
-    uint32_t block_num = b.block_num();
     const chain::database& db = database();
-
-    while (block_num >= _block_info.size())
-        _block_info.emplace_back();
-
-    block_info& info = _block_info[block_num];
     const chain::dynamic_global_property_object& dgpo = db.get_dynamic_global_properties();
 
+    block_info info;
     info.block_id = b.id();
     info.block_size = fc::raw::pack_size(b);
     info.aslot = dgpo.current_aslot;
     info.last_irreversible_block_num = dgpo.last_irreversible_block_num;
-    return;
+
+    _block_info.store(b.block_num(), info);
 }
 }
 }
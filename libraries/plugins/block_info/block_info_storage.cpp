@@ -0,0 +1,150 @@
+#include <deip/plugins/block_info/block_info_storage.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace deip {
+namespace plugin {
+namespace block_info {
+
+namespace bip = boost::interprocess;
+
+block_info_storage::~block_info_storage()
+{
+    close();
+}
+
+void block_info_storage::open(const fc::path& file)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    FC_ASSERT(_file.string().empty(), "Block info storage is already open");
+
+    if (!fc::exists(file.parent_path()))
+        fc::create_directories(file.parent_path());
+
+    const bool created = !fc::exists(file) || fc::file_size(file) == 0;
+    if (created)
+    {
+        std::ofstream(file.string(), std::ios::binary | std::ios::trunc);
+        boost::filesystem::resize_file(file.string(), sizeof(file_header) + uint64_t(grow_records) * sizeof(record));
+    }
+
+    _file = file;
+    map();
+
+    file_header& h = header();
+    if (created)
+    {
+        h.magic = magic;
+        h.version = version;
+        h.record_size = sizeof(record);
+        h.capacity = grow_records;
+    }
+    else
+    {
+        FC_ASSERT(h.magic == magic && h.version == version && h.record_size == sizeof(record),
+                  "Block info file ${f} has an incompatible format, remove it to rebuild it on replay", ("f", file));
+        FC_ASSERT(_region.get_size() >= sizeof(file_header) + uint64_t(h.capacity) * sizeof(record),
+                  "Block info file ${f} is truncated, remove it to rebuild it on replay", ("f", file));
+    }
+}
+
+void block_info_storage::close()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_file.string().empty())
+        return;
+
+    _region.flush();
+    _region = bip::mapped_region();
+    _mapping = bip::file_mapping();
+    _file = fc::path();
+}
+
+void block_info_storage::store(uint32_t block_num, const block_info& info)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    FC_ASSERT(!_file.string().empty(), "Block info storage is not open");
+
+    if (block_num >= header().capacity)
+        grow((block_num / grow_records + 1) * grow_records);
+
+    record& r = records()[block_num];
+    r.block_id = info.block_id;
+    r.block_size = info.block_size;
+    r.aslot = info.aslot;
+    r.last_irreversible_block_num = info.last_irreversible_block_num;
+}
+
+void block_info_storage::read(uint32_t start_block_num,
+                              uint32_t end_block_num,
+                              std::vector<block_info>& result) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    FC_ASSERT(!_file.string().empty(), "Block info storage is not open");
+
+    end_block_num = std::min(end_block_num, header().capacity);
+    const record* rs = records();
+    for (uint32_t block_num = start_block_num; block_num < end_block_num; ++block_num)
+    {
+        const record& r = rs[block_num];
+        if (r.block_id == chain::block_id_type())
+            continue;
+
+        result.emplace_back();
+        block_info& info = result.back();
+        info.block_id = r.block_id;
+        info.block_size = r.block_size;
+        info.aslot = r.aslot;
+        info.last_irreversible_block_num = r.last_irreversible_block_num;
+    }
+}
+
+fc::optional<block_info> block_info_storage::read(uint32_t block_num) const
+{
+    std::vector<block_info> result;
+    read(block_num, block_num + 1, result);
+    if (result.empty())
+        return {};
+    return result.front();
+}
+
+void block_info_storage::map()
+{
+    _mapping = bip::file_mapping(_file.string().c_str(), bip::read_write);
+    _region = bip::mapped_region(_mapping, bip::read_write);
+}
+
+void block_info_storage::grow(uint32_t capacity)
+{
+    _region.flush();
+    _region = bip::mapped_region();
+    _mapping = bip::file_mapping();
+
+    // the new tail of the file reads as zeros, which are empty records
+    boost::filesystem::resize_file(_file.string(), sizeof(file_header) + uint64_t(capacity) * sizeof(record));
+
+    map();
+    header().capacity = capacity;
+}
+
+block_info_storage::file_header& block_info_storage::header() const
+{
+    return *reinterpret_cast<file_header*>(_region.get_address());
+}
+
+block_info_storage::record* block_info_storage::records() const
+{
+    return reinterpret_cast<record*>(static_cast<char*>(_region.get_address()) + sizeof(file_header));
+}
+}
+}
+} // deip::plugin::block_info
@@ -3,9 +3,9 @@
 
 #include <deip/app/plugin.hpp>
 #include <deip/plugins/block_info/block_info.hpp>
+#include <deip/plugins/block_info/block_info_storage.hpp>
 
 #include <string>
-#include <vector>
 
 namespace deip {
 namespace protocol {
@@ -26,13 +26,15 @@ public:
     virtual ~block_info_plugin();
 
     virtual std::string plugin_name() const override;
+    virtual void plugin_set_program_options(boost::program_options::options_description& cli,
+                                            boost::program_options::options_description& cfg) override;
     virtual void plugin_initialize(const boost::program_options::variables_map& options) override;
     virtual void plugin_startup() override;
     virtual void plugin_shutdown() override;
 
     void on_applied_block(const chain::signed_block& b);
 
-    std::vector<block_info> _block_info;
+    block_info_storage _block_info;
 
     boost::signals2::scoped_connection _applied_block_conn;
 };
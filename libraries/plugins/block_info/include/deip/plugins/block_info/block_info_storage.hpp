@@ -0,0 +1,79 @@
+#pragma once
+
+#include <deip/plugins/block_info/block_info.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/optional.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace deip {
+namespace plugin {
+namespace block_info {
+
+/**
+ *  Keeps block_info in a memory mapped file with one fixed width record per block number,
+ *  so that it takes no process memory and survives restarts.
+ *
+ *  A record is overwritten whenever a block with its number is applied, which keeps the file
+ *  in line with the chain through forks and rebuilds it during reindex. Records of blocks
+ *  which were never applied with the plugin enabled are empty and are skipped by reads.
+ */
+class block_info_storage
+{
+public:
+    block_info_storage() = default;
+    ~block_info_storage();
+
+    void open(const fc::path& file);
+    void close();
+
+    void store(uint32_t block_num, const block_info& info);
+
+    /**
+     *  Appends the stored records of blocks [start_block_num, end_block_num) to the result.
+     */
+    void read(uint32_t start_block_num, uint32_t end_block_num, std::vector<block_info>& result) const;
+
+    fc::optional<block_info> read(uint32_t block_num) const;
+
+private:
+    struct file_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t capacity;
+    };
+
+    struct record
+    {
+        chain::block_id_type block_id;
+        uint32_t block_size;
+        uint64_t aslot;
+        uint32_t last_irreversible_block_num;
+    };
+
+    static constexpr uint32_t magic = 0x44424946; // "DBIF"
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t grow_records = 1024 * 1024;
+
+    void map();
+    void grow(uint32_t capacity);
+
+    file_header& header() const;
+    record* records() const;
+
+    fc::path _file;
+    boost::interprocess::file_mapping _mapping;
+    boost::interprocess::mapped_region _region;
+
+    mutable std::mutex _mutex;
+};
+}
+}
+}
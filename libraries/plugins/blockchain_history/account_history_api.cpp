@@ -21,6 +21,20 @@ public:
     {
     }
 
+    /// Sequence of the oldest entry of the account, or the next one if all have been pruned
+    template <typename history_object_type>
+    uint32_t get_first_retained_sequence(const chain::database& db, const std::string& account) const
+    {
+        const auto& idx = db.get_index<history_index<history_object_type>>().indices().template get<by_account>();
+        auto oldest = idx.upper_bound(boost::make_tuple(account, int64_t(0)));
+        if (oldest != idx.begin() && std::prev(oldest)->account == account)
+            return std::prev(oldest)->sequence;
+
+        const auto& pruned_idx = db.get_index<pruned_account_history_index>().indices().get<by_history_and_account>();
+        auto itr = pruned_idx.find(boost::make_tuple(uint16_t(history_object_type::type_id), account_name_type(account)));
+        return itr != pruned_idx.end() ? itr->next_sequence : 0;
+    }
+
     template <typename history_object_type, typename fill_result_functor>
     void get_history(const std::string& account, uint64_t from, uint32_t limit, fill_result_functor& funct) const
     {
@@ -37,6 +51,18 @@ public:
 
         const auto& idx = db->get_index<history_index<history_object_type>>().indices().template get<by_account>();
         auto itr = idx.lower_bound(boost::make_tuple(account, from));
+
+        const uint32_t first_retained = get_first_retained_sequence<history_object_type>(*db, account);
+        if (first_retained > 0)
+        {
+            const uint64_t newest = (itr != idx.end() && itr->account == account)
+                ? itr->sequence
+                : std::min<uint64_t>(from, first_retained);
+            FC_ASSERT(int64_t(newest) - limit + 1 >= int64_t(first_retained),
+                      "History of ${a} before sequence ${s} has been pruned on this node",
+                      ("a", account)("s", first_retained));
+        }
+
         if (itr != idx.end())
         {
             auto end = idx.upper_bound(boost::make_tuple(account, int64_t(0)));
@@ -60,7 +86,13 @@ public:
 
          const auto db = _app.chain_database();
          
-         auto fill_funct = [&](const history_object_type& hobj) { result[hobj.sequence] = db->get(hobj.op); };
+         auto fill_funct = [&](const history_object_type& hobj) {
+             // entries are pruned in the blocks after their operations
+             const operation_object* op = db->find(hobj.op);
+             FC_ASSERT(op != nullptr, "History of ${a} before sequence ${s} has been pruned on this node",
+                       ("a", account)("s", hobj.sequence + 1));
+             result[hobj.sequence] = *op;
+         };
         this->template get_history<history_object_type>(account, from, limit, fill_funct);
          return result;
     }
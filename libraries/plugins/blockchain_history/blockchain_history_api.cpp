@@ -1,5 +1,6 @@
 #include <deip/blockchain_history/blockchain_history_api.hpp>
 #include <deip/app/application.hpp>
+#include <deip/app/history_retention.hpp>
 #include <deip/blockchain_history/operation_objects.hpp>
 
 #include <fc/static_variant.hpp>
@@ -22,7 +23,10 @@ public:
 private:
     template <typename ObjectType> applied_operation get_filtered_operation(const ObjectType& obj) const
     {
-        return _db->get(obj.op);
+        // entries are pruned in the blocks after their operations
+        const operation_object* op = _db->find(obj.op);
+        FC_ASSERT(op != nullptr, "Operation ${op} has been pruned on this node", ("op", obj.op));
+        return *op;
     }
 
     applied_operation get_operation(const filtered_not_virt_operations_history_object& obj) const
@@ -81,6 +85,8 @@ public:
                 --itr;
             auto start = (int64_t(itr->id._id) - limit);
             auto end = itr->id._id;
+            app::check_retained<IndexType>(*_db, std::max<int64_t>(start + 1, 0), "Operation history");
+
             auto range = idx.range(start < boost::lambda::_1, boost::lambda::_1 <= end);
 
             for (auto it = range.first; it != range.second; ++it)
@@ -156,6 +162,13 @@ std::map<uint32_t, applied_operation> blockchain_history_api::get_ops_in_block(u
     const auto& db = _impl->_app.chain_database();
 
     return db->with_read_lock([&]() {
+        if (app::is_pruned<operation_index>(*db))
+        {
+            const uint32_t first_block = db->get_index<operation_index>().indices().get<by_id>().begin()->block;
+            FC_ASSERT(block_num >= first_block, "Operations before block ${b} have been pruned on this node",
+                      ("b", first_block));
+        }
+
         const auto& idx = db->get_index<operation_index>().indices().get<by_location>();
         auto itr = idx.lower_bound(block_num);
 
@@ -201,6 +214,9 @@ annotated_signed_transaction blockchain_history_api::get_transaction(transaction
             result.transaction_num = itr->trx_in_block;
             return result;
         }
+        FC_ASSERT(!app::is_pruned<operation_index>(*db),
+                  "Unknown Transaction ${t}, operations before block ${b} have been pruned on this node",
+                  ("t", id)("b", db->get_index<operation_index>().indices().get<by_id>().begin()->block));
         FC_ASSERT(false, "Unknown Transaction ${t}", ("t", id));
     });
 #endif
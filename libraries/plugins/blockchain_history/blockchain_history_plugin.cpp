@@ -3,6 +3,7 @@
 #include <deip/blockchain_history/blockchain_history_api.hpp>
 #include <deip/blockchain_history/account_history_object.hpp>
 
+#include <deip/app/history_retention.hpp>
 #include <deip/app/impacted.hpp>
 
 #include <deip/protocol/config.hpp>
@@ -17,6 +18,8 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <limits>
+
 #define DEIP_NAMESPACE_PREFIX "deip::protocol::"
 
 namespace deip {
@@ -41,8 +44,13 @@ public:
         db.add_plugin_index<filtered_not_virt_operations_history_index>();
         db.add_plugin_index<filtered_virt_operations_history_index>();
         db.add_plugin_index<filtered_market_operations_history_index>();
+        db.add_plugin_index<pruned_account_history_index>();
 
         db.pre_apply_operation.connect([&](const operation_notification& note) { on_operation(note); });
+        db.applied_block.connect([&](const signed_block&) {
+            if (_retention.enabled())
+                prune();
+        });
     }
     virtual ~blockchain_history_plugin_impl()
     {
@@ -56,12 +64,18 @@ public:
     const operation_object& create_operation_obj(const operation_notification& note);
     void update_filtered_operation_index(const operation_object& object, const operation& op);
     void on_operation(const operation_notification& note);
+    void prune();
+
+    template <typename IndexType, typename OnRemove>
+    void prune_references(int64_t first_op, uint32_t& budget, OnRemove on_remove);
+    template <typename history_object_type> void prune_account_history(int64_t first_op, uint32_t& budget);
 
     blockchain_history_plugin& _self;
     flat_map<account_name_type, account_name_type> _tracked_accounts;
     bool _filter_content = false;
     bool _blacklist = false;
     flat_set<string> _op_list;
+    app::history_retention _retention;
 };
 
 class operation_visitor
@@ -103,7 +117,16 @@ private:
         auto hist_itr = hist_idx.lower_bound(boost::make_tuple(_item, uint32_t(-1)));
         uint32_t sequence = 0;
         if (hist_itr != hist_idx.end() && hist_itr->account == _item)
+        {
             sequence = hist_itr->sequence + 1;
+        }
+        else
+        {
+            const auto& pruned_idx = _db.get_index<pruned_account_history_index>().indices().get<by_history_and_account>();
+            auto pruned_itr = pruned_idx.find(boost::make_tuple(uint16_t(history_object_type::type_id), _item));
+            if (pruned_itr != pruned_idx.end())
+                sequence = pruned_itr->next_sequence;
+        }
 
         _db.create<history_object_type>([&](history_object_type& ahist) {
             ahist.account = _item;
@@ -228,6 +251,102 @@ void blockchain_history_plugin_impl::on_operation(const operation_notification&
     }
 }
 
+/**
+ *  Operations are pruned a block at a time, so that the operations of a block are either all
+ *  retained or all pruned; a block can take the batch over its size, and the operations of the
+ *  head block are always retained. Account history and filtered entries referring to pruned
+ *  operations go first, in the next blocks if the batch ran out.
+ */
+void blockchain_history_plugin_impl::prune()
+{
+    deip::chain::database& db = database();
+
+    const auto& ops = db.get_index<operation_index>().indices().get<by_id>();
+    const auto& ops_by_location = db.get_index<operation_index>().indices().get<by_location>();
+
+    uint32_t budget = _retention.batch_size;
+    const int64_t first_op = ops.empty() ? std::numeric_limits<int64_t>::max() : ops.begin()->id._id;
+
+    prune_account_history<account_history_object>(first_op, budget);
+    prune_account_history<transfers_to_deip_history_object>(first_op, budget);
+    prune_account_history<transfers_to_common_tokens_history_object>(first_op, budget);
+
+    prune_references<filtered_not_virt_operations_history_index>(first_op, budget,
+                                                                 [](const filtered_not_virt_operations_history_object&) {});
+    prune_references<filtered_virt_operations_history_index>(first_op, budget,
+                                                             [](const filtered_virt_operations_history_object&) {});
+    prune_references<filtered_market_operations_history_index>(first_op, budget,
+                                                               [](const filtered_market_operations_history_object&) {});
+
+    const fc::time_point_sec cutoff = _retention.age_cutoff(db);
+    while (budget > 0 && !ops.empty())
+    {
+        const operation_object& oldest = *ops.begin();
+        if (oldest.block >= db.head_block_num())
+            break;
+
+        const bool over_count = _retention.max_objects != 0 && ops.size() > _retention.max_objects;
+        const bool over_age = _retention.max_age_blocks != 0 && oldest.timestamp < cutoff;
+        if (!over_count && !over_age)
+            break;
+
+        const uint32_t block = oldest.block;
+        auto itr = ops_by_location.lower_bound(block);
+        while (itr != ops_by_location.end() && itr->block == block)
+        {
+            const operation_object& op = *itr;
+            ++itr;
+
+            db.remove(op);
+            if (budget > 0)
+                --budget;
+        }
+    }
+}
+
+template <typename IndexType, typename OnRemove>
+void blockchain_history_plugin_impl::prune_references(int64_t first_op, uint32_t& budget, OnRemove on_remove)
+{
+    deip::chain::database& db = database();
+    const auto& idx = db.get_index<IndexType>().indices().template get<by_id>();
+
+    while (budget > 0 && !idx.empty() && idx.begin()->op._id < first_op)
+    {
+        const auto& obj = *idx.begin();
+        on_remove(obj);
+        db.remove(obj);
+        --budget;
+    }
+}
+
+template <typename history_object_type>
+void blockchain_history_plugin_impl::prune_account_history(int64_t first_op, uint32_t& budget)
+{
+    deip::chain::database& db = database();
+    const auto& hist_idx = db.get_index<history_index<history_object_type>>().indices().template get<by_account>();
+    const auto& pruned_idx = db.get_index<pruned_account_history_index>().indices().get<by_history_and_account>();
+
+    prune_references<history_index<history_object_type>>(first_op, budget, [&](const history_object_type& hist) {
+        // the sequence continues from the newest entry of the account
+        if (&*hist_idx.lower_bound(boost::make_tuple(hist.account, uint32_t(-1))) != &hist)
+            return;
+
+        auto itr = pruned_idx.find(boost::make_tuple(uint16_t(history_object_type::type_id), hist.account));
+        if (itr == pruned_idx.end())
+        {
+            db.create<pruned_account_history_object>([&](pruned_account_history_object& pruned) {
+                pruned.history_type = history_object_type::type_id;
+                pruned.account = hist.account;
+                pruned.next_sequence = hist.sequence + 1;
+            });
+        }
+        else
+        {
+            db.modify(*itr, [&](pruned_account_history_object& pruned) { pruned.next_sequence = hist.sequence + 1; });
+        }
+    });
+}
+
 } // end namespace detail
 
 blockchain_history_plugin::blockchain_history_plugin(application* app)
@@ -256,6 +375,7 @@ void blockchain_history_plugin::plugin_set_program_options(boost::program_option
                  "Defines a list of operations which will be explicitly logged.")(
         "history-blacklist-ops", boost::program_options::value<vector<string>>()->composing(),
         "Defines a list of operations which will be explicitly ignored.");
+    app::history_retention::add_program_options(cli, "history");
     cfg.add(cli);
 }
 
@@ -266,6 +386,13 @@ void blockchain_history_plugin::plugin_initialize(const boost::program_options::
     typedef pair<account_name_type, account_name_type> pairstring;
     LOAD_VALUE_SET(options, "track-account-range", my->_tracked_accounts, pairstring);
 
+    my->_retention = app::history_retention::from_options(options, "history");
+    if (my->_retention.enabled())
+    {
+        ilog("Account History: retaining operations of ${b} blocks, ${n} operations at most",
+             ("b", my->_retention.max_age_blocks)("n", my->_retention.max_objects));
+    }
+
     if (options.count("history-whitelist-ops"))
     {
         my->_filter_content = true;
@@ -311,6 +438,7 @@ void blockchain_history_plugin::plugin_startup()
 
     app().register_api_factory<account_history_api>("account_history_api");
     app().register_api_factory<blockchain_history_api>("blockchain_history_api");
+    app().register_binary_api_factory<blockchain_history_api>("blockchain_history_api");
 
     ilog("account_history plugin: plugin_startup() end");
 }
@@ -48,6 +48,41 @@ using transfers_to_common_tokens_history_object = history_object<account_deip_to
 using account_operations_full_history_index = history_index<account_history_object>;
 using transfers_to_deip_history_index = history_index<transfers_to_deip_history_object>;
 using transfers_to_common_tokens_history_index = history_index<transfers_to_common_tokens_history_object>;
+
+/**
+ *  Next sequence of an account all of whose entries of a history index have been pruned, so
+ *  that the sequence of its next entry continues where it was.
+ */
+class pruned_account_history_object : public object<pruned_account_history, pruned_account_history_object>
+{
+public:
+    CHAINBASE_DEFAULT_CONSTRUCTOR(pruned_account_history_object)
+
+    typedef typename object<pruned_account_history, pruned_account_history_object>::id_type id_type;
+
+    id_type id;
+
+    uint16_t history_type = 0;
+    account_name_type account;
+    uint32_t next_sequence = 0;
+};
+
+struct by_history_and_account;
+
+typedef chainbase::shared_multi_index_container<pruned_account_history_object,
+                                     indexed_by<ordered_unique<tag<by_id>,
+                                                               member<pruned_account_history_object,
+                                                                      pruned_account_history_object::id_type,
+                                                                      &pruned_account_history_object::id>>,
+                                                ordered_unique<tag<by_history_and_account>,
+                                                               composite_key<pruned_account_history_object,
+                                                                             member<pruned_account_history_object,
+                                                                                    uint16_t,
+                                                                                    &pruned_account_history_object::history_type>,
+                                                                             member<pruned_account_history_object,
+                                                                                    account_name_type,
+                                                                                    &pruned_account_history_object::account>>>>>
+    pruned_account_history_index;
 //
 } // namespace blockchain_history
 } // namespace deip
@@ -56,6 +91,8 @@ FC_REFLECT(deip::blockchain_history::account_history_object, (id)(account)(seque
 FC_REFLECT(deip::blockchain_history::transfers_to_deip_history_object, (id)(account)(sequence)(op))
 FC_REFLECT(deip::blockchain_history::transfers_to_common_tokens_history_object, (id)(account)(sequence)(op))
 
+FC_REFLECT(deip::blockchain_history::pruned_account_history_object, (id)(history_type)(account)(next_sequence))
+
 CHAINBASE_SET_INDEX_TYPE(deip::blockchain_history::account_history_object,
                          deip::blockchain_history::account_operations_full_history_index)
 
@@ -63,4 +100,7 @@ CHAINBASE_SET_INDEX_TYPE(deip::blockchain_history::transfers_to_deip_history_obj
                          deip::blockchain_history::transfers_to_deip_history_index)
 
 CHAINBASE_SET_INDEX_TYPE(deip::blockchain_history::transfers_to_common_tokens_history_object,
-                         deip::blockchain_history::transfers_to_common_tokens_history_index)
\ No newline at end of file
+                         deip::blockchain_history::transfers_to_common_tokens_history_index)
+
+CHAINBASE_SET_INDEX_TYPE(deip::blockchain_history::pruned_account_history_object,
+                         deip::blockchain_history::pruned_account_history_index)
\ No newline at end of file
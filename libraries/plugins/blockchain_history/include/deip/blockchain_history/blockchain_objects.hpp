@@ -31,6 +31,7 @@ enum blockchain_history_object_type
     filtered_not_virt_operations_history,
     filtered_virt_operations_history,
     filtered_market_operations_history,
+    pruned_account_history,
 };
 }
 }
\ No newline at end of file
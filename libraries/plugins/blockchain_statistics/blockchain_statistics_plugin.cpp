@@ -262,7 +262,8 @@ void blockchain_statistics_plugin::plugin_initialize(const boost::program_option
         chain::database& db = database();
 
         db.applied_block.connect([&](const signed_block& b) { _my->on_block(b); });
-        db.pre_apply_operation.connect([&](const operation_notification& o) { _my->pre_operation(o); });
+        db.pre_apply_operation_dispatcher.subscribe<protocol::withdraw_common_tokens_operation>(
+            [&](const operation_notification& o) { _my->pre_operation(o); });
         db.post_apply_operation.connect([&](const operation_notification& o) { _my->post_operation(o); });
 
         db.add_plugin_index<bucket_index>();
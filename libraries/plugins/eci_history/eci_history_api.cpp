@@ -1,5 +1,6 @@
 #include <deip/app/api_context.hpp>
 #include <deip/app/application.hpp>
+#include <deip/app/history_retention.hpp>
 #include <deip/chain/services/dbs_expertise_contribution.hpp>
 #include <deip/chain/services/dbs_account.hpp>
 #include <deip/chain/services/dbs_expert_token.hpp>
@@ -35,6 +36,16 @@ public:
     {
     }
 
+    /// Results without a from filter cover the retained entries only
+    template <typename IndexType>
+    void check_retained(const chain::database& db, int64_t cursor, const fc::optional<fc::time_point_sec>& from) const
+    {
+        if (cursor > 0)
+            app::check_retained<IndexType>(db, cursor, "ECI history");
+        if (from.valid())
+            app::check_retained_since<IndexType>(db, *from, "ECI history");
+    }
+
     std::vector<research_content_eci_history_api_obj> get_research_content_eci_history(const external_id_type& research_content_external_id,
                                                                                        const research_content_eci_history_id_type& cursor,
                                                                                        const eci_filter& filter) const
@@ -43,6 +54,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& research_content_hist_idx = db->get_index<research_content_eci_history_index>().indices().get<by_research_content_and_cursor>();
+        check_retained<research_content_eci_history_index>(*db, cursor._id, filter.from);
         const auto& account_service = db->obtain_service<chain::dbs_account>();
         const auto& research_service = db->obtain_service<chain::dbs_research>();
         const auto& research_content_service = db->obtain_service<chain::dbs_research_content>();
@@ -129,6 +141,7 @@ public:
     {
         const auto& db = _app.chain_database();
         const auto& research_content_hist_idx = db->get_index<research_content_eci_history_index>().indices().get<by_research_content_id>();
+        check_retained<research_content_eci_history_index>(*db, 0, filter.from);
         const auto& research_content_service = db->obtain_service<chain::dbs_research_content>();
 
         std::map<external_id_type, research_content_eci_stats_api_obj> result;
@@ -217,6 +230,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& research_hist_idx = db->get_index<research_eci_history_index>().indices().get<by_research_and_cursor>();
+        check_retained<research_eci_history_index>(*db, cursor._id, filter.from);
         const auto& research_service = db->obtain_service<chain::dbs_research>();
         const auto& account_service = db->obtain_service<chain::dbs_account>();
 
@@ -299,6 +313,7 @@ public:
     {
         const auto& db = _app.chain_database();
         const auto& research_hist_idx = db->get_index<research_eci_history_index>().indices().get<by_research_id>();
+        check_retained<research_eci_history_index>(*db, 0, filter.from);
         const auto& research_service = db->obtain_service<chain::dbs_research>();
 
         std::map<external_id_type, research_eci_stats_api_obj> result;
@@ -387,6 +402,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& account_hist_idx = db->get_index<account_eci_history_index>().indices().get<by_account_and_cursor>();
+        check_retained<account_eci_history_index>(*db, cursor._id, filter.from);
         const auto& accounts_service = db->obtain_service<chain::dbs_account>();
 
         if (!accounts_service.account_exists(account))
@@ -460,6 +476,7 @@ public:
     {
         const auto& db = _app.chain_database();
         const auto& account_hist_idx = db->get_index<account_eci_history_index>().indices().get<by_account>();
+        check_retained<account_eci_history_index>(*db, 0, filter.from);
         const auto& accounts_service = db->obtain_service<chain::dbs_account>();
 
         std::map<account_name_type, account_eci_stats_api_obj> result;
@@ -548,6 +565,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& discipline_hist_idx = db->get_index<discipline_eci_history_index>().indices().get<by_id>();
+        check_retained<discipline_eci_history_index>(*db, 0, filter.from);
 
         uint32_t limit = DEIP_API_BULK_FETCH_LIMIT;
         for (auto itr = discipline_hist_idx.lower_bound(discipline_eci_history_id_type(0)); limit-- && itr != discipline_hist_idx.end(); ++itr)
@@ -596,6 +614,7 @@ public:
     {
         const auto& db = _app.chain_database();
         const auto& discipline_hist_idx = db->get_index<discipline_eci_history_index>().indices().get<by_discipline>();
+        check_retained<discipline_eci_history_index>(*db, 0, from_filter);
         const auto& disciplines_service = db->obtain_service<chain::dbs_discipline>();
 
         std::map<external_id_type, std::vector<discipline_eci_stats_api_obj>> result;
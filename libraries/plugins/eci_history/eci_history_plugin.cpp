@@ -1,3 +1,4 @@
+#include <deip/app/history_retention.hpp>
 #include <deip/protocol/config.hpp>
 #include <deip/chain/database/database.hpp>
 #include <deip/chain/operation_notification.hpp>
@@ -44,10 +45,11 @@ public:
         return _self.database();
     }
 
-    void pre_operation(const operation_notification& op_obj);
     void post_operation(const operation_notification& op_obj);
+    void prune();
 
     eci_history_plugin& _self;
+    app::history_retention _retention;
 };
 
 struct post_operation_visitor
@@ -379,13 +381,23 @@ struct post_operation_visitor
     }
 };
 
-void eci_history_plugin_impl::pre_operation(const operation_notification& note)
+void eci_history_plugin_impl::post_operation(const operation_notification& note)
 {
+    note.op.visit(post_operation_visitor(_self));
 }
 
-void eci_history_plugin_impl::post_operation(const operation_notification& note)
+void eci_history_plugin_impl::prune()
 {
-    note.op.visit(post_operation_visitor(_self));
+    // the count limit applies to each of the indices, the batch to all of them
+    uint32_t budget = _retention.batch_size;
+    budget -= app::prune_history<account_eci_history_index>(
+        database(), _retention, budget, [](const account_eci_history_object& hist) { return hist.timestamp; });
+    budget -= app::prune_history<research_eci_history_index>(
+        database(), _retention, budget, [](const research_eci_history_object& hist) { return hist.timestamp; });
+    budget -= app::prune_history<research_content_eci_history_index>(
+        database(), _retention, budget, [](const research_content_eci_history_object& hist) { return hist.timestamp; });
+    budget -= app::prune_history<discipline_eci_history_index>(
+        database(), _retention, budget, [](const discipline_eci_history_object& hist) { return hist.timestamp; });
 }
 
 } // end namespace detail
@@ -408,7 +420,7 @@ std::string eci_history_plugin::plugin_name() const
 
 void eci_history_plugin::plugin_set_program_options(boost::program_options::options_description& cli, boost::program_options::options_description& cfg)
 {
-
+    app::history_retention::add_program_options(cfg, "eci-history");
 }
 
 void eci_history_plugin::plugin_initialize(const boost::program_options::variables_map& options)
@@ -422,8 +434,17 @@ void eci_history_plugin::plugin_initialize(const boost::program_options::variabl
     db.add_plugin_index<research_content_eci_history_index>();
     db.add_plugin_index<discipline_eci_history_index>();
 
-    db.pre_apply_operation.connect([&](const operation_notification& note) { my->pre_operation(note); });
-    db.post_apply_operation.connect([&](const operation_notification& note) { my->post_operation(note); });
+    db.post_apply_operation_dispatcher.subscribe<research_content_eci_history_operation,
+                                                 research_eci_history_operation,
+                                                 account_eci_history_operation,
+                                                 disciplines_eci_history_operation>(
+        [&](const operation_notification& note) { my->post_operation(note); });
+
+    my->_retention = app::history_retention::from_options(options, "eci-history");
+    if (my->_retention.enabled())
+    {
+        db.applied_block.connect([&](const signed_block&) { my->prune(); });
+    }
 }
 
 void eci_history_plugin::plugin_startup()
@@ -30,7 +30,12 @@ public:
 
         db.add_plugin_index<withdrawal_request_history_index>();
         
-        db.post_apply_operation.connect([&](const operation_notification& note) { on_operation(note); });
+        db.post_apply_operation_dispatcher.subscribe<create_award_withdrawal_request_operation,
+                                                     certify_award_withdrawal_request_operation,
+                                                     approve_award_withdrawal_request_operation,
+                                                     reject_award_withdrawal_request_operation,
+                                                     pay_award_withdrawal_request_operation>(
+            [&](const operation_notification& note) { on_operation(note); });
     }
     virtual ~fo_history_plugin_impl()
     {
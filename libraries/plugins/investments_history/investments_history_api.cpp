@@ -1,5 +1,6 @@
 #include <deip/app/api_context.hpp>
 #include <deip/app/application.hpp>
+#include <deip/app/history_retention.hpp>
 #include <deip/chain/services/dbs_account.hpp>
 #include <deip/chain/services/dbs_asset.hpp>
 #include <deip/chain/services/dbs_research.hpp>
@@ -26,6 +27,13 @@ public:
     {
     }
 
+    /// Cursor 0 starts from the oldest retained entry
+    void check_cursor(const chain::database& db, const account_revenue_income_history_id_type& cursor) const
+    {
+        if (cursor._id > 0)
+            app::check_retained<account_revenue_income_history_index>(db, cursor._id, "Revenue history");
+    }
+
     std::vector<account_revenue_income_history_api_obj> get_account_revenue_history_by_security_token(const account_name_type& account,
                                                                                                       const string& security_token_symbol,
                                                                                                       const account_revenue_income_history_id_type& cursor,
@@ -36,6 +44,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& asset_service = db->obtain_service<chain::dbs_asset>();
+        check_cursor(*db, cursor);
         const auto& account_revenue_income_hist_idx = db->get_index<account_revenue_income_history_index>()
             .indices()
             .get<by_account_and_security_token_and_cursor>();
@@ -112,6 +121,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& asset_service = db->obtain_service<chain::dbs_asset>();
+        check_cursor(*db, cursor);
 
         const auto& account_revenue_income_hist_idx = db->get_index<account_revenue_income_history_index>()
             .indices()
@@ -139,6 +149,7 @@ public:
 
         const auto& db = _app.chain_database();
         const auto& asset_service = db->obtain_service<chain::dbs_asset>();
+        check_cursor(*db, cursor);
 
         const auto& account_revenue_income_hist_idx = db->get_index<account_revenue_income_history_index>()
             .indices()
@@ -1,3 +1,4 @@
+#include <deip/app/history_retention.hpp>
 #include <deip/protocol/config.hpp>
 #include <deip/chain/database/database.hpp>
 #include <deip/chain/operation_notification.hpp>
@@ -37,10 +38,11 @@ public:
         return _self.database();
     }
 
-    void pre_operation(const operation_notification& op_obj);
     void post_operation(const operation_notification& op_obj);
+    void prune();
 
     investments_history_plugin& _self;
+    app::history_retention _retention;
 };
 
 struct post_operation_visitor
@@ -71,13 +73,16 @@ struct post_operation_visitor
 
 };
 
-void investments_history_plugin_impl::pre_operation(const operation_notification& note)
+void investments_history_plugin_impl::post_operation(const operation_notification& note)
 {
+    note.op.visit(post_operation_visitor(_self));
 }
 
-void investments_history_plugin_impl::post_operation(const operation_notification& note)
+void investments_history_plugin_impl::prune()
 {
-    note.op.visit(post_operation_visitor(_self));
+    app::prune_history<account_revenue_income_history_index>(
+        database(), _retention, _retention.batch_size,
+        [](const account_revenue_income_history_object& hist) { return hist.timestamp; });
 }
 
 } // end namespace detail
@@ -100,7 +105,7 @@ std::string investments_history_plugin::plugin_name() const
 
 void investments_history_plugin::plugin_set_program_options(boost::program_options::options_description& cli, boost::program_options::options_description& cfg)
 {
-
+    app::history_retention::add_program_options(cfg, "investments-history");
 }
 
 void investments_history_plugin::plugin_initialize(const boost::program_options::variables_map& options)
@@ -111,8 +116,14 @@ void investments_history_plugin::plugin_initialize(const boost::program_options:
 
     db.add_plugin_index<account_revenue_income_history_index>();
 
-    db.pre_apply_operation.connect([&](const operation_notification& note) { my->pre_operation(note); });
-    db.post_apply_operation.connect([&](const operation_notification& note) { my->post_operation(note); });
+    db.post_apply_operation_dispatcher.subscribe<account_revenue_income_history_operation>(
+        [&](const operation_notification& note) { my->post_operation(note); });
+
+    my->_retention = app::history_retention::from_options(options, "investments-history");
+    if (my->_retention.enabled())
+    {
+        db.applied_block.connect([&](const signed_block&) { my->prune(); });
+    }
 }
 
 void investments_history_plugin::plugin_startup()
@@ -1,5 +1,6 @@
 #include <deip/app/api_context.hpp>
 #include <deip/app/application.hpp>
+#include <deip/app/history_retention.hpp>
 #include <deip/chain/services/dbs_account.hpp>
 #include <deip/chain/services/dbs_asset.hpp>
 #include <deip/chain/services/dbs_research.hpp>
@@ -113,6 +114,10 @@ public:
         const auto& db = _app.chain_database();
         const auto& proposal_state_idx = db->get_index<proposal_history_index>().indices().get<by_id>();
 
+        // lower bound 0 starts from the oldest retained proposal
+        if (lower_bound._id > 0)
+            app::check_retained<proposal_history_index>(*db, lower_bound._id, "Proposal history");
+
         for (auto itr = proposal_state_idx.lower_bound(lower_bound); limit-- && itr != proposal_state_idx.end(); ++itr)
         {
             result.push_back(*itr);
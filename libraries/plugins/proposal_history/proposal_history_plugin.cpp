@@ -1,3 +1,4 @@
+#include <deip/app/history_retention.hpp>
 #include <deip/protocol/config.hpp>
 #include <deip/chain/database/database.hpp>
 #include <deip/chain/operation_notification.hpp>
@@ -37,10 +38,11 @@ public:
         return _self.database();
     }
 
-    void pre_operation(const operation_notification& op_obj);
     void post_operation(const operation_notification& op_obj);
+    void prune();
 
     proposal_history_plugin& _self;
+    history_retention _retention;
 };
 
 struct post_operation_visitor
@@ -294,13 +296,48 @@ struct post_operation_visitor
     }
 };
 
-void proposal_history_plugin_impl::pre_operation(const operation_notification& note)
+void proposal_history_plugin_impl::post_operation(const operation_notification& note)
 {
+    note.op.visit(post_operation_visitor(_self, note));
 }
 
-void proposal_history_plugin_impl::post_operation(const operation_notification& note)
+/**
+ *  Only settled proposals past their expiration are pruned, so the oldest proposal which is
+ *  still pending holds back pruning of the later ones and the retained states stay a range of ids.
+ */
+void proposal_history_plugin_impl::prune()
 {
-    note.op.visit(post_operation_visitor(_self, note));
+    deip::chain::database& db = database();
+
+    const auto& proposal_state_idx = db.get_index<proposal_history_index>().indices().get<by_id>();
+    const auto& proposal_lookup_idx = db.get_index<proposal_lookup_index>().indices().get<lookup_by_proposal>();
+
+    const fc::time_point_sec now = db.head_block_time();
+    const fc::time_point_sec cutoff = _retention.age_cutoff(db);
+
+    uint32_t budget = _retention.batch_size;
+    while (budget > 0 && !proposal_state_idx.empty())
+    {
+        const proposal_state_object& proposal_state = *proposal_state_idx.begin();
+
+        const bool over_count = _retention.max_objects != 0 && proposal_state_idx.size() > _retention.max_objects;
+        const bool over_age = _retention.max_age_blocks != 0 && proposal_state.expiration_time < cutoff;
+        const bool settled = proposal_state.status != static_cast<uint8_t>(proposal_status::pending)
+            && proposal_state.expiration_time < now;
+        if (!settled || (!over_count && !over_age))
+            break;
+
+        auto itr = proposal_lookup_idx.lower_bound(proposal_state.external_id);
+        while (itr != proposal_lookup_idx.end() && itr->proposal == proposal_state.external_id)
+        {
+            const proposal_lookup_object& lookup = *itr;
+            ++itr;
+            db.remove(lookup);
+        }
+
+        db.remove(proposal_state);
+        --budget;
+    }
 }
 
 } // end namespace detail
@@ -323,7 +360,7 @@ std::string proposal_history_plugin::plugin_name() const
 
 void proposal_history_plugin::plugin_set_program_options(boost::program_options::options_description& cli, boost::program_options::options_description& cfg)
 {
-
+    history_retention::add_program_options(cfg, "proposal-history");
 }
 
 
@@ -335,8 +372,18 @@ void proposal_history_plugin::plugin_initialize(const boost::program_options::va
     db.add_plugin_index<proposal_history_index>();
     db.add_plugin_index<proposal_lookup_index>();
 
-    db.pre_apply_operation.connect([&](const operation_notification& note) { my->pre_operation(note); });
-    db.post_apply_operation.connect([&](const operation_notification& note) { my->post_operation(note); });
+    db.post_apply_operation_dispatcher.subscribe<create_genesis_proposal_operation,
+                                                 create_proposal_operation,
+                                                 update_proposal_operation,
+                                                 delete_proposal_operation,
+                                                 proposal_status_changed_operation>(
+        [&](const operation_notification& note) { my->post_operation(note); });
+
+    my->_retention = history_retention::from_options(options, "proposal-history");
+    if (my->_retention.enabled())
+    {
+        db.applied_block.connect([&](const signed_block&) { my->prune(); });
+    }
 }
 
 void proposal_history_plugin::plugin_startup()
@@ -33,7 +33,8 @@ public:
         db.add_plugin_index<research_content_reference_operation_index>();
         db.add_plugin_index<research_content_reference_operations_history_index>();
 
-        db.pre_apply_operation.connect([&](const operation_notification& note) { on_operation(note); });
+        db.pre_apply_operation_dispatcher.subscribe<research_content_reference_history_operation>(
+            [&](const operation_notification& note) { on_operation(note); });
     }
     virtual ~research_content_reference_history_plugin_impl()
     {
@@ -137,10 +138,9 @@ void research_content_reference_history_plugin_impl::on_operation(const operatio
 {
     deip::chain::database& db = database();
 
-    const research_content_reference_operation_object& new_obj = create_operation_obj(note);
-
     if (note.op.which() == operation::tag<research_content_reference_history_operation>::value) {
 
+        const research_content_reference_operation_object& new_obj = create_operation_obj(note);
         research_content_reference_history_operation op = note.op.get<research_content_reference_history_operation>();
         note.op.visit(research_content_reference_operation_visitor(
           db, 
@@ -34,7 +34,8 @@ public:
         db.add_plugin_index<tsc_operations_full_history_index>();
         db.add_plugin_index<contribute_to_token_sale_history_index>();
 
-        db.pre_apply_operation.connect([&](const operation_notification& note) { on_operation(note); });
+        db.pre_apply_operation_dispatcher.subscribe<token_sale_contribution_to_history_operation>(
+            [&](const operation_notification& note) { on_operation(note); });
     }
     virtual ~tsc_history_plugin_impl()
     {
@@ -128,10 +129,9 @@ void tsc_history_plugin_impl::on_operation(const operation_notification& note)
 {
     deip::chain::database& db = database();
 
-    const tsc_operation_object& new_obj = create_operation_obj(note);
-
     if (note.op.which() == operation::tag<token_sale_contribution_to_history_operation>::value) {
 
+        const tsc_operation_object& new_obj = create_operation_obj(note);
         token_sale_contribution_to_history_operation op = note.op.get<token_sale_contribution_to_history_operation>();
         account_name_type contributor = op.contributor;
         int64_t research_id = op.research_id;
@@ -32,6 +32,7 @@
 #include <fc/time.hpp>
 
 #include <graphene/utilities/key_conversion.hpp>
+#include <graphene/utilities/metrics.hpp>
 
 #include <fc/smart_ref_impl.hpp>
 #include <fc/thread/thread.hpp>
@@ -411,7 +412,8 @@ void witness_plugin::plugin_initialize(const boost::program_options::variables_m
         chain::database& db = database();
 
         db.on_pre_apply_transaction.connect([&](const signed_transaction& tx) { _my->pre_transaction(tx); });
-        db.pre_apply_operation.connect([&](const operation_notification& note) { _my->pre_operation(note); });
+        db.pre_apply_operation_dispatcher.subscribe<protocol::transfer_operation>(
+            [&](const operation_notification& note) { _my->pre_operation(note); });
         db.applied_block.connect([&](const signed_block& b) { _my->on_block(b); });
 
         db.add_plugin_index<account_bandwidth_index>();
@@ -503,9 +505,15 @@ block_production_condition::block_production_condition_enum witness_plugin::bloc
         result = block_production_condition::exception_producing_block;
     }
 
+    static graphene::utilities::counter& produced_metric = graphene::utilities::metrics().get_counter(
+        "deip_witness_blocks_produced_total", "Number of blocks produced by the witnesses of the node");
+    static graphene::utilities::counter& failed_metric = graphene::utilities::metrics().get_counter(
+        "deip_witness_block_production_failures_total", "Number of slots of the node's witnesses lost to an exception");
+
     switch (result)
     {
     case block_production_condition::produced:
+        produced_metric.inc();
         elog("Generated block #${n} with timestamp ${t} at time ${c} by ${w}", (capture));
         break;
     case block_production_condition::not_synced:
@@ -536,6 +544,7 @@ block_production_condition::block_production_condition_enum witness_plugin::bloc
              "--allow-consecutive option.");
         break;
     case block_production_condition::exception_producing_block:
+        failed_metric.inc();
         elog("Failure when producing block with no transactions");
         break;
     case block_production_condition::wait_for_genesis:
@@ -96,6 +96,23 @@ struct entity_operation : public base_operation
     }
 };
 
+/**
+ *  Computes the id validate_entity_id expects for an entity created in a transaction with
+ *  the given reference block. The current value of the id field is ignored.
+ */
+template <typename T>
+external_id_type compute_entity_id(const T& entity, uint16_t ref_block_num, uint32_t ref_block_prefix)
+{
+    std::vector<char> provided_id;
+    std::vector<char> extracted_id = fc::raw::pack(ref_block_num);
+    const std::vector<char> ref_block_prefix_data = fc::raw::pack(ref_block_prefix);
+    extracted_id.insert(extracted_id.end(), ref_block_prefix_data.begin(), ref_block_prefix_data.end());
+
+    fc::reflector<T>::visit(entity_id_extractor<T>(entity, entity.entity_id(), extracted_id, provided_id));
+
+    return (std::string)fc::ripemd160::hash(extracted_id.data(), (uint32_t)extracted_id.size());
+}
+
 
 typedef static_variant<void_t,
     version, // Normal witness version reporting, for diagnostics and voting
@@ -66,6 +66,7 @@
 
 #define DEIP_MIN_ACCOUNT_CREATION_FEE        asset( 0, DEIP_SYMBOL )
 #define DEIP_MIN_DISCIPLINE_SUPPLY_PER_BLOCK 1
+#define DEIP_MAX_TOKEN_SALE_SETTLEMENTS_PER_BLOCK 100 // contributions of ended token sales settled per block
 
 #define DEIP_BLOCK_INTERVAL                  3
 #define DEIP_BLOCKS_PER_YEAR                 (365*24*60*60/DEIP_BLOCK_INTERVAL)
@@ -111,6 +112,8 @@
 #define DEIP_1_PERCENT                       (DEIP_100_PERCENT/100)
 #define DEIP_1_TENTH_PERCENT                 (DEIP_100_PERCENT/1000)
 
+#define DEIP_LICENSE_REVENUE_PER_UNIT_PRECISION uint64_t(1000000000000) ///< scale of the per security token unit revenue accumulators
+
 #define DEIP_REVIEW_REQUIRED_POWER_PERCENT   (0 * DEIP_1_PERCENT)
 #define DEIP_REVIEW_VOTE_SPREAD_DENOMINATOR  10
 
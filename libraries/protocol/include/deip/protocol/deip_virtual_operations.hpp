@@ -298,6 +298,27 @@ struct create_genesis_account_operation : public virtual_operation
     account_name_type account;
 };
 
+struct token_sale_contribution_settled_operation : public virtual_operation
+{
+    token_sale_contribution_settled_operation() {}
+    token_sale_contribution_settled_operation(const external_id_type& research_token_sale_external_id,
+                                              const account_name_type& contributor,
+                                              const asset& contribution,
+                                              const uint16_t& status)
+        : research_token_sale_external_id(research_token_sale_external_id)
+        , contributor(contributor)
+        , contribution(contribution)
+        , status(status)
+    {
+    }
+
+    external_id_type research_token_sale_external_id;
+    account_name_type contributor;
+    asset contribution;
+    uint16_t status; // finished: the security tokens are distributed, expired: the contribution is refunded
+    std::vector<asset> security_tokens;
+};
+
 
 }
 } // deip::protocol
@@ -315,4 +336,5 @@ FC_REFLECT(deip::protocol::disciplines_eci_history_operation, (contributions)(ti
 FC_REFLECT(deip::protocol::account_revenue_income_history_operation, (account)(security_token)(revenue)(timestamp))
 FC_REFLECT(deip::protocol::proposal_status_changed_operation, (external_id)(status))
 FC_REFLECT(deip::protocol::create_genesis_proposal_operation, (external_id)(proposer)(serialized_proposed_transaction)(expiration_time)(created_at)(review_period_time)(active_approvals)(owner_approvals)(key_approvals))
-FC_REFLECT(deip::protocol::create_genesis_account_operation, (account))
\ No newline at end of file
+FC_REFLECT(deip::protocol::create_genesis_account_operation, (account))
+FC_REFLECT(deip::protocol::token_sale_contribution_settled_operation, (research_token_sale_external_id)(contributor)(contribution)(status)(security_tokens))
\ No newline at end of file
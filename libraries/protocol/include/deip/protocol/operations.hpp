@@ -98,7 +98,8 @@ typedef fc::static_variant<create_account_operation, // 0
                            account_revenue_income_history_operation,
                            proposal_status_changed_operation,
                            create_genesis_proposal_operation,
-                           create_genesis_account_operation>
+                           create_genesis_account_operation,
+                           token_sale_contribution_settled_operation>
 
     operation;
 
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace graphene {
+namespace utilities {
+
+typedef std::map<std::string, std::string> metric_labels;
+
+/// Count of events which only goes up
+class counter
+{
+public:
+    void inc(uint64_t n = 1)
+    {
+        _value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const
+    {
+        return _value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> _value{ 0 };
+};
+
+/// Current value of a quantity which goes up and down
+class gauge
+{
+public:
+    void set(double value)
+    {
+        _value.store(value, std::memory_order_relaxed);
+    }
+
+    void add(double delta);
+
+    double value() const
+    {
+        return _value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> _value{ 0 };
+};
+
+/**
+ *  Distribution of observed values over buckets with the given upper bounds, plus the bucket
+ *  of values above the last bound. Observing a value is lock free.
+ */
+class histogram
+{
+public:
+    explicit histogram(const std::vector<double>& bounds);
+
+    void observe(double value);
+
+    const std::vector<double>& bounds() const
+    {
+        return _bounds;
+    }
+
+    /// cumulative counts, of values less than or equal to each bound and of all values last
+    std::vector<uint64_t> cumulative_counts() const;
+
+    uint64_t count() const
+    {
+        return _count.load(std::memory_order_relaxed);
+    }
+
+    double sum() const
+    {
+        return _sum.value();
+    }
+
+    /// count bounds from start on, each factor times the previous one
+    static std::vector<double> exponential_bounds(double start, double factor, size_t count);
+
+private:
+    const std::vector<double> _bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> _buckets;
+    std::atomic<uint64_t> _count{ 0 };
+    gauge _sum;
+};
+
+/**
+ *  Metrics of the process, exported in the Prometheus text format.
+ *
+ *  A metric is created on its first lookup and lives as long as the process, so callers can
+ *  keep the returned reference and update the metric without going through the registry.
+ *  Metrics of one name are a family of the same type, one for every set of labels.
+ */
+class metrics_registry
+{
+public:
+    static metrics_registry& instance();
+
+    counter& get_counter(const std::string& name, const std::string& help, const metric_labels& labels = metric_labels());
+
+    gauge& get_gauge(const std::string& name, const std::string& help, const metric_labels& labels = metric_labels());
+
+    histogram& get_histogram(const std::string& name,
+                             const std::string& help,
+                             const std::vector<double>& bounds,
+                             const metric_labels& labels = metric_labels());
+
+    /// Text exposition format 0.0.4
+    std::string to_prometheus() const;
+
+private:
+    enum class metric_type
+    {
+        counter,
+        gauge,
+        histogram
+    };
+
+    struct family
+    {
+        metric_type type;
+        std::string help;
+
+        // by formatted labels
+        std::map<std::string, std::unique_ptr<counter>> counters;
+        std::map<std::string, std::unique_ptr<gauge>> gauges;
+        std::map<std::string, std::unique_ptr<histogram>> histograms;
+    };
+
+    family& get_family(const std::string& name, const std::string& help, metric_type type);
+
+    mutable std::mutex _mutex;
+    std::map<std::string, family> _families;
+};
+
+/// The metrics registry of the process
+inline metrics_registry& metrics()
+{
+    return metrics_registry::instance();
+}
+}
+}
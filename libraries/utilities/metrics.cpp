@@ -0,0 +1,261 @@
+#include <graphene/utilities/metrics.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+namespace graphene {
+namespace utilities {
+
+namespace {
+
+bool is_valid_name(const std::string& name)
+{
+    if (name.empty())
+        return false;
+
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        const char c = name[i];
+        const bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        if (!letter && !(i > 0 && c >= '0' && c <= '9'))
+            return false;
+    }
+
+    return true;
+}
+
+std::string escape(const std::string& value, bool quotes)
+{
+    std::string result;
+    result.reserve(value.size());
+
+    for (const char c : value)
+    {
+        if (c == '\\')
+            result += "\\\\";
+        else if (c == '\n')
+            result += "\\n";
+        else if (c == '"' && quotes)
+            result += "\\\"";
+        else
+            result += c;
+    }
+
+    return result;
+}
+
+/// label pairs without the braces, so that le can be appended for histogram buckets
+std::string format_labels(const metric_labels& labels)
+{
+    std::string result;
+    for (const auto& label : labels)
+    {
+        FC_ASSERT(is_valid_name(label.first) && label.first != "le", "Invalid metric label ${l}", ("l", label.first));
+
+        if (!result.empty())
+            result += ',';
+        result += label.first + "=\"" + escape(label.second, true) + '"';
+    }
+
+    return result;
+}
+
+std::string format_value(double value)
+{
+    if (std::isnan(value))
+        return "NaN";
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+void write_sample(std::ostream& out, const std::string& name, const std::string& labels, const std::string& value)
+{
+    out << name;
+    if (!labels.empty())
+        out << '{' << labels << '}';
+    out << ' ' << value << '\n';
+}
+
+void add_atomic(std::atomic<double>& target, double delta)
+{
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed))
+    {
+    }
+}
+}
+
+void gauge::add(double delta)
+{
+    add_atomic(_value, delta);
+}
+
+histogram::histogram(const std::vector<double>& bounds)
+    : _bounds(bounds)
+    , _buckets(new std::atomic<uint64_t>[bounds.size() + 1])
+{
+    for (size_t i = 1; i < _bounds.size(); ++i)
+        FC_ASSERT(_bounds[i - 1] < _bounds[i], "Histogram bounds must be increasing");
+
+    for (size_t i = 0; i <= _bounds.size(); ++i)
+        _buckets[i].store(0, std::memory_order_relaxed);
+}
+
+void histogram::observe(double value)
+{
+    size_t bucket = 0;
+    while (bucket < _bounds.size() && value > _bounds[bucket])
+        ++bucket;
+
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _sum.add(value);
+    _count.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> histogram::cumulative_counts() const
+{
+    std::vector<uint64_t> counts(_bounds.size() + 1);
+
+    uint64_t total = 0;
+    for (size_t i = 0; i <= _bounds.size(); ++i)
+    {
+        total += _buckets[i].load(std::memory_order_relaxed);
+        counts[i] = total;
+    }
+
+    return counts;
+}
+
+std::vector<double> histogram::exponential_bounds(double start, double factor, size_t count)
+{
+    FC_ASSERT(start > 0 && factor > 1, "Exponential bounds must start above 0 and grow");
+
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    for (double bound = start; bounds.size() < count; bound *= factor)
+        bounds.push_back(bound);
+
+    return bounds;
+}
+
+metrics_registry& metrics_registry::instance()
+{
+    static metrics_registry registry;
+    return registry;
+}
+
+metrics_registry::family&
+metrics_registry::get_family(const std::string& name, const std::string& help, metric_type type)
+{
+    FC_ASSERT(is_valid_name(name), "Invalid metric name ${n}", ("n", name));
+
+    auto itr = _families.find(name);
+    if (itr == _families.end())
+    {
+        itr = _families.insert(std::make_pair(name, family())).first;
+        itr->second.type = type;
+        itr->second.help = help;
+    }
+
+    FC_ASSERT(itr->second.type == type, "Metric ${n} is registered with another type", ("n", name));
+    return itr->second;
+}
+
+counter& metrics_registry::get_counter(const std::string& name, const std::string& help, const metric_labels& labels)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::unique_ptr<counter>& metric = get_family(name, help, metric_type::counter).counters[format_labels(labels)];
+    if (!metric)
+        metric.reset(new counter());
+
+    return *metric;
+}
+
+gauge& metrics_registry::get_gauge(const std::string& name, const std::string& help, const metric_labels& labels)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::unique_ptr<gauge>& metric = get_family(name, help, metric_type::gauge).gauges[format_labels(labels)];
+    if (!metric)
+        metric.reset(new gauge());
+
+    return *metric;
+}
+
+histogram& metrics_registry::get_histogram(const std::string& name,
+                                           const std::string& help,
+                                           const std::vector<double>& bounds,
+                                           const metric_labels& labels)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::unique_ptr<histogram>& metric
+        = get_family(name, help, metric_type::histogram).histograms[format_labels(labels)];
+    if (!metric)
+        metric.reset(new histogram(bounds));
+
+    FC_ASSERT(metric->bounds() == bounds, "Histogram ${n} is registered with other bounds", ("n", name));
+    return *metric;
+}
+
+std::string metrics_registry::to_prometheus() const
+{
+    std::ostringstream out;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& item : _families)
+    {
+        const std::string& name = item.first;
+        const family& f = item.second;
+
+        out << "# HELP " << name << ' ' << escape(f.help, false) << '\n';
+
+        switch (f.type)
+        {
+        case metric_type::counter:
+            out << "# TYPE " << name << " counter\n";
+            for (const auto& metric : f.counters)
+                write_sample(out, name, metric.first, std::to_string(metric.second->value()));
+            break;
+
+        case metric_type::gauge:
+            out << "# TYPE " << name << " gauge\n";
+            for (const auto& metric : f.gauges)
+                write_sample(out, name, metric.first, format_value(metric.second->value()));
+            break;
+
+        case metric_type::histogram:
+            out << "# TYPE " << name << " histogram\n";
+            for (const auto& metric : f.histograms)
+            {
+                const histogram& h = *metric.second;
+                const std::string& labels = metric.first;
+                const std::string separator = labels.empty() ? "" : ",";
+
+                // the count of the last bucket is taken as the total, so that the buckets and the count agree
+                const std::vector<uint64_t> counts = h.cumulative_counts();
+                for (size_t i = 0; i < counts.size(); ++i)
+                {
+                    const std::string le = i < h.bounds().size() ? format_value(h.bounds()[i]) : "+Inf";
+                    write_sample(out, name + "_bucket", labels + separator + "le=\"" + le + '"',
+                                 std::to_string(counts[i]));
+                }
+                write_sample(out, name + "_sum", labels, format_value(h.sum()));
+                write_sample(out, name + "_count", labels, std::to_string(counts.back()));
+            }
+            break;
+        }
+    }
+
+    return out.str();
+}
+}
+}
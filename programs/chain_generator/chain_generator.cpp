@@ -0,0 +1,539 @@
+#include "chain_generator.hpp"
+
+#include <deip/chain/schema/research_content_object.hpp>
+#include <deip/protocol/deip_operations.hpp>
+
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/io/json.hpp>
+
+#include <algorithm>
+
+namespace deip {
+namespace generator {
+
+namespace {
+
+const std::string witness_account_name = "initdelegate";
+const share_type init_supply = 10000000000ll;
+
+const share_type user_funding = 100000;
+const share_type license_fee = 10;
+const share_type contribution_amount = 10;
+
+const share_type security_token_supply = 1000000;
+const share_type security_tokens_on_sale = 100;
+const uint32_t token_sale_blocks = 100;
+
+std::string security_token_symbol(uint64_t index)
+{
+    std::string symbol = "R";
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        symbol += char('A' + index % 26);
+        index /= 26;
+    }
+    return symbol;
+}
+
+// weights of the actions in chain_generator::action order
+const std::map<operation_mix, std::vector<uint32_t>> operation_mix_weights = {
+    { operation_mix::research,   { 10, 10, 3, 5, 15, 25, 25, 5, 1, 1 } },
+    { operation_mix::transfer,   { 5, 85, 1, 1, 2, 2, 2, 1, 0, 1 } },
+    { operation_mix::token_sale, { 10, 10, 2, 5, 3, 3, 2, 5, 10, 50 } }
+};
+
+} // namespace
+
+operation_mix operation_mix_from_string(const std::string& name)
+{
+    if (name == "research")
+        return operation_mix::research;
+    if (name == "transfer")
+        return operation_mix::transfer;
+    if (name == "token-sale")
+        return operation_mix::token_sale;
+
+    FC_ASSERT(false, "Unknown operation mix ${1}, expected research, transfer or token-sale", ("1", name));
+}
+
+chain_generator::chain_generator(const generator_options& options)
+    : _options(options)
+    , _key(fc::ecc::private_key::regenerate(fc::sha256::hash("chain_generator_" + fc::to_string(options.seed))))
+    , _rng(options.seed)
+{
+    FC_ASSERT(_options.transactions_per_block > 0, "At least one transaction per block is required");
+    FC_ASSERT(_options.disciplines > 0, "At least one discipline besides the common one is required");
+
+    generate_genesis();
+}
+
+void chain_generator::generate_genesis()
+{
+    const public_key_type public_key = _key.get_public_key();
+
+    _genesis.init_supply = init_supply;
+    _genesis.init_rewards_supply = DEIP_REWARDS_INITIAL_SUPPLY;
+    _genesis.initial_timestamp = _options.genesis_time;
+
+    _genesis.registrar_account.name = DEIP_REGISTRAR_ACCOUNT_NAME;
+    _genesis.registrar_account.public_key = public_key;
+
+    _genesis.accounts.push_back({ witness_account_name, "", public_key });
+    _genesis.witness_candidates.push_back({ witness_account_name, public_key });
+
+    genesis_state_type::account_balance_type balance;
+    balance.owner = witness_account_name;
+    balance.amount = init_supply;
+    _genesis.account_balances.push_back(balance);
+
+    _genesis.disciplines.push_back({ "Common", DEIP_COMMON_DISCIPLINE_ID, "" });
+    for (uint32_t i = 0; i < _options.disciplines; ++i)
+    {
+        const std::string name = "Discipline " + fc::to_string(i);
+        const external_id_type external_id = fc::ripemd160::hash(fc::to_string(_options.seed) + name).str();
+
+        _genesis.disciplines.push_back({ name, external_id, "" });
+        _disciplines.push_back(external_id);
+    }
+
+    // deipd derives the chain id from the genesis file contents
+    _genesis_json = fc::json::to_pretty_string(_genesis);
+    _genesis.initial_chain_id = fc::sha256::hash(_genesis_json);
+}
+
+void chain_generator::generate(database& db)
+{
+    for (uint32_t i = 0; i < _options.blocks; ++i)
+    {
+        for (uint32_t j = 0; j < _options.transactions_per_block; ++j)
+            push_action(db, choose_action());
+
+        db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), _key, database::skip_nothing);
+        _block_transactions.clear();
+
+        if (db.head_block_num() % 10000 == 0)
+            ilog("Generated block ${n}, ${o} operations", ("n", db.head_block_num())("o", _operations_count));
+    }
+}
+
+uint64_t chain_generator::random(uint64_t bound)
+{
+    // the output of mt19937_64 is fixed by the standard, unlike the distributions
+    return _rng() % bound;
+}
+
+chain_generator::action chain_generator::choose_action()
+{
+    const auto& weights = operation_mix_weights.at(_options.mix);
+
+    uint64_t total = 0;
+    for (const auto& weight : weights)
+        total += weight;
+
+    uint64_t value = random(total);
+    for (uint32_t a = 0; a < actions_count; ++a)
+    {
+        if (value < weights[a])
+            return static_cast<action>(a);
+        value -= weights[a];
+    }
+
+    return create_account;
+}
+
+/**
+ *  Pushes the action, or the action it depends on when it is not possible yet: a review
+ *  needs content, which needs research, which needs a research group, and so on.
+ */
+bool chain_generator::push_action(database& db, action a)
+{
+    switch (a)
+    {
+    case create_account:
+        return push_create_account(db);
+    case transfer:
+        return push_transfer(db) || push_action(db, create_account);
+    case create_research_group:
+        return push_create_research_group(db);
+    case create_research:
+        return push_create_research(db) || push_action(db, create_research_group);
+    case create_research_content:
+        return push_create_research_content(db) || push_action(db, create_research);
+    case create_review:
+        return push_create_review(db) || push_action(db, _users.empty() ? create_account : create_research_content);
+    case vote_for_review:
+        return push_vote_for_review(db) || push_action(db, create_review);
+    case create_research_license:
+        return push_create_research_license(db) || push_action(db, _users.empty() ? create_account : create_research);
+    case create_research_token_sale:
+        return push_create_research_token_sale(db) || push_action(db, create_research);
+    case contribute_to_token_sale:
+        return push_contribute_to_token_sale(db) || push_action(db, _users.empty() ? create_account : create_research_token_sale);
+    default:
+        FC_ASSERT(false, "Unknown action ${1}", ("1", static_cast<uint32_t>(a)));
+    }
+}
+
+bool chain_generator::push_create_account(database& db)
+{
+    const account_name_type name = "user-" + fc::to_string(_users.size());
+    const public_key_type public_key = _key.get_public_key();
+
+    begin_transaction(db);
+
+    create_account_operation create_op;
+    create_op.fee = asset(0, DEIP_SYMBOL);
+    create_op.creator = witness_account_name;
+    create_op.new_account_name = name;
+    create_op.owner = authority(1, public_key, 1);
+    create_op.active = authority(1, public_key, 1);
+    create_op.memo_key = public_key;
+    _trx.operations.push_back(create_op);
+
+    transfer_operation transfer_op;
+    transfer_op.from = witness_account_name;
+    transfer_op.to = name;
+    transfer_op.amount = asset(user_funding, DEIP_SYMBOL);
+    _trx.operations.push_back(transfer_op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _users.push_back(name);
+    _balances[name] = user_funding;
+    return true;
+}
+
+bool chain_generator::push_transfer(database& db)
+{
+    if (_users.size() < 2)
+        return false;
+
+    const account_name_type& from = random_user();
+    const account_name_type& to = random_user();
+    const share_type amount = static_cast<int64_t>(1 + random(100));
+
+    if (from == to || _balances[from] < amount)
+        return false;
+
+    begin_transaction(db);
+
+    transfer_operation op;
+    op.from = from;
+    op.to = to;
+    op.amount = asset(amount, DEIP_SYMBOL);
+    op.memo = fc::to_string(_operations_count);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _balances[from] -= amount;
+    _balances[to] += amount;
+    return true;
+}
+
+bool chain_generator::push_create_research_group(database& db)
+{
+    const public_key_type public_key = _key.get_public_key();
+
+    begin_transaction(db);
+
+    research_group_trait trait;
+    trait.description = "Research group " + fc::to_string(_research_groups.size());
+
+    create_account_operation op;
+    op.fee = asset(0, DEIP_SYMBOL);
+    op.creator = witness_account_name;
+    op.owner = authority(1, public_key, 1);
+    op.active = authority(1, public_key, 1);
+    op.memo_key = public_key;
+    op.traits.insert(trait);
+    op.new_account_name = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _research_groups.push_back(op.new_account_name);
+    return true;
+}
+
+bool chain_generator::push_create_research(database& db)
+{
+    if (_research_groups.empty())
+        return false;
+
+    begin_transaction(db);
+
+    create_research_operation op;
+    op.account = _research_groups[random(_research_groups.size())];
+    op.description = "Research " + fc::to_string(_researches.size());
+    op.disciplines.insert(_disciplines[random(_disciplines.size())]);
+    op.is_private = false;
+    op.external_id = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    research_info research;
+    research.external_id = op.external_id;
+    research.research_group = op.account;
+    research.discipline = *op.disciplines.begin();
+    _researches.push_back(research);
+    return true;
+}
+
+bool chain_generator::push_create_research_content(database& db)
+{
+    if (_researches.empty())
+        return false;
+
+    const research_info& research = _researches[random(_researches.size())];
+
+    begin_transaction(db);
+
+    create_research_content_operation op;
+    op.research_external_id = research.external_id;
+    op.research_group = research.research_group;
+    op.type = static_cast<uint16_t>(research_content_type::announcement);
+    op.description = "Content " + fc::to_string(_contents.size());
+    op.content = fc::ripemd160::hash(op.description).str();
+    op.authors.insert(research.research_group);
+    op.external_id = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _contents.push_back({ op.external_id, research.discipline });
+    return true;
+}
+
+bool chain_generator::push_create_review(database& db)
+{
+    if (_contents.empty() || _users.empty())
+        return false;
+
+    const content_info& content = _contents[random(_contents.size())];
+    const account_name_type& author = random_user();
+
+    if (_reviewed_contents.count(std::make_pair(author, content.external_id)) != 0)
+        return false;
+
+    begin_transaction(db);
+
+    binary_scoring_assessment_model_type assessment_model;
+    assessment_model.is_positive = random(2) == 0;
+
+    create_review_operation op;
+    op.author = author;
+    op.research_content_external_id = content.external_id;
+    op.content = "Review " + fc::to_string(_reviews.size());
+    op.weight = percent(DEIP_100_PERCENT);
+    op.assessment_model = assessment_model;
+    op.disciplines.insert(content.discipline);
+    op.external_id = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _reviewed_contents.insert(std::make_pair(author, content.external_id));
+    _reviews.push_back({ op.external_id, content.discipline });
+    return true;
+}
+
+bool chain_generator::push_vote_for_review(database& db)
+{
+    if (_reviews.empty() || _users.empty())
+        return false;
+
+    const review_info& review = _reviews[random(_reviews.size())];
+    const account_name_type& voter = random_user();
+
+    if (_voted_reviews.count(std::make_pair(voter, review.external_id)) != 0)
+        return false;
+
+    begin_transaction(db);
+
+    vote_for_review_operation op;
+    op.voter = voter;
+    op.review_external_id = review.external_id;
+    op.discipline_external_id = review.discipline;
+    op.weight = percent(static_cast<int64_t>(DEIP_1_PERCENT * (1 + random(100))));
+    op.external_id = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _voted_reviews.insert(std::make_pair(voter, review.external_id));
+    return true;
+}
+
+bool chain_generator::push_create_research_license(database& db)
+{
+    if (_researches.empty() || _users.empty())
+        return false;
+
+    const research_info& research = _researches[random(_researches.size())];
+    const account_name_type& licensee = random_user();
+
+    if (_balances[licensee] < license_fee)
+        return false;
+
+    begin_transaction(db);
+
+    licensing_fee_type fee_model;
+    fee_model.terms = "License " + fc::to_string(_operations_count);
+    fee_model.fee = asset(license_fee, DEIP_SYMBOL);
+
+    create_research_license_operation op;
+    op.research_external_id = research.external_id;
+    op.licenser = research.research_group;
+    op.licensee = licensee;
+    op.license_conditions = fee_model;
+    op.external_id = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _balances[licensee] -= license_fee;
+    return true;
+}
+
+bool chain_generator::push_create_research_token_sale(database& db)
+{
+    if (_researches.empty())
+        return false;
+
+    const size_t index = random(_researches.size());
+    research_info& research = _researches[index];
+
+    // the previous sale is closed by the block at its end time
+    if (research.token_sale_end_time + DEIP_BLOCK_INTERVAL >= db.head_block_time())
+        return false;
+
+    begin_transaction(db);
+
+    asset_symbol_type security_token;
+    if (research.security_token.valid())
+    {
+        security_token = *research.security_token;
+    }
+    else
+    {
+        const std::string symbol = security_token_symbol(index);
+        security_token = asset::from_string("0.000 " + symbol).symbol;
+
+        research_security_token_trait security_token_trait;
+        security_token_trait.research_external_id = research.external_id;
+        security_token_trait.research_group = research.research_group;
+
+        research_license_revenue_trait license_revenue_trait;
+        license_revenue_trait.holders_share = percent(DEIP_1_PERCENT * 10);
+
+        create_asset_operation create_op;
+        create_op.issuer = research.research_group;
+        create_op.symbol = symbol;
+        create_op.precision = 3;
+        create_op.max_supply = security_token_supply;
+        create_op.traits.insert(security_token_trait);
+        create_op.traits.insert(license_revenue_trait);
+        _trx.operations.push_back(create_op);
+
+        issue_asset_operation issue_op;
+        issue_op.issuer = research.research_group;
+        issue_op.amount = asset(security_token_supply, security_token);
+        issue_op.recipient = research.research_group;
+        _trx.operations.push_back(issue_op);
+    }
+
+    create_research_token_sale_operation op;
+    op.research_group = research.research_group;
+    op.research_external_id = research.external_id;
+    op.start_time = db.head_block_time() + DEIP_BLOCK_INTERVAL;
+    op.end_time = op.start_time + DEIP_BLOCK_INTERVAL * token_sale_blocks;
+    op.security_tokens_on_sale.insert(asset(security_tokens_on_sale, security_token));
+    op.soft_cap = asset(contribution_amount, DEIP_SYMBOL);
+    op.hard_cap = asset(init_supply, DEIP_SYMBOL);
+    op.external_id = entity_external_id(op);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    research.security_token = security_token;
+    research.token_sale_end_time = op.end_time;
+    _token_sales.push_back({ op.external_id, op.start_time, op.end_time });
+    return true;
+}
+
+bool chain_generator::push_contribute_to_token_sale(database& db)
+{
+    const fc::time_point_sec now = db.head_block_time();
+
+    // sales are opened by the block at their start time and closed by the block at their end time
+    _token_sales.erase(std::remove_if(_token_sales.begin(), _token_sales.end(),
+                                      [&](const token_sale_info& sale) { return sale.end_time <= now + DEIP_BLOCK_INTERVAL; }),
+                       _token_sales.end());
+
+    if (_token_sales.empty() || _users.empty())
+        return false;
+
+    const token_sale_info& sale = _token_sales[random(_token_sales.size())];
+    const account_name_type& contributor = random_user();
+
+    if (sale.start_time >= now || _balances[contributor] < contribution_amount)
+        return false;
+
+    begin_transaction(db);
+
+    contribute_to_token_sale_operation op;
+    op.token_sale_external_id = sale.external_id;
+    op.contributor = contributor;
+    op.amount = asset(contribution_amount, DEIP_SYMBOL);
+    _trx.operations.push_back(op);
+
+    if (!push_transaction(db))
+        return false;
+
+    _balances[contributor] -= contribution_amount;
+    return true;
+}
+
+void chain_generator::begin_transaction(const database& db)
+{
+    _trx.clear();
+    _trx.set_expiration(db.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+    _trx.set_reference_block(db.head_block_id());
+}
+
+/**
+ *  Pushes the transaction signed with the generator key, unless the same transaction is in
+ *  the pending block already.
+ */
+bool chain_generator::push_transaction(database& db)
+{
+    _trx.sign(_key, db.get_chain_id());
+
+    const bool is_pushed = _block_transactions.insert(_trx.id()).second;
+    if (is_pushed)
+    {
+        db.push_transaction(_trx, database::skip_nothing);
+        _operations_count += _trx.operations.size();
+    }
+
+    _trx.clear();
+    return is_pushed;
+}
+
+const account_name_type& chain_generator::random_user()
+{
+    return _users[random(_users.size())];
+}
+}
+}
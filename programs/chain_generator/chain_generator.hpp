@@ -0,0 +1,169 @@
+#pragma once
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/genesis_state.hpp>
+
+#include <fc/crypto/elliptic.hpp>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace deip {
+namespace generator {
+
+using namespace deip::chain;
+using namespace deip::protocol;
+
+enum class operation_mix
+{
+    research,
+    transfer,
+    token_sale
+};
+
+operation_mix operation_mix_from_string(const std::string& name);
+
+struct generator_options
+{
+    uint64_t seed = 0;
+    uint32_t blocks = 10000;
+    uint32_t transactions_per_block = 20;
+    uint32_t disciplines = 8;
+    operation_mix mix = operation_mix::research;
+    fc::time_point_sec genesis_time = fc::time_point_sec(1577836800);
+};
+
+/**
+ *  Produces a chain with a generated genesis the way debug_node_plugin does: transactions are
+ *  pushed as pending and blocks are generated with database::generate_block for the only
+ *  genesis witness.
+ *
+ *  Everything is derived from the seed: the genesis, the signing key shared by the witness and
+ *  all accounts, and the choice and arguments of every operation. Block times follow the slots
+ *  from the genesis time, so the same options always produce the same block_log.
+ */
+class chain_generator
+{
+public:
+    explicit chain_generator(const generator_options& options);
+
+    /**
+     *  Genesis of the generated chain, in the form deipd reads with --genesis-json.
+     */
+    const std::string& genesis_json() const
+    {
+        return _genesis_json;
+    }
+
+    const genesis_state_type& genesis() const
+    {
+        return _genesis;
+    }
+
+    /**
+     *  Generates the configured number of blocks on top of the database, which must be
+     *  opened with genesis().
+     */
+    void generate(database& db);
+
+private:
+    enum action
+    {
+        create_account,
+        transfer,
+        create_research_group,
+        create_research,
+        create_research_content,
+        create_review,
+        vote_for_review,
+        create_research_license,
+        create_research_token_sale,
+        contribute_to_token_sale,
+        actions_count
+    };
+
+    struct research_info
+    {
+        external_id_type external_id;
+        account_name_type research_group;
+        external_id_type discipline;
+        fc::optional<asset_symbol_type> security_token;
+        fc::time_point_sec token_sale_end_time;
+    };
+
+    struct token_sale_info
+    {
+        external_id_type external_id;
+        fc::time_point_sec start_time;
+        fc::time_point_sec end_time;
+    };
+
+    struct content_info
+    {
+        external_id_type external_id;
+        external_id_type discipline;
+    };
+
+    struct review_info
+    {
+        external_id_type external_id;
+        external_id_type discipline;
+    };
+
+    void generate_genesis();
+
+    uint64_t random(uint64_t bound);
+    action choose_action();
+
+    bool push_action(database& db, action a);
+
+    bool push_create_account(database& db);
+    bool push_transfer(database& db);
+    bool push_create_research_group(database& db);
+    bool push_create_research(database& db);
+    bool push_create_research_content(database& db);
+    bool push_create_review(database& db);
+    bool push_vote_for_review(database& db);
+    bool push_create_research_license(database& db);
+    bool push_create_research_token_sale(database& db);
+    bool push_contribute_to_token_sale(database& db);
+
+    void begin_transaction(const database& db);
+    bool push_transaction(database& db);
+
+    template <typename T> external_id_type entity_external_id(const T& op) const
+    {
+        return compute_entity_id(op, _trx.ref_block_num, _trx.ref_block_prefix);
+    }
+
+    const account_name_type& random_user();
+
+    const generator_options _options;
+    const fc::ecc::private_key _key;
+
+    std::mt19937_64 _rng;
+
+    genesis_state_type _genesis;
+    std::string _genesis_json;
+
+    signed_transaction _trx;
+    std::set<transaction_id_type> _block_transactions;
+    uint64_t _operations_count = 0;
+
+    std::vector<external_id_type> _disciplines;
+    std::vector<account_name_type> _users;
+    std::map<account_name_type, share_type> _balances;
+    std::vector<account_name_type> _research_groups;
+    std::vector<research_info> _researches;
+    std::vector<content_info> _contents;
+    std::vector<review_info> _reviews;
+    std::vector<token_sale_info> _token_sales;
+
+    std::set<std::pair<account_name_type, external_id_type>> _reviewed_contents;
+    std::set<std::pair<account_name_type, external_id_type>> _voted_reviews;
+};
+}
+}
@@ -0,0 +1,93 @@
+#include "chain_generator.hpp"
+
+#include <fc/filesystem.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/string.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+namespace bpo = boost::program_options;
+
+using namespace deip;
+using namespace deip::generator;
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        bpo::options_description options("Generates a deterministic synthetic chain for replay and sync testing");
+        options.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("data-dir,d", bpo::value<boost::filesystem::path>()->required(), "Directory to write the chain to, in the deipd data directory layout")
+            ("blocks,b", bpo::value<uint32_t>()->default_value(10000), "Number of blocks to generate")
+            ("seed,s", bpo::value<uint64_t>()->default_value(0), "Seed the genesis, keys and operations are derived from")
+            ("mix,m", bpo::value<std::string>()->default_value("research"), "Operation mix: research, transfer or token-sale")
+            ("transactions-per-block,t", bpo::value<uint32_t>()->default_value(20), "Number of transactions in every block")
+            ("disciplines", bpo::value<uint32_t>()->default_value(8), "Number of genesis disciplines besides the common one")
+            ("genesis-time", bpo::value<uint32_t>()->default_value(1577836800), "Genesis timestamp, in seconds since epoch")
+            ("shared-file-size", bpo::value<std::string>()->default_value("8G"), "Size of the shared memory file");
+
+        bpo::variables_map args;
+        bpo::store(bpo::parse_command_line(argc, argv, options), args);
+
+        if (args.count("help"))
+        {
+            std::cout << options << "\n";
+            return 0;
+        }
+
+        bpo::notify(args);
+
+        generator_options generator_opts;
+        generator_opts.seed = args["seed"].as<uint64_t>();
+        generator_opts.blocks = args["blocks"].as<uint32_t>();
+        generator_opts.transactions_per_block = args["transactions-per-block"].as<uint32_t>();
+        generator_opts.disciplines = args["disciplines"].as<uint32_t>();
+        generator_opts.mix = operation_mix_from_string(args["mix"].as<std::string>());
+        generator_opts.genesis_time = fc::time_point_sec(args["genesis-time"].as<uint32_t>());
+
+        const fc::path data_dir = args["data-dir"].as<boost::filesystem::path>();
+        const fc::path blockchain_dir = data_dir / "blockchain";
+        const fc::path genesis_path = data_dir / "genesis.json";
+
+        FC_ASSERT(!fc::exists(blockchain_dir), "${1} exists already", ("1", blockchain_dir));
+        fc::create_directories(blockchain_dir);
+
+        chain_generator generator(generator_opts);
+
+        {
+            fc::ofstream genesis_file(genesis_path);
+            genesis_file << generator.genesis_json();
+        }
+
+        chain::database db;
+        db._log_hardforks = false;
+        db.open(blockchain_dir, blockchain_dir, fc::parse_size(args["shared-file-size"].as<std::string>()),
+                chainbase::database::read_write, generator.genesis());
+
+        generator.generate(db);
+
+        const uint32_t head_block_num = db.head_block_num();
+        const auto head_block_id = db.head_block_id();
+        db.close();
+
+        std::cout << "Generated " << head_block_num << " blocks, head " << head_block_id.str() << "\n";
+        std::cout << "Chain id " << generator.genesis().initial_chain_id.str() << "\n";
+        std::cout << "Replay with: deipd --data-dir " << data_dir.generic_string() << " --genesis-json "
+                  << genesis_path.generic_string() << " --replay-blockchain\n";
+    }
+    catch (const fc::exception& e)
+    {
+        std::cerr << e.to_detail_string() << "\n";
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <deip/protocol/config.hpp>
+#include <deip/protocol/version.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/time.hpp>
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace deip {
+namespace chain {
+
+/**
+ *  Collects the results of a deip_bench run.
+ *
+ *  Every result is printed as a "name value unit" line. When DEIP_BENCH_OUTPUT is set, all
+ *  results are also written to that file as JSON at the end of the run, so that runs of
+ *  different releases can be compared by scripts.
+ */
+class benchmark_report
+{
+public:
+    static benchmark_report& instance()
+    {
+        static benchmark_report report;
+        return report;
+    }
+
+    void add(const std::string& name, double value, const std::string& unit)
+    {
+        std::cout << name << " " << value << " " << unit << "\n";
+
+        fc::mutable_variant_object metric;
+        metric("name", name)("value", value)("unit", unit);
+        _metrics.push_back(metric);
+    }
+
+    /**
+     *  Adds the 50th, 90th and 99th percentiles and the maximum of the samples.
+     */
+    void add_percentiles(const std::string& name, std::vector<double> samples, const std::string& unit)
+    {
+        if (samples.empty())
+            return;
+
+        std::sort(samples.begin(), samples.end());
+
+        add(name + "_p50", percentile(samples, 50), unit);
+        add(name + "_p90", percentile(samples, 90), unit);
+        add(name + "_p99", percentile(samples, 99), unit);
+        add(name + "_max", samples.back(), unit);
+    }
+
+    void write() const
+    {
+        const char* path = std::getenv("DEIP_BENCH_OUTPUT");
+        if (path == nullptr)
+            return;
+
+        fc::mutable_variant_object report;
+        report("blockchain_version", DEIP_BLOCKCHAIN_VERSION)
+              ("timestamp", fc::time_point_sec(fc::time_point::now()))
+              ("metrics", _metrics);
+
+        fc::json::save_to_file(fc::variant(report), fc::path(path));
+    }
+
+private:
+    benchmark_report() = default;
+
+    static double percentile(const std::vector<double>& sorted_samples, uint32_t percent)
+    {
+        const size_t index = (sorted_samples.size() - 1) * percent / 100;
+        return sorted_samples[index];
+    }
+
+    std::vector<fc::variant> _metrics;
+};
+}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/genesis_state.hpp>
+
+#include <cstdlib>
+
+#include "database_fixture.hpp"
+
+namespace deip {
+namespace chain {
+
+/**
+ *  Opens the database with the genesis of database_fixture.
+ */
+inline void open_benchmark_database(database& db, const fc::path& path)
+{
+    genesis_state_type genesis;
+
+    genesis.init_supply = TEST_INITIAL_SUPPLY;
+    genesis.init_rewards_supply = TEST_REWARD_INITIAL_SUPPLY;
+    genesis.initial_chain_id = TEST_CHAIN_ID;
+    genesis.initial_timestamp = fc::time_point_sec(TEST_GENESIS_TIMESTAMP);
+    auto registrar = genesis_state_type::registrar_account_type();
+    registrar.name = DEIP_REGISTRAR_ACCOUNT_NAME;
+    registrar.public_key = public_key_type();
+    genesis.registrar_account = registrar;
+
+    genesis.assets.push_back({ "TESTS", 3, 0 });
+
+    create_disciplines_for_genesis_state(genesis);
+    create_initdelegate_for_genesis_state(genesis);
+    create_initdelegate_expert_tokens_for_genesis_state(genesis);
+
+    db._log_hardforks = false;
+    db.open(path, path, TEST_SHARED_MEM_SIZE_128MB, chainbase::database::read_write, genesis);
+}
+
+/**
+ *  Reads a benchmark size from the environment.
+ */
+inline uint32_t benchmark_parameter(const char* name, uint32_t default_value)
+{
+    const char* value = std::getenv(name);
+    return value != nullptr ? std::strtoul(value, nullptr, 10) : default_value;
+}
+}
+}
@@ -0,0 +1,118 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/chain/services/dbs_account.hpp>
+#include <deip/chain/services/dbs_discipline.hpp>
+#include <deip/chain/services/dbs_expert_token.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <chrono>
+
+#include "bench_report.hpp"
+#include "benchmark_database.hpp"
+
+using namespace deip;
+using namespace deip::chain;
+using namespace deip::protocol;
+
+namespace {
+
+struct account_creation_result
+{
+    double accounts_per_sec = 0;
+    size_t shared_memory_per_account = 0;
+    size_t expert_tokens = 0;
+};
+
+/**
+ *  Creates user accounts the way create_account_evaluator does. With materialize set every
+ *  default expert token is created right away, which is the state the evaluator produced
+ *  before the default expertise became implicit.
+ */
+account_creation_result create_accounts(uint32_t accounts_count, bool materialize)
+{
+    fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+    database db;
+    open_benchmark_database(db, data_dir.path());
+
+    auto& account_service = db.obtain_service<dbs_account>();
+    auto& discipline_service = db.obtain_service<dbs_discipline>();
+    auto& expert_token_service = db.obtain_service<dbs_expert_token>();
+
+    const auto key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("bench_key"))).get_public_key();
+    const auto& disciplines = discipline_service.lookup_disciplines(discipline_id_type(0), DEIP_API_BULK_FETCH_LIMIT);
+
+    const size_t free_memory_before = db.get_free_memory();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < accounts_count; ++i)
+    {
+        const account_name_type name = "bench-" + fc::to_string(i);
+
+        account_service.create_account_by_faucets(name, "initdelegate", key, fc::optional<std::string>(),
+                                                  authority(1, key, 1), authority(1, key, 1),
+                                                  flat_map<uint16_t, authority>(), asset(0, DEIP_SYMBOL),
+                                                  flat_set<account_trait>(), true);
+        expert_token_service.grant_default_expertise(name);
+
+        if (!materialize)
+            continue;
+
+        for (const discipline_object& discipline : disciplines)
+        {
+            if (expert_token_service.has_implicit_expert_token(name, discipline.id))
+                expert_token_service.materialize_expert_token(name, discipline.id);
+        }
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    account_creation_result result;
+    result.accounts_per_sec = accounts_count / std::chrono::duration<double>(elapsed).count();
+    result.shared_memory_per_account = (free_memory_before - db.get_free_memory()) / accounts_count;
+    result.expert_tokens = db.get_index<expert_token_index>().indices().size();
+
+    db.close();
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(expertise_benchmark)
+
+/**
+ *  Compares user account creation with implicit default expertise against materialized
+ *  default expert tokens: throughput and shared memory used per account.
+ *
+ *  The account count is taken from DEIP_BENCH_ACCOUNTS.
+ */
+BOOST_AUTO_TEST_CASE(account_creation)
+{
+    try
+    {
+        const uint32_t accounts_count = benchmark_parameter("DEIP_BENCH_ACCOUNTS", 2000);
+
+        const auto materialized = create_accounts(accounts_count, true);
+        const auto implicit = create_accounts(accounts_count, false);
+
+        BOOST_REQUIRE(implicit.expert_tokens < materialized.expert_tokens);
+
+        auto& report = benchmark_report::instance();
+        report.add("accounts", accounts_count, "count");
+        report.add("account_creation_materialized", materialized.accounts_per_sec, "accounts/s");
+        report.add("account_creation_implicit", implicit.accounts_per_sec, "accounts/s");
+        report.add("shared_memory_per_account_materialized", materialized.shared_memory_per_account, "bytes");
+        report.add("shared_memory_per_account_implicit", implicit.shared_memory_per_account, "bytes");
+        report.add("expert_tokens_materialized", materialized.expert_tokens, "count");
+        report.add("expert_tokens_implicit", implicit.expert_tokens, "count");
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,164 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/app/api_context.hpp>
+#include <deip/app/binary_rpc.hpp>
+#include <deip/app/database_api.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <chrono>
+#include <functional>
+#include <set>
+#include <string>
+
+#include "bench_report.hpp"
+#include "benchmark_database.hpp"
+
+using namespace deip;
+using namespace deip::app;
+using namespace deip::chain;
+using namespace deip::protocol;
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+/**
+ *  Chain with blocks full of transfers and a set of funded accounts, and a session with
+ *  database_api to call over binary RPC.
+ */
+struct rpc_fixture : public clean_database_fixture
+{
+    rpc_fixture()
+        : calls(benchmark_parameter("DEIP_BENCH_RPC_CALLS", 2000))
+        , session(std::make_shared<api_session_data>())
+    {
+        const uint32_t accounts = benchmark_parameter("DEIP_BENCH_RPC_ACCOUNTS", 50);
+        const uint32_t transfers = benchmark_parameter("DEIP_BENCH_RPC_TRANSFERS_PER_BLOCK", 200);
+
+        for (uint32_t i = 0; i < accounts; ++i)
+        {
+            const std::string name = "account" + fc::to_string(i);
+            create_account(name, init_account_pub_key);
+            fund(name, 1000);
+            account_names.insert(name);
+        }
+        generate_block();
+
+        for (uint32_t i = 0; i < transfers; ++i)
+        {
+            signed_transaction tx;
+            transfer_operation op;
+            op.from = TEST_INIT_DELEGATE_NAME;
+            op.to = "account" + fc::to_string(i % accounts);
+            op.amount = asset(i + 1, DEIP_SYMBOL);
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+            tx.set_reference_block(db.head_block_id());
+            tx.sign(init_account_priv_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+        }
+        generate_block();
+        full_block_num = db.head_block_num();
+
+        app.register_api_factory<database_api>("database_api");
+        app.register_binary_api_factory<database_api>("database_api");
+
+        api_context ctx(app, "database_api", session);
+        session->api_map["database_api"] = app.create_api_by_name(ctx);
+
+        binary_rpc_request negotiate;
+        negotiate.api = binary_rpc_negotiate_api;
+        negotiate.method = binary_rpc_negotiate_method;
+        negotiate.params = fc::raw::pack(binary_rpc_version);
+        BOOST_REQUIRE(!app.call_binary_api(*session, negotiate).error.valid());
+
+        api = std::dynamic_pointer_cast<fc::api<database_api>>(session->api_map["database_api"]);
+        BOOST_REQUIRE(api);
+    }
+
+    /**
+     *  Reports calls per second and response size of a method over JSON, as
+     *  websocket_api_connection encodes results, and over binary RPC, both decoded by the client.
+     */
+    template <typename R, typename... Args>
+    void compare(const std::string& name, const std::string& method, std::function<R()> local_call, const Args&... args)
+    {
+        size_t json_bytes = 0;
+        const auto json_start = bench_clock::now();
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            const std::string response = fc::json::to_string(fc::variant(local_call()));
+            json_bytes = response.size();
+
+            const R decoded = fc::json::from_string(response).as<R>();
+            (void)decoded;
+        }
+        const double json_seconds = std::chrono::duration<double>(bench_clock::now() - json_start).count();
+
+        binary_rpc_request request;
+        request.api = "database_api";
+        request.method = method;
+        (void)std::initializer_list<int>{ (detail::append_binary_rpc_param(request.params, args), 0)... };
+        const std::string request_frame = pack_binary_rpc_frame(request);
+
+        size_t binary_bytes = 0;
+        const auto binary_start = bench_clock::now();
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            const binary_rpc_request received = unpack_binary_rpc_frame<binary_rpc_request>(request_frame);
+            const std::string response = pack_binary_rpc_frame(app.call_binary_api(*session, received));
+            binary_bytes = response.size();
+
+            const R decoded = fc::raw::unpack<R>(unpack_binary_rpc_frame<binary_rpc_response>(response).result);
+            (void)decoded;
+        }
+        const double binary_seconds = std::chrono::duration<double>(bench_clock::now() - binary_start).count();
+
+        auto& report = benchmark_report::instance();
+        report.add(name + "_json", calls / json_seconds, "calls/s");
+        report.add(name + "_binary", calls / binary_seconds, "calls/s");
+        report.add(name + "_json_response_size", json_bytes, "bytes");
+        report.add(name + "_binary_response_size", binary_bytes, "bytes");
+    }
+
+    const uint32_t calls;
+    std::shared_ptr<api_session_data> session;
+    std::shared_ptr<fc::api<database_api>> api;
+    std::set<std::string> account_names;
+    uint32_t full_block_num = 0;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(rpc_benchmark, rpc_fixture)
+
+/**
+ *  Compares JSON and binary RPC throughput of get_block and get_accounts. The workload size is
+ *  taken from DEIP_BENCH_RPC_CALLS, DEIP_BENCH_RPC_ACCOUNTS and
+ *  DEIP_BENCH_RPC_TRANSFERS_PER_BLOCK.
+ */
+BOOST_AUTO_TEST_CASE(json_and_binary_rpc)
+{
+    try
+    {
+        const uint32_t block_num = full_block_num;
+        const std::set<std::string> names = account_names;
+        const fc::api<database_api> local_api = *api;
+
+        compare<optional<signed_block_api_obj>>("get_block", "get_block",
+                                                [&]() { return local_api->get_block(block_num); }, block_num);
+
+        compare<vector<optional<account_api_obj>>>("get_accounts", "get_accounts",
+                                                   [&]() { return local_api->get_accounts(names); }, names);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
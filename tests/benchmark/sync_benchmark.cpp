@@ -0,0 +1,257 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/chain/database/block_prevalidator.hpp>
+#include <deip/chain/database/parallel_transaction_verifier.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <chrono>
+
+#include "bench_report.hpp"
+#include "benchmark_database.hpp"
+
+using namespace deip;
+using namespace deip::chain;
+using namespace deip::protocol;
+
+namespace {
+
+double blocks_per_sec(uint32_t blocks, std::chrono::steady_clock::duration elapsed)
+{
+    return blocks / std::chrono::duration<double>(elapsed).count();
+}
+
+/// Signs the transaction with the key and with the init key as the tenant, as a client would
+void sign_with_tenant(signed_transaction& trx, const fc::ecc::private_key& key, const chain_id_type& chain_id)
+{
+    trx.sign(key, chain_id);
+
+    tenant_affirmation_type tenant;
+    tenant.tenant = TEST_INIT_DELEGATE_NAME;
+    tenant.signature = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")))
+                           .sign_compact(trx.sig_digest(chain_id));
+    trx.tenant_signature = tenant;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(sync_benchmark)
+
+/**
+ *  Syncs two local databases from the same generated chain of transfer blocks: one pushes
+ *  blocks serially the way handle_block does without verification threads, the other
+ *  verifies signatures and merkle roots in a block_prevalidator ahead of application.
+ *
+ *  The size is taken from DEIP_BENCH_SYNC_BLOCKS and DEIP_BENCH_SYNC_TRANSACTIONS_PER_BLOCK.
+ */
+BOOST_AUTO_TEST_CASE(sync_blocks_per_sec)
+{
+    try
+    {
+        const uint32_t blocks_count = benchmark_parameter("DEIP_BENCH_SYNC_BLOCKS", 2000);
+        const uint32_t transactions_per_block = benchmark_parameter("DEIP_BENCH_SYNC_TRANSACTIONS_PER_BLOCK", 50);
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+
+        std::vector<signed_block> blocks;
+        {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            database source;
+            open_benchmark_database(source, data_dir.path());
+            const chain_id_type chain_id = source.get_chain_id();
+
+            auto push = [&](const operation& op) {
+                signed_transaction trx;
+                trx.operations.push_back(op);
+                trx.set_expiration(source.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+                trx.set_reference_block(source.head_block_id());
+                sign_with_tenant(trx, init_account_priv_key, chain_id);
+                source.push_transaction(trx, database::skip_nothing);
+            };
+
+            auto generate = [&]() {
+                return source.generate_block(source.get_slot_time(1), source.get_scheduled_witness(1),
+                                             init_account_priv_key, database::skip_nothing);
+            };
+
+            for (uint32_t i = 0; i < transactions_per_block; ++i)
+            {
+                create_account_operation op;
+                op.new_account_name = "syncaccount" + fc::to_string(i);
+                op.creator = TEST_INIT_DELEGATE_NAME;
+                op.owner = authority(1, public_key_type(init_account_priv_key.get_public_key()), 1);
+                op.active = op.owner;
+                op.memo_key = init_account_priv_key.get_public_key();
+                op.fee = asset(30000, DEIP_SYMBOL);
+                push(op);
+            }
+
+            blocks.reserve(blocks_count);
+            blocks.push_back(generate());
+
+            while (blocks.size() < blocks_count)
+            {
+                for (uint32_t i = 0; i < transactions_per_block; ++i)
+                {
+                    transfer_operation op;
+                    op.from = TEST_INIT_DELEGATE_NAME;
+                    op.to = "syncaccount" + fc::to_string(i);
+                    op.amount = asset(blocks.size(), DEIP_SYMBOL);
+                    push(op);
+                }
+                blocks.push_back(generate());
+            }
+        }
+
+        fc::temp_directory serial_dir(graphene::utilities::temp_directory_path());
+        database serial;
+        open_benchmark_database(serial, serial_dir.path());
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& b : blocks)
+            serial.push_block(b, database::skip_transaction_signatures);
+        const auto serial_elapsed = std::chrono::steady_clock::now() - start;
+
+        fc::temp_directory parallel_dir(graphene::utilities::temp_directory_path());
+        database parallel;
+        open_benchmark_database(parallel, parallel_dir.path());
+
+        block_prevalidator prevalidator(2);
+
+        start = std::chrono::steady_clock::now();
+        for (const auto& b : blocks)
+            prevalidator.schedule(b);
+        for (const auto& b : blocks)
+            parallel.push_block(b, database::skip_transaction_signatures | prevalidator.get_skip_flags(parallel, b));
+        const auto parallel_elapsed = std::chrono::steady_clock::now() - start;
+
+        BOOST_REQUIRE(serial.head_block_id() == parallel.head_block_id());
+
+        auto& report = benchmark_report::instance();
+        report.add("sync_blocks", blocks_count, "count");
+        report.add("sync_transactions_per_block", transactions_per_block, "count");
+        report.add("sync_serial", blocks_per_sec(blocks_count, serial_elapsed), "blocks/s");
+        report.add("sync_prevalidated", blocks_per_sec(blocks_count, parallel_elapsed), "blocks/s");
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+/**
+ *  Applies the same generated blocks of transfers between distinct accounts with all
+ *  signatures checked, once verifying the transactions serially and once with a
+ *  parallel_transaction_verifier.
+ *
+ *  The size is taken from DEIP_BENCH_VERIFIED_BLOCKS, DEIP_BENCH_VERIFIED_TRANSACTIONS_PER_BLOCK
+ *  and DEIP_BENCH_VERIFICATION_THREADS.
+ */
+BOOST_AUTO_TEST_CASE(verified_transactions_per_sec)
+{
+    try
+    {
+        const uint32_t blocks_count = benchmark_parameter("DEIP_BENCH_VERIFIED_BLOCKS", 20);
+        const uint32_t transactions_per_block = benchmark_parameter("DEIP_BENCH_VERIFIED_TRANSACTIONS_PER_BLOCK", 200);
+        const uint32_t threads = benchmark_parameter("DEIP_BENCH_VERIFICATION_THREADS", 4);
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+
+        auto key_of = [](uint32_t i) {
+            return fc::ecc::private_key::regenerate(fc::sha256::hash("account" + fc::to_string(i)));
+        };
+
+        std::vector<signed_block> setup_blocks;
+        std::vector<signed_block> blocks;
+        {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            database source;
+            open_benchmark_database(source, data_dir.path());
+            const chain_id_type chain_id = source.get_chain_id();
+
+            auto push = [&](const operation& op, const fc::ecc::private_key& key) {
+                signed_transaction trx;
+                trx.operations.push_back(op);
+                trx.set_expiration(source.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+                trx.set_reference_block(source.head_block_id());
+                sign_with_tenant(trx, key, chain_id);
+                source.push_transaction(trx, database::skip_nothing);
+            };
+
+            auto generate = [&]() {
+                return source.generate_block(source.get_slot_time(1), source.get_scheduled_witness(1),
+                                             init_account_priv_key, database::skip_nothing);
+            };
+
+            for (uint32_t i = 0; i < transactions_per_block; ++i)
+            {
+                create_account_operation op;
+                op.new_account_name = "account" + fc::to_string(i);
+                op.creator = TEST_INIT_DELEGATE_NAME;
+                op.owner = authority(1, public_key_type(key_of(i).get_public_key()), 1);
+                op.active = op.owner;
+                op.memo_key = key_of(i).get_public_key();
+                op.fee = asset(30000, DEIP_SYMBOL);
+                push(op, init_account_priv_key);
+            }
+            setup_blocks.push_back(generate());
+
+            for (uint32_t i = 0; i < transactions_per_block; ++i)
+            {
+                transfer_operation op;
+                op.from = TEST_INIT_DELEGATE_NAME;
+                op.to = "account" + fc::to_string(i);
+                op.amount = asset(100000, DEIP_SYMBOL);
+                push(op, init_account_priv_key);
+            }
+            setup_blocks.push_back(generate());
+
+            for (uint32_t b = 0; b < blocks_count; ++b)
+            {
+                for (uint32_t i = 0; i < transactions_per_block; ++i)
+                {
+                    transfer_operation op;
+                    op.from = "account" + fc::to_string(i);
+                    op.to = "account" + fc::to_string((i + 1) % transactions_per_block);
+                    op.amount = asset(b + 1, DEIP_SYMBOL);
+                    push(op, key_of(i));
+                }
+                blocks.push_back(generate());
+            }
+        }
+
+        auto apply = [&](uint32_t verification_threads) -> std::chrono::steady_clock::duration {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            database db;
+            open_benchmark_database(db, data_dir.path());
+            db.set_transaction_verification_threads(verification_threads);
+
+            for (const auto& b : setup_blocks)
+                db.push_block(b);
+
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& b : blocks)
+                db.push_block(b);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            BOOST_REQUIRE(db.head_block_id() == blocks.back().id());
+            return elapsed;
+        };
+
+        const auto serial_elapsed = apply(0);
+        const auto parallel_elapsed = apply(threads);
+
+        auto& report = benchmark_report::instance();
+        report.add("verified_transactions_per_block", transactions_per_block, "count");
+        report.add("verified_serial", blocks_per_sec(blocks_count * transactions_per_block, serial_elapsed), "trx/s");
+        report.add("verified_parallel", blocks_per_sec(blocks_count * transactions_per_block, parallel_elapsed), "trx/s");
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,137 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/schema/transaction_object.hpp>
+
+#include <chrono>
+#include <vector>
+
+#include "bench_report.hpp"
+#include "benchmark_database.hpp"
+
+using namespace deip;
+using namespace deip::chain;
+using namespace deip::protocol;
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+/**
+ *  Pushes single transfer transactions, so that every one of them leaves an entry in the
+ *  transaction dedupe index until it expires.
+ */
+struct transaction_fixture : public clean_database_fixture
+{
+    transaction_fixture()
+        : blocks(benchmark_parameter("DEIP_BENCH_TRANSACTION_BLOCKS", 20))
+        , transactions_per_block(benchmark_parameter("DEIP_BENCH_TRANSACTIONS_PER_BLOCK", 500))
+    {
+        begin_transaction();
+
+        create_account_operation op;
+        op.fee = asset(0, DEIP_SYMBOL);
+        op.creator = TEST_INIT_DELEGATE_NAME;
+        op.new_account_name = "recipient";
+        op.owner = authority(1, init_account_pub_key, 1);
+        op.active = authority(1, init_account_pub_key, 1);
+        op.memo_key = init_account_pub_key;
+        trx.operations.push_back(op);
+        trx.sign(init_account_priv_key, db.get_chain_id());
+        db.push_transaction(trx, 0);
+
+        generate_block();
+    }
+
+    void begin_transaction()
+    {
+        trx.clear();
+        trx.set_expiration(db.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+        trx.set_reference_block(db.head_block_id());
+    }
+
+    transaction_id_type push_transfer(uint32_t n)
+    {
+        begin_transaction();
+
+        // distinct amounts keep the transactions of a block distinct
+        transfer_operation op;
+        op.from = TEST_INIT_DELEGATE_NAME;
+        op.to = "recipient";
+        op.amount = asset(n + 1, DEIP_SYMBOL);
+        trx.operations.push_back(op);
+        trx.sign(init_account_priv_key, db.get_chain_id());
+
+        db.push_transaction(trx, 0);
+        return trx.id();
+    }
+
+    const uint32_t blocks;
+    const uint32_t transactions_per_block;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(transaction_benchmark, transaction_fixture)
+
+/**
+ *  Reports push_transaction throughput, the shared memory taken per transaction while it
+ *  stays in the dedupe index, and the latency of looking up a recent transaction by id.
+ *
+ *  The workload size is taken from DEIP_BENCH_TRANSACTION_BLOCKS and
+ *  DEIP_BENCH_TRANSACTIONS_PER_BLOCK.
+ */
+BOOST_AUTO_TEST_CASE(transfer_transactions)
+{
+    try
+    {
+        const size_t free_memory_before = db.get_free_memory();
+
+        std::vector<transaction_id_type> transaction_ids;
+        bench_clock::duration push_duration{};
+
+        for (uint32_t block = 0; block < blocks; ++block)
+        {
+            for (uint32_t i = 0; i < transactions_per_block; ++i)
+            {
+                const auto start = bench_clock::now();
+                transaction_ids.push_back(push_transfer(i));
+                push_duration += bench_clock::now() - start;
+            }
+
+            generate_block();
+        }
+
+        const size_t shared_memory_growth = free_memory_before - db.get_free_memory();
+        const size_t dedupe_entries = db.get_index<transaction_index>().indices().size();
+
+        BOOST_REQUIRE(dedupe_entries >= transaction_ids.size());
+
+        std::vector<double> lookup_latencies;
+        lookup_latencies.reserve(transaction_ids.size());
+        for (const transaction_id_type& id : transaction_ids)
+        {
+            const auto start = bench_clock::now();
+            const signed_transaction recent = db.get_recent_transaction(id);
+            lookup_latencies.push_back(std::chrono::duration<double, std::micro>(bench_clock::now() - start).count());
+
+            BOOST_REQUIRE(recent.id() == id);
+        }
+
+        auto& report = benchmark_report::instance();
+        report.add("transfer_push_transaction",
+                   transaction_ids.size() / std::chrono::duration<double>(push_duration).count(), "trx/s");
+        report.add("transaction_dedupe_entries", dedupe_entries, "count");
+        report.add("shared_memory_growth_per_transaction", shared_memory_growth / transaction_ids.size(), "bytes");
+        report.add_percentiles("get_recent_transaction_latency", lookup_latencies, "us");
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
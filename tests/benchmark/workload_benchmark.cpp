@@ -0,0 +1,409 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/chain/database/database.hpp>
+#include <deip/chain/schema/research_content_object.hpp>
+#include <deip/chain/services/dbs_discipline.hpp>
+
+#include <chrono>
+#include <map>
+
+#include "bench_report.hpp"
+#include "benchmark_database.hpp"
+
+using namespace deip;
+using namespace deip::chain;
+using namespace deip::protocol;
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+double to_milliseconds(bench_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::string security_token_symbol(uint32_t index)
+{
+    std::string symbol = "R";
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        symbol += char('A' + index % 26);
+        index /= 26;
+    }
+    return symbol;
+}
+
+/**
+ *  Runs the research flows of the platform through push_transaction: user accounts and
+ *  transfers, research groups with their research, content and security tokens, reviews,
+ *  review votes, licenses and token sale contributions.
+ *
+ *  All accounts share the init key, so every transaction carries a single signature.
+ */
+struct workload_fixture : public clean_database_fixture
+{
+    workload_fixture()
+        : rounds(benchmark_parameter("DEIP_BENCH_WORKLOAD_ROUNDS", 20))
+        , round_size(benchmark_parameter("DEIP_BENCH_WORKLOAD_SIZE", 20))
+    {
+        auto& discipline_service = db.obtain_service<dbs_discipline>();
+        for (const discipline_object& discipline : discipline_service.lookup_disciplines(discipline_id_type(0), DEIP_API_BULK_FETCH_LIMIT))
+        {
+            if (discipline.external_id != DEIP_COMMON_DISCIPLINE_ID)
+            {
+                discipline_external_id = discipline.external_id;
+                break;
+            }
+        }
+    }
+
+    template <typename T> external_id_type entity_external_id(const T& op) const
+    {
+        return compute_entity_id(op, trx.ref_block_num, trx.ref_block_prefix);
+    }
+
+    void begin_transaction()
+    {
+        trx.clear();
+        trx.set_expiration(db.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+        trx.set_reference_block(db.head_block_id());
+    }
+
+    void push_operation(const std::string& flow, const operation& op)
+    {
+        trx.operations.push_back(op);
+        trx.sign(init_account_priv_key, db.get_chain_id());
+
+        const auto start = bench_clock::now();
+        db.push_transaction(trx, 0);
+        push_durations[flow] += bench_clock::now() - start;
+        ++push_counts[flow];
+
+        trx.clear();
+    }
+
+    void timed_generate_block()
+    {
+        const auto start = bench_clock::now();
+        generate_block();
+        block_latencies.push_back(to_milliseconds(bench_clock::now() - start));
+    }
+
+    account_name_type create_user(const std::string& name)
+    {
+        begin_transaction();
+
+        create_account_operation op;
+        op.fee = asset(0, DEIP_SYMBOL);
+        op.creator = TEST_INIT_DELEGATE_NAME;
+        op.new_account_name = name;
+        op.owner = authority(1, init_account_pub_key, 1);
+        op.active = authority(1, init_account_pub_key, 1);
+        op.memo_key = init_account_pub_key;
+        push_operation("create_account", op);
+
+        return op.new_account_name;
+    }
+
+    void transfer_to(const account_name_type& to, const asset& amount)
+    {
+        begin_transaction();
+
+        transfer_operation op;
+        op.from = TEST_INIT_DELEGATE_NAME;
+        op.to = to;
+        op.amount = amount;
+        push_operation("transfer", op);
+    }
+
+    account_name_type create_research_group(uint32_t index)
+    {
+        begin_transaction();
+
+        research_group_trait trait;
+        trait.description = "Benchmark group " + fc::to_string(index);
+
+        create_account_operation op;
+        op.fee = asset(0, DEIP_SYMBOL);
+        op.creator = TEST_INIT_DELEGATE_NAME;
+        op.owner = authority(1, init_account_pub_key, 1);
+        op.active = authority(1, init_account_pub_key, 1);
+        op.memo_key = init_account_pub_key;
+        op.traits.insert(trait);
+        op.new_account_name = entity_external_id(op);
+        push_operation("create_research_group", op);
+
+        return op.new_account_name;
+    }
+
+    external_id_type create_research(const account_name_type& research_group, uint32_t index)
+    {
+        begin_transaction();
+
+        create_research_operation op;
+        op.account = research_group;
+        op.description = "Benchmark research " + fc::to_string(index);
+        op.disciplines.insert(discipline_external_id);
+        op.is_private = false;
+        op.external_id = entity_external_id(op);
+        push_operation("create_research", op);
+
+        return op.external_id;
+    }
+
+    external_id_type create_research_content(const account_name_type& research_group, const external_id_type& research, uint32_t index)
+    {
+        begin_transaction();
+
+        create_research_content_operation op;
+        op.research_external_id = research;
+        op.research_group = research_group;
+        op.type = static_cast<uint16_t>(research_content_type::announcement);
+        op.description = "Benchmark content " + fc::to_string(index);
+        op.content = "content-" + fc::to_string(index);
+        op.authors.insert(research_group);
+        op.external_id = entity_external_id(op);
+        push_operation("create_research_content", op);
+
+        return op.external_id;
+    }
+
+    asset_symbol_type tokenize_research(const account_name_type& research_group, const external_id_type& research, uint32_t index)
+    {
+        const std::string symbol = security_token_symbol(index);
+        const asset_symbol_type symbol_type = asset::from_string("0.000 " + symbol).symbol;
+
+        research_security_token_trait security_token_trait;
+        security_token_trait.research_external_id = research;
+        security_token_trait.research_group = research_group;
+
+        research_license_revenue_trait license_revenue_trait;
+        license_revenue_trait.holders_share = percent(DEIP_1_PERCENT * 10);
+
+        begin_transaction();
+
+        create_asset_operation create_op;
+        create_op.issuer = research_group;
+        create_op.symbol = symbol;
+        create_op.precision = 3;
+        create_op.max_supply = 10000;
+        create_op.traits.insert(security_token_trait);
+        create_op.traits.insert(license_revenue_trait);
+        push_operation("create_asset", create_op);
+
+        begin_transaction();
+
+        issue_asset_operation issue_op;
+        issue_op.issuer = research_group;
+        issue_op.amount = asset(10000, symbol_type);
+        issue_op.recipient = research_group;
+        push_operation("issue_asset", issue_op);
+
+        return symbol_type;
+    }
+
+    external_id_type create_token_sale(const account_name_type& research_group, const external_id_type& research, const asset_symbol_type& security_token)
+    {
+        begin_transaction();
+
+        create_research_token_sale_operation op;
+        op.research_group = research_group;
+        op.research_external_id = research;
+        op.start_time = db.head_block_time() + DEIP_BLOCK_INTERVAL;
+        op.end_time = op.start_time + fc::days(1);
+        op.security_tokens_on_sale.insert(asset(1000, security_token));
+        op.soft_cap = asset(1, DEIP_SYMBOL);
+        op.hard_cap = asset(TEST_INITIAL_SUPPLY, DEIP_SYMBOL);
+        op.external_id = entity_external_id(op);
+        push_operation("create_research_token_sale", op);
+
+        return op.external_id;
+    }
+
+    external_id_type create_review(const account_name_type& author, const external_id_type& research_content)
+    {
+        begin_transaction();
+
+        binary_scoring_assessment_model_type assessment_model;
+        assessment_model.is_positive = true;
+
+        create_review_operation op;
+        op.author = author;
+        op.research_content_external_id = research_content;
+        op.content = "Review by " + std::string(author);
+        op.weight = percent(DEIP_100_PERCENT);
+        op.assessment_model = assessment_model;
+        op.disciplines.insert(discipline_external_id);
+        op.external_id = entity_external_id(op);
+        push_operation("create_review", op);
+
+        return op.external_id;
+    }
+
+    void vote_for_review(const account_name_type& voter, const external_id_type& review)
+    {
+        begin_transaction();
+
+        vote_for_review_operation op;
+        op.voter = voter;
+        op.review_external_id = review;
+        op.discipline_external_id = discipline_external_id;
+        op.weight = percent(DEIP_1_PERCENT * 50);
+        op.external_id = entity_external_id(op);
+        push_operation("vote_for_review", op);
+    }
+
+    void create_license(const account_name_type& research_group, const external_id_type& research, const account_name_type& licensee)
+    {
+        begin_transaction();
+
+        licensing_fee_type fee_model;
+        fee_model.terms = "Benchmark license for " + std::string(licensee);
+        fee_model.fee = asset(10, DEIP_SYMBOL);
+
+        create_research_license_operation op;
+        op.research_external_id = research;
+        op.licenser = research_group;
+        op.licensee = licensee;
+        op.license_conditions = fee_model;
+        op.external_id = entity_external_id(op);
+        push_operation("create_research_license", op);
+    }
+
+    void contribute(const account_name_type& contributor, const external_id_type& token_sale)
+    {
+        begin_transaction();
+
+        contribute_to_token_sale_operation op;
+        op.token_sale_external_id = token_sale;
+        op.contributor = contributor;
+        op.amount = asset(10, DEIP_SYMBOL);
+        push_operation("contribute_to_token_sale", op);
+    }
+
+    /**
+     *  Each round creates round_size users and a research group, runs every flow on them and
+     *  closes the round with a block. Token sales start in the block after their creation,
+     *  so a round produces three blocks.
+     */
+    void run_round(uint32_t round)
+    {
+        std::vector<account_name_type> users;
+        for (uint32_t i = 0; i < round_size; ++i)
+        {
+            users.push_back(create_user("bench-" + fc::to_string(round) + "-" + fc::to_string(i)));
+            transfer_to(users.back(), asset(1000, DEIP_SYMBOL));
+        }
+
+        const account_name_type research_group = create_research_group(round);
+        const external_id_type research = create_research(research_group, round);
+        const external_id_type research_content = create_research_content(research_group, research, round);
+        const asset_symbol_type security_token = tokenize_research(research_group, research, round);
+        const external_id_type token_sale = create_token_sale(research_group, research, security_token);
+
+        std::vector<external_id_type> reviews;
+        for (const auto& user : users)
+            reviews.push_back(create_review(user, research_content));
+
+        for (uint32_t i = 0; i < users.size(); ++i)
+            vote_for_review(users[i], reviews[(i + 1) % reviews.size()]);
+
+        for (const auto& user : users)
+            create_license(research_group, research, user);
+
+        timed_generate_block();
+        timed_generate_block();
+
+        for (const auto& user : users)
+            contribute(user, token_sale);
+
+        timed_generate_block();
+    }
+
+    const uint32_t rounds;
+    const uint32_t round_size;
+
+    external_id_type discipline_external_id;
+
+    std::map<std::string, bench_clock::duration> push_durations;
+    std::map<std::string, uint32_t> push_counts;
+    std::vector<double> block_latencies;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(workload_benchmark, workload_fixture)
+
+/**
+ *  Reports push_transaction throughput of every flow, latency percentiles of the blocks
+ *  carrying the workload, shared memory growth, and then reindexes the chain from its
+ *  block log and reports the replay speed and per block apply latency percentiles.
+ *
+ *  The workload size is taken from DEIP_BENCH_WORKLOAD_ROUNDS and DEIP_BENCH_WORKLOAD_SIZE.
+ */
+BOOST_AUTO_TEST_CASE(research_flows)
+{
+    try
+    {
+        BOOST_REQUIRE(discipline_external_id != external_id_type());
+
+        const size_t free_memory_before = db.get_free_memory();
+        const uint32_t head_block_num_before = db.head_block_num();
+
+        for (uint32_t round = 0; round < rounds; ++round)
+            run_round(round);
+
+        const size_t shared_memory_growth = free_memory_before - db.get_free_memory();
+        const uint32_t workload_blocks = db.head_block_num() - head_block_num_before;
+
+        auto& report = benchmark_report::instance();
+        report.add("workload_rounds", rounds, "count");
+        report.add("workload_round_size", round_size, "count");
+
+        for (const auto& flow : push_durations)
+        {
+            const double seconds = std::chrono::duration<double>(flow.second).count();
+            report.add(flow.first + "_push_transaction", push_counts[flow.first] / seconds, "trx/s");
+        }
+
+        report.add_percentiles("workload_block_latency", block_latencies, "ms");
+        report.add("shared_memory_growth", shared_memory_growth, "bytes");
+        report.add("shared_memory_growth_per_block", shared_memory_growth / workload_blocks, "bytes");
+
+        const block_id_type head_block_id = db.head_block_id();
+        const uint32_t head_block_num = db.head_block_num();
+
+        std::vector<double> apply_latencies;
+        auto last_applied = bench_clock::now();
+        auto applied_block_connection = db.applied_block.connect([&](const signed_block&) {
+            const auto now = bench_clock::now();
+            apply_latencies.push_back(to_milliseconds(now - last_applied));
+            last_applied = now;
+        });
+
+        const auto reindex_start = bench_clock::now();
+        db.reindex(data_dir->path(), data_dir->path(), TEST_SHARED_MEM_SIZE_128MB, genesis_state);
+        const auto reindex_elapsed = bench_clock::now() - reindex_start;
+
+        applied_block_connection.disconnect();
+
+        BOOST_REQUIRE(db.head_block_id() == head_block_id);
+
+        // the first interval includes opening the database
+        if (!apply_latencies.empty())
+            apply_latencies.erase(apply_latencies.begin());
+
+        report.add("reindex", head_block_num / std::chrono::duration<double>(reindex_elapsed).count(), "blocks/s");
+        report.add_percentiles("reindex_block_apply_latency", apply_latencies, "ms");
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
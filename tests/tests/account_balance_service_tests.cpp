@@ -1,6 +1,7 @@
 #ifdef IS_TEST_NET
 #include <boost/test/unit_test.hpp>
 #include <deip/chain/services/dbs_account_balance.hpp>
+#include <deip/chain/services/dbs_asset.hpp>
 #include <deip/chain/schema/asset_object.hpp>
 
 #include "database_fixture.hpp"
@@ -182,6 +183,126 @@ BOOST_AUTO_TEST_CASE(get_account_balance_by_owner_and_asset)
     FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(settle_license_revenue)
+{
+    try
+    {
+        create_assets();
+
+        const asset_symbol_type usd = db.get<asset_object>(1).symbol;
+        const auto& security_token = db.create<asset_object>([&](asset_object& a_o) {
+            a_o.id = 3;
+            a_o.symbol = (uint64_t(0) | (uint64_t('R') << 8) | (uint64_t('S') << 16) | (uint64_t('T') << 24));
+            fc::from_string(a_o.string_symbol, "RST");
+            a_o.precision = 0;
+            a_o.type = static_cast<uint8_t>(asset_type::research_security_token);
+            a_o.tokenized_research = external_id_type("c8a87b12c23f53866acd397f43b591fd4e631419");
+            a_o.current_supply = 3;
+        });
+
+        auto& asset_service = db.obtain_service<dbs_asset>();
+
+        data_service.create_account_balance("alice", security_token.symbol, 2);
+        data_service.create_account_balance("bob", security_token.symbol, 1);
+
+        const asset distributed = asset_service.distribute_license_revenue(security_token, asset(1000, usd));
+        BOOST_CHECK(distributed == asset(1000, usd));
+
+        // a holder joining later is not owed earlier revenue
+        data_service.create_account_balance("sam", security_token.symbol, 0);
+
+        // 2/3 and 1/3 of the revenue, rounded down
+        BOOST_CHECK(data_service.get_pending_license_revenue("alice").at(usd) == 666);
+        BOOST_CHECK(data_service.get_pending_license_revenue("bob").at(usd) == 333);
+        BOOST_CHECK(data_service.get_pending_license_revenue("sam").empty());
+
+        // holdings change only after settlement
+        data_service.adjust_account_balance("alice", asset(-1, security_token.symbol));
+        data_service.adjust_account_balance("sam", asset(1, security_token.symbol));
+
+        BOOST_CHECK(data_service.get_account_balance_by_owner_and_asset("alice", usd).amount == 666);
+        BOOST_CHECK(data_service.get_pending_license_revenue("alice").empty());
+        BOOST_CHECK(data_service.get_pending_license_revenue("sam").empty());
+        BOOST_CHECK(security_token.license_revenue.at(usd).undistributed == 334);
+
+        asset_service.distribute_license_revenue(security_token, asset(300, usd));
+
+        BOOST_CHECK(data_service.get_pending_license_revenue("alice").at(usd) == 100);
+        BOOST_CHECK(data_service.get_pending_license_revenue("bob").at(usd) == 433);
+        BOOST_CHECK(data_service.get_pending_license_revenue("sam").at(usd) == 100);
+
+        data_service.settle_license_revenue("bob");
+        BOOST_CHECK(data_service.get_account_balance_by_owner_and_asset("bob", usd).amount == 433);
+        BOOST_CHECK(security_token.license_revenue.at(usd).undistributed == 201);
+
+        // settling again writes nothing
+        {
+            auto session = db.start_undo_session(true);
+            data_service.settle_license_revenue("bob");
+
+            std::vector<chainbase::object_change> changes;
+            db.get_head_changes(changes);
+            BOOST_CHECK(changes.empty());
+        }
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(settle_license_revenue_below_one_unit_before_holding_changes)
+{
+    try
+    {
+        create_assets();
+
+        const asset_symbol_type usd = db.get<asset_object>(1).symbol;
+        const auto& security_token = db.create<asset_object>([&](asset_object& a_o) {
+            a_o.id = 3;
+            a_o.symbol = (uint64_t(0) | (uint64_t('R') << 8) | (uint64_t('S') << 16) | (uint64_t('T') << 24));
+            fc::from_string(a_o.string_symbol, "RST");
+            a_o.precision = 0;
+            a_o.type = static_cast<uint8_t>(asset_type::research_security_token);
+            a_o.tokenized_research = external_id_type("c8a87b12c23f53866acd397f43b591fd4e631419");
+            a_o.current_supply = 10000;
+        });
+
+        auto& asset_service = db.obtain_service<dbs_asset>();
+
+        data_service.create_account_balance("alice", security_token.symbol, 1);
+        data_service.create_account_balance("bob", security_token.symbol, 9999);
+
+        // alice is owed half a unit
+        asset_service.distribute_license_revenue(security_token, asset(5000, usd));
+        BOOST_CHECK(data_service.get_pending_license_revenue("alice").empty());
+        BOOST_CHECK(data_service.get_pending_license_revenue("bob").at(usd) == 4999);
+
+        // the revenue of the transferred tokens is settled by bob, alice does not earn it again
+        data_service.adjust_account_balance("bob", asset(-9999, security_token.symbol));
+        data_service.adjust_account_balance("alice", asset(9999, security_token.symbol));
+
+        BOOST_CHECK(data_service.get_account_balance_by_owner_and_asset("bob", usd).amount == 4999);
+        BOOST_CHECK(data_service.get_pending_license_revenue("alice").empty());
+        BOOST_CHECK(security_token.license_revenue.at(usd).undistributed == 1);
+
+        // the halves below one unit are carried, not lost
+        asset_service.distribute_license_revenue(security_token, asset(10000, usd));
+        BOOST_CHECK(data_service.get_pending_license_revenue("alice").at(usd) == 10000);
+        BOOST_CHECK(data_service.get_pending_license_revenue("bob").empty());
+
+        data_service.settle_license_revenue("alice");
+        data_service.settle_license_revenue("bob");
+        BOOST_CHECK(data_service.get_account_balance_by_owner_and_asset("alice", usd).amount == 10000);
+        BOOST_CHECK(data_service.get_account_balance_by_owner_and_asset("bob", usd).amount == 4999);
+        BOOST_CHECK(security_token.license_revenue.at(usd).undistributed == 1);
+
+        // the carried half unit of alice stays below one unit
+        asset_service.distribute_license_revenue(security_token, asset(5000, usd));
+        data_service.settle_license_revenue("alice");
+        BOOST_CHECK(data_service.get_account_balance_by_owner_and_asset("alice", usd).amount == 15000);
+        BOOST_CHECK(security_token.license_revenue.at(usd).undistributed == 1);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace chain
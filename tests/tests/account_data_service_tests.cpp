@@ -1,6 +1,7 @@
 #ifdef IS_TEST_NET
 #include <boost/test/unit_test.hpp>
 
+#include <deip/chain/database/authority_cache.hpp>
 #include <deip/chain/schema/account_object.hpp>
 #include <deip/chain/services/dbs_account.hpp>
 #include <deip/chain/services/dbs_account_balance.hpp>
@@ -129,6 +130,52 @@ BOOST_AUTO_TEST_CASE(check_fee_after_creation)
     FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(authority_cache_follows_updates)
+{
+    try
+    {
+        const public_key_type other_key = generate_private_key("other private key").get_public_key();
+        const uint16_t op_tag = operation::tag<transfer_operation>::value;
+
+        fc::optional<std::string> json_metadata;
+        flat_map<uint16_t, authority> active_overrides;
+        active_overrides[op_tag] = authority(1, other_key, 1);
+        flat_set<account_trait> traits;
+
+        data_service.create_account_by_faucets("user", "initdelegate", public_key, json_metadata, authority(1, public_key, 1),
+                                               authority(1, public_key, 1), active_overrides, asset(0, DEIP_SYMBOL), traits,
+                                               true);
+
+        authority_cache& authorities = db.get_authority_cache();
+        const account_object& account = db.get_account("user");
+
+        BOOST_CHECK(authorities.get_active("user") == authority(1, public_key, 1));
+        BOOST_CHECK(authorities.get_owner("user") == authority(1, public_key, 1));
+        BOOST_CHECK(*authorities.get_active_override("user", op_tag) == authority(1, other_key, 1));
+        BOOST_CHECK(!authorities.get_active_override("user", op_tag + 1).valid());
+        BOOST_CHECK(authorities.size() > 0u);
+
+        {
+            auto session = db.start_undo_session(true);
+
+            data_service.update_active_authority(account, authority(1, other_key, 1));
+            BOOST_CHECK(authorities.get_active("user") == authority(1, other_key, 1));
+
+            flat_map<uint16_t, optional<authority>> override_updates;
+            override_updates[op_tag] = optional<authority>();
+            data_service.update_active_overrides_authorities(account, override_updates);
+            BOOST_CHECK(!authorities.get_active_override("user", op_tag).valid());
+        }
+
+        BOOST_CHECK(authorities.get_active("user") == authority(1, public_key, 1));
+        BOOST_CHECK(*authorities.get_active_override("user", op_tag) == authority(1, other_key, 1));
+
+        authorities.clear();
+        BOOST_CHECK_EQUAL(authorities.size(), 0u);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace chain
@@ -0,0 +1,289 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/app/api.hpp>
+#include <deip/app/api_access.hpp>
+#include <deip/app/api_context.hpp>
+#include <deip/app/api_thread_pool.hpp>
+#include <deip/app/database_api.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/network/http/websocket.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "database_fixture.hpp"
+
+using namespace deip::app;
+
+namespace {
+
+const auto wait_timeout = std::chrono::seconds(10);
+
+template <typename Predicate> bool wait_until(Predicate predicate)
+{
+    const auto until = std::chrono::steady_clock::now() + wait_timeout;
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() > until)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/// counts the calls of a method executing at once
+struct concurrency_counter
+{
+    std::atomic<uint32_t> running{ 0 };
+    std::atomic<uint32_t> max_running{ 0 };
+
+    void enter()
+    {
+        const uint32_t n = ++running;
+        uint32_t max = max_running;
+        while (n > max && !max_running.compare_exchange_weak(max, n))
+            ;
+    }
+
+    void leave()
+    {
+        --running;
+    }
+};
+
+/// websocket connection which keeps the messages sent to the client
+struct test_websocket_connection : public fc::http::websocket_connection
+{
+    void send_message(const std::string& message) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back(message);
+    }
+
+    std::vector<std::string> messages() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sent;
+    }
+
+    mutable std::mutex mutex;
+    std::vector<std::string> sent;
+};
+}
+
+BOOST_AUTO_TEST_SUITE(api_thread_pool_tests)
+
+BOOST_AUTO_TEST_CASE(call_expires_at_deadline)
+{
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> expired;
+    std::atomic<bool> executed{ false };
+
+    api_thread_pool pool(1, fc::milliseconds(50), {});
+
+    pool.post("slow", [&]() { started.set_value(); released.wait(); }, []() {});
+    BOOST_REQUIRE(started.get_future().wait_for(wait_timeout) == std::future_status::ready);
+
+    pool.post("get_block", [&]() { executed = true; }, [&]() { expired.set_value(); });
+
+    // the only thread is busy past the deadline of the queued call
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    release.set_value();
+
+    BOOST_REQUIRE(expired.get_future().wait_for(wait_timeout) == std::future_status::ready);
+    BOOST_CHECK(!executed);
+
+    BOOST_REQUIRE(wait_until([&]() { return pool.get_stats()["slow"].calls == 1; }));
+    BOOST_REQUIRE(wait_until([&]() { return pool.get_stats()["get_block"].expired == 1; }));
+    BOOST_CHECK_EQUAL(pool.get_stats()["get_block"].calls, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(method_limit_lets_other_methods_overtake)
+{
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> other_done;
+    std::promise<void> second_done;
+    std::atomic<bool> second_started{ false };
+    concurrency_counter slow;
+
+    api_thread_pool pool(2, fc::milliseconds(0), { { "broadcast_transaction_synchronous", 1 } });
+
+    pool.post("broadcast_transaction_synchronous",
+              [&]() {
+                  slow.enter();
+                  started.set_value();
+                  released.wait();
+                  slow.leave();
+              },
+              []() {});
+    BOOST_REQUIRE(started.get_future().wait_for(wait_timeout) == std::future_status::ready);
+
+    pool.post("broadcast_transaction_synchronous",
+              [&]() {
+                  slow.enter();
+                  second_started = true;
+                  slow.leave();
+                  second_done.set_value();
+              },
+              []() {});
+    pool.post("get_block", [&]() { other_done.set_value(); }, []() {});
+
+    // the second thread is idle, but only the other method may use it
+    BOOST_REQUIRE(other_done.get_future().wait_for(wait_timeout) == std::future_status::ready);
+    BOOST_CHECK(!second_started);
+
+    release.set_value();
+    BOOST_REQUIRE(second_done.get_future().wait_for(wait_timeout) == std::future_status::ready);
+    BOOST_CHECK_EQUAL(slow.max_running.load(), 1u);
+
+    BOOST_REQUIRE(wait_until([&]() { return pool.get_stats()["broadcast_transaction_synchronous"].calls == 2; }));
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_broadcasts)
+{
+    const uint32_t posting_threads = 4;
+    const uint32_t calls_per_thread = 50;
+    const uint32_t limit = 2;
+
+    concurrency_counter broadcasts;
+    std::atomic<uint32_t> done{ 0 };
+    std::atomic<uint32_t> expired{ 0 };
+
+    api_thread_pool pool(4, fc::milliseconds(0), { { "broadcast_transaction", limit } });
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < posting_threads; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (uint32_t i = 0; i < calls_per_thread; ++i)
+            {
+                pool.post("broadcast_transaction",
+                          [&]() {
+                              broadcasts.enter();
+                              std::this_thread::sleep_for(std::chrono::microseconds(200));
+                              broadcasts.leave();
+                              ++done;
+                          },
+                          [&]() { ++expired; });
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const uint32_t total = posting_threads * calls_per_thread;
+    BOOST_REQUIRE(wait_until([&]() { return pool.get_stats()["broadcast_transaction"].calls == total; }));
+
+    BOOST_CHECK_EQUAL(done.load(), total);
+    BOOST_CHECK_EQUAL(expired.load(), 0u);
+    BOOST_CHECK(broadcasts.max_running <= limit);
+    BOOST_CHECK(broadcasts.max_running > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(calls_of_a_sequence_run_in_order)
+{
+    const uint32_t calls_per_sequence = 50;
+
+    std::vector<uint32_t> order[2];
+    concurrency_counter counters[2];
+    std::atomic<uint32_t> done{ 0 };
+
+    api_thread_pool pool(4, fc::milliseconds(0), { { "limited", 1 } });
+
+    for (uint32_t i = 0; i < calls_per_sequence; ++i)
+    {
+        for (uint32_t sequence = 0; sequence < 2; ++sequence)
+        {
+            // a method limit holds up the later calls of the sequence as well
+            const std::string method = i % 5 == 0 ? "limited" : "get_block";
+            pool.post(&order[sequence], method,
+                      [&, sequence, i]() {
+                          counters[sequence].enter();
+                          std::this_thread::sleep_for(std::chrono::microseconds(100));
+                          order[sequence].push_back(i);
+                          counters[sequence].leave();
+                          ++done;
+                      },
+                      []() {});
+        }
+    }
+
+    BOOST_REQUIRE(wait_until([&]() { return done == 2 * calls_per_sequence; }));
+
+    for (uint32_t sequence = 0; sequence < 2; ++sequence)
+    {
+        BOOST_REQUIRE_EQUAL(order[sequence].size(), calls_per_sequence);
+        for (uint32_t i = 0; i < calls_per_sequence; ++i)
+            BOOST_CHECK_EQUAL(order[sequence][i], i);
+        BOOST_CHECK_EQUAL(counters[sequence].max_running.load(), 1u);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(pipelined_calls_of_a_connection, deip::chain::clean_database_fixture)
+{
+    try
+    {
+        app.register_api_factory<login_api>("login_api");
+        app.register_api_factory<database_api>("database_api");
+
+        api_access_info access;
+        access.username = "user";
+        access.password_hash_b64 = "*";
+        access.allowed_apis = { "database_api" };
+        app.set_api_access_info("user", std::move(access));
+
+        auto pool = std::make_shared<api_thread_pool>(4, fc::milliseconds(0), std::map<std::string, uint32_t>());
+        auto socket = std::make_shared<test_websocket_connection>();
+
+        auto session = std::make_shared<api_session_data>();
+        session->wsc = std::make_shared<pooled_websocket_api_connection>(
+            socket, pool, [](const binary_rpc_request& request) {
+                binary_rpc_response response;
+                response.id = request.id;
+                response.error = "Binary RPC is not used by this test";
+                return response;
+            });
+
+        api_context ctx(app, "login_api", session);
+        session->api_map["login_api"] = app.create_api_by_name(ctx);
+        session->api_map["login_api"]->register_api(*session->wsc);
+
+        // sent without waiting for responses: database_api is created by the login and becomes
+        // the second API of the connection with get_api_by_name
+        const uint32_t calls = 20;
+        socket->on_message(R"({"jsonrpc":"2.0","id":1,"method":"call","params":[0,"login",["user","password"]]})");
+        socket->on_message(R"({"jsonrpc":"2.0","id":2,"method":"call","params":[0,"get_api_by_name",["database_api"]]})");
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            socket->on_message(R"({"jsonrpc":"2.0","id":)" + fc::to_string(i + 3)
+                               + R"(,"method":"call","params":[1,"get_dynamic_global_properties",[]]})");
+        }
+
+        BOOST_REQUIRE(wait_until([&]() { return socket->messages().size() == calls + 2; }));
+
+        const std::vector<std::string> responses = socket->messages();
+        for (size_t i = 0; i < responses.size(); ++i)
+        {
+            const fc::variant_object response = fc::json::from_string(responses[i]).get_object();
+            BOOST_CHECK_EQUAL(response["id"].as_uint64(), i + 1);
+            BOOST_CHECK_MESSAGE(!response.contains("error"), responses[i]);
+        }
+
+        BOOST_CHECK(fc::json::from_string(responses[0]).get_object()["result"].as_bool());
+        BOOST_CHECK_EQUAL(fc::json::from_string(responses[1]).get_object()["result"].as_uint64(), 1u);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
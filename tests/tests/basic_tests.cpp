@@ -333,4 +333,107 @@ BOOST_AUTO_TEST_CASE(format_string)
     BOOST_CHECK(!out.compare(etalon));
 }
 
+BOOST_AUTO_TEST_CASE(operation_dispatcher_routes_by_tag)
+{
+    operation_dispatcher dispatcher;
+
+    int transfers = 0;
+    int votes = 0;
+    dispatcher.subscribe<transfer_operation>([&](const operation_notification&) { ++transfers; });
+    dispatcher.subscribe<transfer_operation, vote_for_review_operation>(
+        [&](const operation_notification&) { ++votes; });
+
+    BOOST_CHECK(dispatcher.has_subscribers(operation::tag<transfer_operation>::value));
+    BOOST_CHECK(dispatcher.has_subscribers(operation::tag<vote_for_review_operation>::value));
+    BOOST_CHECK(!dispatcher.has_subscribers(operation::tag<create_account_operation>::value));
+
+    dispatcher(operation_notification(transfer_operation()));
+    dispatcher(operation_notification(vote_for_review_operation()));
+    dispatcher(operation_notification(create_account_operation()));
+
+    BOOST_CHECK_EQUAL(transfers, 1);
+    BOOST_CHECK_EQUAL(votes, 2);
+
+    BOOST_CHECK_THROW(dispatcher.subscribe(operation::count(), [](const operation_notification&) {}),
+                      fc::assert_exception);
+}
+
+BOOST_AUTO_TEST_CASE(changed_objects_per_block)
+{
+    std::vector<block_changeset> changesets;
+    auto connection = db.changed_objects.connect([&](const block_changeset& c) { changesets.push_back(c); });
+
+    generate_block();
+
+    BOOST_REQUIRE_EQUAL(changesets.size(), 1u);
+    BOOST_CHECK_EQUAL(changesets[0].block_num, db.head_block_num());
+    BOOST_CHECK(changesets[0].block_id == db.head_block_id());
+
+    auto itr = std::find_if(changesets[0].objects.begin(), changesets[0].objects.end(), [](const changed_object& o) {
+        return o.type_id == dynamic_global_property_object_type;
+    });
+    BOOST_REQUIRE(itr != changesets[0].objects.end());
+    BOOST_CHECK(itr->type == chainbase::object_change::modified);
+    BOOST_REQUIRE(!itr->data.empty());
+
+    auto dgp = fc::raw::unpack<dynamic_global_property_object>(itr->data);
+    BOOST_CHECK_EQUAL(dgp.head_block_number, db.head_block_num());
+
+    connection.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(changed_objects_pack_chain_objects)
+{
+    create_account("alice", init_account_pub_key);
+
+    std::vector<block_changeset> changesets;
+    auto connection = db.changed_objects.connect([&](const block_changeset& c) { changesets.push_back(c); });
+
+    generate_block();
+
+    BOOST_REQUIRE_EQUAL(changesets.size(), 1u);
+
+    for (const auto type_id : { account_object_type, account_authority_object_type })
+    {
+        auto itr = std::find_if(changesets[0].objects.begin(), changesets[0].objects.end(),
+                                [&](const changed_object& o) { return o.type_id == type_id; });
+        BOOST_REQUIRE(itr != changesets[0].objects.end());
+        BOOST_CHECK(itr->type == chainbase::object_change::created);
+        BOOST_CHECK(!itr->data.empty());
+    }
+
+    connection.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(changed_objects_reverted_on_pop_block)
+{
+    generate_block();
+    const uint32_t popped_num = db.head_block_num();
+    const block_id_type popped_id = db.head_block_id();
+
+    std::vector<block_changeset> changesets;
+    auto connection = db.changed_objects.connect([&](const block_changeset& c) { changesets.push_back(c); });
+
+    db.pop_block();
+
+    BOOST_REQUIRE_EQUAL(changesets.size(), 1u);
+    BOOST_CHECK(changesets[0].reverted);
+    BOOST_CHECK_EQUAL(changesets[0].block_num, popped_num);
+    BOOST_CHECK(changesets[0].block_id == popped_id);
+
+    auto itr = std::find_if(changesets[0].objects.begin(), changesets[0].objects.end(), [](const changed_object& o) {
+        return o.type_id == dynamic_global_property_object_type;
+    });
+    BOOST_REQUIRE(itr != changesets[0].objects.end());
+    BOOST_CHECK(itr->type == chainbase::object_change::modified);
+    BOOST_REQUIRE(!itr->data.empty());
+
+    // the value undo restored
+    auto dgp = fc::raw::unpack<dynamic_global_property_object>(itr->data);
+    BOOST_CHECK_EQUAL(dgp.head_block_number, popped_num - 1);
+    BOOST_CHECK_EQUAL(db.head_block_num(), popped_num - 1);
+
+    connection.disconnect();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,223 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/app/api_context.hpp>
+#include <deip/app/binary_rpc.hpp>
+#include <deip/app/database_api.hpp>
+#include <deip/blockchain_history/blockchain_history_api.hpp>
+
+#include <fc/io/json.hpp>
+
+#include "database_fixture.hpp"
+
+using namespace deip;
+using namespace deip::app;
+using namespace deip::chain;
+using namespace deip::protocol;
+using deip::blockchain_history::applied_operation;
+using deip::blockchain_history::applied_operation_type;
+using deip::blockchain_history::blockchain_history_api;
+
+namespace {
+
+/**
+ *  Session with database_api and blockchain_history_api, so that binary RPC requests can be
+ *  executed through application::call_binary_api as they are for a websocket connection.
+ */
+struct binary_rpc_fixture : public clean_database_fixture
+{
+    binary_rpc_fixture()
+        : session(std::make_shared<api_session_data>())
+    {
+        app.register_api_factory<database_api>("database_api");
+        app.register_binary_api_factory<database_api>("database_api");
+        app.register_api_factory<blockchain_history_api>("blockchain_history_api");
+        app.register_binary_api_factory<blockchain_history_api>("blockchain_history_api");
+
+        for (const std::string& name : { std::string("database_api"), std::string("blockchain_history_api") })
+        {
+            api_context ctx(app, name, session);
+            session->api_map[name] = app.create_api_by_name(ctx);
+        }
+    }
+
+    /// the API of the session, called directly
+    template <typename Api> fc::api<Api> local_api(const std::string& name)
+    {
+        auto api = std::dynamic_pointer_cast<fc::api<Api>>(session->api_map.at(name));
+        BOOST_REQUIRE(api);
+        return *api;
+    }
+
+    template <typename... Args>
+    binary_rpc_response send(const std::string& api, const std::string& method, const Args&... args)
+    {
+        binary_rpc_request request;
+        request.id = ++last_request_id;
+        request.api = api;
+        request.method = method;
+        (void)std::initializer_list<int>{ (detail::append_binary_rpc_param(request.params, args), 0)... };
+
+        // through the frame encoding, as a websocket client would send it
+        request = unpack_binary_rpc_frame<binary_rpc_request>(pack_binary_rpc_frame(request));
+        const binary_rpc_response response = app.call_binary_api(*session, request);
+
+        BOOST_REQUIRE(response.id == request.id);
+        return unpack_binary_rpc_frame<binary_rpc_response>(pack_binary_rpc_frame(response));
+    }
+
+    template <typename R, typename... Args> R call(const std::string& api, const std::string& method, const Args&... args)
+    {
+        const binary_rpc_response response = send(api, method, args...);
+        BOOST_REQUIRE_MESSAGE(!response.error.valid(), response.error.valid() ? *response.error : std::string());
+        return fc::raw::unpack<R>(response.result);
+    }
+
+    void negotiate()
+    {
+        BOOST_REQUIRE(call<uint32_t>(binary_rpc_negotiate_api, binary_rpc_negotiate_method, binary_rpc_version)
+                      == binary_rpc_version);
+    }
+
+    /// the JSON text a websocket client would receive for the value
+    template <typename T> static std::string to_json(const T& value)
+    {
+        return fc::json::to_string(fc::variant(value));
+    }
+
+    std::shared_ptr<api_session_data> session;
+    uint64_t last_request_id = 0;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(binary_rpc_tests, binary_rpc_fixture)
+
+BOOST_AUTO_TEST_CASE(frame_round_trip)
+{
+    try
+    {
+        binary_rpc_request request;
+        request.id = 42;
+        request.api = "database_api";
+        request.method = "get_block";
+        request.params = { 0, 1, char(0xff), 0 };
+
+        const std::string request_frame = pack_binary_rpc_frame(request);
+        BOOST_CHECK(is_binary_rpc_frame(request_frame));
+
+        const binary_rpc_request unpacked_request = unpack_binary_rpc_frame<binary_rpc_request>(request_frame);
+        BOOST_CHECK(unpacked_request.id == request.id);
+        BOOST_CHECK(unpacked_request.api == request.api);
+        BOOST_CHECK(unpacked_request.method == request.method);
+        BOOST_CHECK(unpacked_request.params == request.params);
+
+        binary_rpc_response response;
+        response.id = 42;
+        response.error = "failure";
+
+        const binary_rpc_response unpacked_response
+            = unpack_binary_rpc_frame<binary_rpc_response>(pack_binary_rpc_frame(response));
+        BOOST_CHECK(unpacked_response.id == response.id);
+        BOOST_CHECK(unpacked_response.result.empty());
+        BOOST_REQUIRE(unpacked_response.error.valid());
+        BOOST_CHECK(*unpacked_response.error == "failure");
+
+        BOOST_CHECK(!is_binary_rpc_frame("{\"id\":1,\"method\":\"call\",\"params\":[\"database_api\",\"get_config\",[]]}"));
+        BOOST_CHECK(!is_binary_rpc_frame(""));
+        BOOST_CHECK_THROW(unpack_binary_rpc_frame<binary_rpc_request>("[1,2]"), fc::exception);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(calls_require_negotiation)
+{
+    try
+    {
+        BOOST_CHECK(send("database_api", "get_dynamic_global_properties").error.valid());
+        BOOST_CHECK(send(binary_rpc_negotiate_api, binary_rpc_negotiate_method, uint32_t(0)).error.valid());
+
+        // a newer client gets the version of the node
+        BOOST_CHECK(call<uint32_t>(binary_rpc_negotiate_api, binary_rpc_negotiate_method, binary_rpc_version + 1)
+                    == binary_rpc_version);
+
+        BOOST_CHECK(!send("database_api", "get_dynamic_global_properties").error.valid());
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(unavailable_calls_fail)
+{
+    try
+    {
+        negotiate();
+
+        BOOST_CHECK(send("unknown_api", "get_block", uint32_t(1)).error.valid());
+        BOOST_CHECK(send("network_broadcast_api", "broadcast_transaction", signed_transaction()).error.valid());
+        BOOST_CHECK(send("database_api", "unknown_method").error.valid());
+
+        // callbacks cannot be packed, these methods are JSON only
+        BOOST_CHECK(send("database_api", "set_block_applied_callback").error.valid());
+
+        // missing and trailing parameters
+        BOOST_CHECK(send("database_api", "get_block").error.valid());
+        BOOST_CHECK(send("database_api", "get_block", uint32_t(1), uint32_t(2)).error.valid());
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(database_api_results_match_json)
+{
+    try
+    {
+        negotiate();
+
+        create_account("alice", init_account_pub_key);
+        create_account("bob", init_account_pub_key);
+        generate_block();
+
+        const fc::api<database_api> api = local_api<database_api>("database_api");
+
+        for (uint32_t block_num : { uint32_t(1), db.head_block_num(), db.head_block_num() + 1 })
+        {
+            const auto block = call<optional<signed_block_api_obj>>("database_api", "get_block", block_num);
+            BOOST_CHECK_EQUAL(to_json(block), to_json(api->get_block(block_num)));
+        }
+
+        const std::set<std::string> names = { "alice", "bob", TEST_INIT_DELEGATE_NAME, "nobody" };
+        const auto accounts = call<vector<optional<account_api_obj>>>("database_api", "get_accounts", names);
+        BOOST_REQUIRE_EQUAL(accounts.size(), names.size());
+        BOOST_CHECK_EQUAL(to_json(accounts), to_json(api->get_accounts(names)));
+
+        BOOST_CHECK_EQUAL(to_json(call<dynamic_global_property_api_obj>("database_api", "get_dynamic_global_properties")),
+                          to_json(api->get_dynamic_global_properties()));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_history_api_results_match_json)
+{
+    try
+    {
+        negotiate();
+
+        create_account("alice", init_account_pub_key);
+        fund("alice", 1000);
+        generate_block();
+
+        const fc::api<blockchain_history_api> api = local_api<blockchain_history_api>("blockchain_history_api");
+        const uint32_t head_block_num = db.head_block_num();
+
+        const auto ops = call<std::map<uint32_t, applied_operation>>("blockchain_history_api", "get_ops_in_block",
+                                                                     head_block_num, applied_operation_type::all);
+        BOOST_CHECK_EQUAL(to_json(ops), to_json(api->get_ops_in_block(head_block_num, applied_operation_type::all)));
+
+        const auto header = call<optional<block_header>>("blockchain_history_api", "get_block_header", head_block_num);
+        BOOST_REQUIRE(header.valid());
+        BOOST_CHECK_EQUAL(to_json(header), to_json(api->get_block_header(head_block_num)));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,226 @@
+#include <boost/test/unit_test.hpp>
+
+#include <deip/chain/block_log.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/raw.hpp>
+
+#include <fstream>
+
+using namespace deip::chain;
+using namespace deip::protocol;
+
+namespace {
+
+/// Chain of blocks of different sizes, one transfer each
+std::vector<signed_block> make_blocks(uint32_t count)
+{
+    std::vector<signed_block> blocks;
+    block_id_type previous;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        signed_block b;
+        b.previous = previous;
+        b.timestamp = fc::time_point_sec(1500000000 + i * 3);
+        b.witness = "initdelegate";
+
+        transfer_operation op;
+        op.from = "initdelegate";
+        op.to = "alice";
+        op.amount = asset(i + 1, DEIP_SYMBOL);
+        op.memo = std::string(i * 37 % 200, 'm');
+
+        signed_transaction trx;
+        trx.operations.push_back(op);
+        b.transactions.push_back(trx);
+
+        previous = b.id();
+        blocks.push_back(b);
+    }
+
+    return blocks;
+}
+
+/// Checks that the log holds exactly the first blocks up to its head, and returns the head number
+uint32_t check_log(const fc::path& file, const std::vector<signed_block>& blocks)
+{
+    block_log log;
+    log.open(file);
+
+    BOOST_REQUIRE(log.head().valid());
+    const uint32_t head_num = log.head()->block_num();
+    BOOST_REQUIRE(head_num <= blocks.size());
+
+    for (uint32_t num = 1; num <= head_num; ++num)
+    {
+        const optional<signed_block> b = log.read_block_by_num(num);
+        BOOST_REQUIRE(b.valid());
+        BOOST_CHECK(b->id() == blocks[num - 1].id());
+    }
+
+    const uint64_t head_end = log.get_block_pos(head_num) + fc::raw::pack_size(blocks[head_num - 1]) + sizeof(uint64_t);
+    BOOST_CHECK_EQUAL(fc::file_size(file), head_end);
+    BOOST_CHECK_EQUAL(fc::file_size(fc::path(file.generic_string() + ".index")), head_num * sizeof(uint64_t));
+
+    return head_num;
+}
+
+void append_bytes(const fc::path& file, const std::vector<char>& bytes)
+{
+    std::ofstream out(file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    out.write(bytes.data(), bytes.size());
+}
+}
+
+BOOST_AUTO_TEST_SUITE(block_log_tests)
+
+BOOST_AUTO_TEST_CASE(queued_blocks_are_readable)
+{
+    try
+    {
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        const fc::path file = data_dir.path() / "block_log";
+        const std::vector<signed_block> blocks = make_blocks(20);
+
+        {
+            block_log log;
+            log.set_max_queue_size(4);
+            log.open(file);
+
+            for (const auto& b : blocks)
+                log.append(b);
+
+            BOOST_CHECK_EQUAL(log.head()->block_num(), 20u);
+
+            // reads wait for the writer
+            for (uint32_t num = 1; num <= blocks.size(); ++num)
+                BOOST_CHECK(log.read_block_by_num(num)->id() == blocks[num - 1].id());
+
+            auto itr = log.read_block(0);
+            for (uint32_t num = 2; num <= blocks.size(); ++num)
+            {
+                itr = log.read_block(itr.second);
+                BOOST_CHECK(itr.first.id() == blocks[num - 1].id());
+            }
+
+            log.flush();
+            BOOST_CHECK_EQUAL(log.written_block_num(), 20u);
+        }
+
+        BOOST_CHECK_EQUAL(check_log(file, blocks), 20u);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(writer_crash_mid_batch_truncates_torn_tail)
+{
+    try
+    {
+        const std::vector<signed_block> blocks = make_blocks(10);
+
+        // bytes the writer writes for blocks 6 to 10, to the main file and to the index
+        uint64_t batch_size = 0;
+        for (uint32_t i = 5; i < blocks.size(); ++i)
+            batch_size += fc::raw::pack_size(blocks[i]) + 2 * sizeof(uint64_t);
+
+        for (uint64_t crash_point = 0; crash_point < batch_size; crash_point += 29)
+        {
+            BOOST_TEST_MESSAGE("Writer crashes after " << crash_point << " bytes");
+
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            const fc::path file = data_dir.path() / "block_log";
+
+            {
+                block_log log;
+                log.open(file);
+                for (uint32_t i = 0; i < 5; ++i)
+                    log.append(blocks[i]);
+                log.flush();
+
+                log.crash_writer_after(crash_point);
+                try
+                {
+                    for (uint32_t i = 5; i < blocks.size(); ++i)
+                        log.append(blocks[i]);
+                }
+                catch (fc::exception&)
+                {
+                    // the writer crashed before all blocks were queued
+                }
+
+                BOOST_CHECK_THROW(log.flush(), fc::exception);
+            }
+
+            const uint32_t head_num = check_log(file, blocks);
+            BOOST_CHECK_GE(head_num, 5u);
+
+            {
+                block_log log;
+                log.open(file);
+                for (uint32_t i = head_num; i < blocks.size(); ++i)
+                    log.append(blocks[i]);
+            }
+
+            BOOST_CHECK_EQUAL(check_log(file, blocks), 10u);
+        }
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(torn_tail_is_truncated_on_open)
+{
+    try
+    {
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        const fc::path file = data_dir.path() / "block_log";
+        const fc::path index_file = fc::path(file.generic_string() + ".index");
+        const std::vector<signed_block> blocks = make_blocks(7);
+
+        {
+            block_log log;
+            log.open(file);
+            for (uint32_t i = 0; i < 5; ++i)
+                log.append(blocks[i]);
+        }
+
+        // half of block 6 in the main file, part of its entry in the index
+        std::vector<char> packed = fc::raw::pack(blocks[5]);
+        packed.resize(packed.size() / 2);
+        append_bytes(file, packed);
+        append_bytes(index_file, std::vector<char>(3, 'x'));
+
+        BOOST_CHECK_EQUAL(check_log(file, blocks), 5u);
+
+        // block 6 without its position
+        append_bytes(file, fc::raw::pack(blocks[5]));
+
+        BOOST_CHECK_EQUAL(check_log(file, blocks), 5u);
+
+        {
+            block_log log;
+            log.open(file);
+            log.append(blocks[5]);
+            log.append(blocks[6]);
+        }
+
+        BOOST_CHECK_EQUAL(check_log(file, blocks), 7u);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -27,7 +27,11 @@
 #include <deip/protocol/exceptions.hpp>
 
 #include <deip/chain/database/database.hpp>
+#include <deip/chain/database/block_prevalidator.hpp>
+#include <deip/chain/database/parallel_transaction_verifier.hpp>
 #include <deip/chain/schema/deip_objects.hpp>
+#include <deip/chain/schema/account_balance_object.hpp>
+#include <deip/chain/schema/transaction_object.hpp>
 #include <deip/blockchain_history/account_history_object.hpp>
 #include <deip/chain/genesis_state.hpp>
 
@@ -37,6 +41,11 @@
 
 #include <fc/crypto/digest.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <random>
+
 #include "database_fixture.hpp"
 
 using namespace deip;
@@ -45,7 +54,7 @@ using namespace deip::protocol;
 
 BOOST_AUTO_TEST_SUITE(block_tests)
 
-void db_setup_and_open(database& db, const fc::path& path)
+genesis_state_type test_genesis()
 {
     genesis_state_type genesis;
 
@@ -64,8 +73,69 @@ void db_setup_and_open(database& db, const fc::path& path)
     create_initdelegate_for_genesis_state(genesis);
     create_initdelegate_expert_tokens_for_genesis_state(genesis);
 
+    return genesis;
+}
+
+void db_setup_and_open(database& db, const fc::path& path)
+{
     db._log_hardforks = false;
-    db.open(path, path, TEST_SHARED_MEM_SIZE_8MB, chainbase::database::read_write, genesis);
+    db.open(path, path, TEST_SHARED_MEM_SIZE_8MB, chainbase::database::read_write, test_genesis());
+}
+
+/// Copies the files of a node in the order they are found by a process which is killed meanwhile
+void copy_node_files(const fc::path& from, const fc::path& to)
+{
+    for (const char* name :
+         { "shared_memory.checkpoint", "shared_memory.meta", "shared_memory.bin", "block_log.index", "block_log" })
+    {
+        if (fc::exists(from / name))
+            fc::copy(from / name, to / name);
+    }
+}
+
+/// Signs the transaction with the key and with the init key as the tenant
+void sign_with_tenant(signed_transaction& trx, const fc::ecc::private_key& key, const chain_id_type& chain_id)
+{
+    trx.sign(key, chain_id);
+
+    tenant_affirmation_type tenant;
+    tenant.tenant = TEST_INIT_DELEGATE_NAME;
+    tenant.signature = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")))
+                           .sign_compact(trx.sig_digest(chain_id));
+    trx.tenant_signature = tenant;
+}
+
+/// Digest of the state written by the transactions of parallel_verified_blocks_match_serial
+fc::sha256 state_digest(const database& db)
+{
+    fc::sha256::encoder enc;
+    fc::raw::pack(enc, db.head_block_id());
+
+    for (const auto& account : db.get_index<account_index>().indices().get<by_id>())
+    {
+        fc::raw::pack(enc, account.name);
+        fc::raw::pack(enc, account.memo_key);
+        fc::raw::pack(enc, account.common_tokens_balance);
+    }
+
+    for (const auto& auth : db.get_index<account_authority_index>().indices().get<by_id>())
+    {
+        fc::raw::pack(enc, auth.account);
+        fc::raw::pack(enc, authority(auth.owner));
+        fc::raw::pack(enc, authority(auth.active));
+    }
+
+    for (const auto& balance : db.get_index<account_balance_index>().indices().get<by_id>())
+    {
+        fc::raw::pack(enc, balance.owner);
+        fc::raw::pack(enc, balance.symbol);
+        fc::raw::pack(enc, balance.amount);
+    }
+
+    fc::raw::pack(enc, db.get_dynamic_global_properties().current_supply);
+    fc::raw::pack(enc, uint64_t(db.get_index<transaction_index>().indices().size()));
+
+    return enc.result();
 }
 
 BOOST_AUTO_TEST_CASE(generate_empty_blocks)
@@ -257,6 +327,202 @@ BOOST_AUTO_TEST_CASE(fork_blocks)
     }
 }
 
+BOOST_AUTO_TEST_CASE(prevalidated_sync_blocks)
+{
+    try
+    {
+        fc::temp_directory data_dir1(graphene::utilities::temp_directory_path());
+        fc::temp_directory data_dir2(graphene::utilities::temp_directory_path());
+
+        database db1;
+        db_setup_and_open(db1, data_dir1.path());
+        database db2;
+        db_setup_and_open(db2, data_dir2.path());
+
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+        std::vector<signed_block> blocks;
+        for (uint32_t i = 0; i < 10; ++i)
+            blocks.push_back(db1.generate_block(db1.get_slot_time(1), db1.get_scheduled_witness(1),
+                                                init_account_priv_key, database::skip_nothing));
+
+        block_prevalidator prevalidator(2);
+        for (const auto& b : blocks)
+            prevalidator.schedule(b);
+
+        // a block that does not extend the head gets no skip flags, its verification and the
+        // older ones are released
+        BOOST_CHECK_EQUAL(prevalidator.get_skip_flags(db2, blocks[1]), uint32_t(database::skip_nothing));
+        BOOST_CHECK_EQUAL(prevalidator.pending_count(), blocks.size() - 2);
+
+        for (const auto& b : blocks)
+            prevalidator.schedule(b);
+        BOOST_CHECK_EQUAL(prevalidator.pending_count(), blocks.size());
+
+        for (const auto& b : blocks)
+        {
+            const uint32_t skip = prevalidator.get_skip_flags(db2, b);
+            BOOST_CHECK_EQUAL(skip, uint32_t(database::skip_witness_signature | database::skip_merkle_check));
+            PUSH_BLOCK(db2, b, skip);
+        }
+        BOOST_CHECK(db2.head_block_id() == db1.head_block_id());
+        BOOST_CHECK_EQUAL(prevalidator.pending_count(), 0u);
+
+        // tampered blocks are left to push_block
+        auto b = db1.generate_block(db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key,
+                                    database::skip_nothing);
+        b.transactions.emplace_back(signed_transaction());
+        b.transactions.back().operations.emplace_back(transfer_operation());
+        b.sign(fc::ecc::private_key::regenerate(fc::sha256::hash(string("other_key"))));
+
+        prevalidator.schedule(b);
+        BOOST_CHECK_EQUAL(prevalidator.get_skip_flags(db2, b), uint32_t(database::skip_nothing));
+        DEIP_CHECK_THROW(PUSH_BLOCK(db2, b), fc::exception);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+/**
+ *  Applies the same generated blocks with transactions verified serially and by a
+ *  parallel_transaction_verifier and compares the state after every block, including blocks
+ *  where an earlier transaction changes the authority a later one is verified against.
+ */
+BOOST_AUTO_TEST_CASE(parallel_verified_blocks_match_serial)
+{
+    try
+    {
+        fc::temp_directory source_dir(graphene::utilities::temp_directory_path());
+        fc::temp_directory serial_dir(graphene::utilities::temp_directory_path());
+        fc::temp_directory parallel_dir(graphene::utilities::temp_directory_path());
+
+        database source;
+        db_setup_and_open(source, source_dir.path());
+        database serial;
+        db_setup_and_open(serial, serial_dir.path());
+        database parallel;
+        db_setup_and_open(parallel, parallel_dir.path());
+        parallel.set_transaction_verification_threads(2);
+
+        const auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+        const chain_id_type chain_id = source.get_chain_id();
+
+        auto key_of = [](const std::string& name) {
+            return fc::ecc::private_key::regenerate(fc::sha256::hash(name));
+        };
+
+        const uint32_t users = 8;
+        auto user = [](uint32_t i) -> std::string { return "user" + fc::to_string(i); };
+
+        auto push = [&](const operation& op, const fc::ecc::private_key& key, uint32_t skip) {
+            signed_transaction trx;
+            trx.operations.push_back(op);
+            trx.set_expiration(source.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+            trx.set_reference_block(source.head_block_id());
+            sign_with_tenant(trx, key, chain_id);
+            source.push_transaction(trx, skip);
+        };
+
+        auto transfer = [&](const std::string& from, const std::string& to, int64_t amount) -> transfer_operation {
+            transfer_operation op;
+            op.from = from;
+            op.to = to;
+            op.amount = asset(amount, DEIP_SYMBOL);
+            return op;
+        };
+
+        auto update_active = [&](const std::string& account, const authority& active) -> update_account_operation {
+            update_account_operation op;
+            op.account = account;
+            op.active = active;
+            return op;
+        };
+
+        // pushes the next block of the source to both databases, which must both accept or both reject it
+        auto generate_and_compare = [&](uint32_t skip) -> bool {
+            const signed_block b = source.generate_block(source.get_slot_time(1), source.get_scheduled_witness(1),
+                                                         init_account_priv_key, skip);
+
+            auto accepts = [&](database& db) -> bool {
+                try
+                {
+                    db.push_block(b);
+                    return true;
+                }
+                catch (const fc::exception&)
+                {
+                    return false;
+                }
+            };
+
+            const bool serial_accepted = accepts(serial);
+            const bool parallel_accepted = accepts(parallel);
+
+            BOOST_REQUIRE_EQUAL(serial_accepted, parallel_accepted);
+            BOOST_REQUIRE(state_digest(serial) == state_digest(parallel));
+            return serial_accepted;
+        };
+
+        for (uint32_t i = 0; i < users; ++i)
+        {
+            create_account_operation op;
+            op.new_account_name = user(i);
+            op.creator = TEST_INIT_DELEGATE_NAME;
+            op.owner = authority(1, public_key_type(key_of(user(i)).get_public_key()), 1);
+            op.active = op.owner;
+            op.memo_key = key_of(user(i)).get_public_key();
+            op.fee = asset(30000, DEIP_SYMBOL);
+            push(op, init_account_priv_key, database::skip_nothing);
+        }
+        BOOST_REQUIRE(generate_and_compare(database::skip_nothing));
+
+        for (uint32_t i = 0; i < users; ++i)
+            push(transfer(TEST_INIT_DELEGATE_NAME, user(i), 1000), init_account_priv_key, database::skip_nothing);
+        BOOST_REQUIRE(generate_and_compare(database::skip_nothing));
+
+        // disjoint transfers, every one verified in parallel
+        for (uint32_t i = 0; i < users; ++i)
+            push(transfer(user(i), user((i + 1) % users), 10 + i), key_of(user(i)), database::skip_nothing);
+        BOOST_REQUIRE(generate_and_compare(database::skip_nothing));
+
+        const auto verified = parallel.get_transaction_verifier()->get_counters().verified;
+        BOOST_CHECK_GE(verified, uint64_t(users * 2));
+
+        // user0 replaces its key, the transfer signed with the new key fails the optimistic check;
+        // user1 adds a key, the transfer signed with the old key has its read set changed
+        const auto user0_new_key = key_of("user0_new");
+        push(update_active(user(0), authority(1, public_key_type(user0_new_key.get_public_key()), 1)),
+             key_of(user(0)), database::skip_nothing);
+        push(transfer(user(0), user(2), 5), user0_new_key, database::skip_nothing);
+
+        authority user1_active(1, public_key_type(key_of(user(1)).get_public_key()), 1);
+        user1_active.add_authority(public_key_type(key_of("user1_new").get_public_key()), 1);
+        push(update_active(user(1), user1_active), key_of(user(1)), database::skip_nothing);
+        push(transfer(user(1), user(3), 5), key_of(user(1)), database::skip_nothing);
+        BOOST_REQUIRE(generate_and_compare(database::skip_nothing));
+
+        const auto counters = parallel.get_transaction_verifier()->get_counters();
+        BOOST_CHECK_GE(counters.failed, uint64_t(1));
+        BOOST_CHECK_GE(counters.conflicts, uint64_t(1));
+
+        // user2 replaces its key, a later transfer signed with the old key passes the optimistic
+        // check against the state before the block, but must be rejected
+        push(update_active(user(2), authority(1, public_key_type(key_of("user2_new").get_public_key()), 1)),
+             key_of(user(2)), database::skip_nothing);
+        push(transfer(user(2), user(4), 5), key_of(user(2)),
+             database::skip_transaction_signatures | database::skip_authority_check);
+        BOOST_CHECK(!generate_and_compare(database::skip_transaction_signatures | database::skip_authority_check));
+        BOOST_CHECK(serial.head_block_id() == parallel.head_block_id());
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
 BOOST_AUTO_TEST_CASE(switch_forks_undo_create)
 {
     try
@@ -447,6 +713,338 @@ BOOST_AUTO_TEST_CASE(tapos)
     }
 }
 
+BOOST_AUTO_TEST_CASE(killed_node_resumes_from_state_checkpoint)
+{
+    try
+    {
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+
+        struct kill_point
+        {
+            std::shared_ptr<fc::temp_directory> dir;
+            bool in_block;
+        };
+        std::vector<kill_point> kill_points;
+
+        // the chain by block number
+        std::vector<block_id_type> block_ids;
+        std::vector<fc::sha256> digests;
+
+        {
+            database db;
+            db_setup_and_open(db, data_dir.path());
+            block_ids.push_back(db.head_block_id());
+            digests.push_back(state_digest(db));
+
+            // blocks in the block log for a reindex
+            for (uint32_t i = 0; i < 5; ++i)
+            {
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+                block_ids.push_back(db.head_block_id());
+                digests.push_back(state_digest(db));
+            }
+            db.close();
+        }
+
+        {
+            database db;
+            db_setup_and_open(db, data_dir.path());
+            db.set_flush_interval(5);
+            BOOST_REQUIRE_EQUAL(db.head_block_num(), 5u);
+
+            auto kill = [&](bool in_block) {
+                kill_point point;
+                point.dir = std::make_shared<fc::temp_directory>(graphene::utilities::temp_directory_path());
+                point.in_block = in_block;
+                copy_node_files(data_dir.path(), point.dir->path());
+                kill_points.push_back(point);
+            };
+
+            // a kill in a block is while the block is applied, with the write lock held
+            bool kill_in_block = false;
+            db.applied_block.connect([&](const signed_block&) {
+                if (kill_in_block)
+                {
+                    kill_in_block = false;
+                    kill(true);
+                }
+            });
+
+            std::mt19937 rng(11);
+            for (uint32_t i = 0; i < 60; ++i)
+            {
+                const uint32_t point = std::uniform_int_distribution<uint32_t>(0, 3)(rng);
+                if (point == 0)
+                    kill(false);
+                kill_in_block = point == 1;
+
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+
+                block_ids.push_back(db.head_block_id());
+                digests.push_back(state_digest(db));
+            }
+
+            db.close();
+        }
+
+        uint32_t checkpointed = 0;
+        for (const auto& point : kill_points)
+        {
+            const fc::path path = point.dir->path();
+            const auto checkpoint = state_checkpointer::read_journal(path / "shared_memory.checkpoint");
+            // the checkpoint at block 5 is the one taken on close
+            if (checkpoint && checkpoint->block_num > 5)
+                ++checkpointed;
+
+            database db;
+            db._log_hardforks = false;
+            if (point.in_block)
+            {
+                // the application falls back to a reindex on assertions
+                BOOST_CHECK_THROW(
+                    db.open(path, path, TEST_SHARED_MEM_SIZE_8MB, chainbase::database::read_write, test_genesis()),
+                    fc::assert_exception);
+                db.reindex(path, path, TEST_SHARED_MEM_SIZE_8MB, test_genesis());
+            }
+            else
+            {
+                db.open(path, path, TEST_SHARED_MEM_SIZE_8MB, chainbase::database::read_write, test_genesis());
+            }
+
+            // the state which was resumed and the replayed tail of the block log are the chain's
+            const uint32_t head = db.head_block_num();
+            BOOST_REQUIRE_LT(head, block_ids.size());
+            BOOST_CHECK(db.head_block_id() == block_ids[head]);
+            BOOST_CHECK(state_digest(db) == digests[head]);
+            if (checkpoint)
+                BOOST_CHECK_GE(head, checkpoint->block_num);
+
+            db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                              database::skip_nothing);
+            db.close();
+        }
+
+        BOOST_TEST_MESSAGE("kill points: " << kill_points.size() << ", after a checkpoint: " << checkpointed);
+        BOOST_CHECK_GT(checkpointed, 0u);
+        const auto in_block = std::count_if(kill_points.begin(), kill_points.end(),
+                                            [](const kill_point& point) { return point.in_block; });
+        BOOST_CHECK_GT(in_block, 0);
+        BOOST_CHECK_LT(size_t(in_block), kill_points.size());
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(state_checkpoint_replays_block_log_tail)
+{
+    try
+    {
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        fc::temp_directory early_dir(graphene::utilities::temp_directory_path());
+
+        block_id_type head_id;
+        fc::sha256 head_digest;
+        {
+            database db;
+            db_setup_and_open(db, data_dir.path());
+            db.set_flush_interval(1);
+
+            for (uint32_t i = 0; i < 10; ++i)
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+            db.get_state_checkpointer().wait();
+            copy_node_files(data_dir.path(), early_dir.path());
+
+            for (uint32_t i = 0; i < 20; ++i)
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+
+            head_id = db.head_block_id();
+            head_digest = state_digest(db);
+            db.close();
+        }
+
+        // a state which is behind its checkpoint lost writes
+        {
+            fc::temp_directory dir(graphene::utilities::temp_directory_path());
+            copy_node_files(early_dir.path(), dir.path());
+            fc::remove(dir.path() / "shared_memory.checkpoint");
+            fc::copy(data_dir.path() / "shared_memory.checkpoint", dir.path() / "shared_memory.checkpoint");
+
+            database db;
+            db._log_hardforks = false;
+            BOOST_CHECK_THROW(db.open(dir.path(), dir.path(), TEST_SHARED_MEM_SIZE_8MB,
+                                      chainbase::database::read_write, test_genesis()),
+                              fc::assert_exception);
+        }
+
+        // the early state with the whole block log resumes from its checkpoint and replays the rest
+        {
+            const fc::path path = early_dir.path();
+            fc::remove(path / "block_log");
+            fc::remove(path / "block_log.index");
+            fc::copy(data_dir.path() / "block_log", path / "block_log");
+            fc::copy(data_dir.path() / "block_log.index", path / "block_log.index");
+
+            const auto checkpoint = state_checkpointer::read_journal(path / "shared_memory.checkpoint");
+            BOOST_REQUIRE(checkpoint.valid());
+            BOOST_CHECK_GT(checkpoint->block_num, 0u);
+            BOOST_CHECK_LE(checkpoint->block_num, 10u);
+
+            database db;
+            db_setup_and_open(db, path);
+            BOOST_CHECK_EQUAL(db.head_block_num(), 30u);
+            BOOST_CHECK(db.head_block_id() == head_id);
+            BOOST_CHECK(state_digest(db) == head_digest);
+        }
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(state_checkpoint_killed_before_journal_replaced)
+{
+    try
+    {
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        fc::temp_directory killed_dir(graphene::utilities::temp_directory_path());
+
+        database db;
+        db_setup_and_open(db, data_dir.path());
+        db.set_flush_interval(1);
+
+        auto generate = [&](uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i)
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+        };
+
+        generate(5);
+        db.get_state_checkpointer().wait();
+        const auto before = db.get_state_checkpointer().last();
+        BOOST_REQUIRE(before.valid());
+
+        db.get_state_checkpointer().crash_before_journal_replaced();
+        generate(2);
+        BOOST_CHECK_THROW(db.get_state_checkpointer().wait(), fc::exception);
+
+        // the previous journal is kept next to the new one which was not put in place
+        const fc::path journal = data_dir.path() / "shared_memory.checkpoint";
+        BOOST_CHECK(fc::exists(fc::path(journal.generic_string() + ".tmp")));
+        const auto kept = state_checkpointer::read_journal(journal);
+        BOOST_REQUIRE(kept.valid());
+        BOOST_CHECK_EQUAL(kept->block_num, before->block_num);
+        BOOST_CHECK(kept->block_id == before->block_id);
+
+        copy_node_files(data_dir.path(), killed_dir.path());
+        fc::copy(fc::path(journal.generic_string() + ".tmp"),
+                 killed_dir.path() / "shared_memory.checkpoint.tmp");
+
+        // the next checkpoint goes through
+        generate(2);
+        db.get_state_checkpointer().wait();
+        BOOST_CHECK_GT(db.get_state_checkpointer().last()->block_num, before->block_num);
+
+        std::vector<block_id_type> block_ids(1);
+        for (uint32_t num = 1; num <= db.head_block_num(); ++num)
+            block_ids.push_back(db.get_block_id_for_num(num));
+        db.close();
+
+        // the killed node resumes from the previous checkpoint
+        database killed;
+        db_setup_and_open(killed, killed_dir.path());
+        BOOST_CHECK(!fc::exists(killed_dir.path() / "shared_memory.checkpoint.tmp"));
+        BOOST_REQUIRE_LT(killed.head_block_num(), block_ids.size());
+        BOOST_CHECK_GE(killed.head_block_num(), before->block_num);
+        BOOST_CHECK(killed.head_block_id() == block_ids[killed.head_block_num()]);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(state_open_during_host_restart_is_reindexed)
+{
+    try
+    {
+        auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init_key")));
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        fc::temp_directory restarted_dir(graphene::utilities::temp_directory_path());
+
+        {
+            database db;
+            db_setup_and_open(db, data_dir.path());
+            db.set_flush_interval(1);
+
+            for (uint32_t i = 0; i < 5; ++i)
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+            db.get_state_checkpointer().wait();
+
+            // the files of the running node as the host left them
+            copy_node_files(data_dir.path(), restarted_dir.path());
+            db.close();
+        }
+
+        // the journal as if it was written before the host restarted
+        auto restart_host = [](const fc::path& path) {
+            const fc::path journal = path / "shared_memory.checkpoint";
+            auto checkpoint = state_checkpointer::read_journal(journal);
+            BOOST_REQUIRE(checkpoint.valid());
+            BOOST_REQUIRE(checkpoint->boot_id == state_checkpointer::current_boot_id());
+
+            checkpoint->boot_id = fc::sha256::hash(string("previous boot"));
+            const std::vector<char> data = fc::raw::pack(*checkpoint);
+            std::ofstream(journal.generic_string(), std::ios::binary | std::ios::trunc).write(data.data(), data.size());
+            return *checkpoint;
+        };
+
+        // a state which was closed was synced while nothing was written to it
+        const state_checkpoint closed = restart_host(data_dir.path());
+        BOOST_CHECK(closed.closed);
+        {
+            database db;
+            db_setup_and_open(db, data_dir.path());
+            BOOST_CHECK_EQUAL(db.head_block_num(), 5u);
+        }
+
+        // a state which was open may have been synced in pieces of different blocks
+        const state_checkpoint open = restart_host(restarted_dir.path());
+        BOOST_CHECK(!open.closed);
+        BOOST_REQUIRE_GT(open.block_num, 0u);
+
+        const fc::path path = restarted_dir.path();
+        database db;
+        db._log_hardforks = false;
+        // the application falls back to a reindex on assertions
+        BOOST_CHECK_THROW(db.open(path, path, TEST_SHARED_MEM_SIZE_8MB, chainbase::database::read_write, test_genesis()),
+                          fc::assert_exception);
+        BOOST_CHECK(state_checkpointer::read_journal(path / "shared_memory.checkpoint")->boot_id == open.boot_id);
+
+        db.reindex(path, path, TEST_SHARED_MEM_SIZE_8MB, test_genesis());
+        BOOST_CHECK_GE(db.head_block_num(), open.block_num);
+        BOOST_CHECK(db.get_block_id_for_num(open.block_num) == open.block_id);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(optional_tapos, clean_database_fixture)
 {
     try
@@ -518,6 +1116,67 @@ BOOST_FIXTURE_TEST_CASE(optional_tapos, clean_database_fixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(tapos_block_summary_fork, clean_database_fixture)
+{
+    try
+    {
+        ACTORS_WITH_EXPERT_TOKENS((alice));
+        generate_blocks(5);
+
+        for (uint32_t block_num = 1; block_num <= db.head_block_num(); ++block_num)
+        {
+            const auto& summary = db.get<block_summary_object>(block_summary_id_type(block_num & 0xffff));
+            BOOST_CHECK(summary.block_id == db.get_block_id_for_num(block_num));
+        }
+
+        BOOST_REQUIRE(db.find<block_summary_object>(block_summary_id_type(0xffff)) != nullptr);
+        BOOST_REQUIRE(db.find<block_summary_object>(block_summary_id_type(0x10000)) == nullptr);
+
+        const uint32_t fork_block_num = db.head_block_num();
+        const block_id_type popped_block_id = db.head_block_id();
+
+        signed_transaction tx;
+        transfer_operation op;
+        op.from = TEST_INIT_DELEGATE_NAME;
+        op.to = "alice";
+        op.amount = asset(1, DEIP_SYMBOL);
+        tx.operations.push_back(op);
+        tx.set_expiration(db.head_block_time() + DEIP_MAX_TIME_UNTIL_EXPIRATION);
+
+        auto push_with_reference = [&](const block_id_type& reference) {
+            tx.set_reference_block(reference);
+            tx.signatures.clear();
+            tx.sign(init_account_priv_key, db.get_chain_id());
+            db.push_transaction(tx, database::skip_transaction_dupe_check);
+            db.clear_pending();
+        };
+
+        BOOST_TEST_MESSAGE("Referencing the head block");
+        push_with_reference(popped_block_id);
+
+        BOOST_TEST_MESSAGE("Popping the head block restores its block summary");
+        db.pop_block();
+        db.clear_pending();
+
+        BOOST_CHECK(db.get<block_summary_object>(block_summary_id_type(fork_block_num & 0xffff)).block_id
+                    == block_id_type());
+        DEIP_REQUIRE_THROW(push_with_reference(popped_block_id), transaction_tapos_exception);
+
+        BOOST_TEST_MESSAGE("Referencing a block of the other fork");
+        generate_block(0, init_account_priv_key, 1);
+        BOOST_REQUIRE_EQUAL(db.head_block_num(), fork_block_num);
+        BOOST_REQUIRE(db.head_block_id() != popped_block_id);
+
+        DEIP_REQUIRE_THROW(push_with_reference(popped_block_id), transaction_tapos_exception);
+        push_with_reference(db.head_block_id());
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(double_sign_check, clean_database_fixture)
 {
     try
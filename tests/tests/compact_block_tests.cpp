@@ -0,0 +1,162 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/compact_block.hpp>
+
+#include <map>
+
+#include "database_fixture.hpp"
+
+using namespace deip::chain;
+using namespace deip::protocol;
+using namespace graphene::net;
+
+namespace {
+
+/// A block with a few transfers that the chain has popped again, and a mempool holding its transactions
+struct compact_block_fixture : public clean_database_fixture
+{
+    compact_block_fixture()
+    {
+        create_account("alice", init_account_pub_key);
+        generate_block();
+
+        for (const share_type amount : { 100, 200, 300 })
+            transfer(TEST_INIT_DELEGATE_NAME, "alice", amount);
+        generate_block();
+
+        block = *db.fetch_block_by_number(db.head_block_num());
+        BOOST_REQUIRE_EQUAL(block.transactions.size(), 3u);
+
+        for (const auto& trx : block.transactions)
+            mempool[compact_block_message::get_short_transaction_id(trx.id())] = trx;
+
+        db.pop_block();
+    }
+
+    compact_block_builder::transaction_lookup_type mempool_lookup() const
+    {
+        return [this](short_transaction_id_type short_id) {
+            auto itr = mempool.find(short_id);
+            if (itr != mempool.end())
+                return fc::optional<signed_transaction>(itr->second);
+            return fc::optional<signed_transaction>();
+        };
+    }
+
+    /// what the sending node answers
+    block_transactions_message answer(const get_block_transactions_message& request) const
+    {
+        BOOST_REQUIRE(request.block_id == block.id());
+        return block_transactions_message(block, request.transaction_indexes);
+    }
+
+    void push_rebuilt_block(const compact_block_builder& builder)
+    {
+        BOOST_REQUIRE(builder.is_complete());
+        BOOST_CHECK(builder.get_block().id() == block.id());
+        BOOST_CHECK(builder.get_block().calculate_merkle_root() == block.transaction_merkle_root);
+
+        db.push_block(builder.get_block(), default_skip);
+        BOOST_CHECK(db.head_block_id() == block.id());
+    }
+
+    signed_block block;
+    std::map<short_transaction_id_type, signed_transaction> mempool;
+};
+}
+
+BOOST_FIXTURE_TEST_SUITE(compact_block_tests, compact_block_fixture)
+
+BOOST_AUTO_TEST_CASE(rebuild_from_mempool)
+{
+    try
+    {
+        compact_block_builder builder(compact_block_message(block), mempool_lookup());
+
+        BOOST_CHECK(builder.is_complete());
+        BOOST_CHECK(builder.get_missing_transactions().transaction_indexes.empty());
+
+        push_rebuilt_block(builder);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(rebuild_fetching_missing_transactions)
+{
+    try
+    {
+        mempool.erase(compact_block_message::get_short_transaction_id(block.transactions[1].id()));
+
+        compact_block_builder builder(compact_block_message(block), mempool_lookup());
+        BOOST_REQUIRE(!builder.is_complete());
+
+        const get_block_transactions_message request = builder.get_missing_transactions();
+        BOOST_REQUIRE_EQUAL(request.transaction_indexes.size(), 1u);
+        BOOST_CHECK_EQUAL(request.transaction_indexes[0], 1u);
+
+        const block_transactions_message reply = answer(request);
+        BOOST_REQUIRE_EQUAL(reply.transactions.size(), 1u);
+        BOOST_CHECK(reply.transactions[0].id() == block.transactions[1].id());
+
+        // an answer to another request is ignored
+        block_transactions_message wrong_reply = reply;
+        wrong_reply.transactions.push_back(block.transactions[0]);
+        BOOST_CHECK(!builder.add_transactions(wrong_reply));
+        BOOST_CHECK(!builder.is_complete());
+
+        BOOST_REQUIRE(builder.add_transactions(reply));
+        push_rebuilt_block(builder);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(short_id_collision_fetches_full_block)
+{
+    try
+    {
+        // a different transaction in the mempool under the short id of the second one
+        signed_transaction colliding = block.transactions[2];
+        colliding.operations[0].get<transfer_operation>().amount = asset(999, DEIP_SYMBOL);
+        BOOST_REQUIRE(colliding.id() != block.transactions[1].id());
+        mempool[compact_block_message::get_short_transaction_id(block.transactions[1].id())] = colliding;
+
+        compact_block_builder builder(compact_block_message(block), mempool_lookup());
+        BOOST_REQUIRE(!builder.is_complete());
+
+        const get_block_transactions_message request = builder.get_missing_transactions();
+        BOOST_CHECK_EQUAL(request.transaction_indexes.size(), block.transactions.size());
+
+        BOOST_REQUIRE(builder.add_transactions(answer(request)));
+        push_rebuilt_block(builder);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(short_id_collision_after_fetch_fetches_full_block)
+{
+    try
+    {
+        signed_transaction colliding = block.transactions[0];
+        colliding.operations[0].get<transfer_operation>().amount = asset(999, DEIP_SYMBOL);
+        mempool[compact_block_message::get_short_transaction_id(block.transactions[0].id())] = colliding;
+        mempool.erase(compact_block_message::get_short_transaction_id(block.transactions[2].id()));
+
+        compact_block_builder builder(compact_block_message(block), mempool_lookup());
+        BOOST_REQUIRE_EQUAL(builder.get_missing_transactions().transaction_indexes.size(), 1u);
+
+        // the fetched transaction completes a block that doesn't match the header
+        BOOST_REQUIRE(builder.add_transactions(answer(builder.get_missing_transactions())));
+        BOOST_REQUIRE(!builder.is_complete());
+
+        const get_block_transactions_message request = builder.get_missing_transactions();
+        BOOST_CHECK_EQUAL(request.transaction_indexes.size(), block.transactions.size());
+
+        BOOST_REQUIRE(builder.add_transactions(answer(request)));
+        push_rebuilt_block(builder);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -1,9 +1,13 @@
 #ifdef IS_TEST_NET
 #include <boost/test/unit_test.hpp>
 
+#include <deip/app/api_context.hpp>
+#include <deip/app/database_api.hpp>
 #include <deip/chain/schema/expert_token_object.hpp>
 #include <deip/chain/services/dbs_expert_token.hpp>
 
+#include <fc/io/json.hpp>
+
 #include "database_fixture.hpp"
 
 namespace deip {
@@ -143,8 +147,102 @@ BOOST_AUTO_TEST_CASE(check_expert_token_existence_by_account_and_discipline_id)
     BOOST_CHECK(!data_service.expert_token_exists_by_account_and_discipline("alice", 1));
 }
 
+BOOST_AUTO_TEST_CASE(implicit_default_expertise)
+{
+    ACTORS((alice))
+
+    try
+    {
+        BOOST_CHECK(db.get_account("alice").has_default_expertise);
+
+        BOOST_CHECK(!data_service.get_expert_token_by_account_and_discipline_if_exists("alice", 2).valid());
+        BOOST_CHECK(data_service.has_implicit_expert_token("alice", 2));
+        BOOST_CHECK(data_service.expert_token_exists_by_account_and_discipline("alice", 2));
+        BOOST_CHECK(data_service.get_expertise_amount("alice", 2) == DEIP_DEFAULT_EXPERTISE_AMOUNT);
+
+        BOOST_CHECK(!data_service.has_implicit_expert_token("alice", 0));
+        BOOST_CHECK(data_service.get_expertise_amount("alice", 0) == 0);
+
+        const auto& implicit_tokens = data_service.get_implicit_expert_tokens_by_discipline(2);
+        const auto implicit_token = std::find_if(implicit_tokens.begin(), implicit_tokens.end(),
+          [](const implicit_expert_token& t) { return t.account_name == "alice"; });
+        BOOST_REQUIRE(implicit_token != implicit_tokens.end());
+
+        const auto& alice_tokens = data_service.get_implicit_expert_tokens_by_account_name("alice");
+        const auto alice_token = std::find_if(alice_tokens.begin(), alice_tokens.end(),
+          [](const implicit_expert_token& t) { return t.discipline_id == 2; });
+        BOOST_REQUIRE(alice_token != alice_tokens.end());
+        BOOST_CHECK(alice_token->id == implicit_token->id);
+
+        const auto& token_by_id = data_service.get_implicit_expert_token_if_exists(implicit_token->id);
+        BOOST_REQUIRE(token_by_id.valid());
+        BOOST_CHECK(token_by_id->account_name == "alice");
+        BOOST_CHECK(token_by_id->discipline_id == 2);
+
+        const share_type balance_before = db.get_account("alice").expertise_tokens_balance;
+
+        const auto& result = data_service.adjust_expert_token("alice", 2, 100);
+        BOOST_CHECK(std::get<0>(result) == DEIP_DEFAULT_EXPERTISE_AMOUNT);
+        BOOST_CHECK(std::get<1>(result) == DEIP_DEFAULT_EXPERTISE_AMOUNT + 100);
+
+        const auto& expert_token = data_service.get_expert_token_by_account_and_discipline("alice", 2);
+        BOOST_CHECK(expert_token.id == implicit_token->id);
+        BOOST_CHECK(expert_token.amount == DEIP_DEFAULT_EXPERTISE_AMOUNT + 100);
+        BOOST_CHECK(expert_token.voting_power == DEIP_100_PERCENT);
+        BOOST_CHECK(db.get_account("alice").expertise_tokens_balance == balance_before + 100);
+
+        BOOST_CHECK(!data_service.has_implicit_expert_token("alice", 2));
+        BOOST_CHECK(!data_service.get_implicit_expert_token_if_exists(implicit_token->id).valid());
+        BOOST_CHECK(data_service.get_implicit_expert_tokens_by_discipline(2).size() == implicit_tokens.size() - 1);
+        BOOST_CHECK(data_service.get_implicit_expert_tokens_by_account_name("alice").size() == alice_tokens.size() - 1);
+        BOOST_CHECK(data_service.has_implicit_expert_token("alice", 3));
+        BOOST_CHECK_THROW(data_service.create_expert_token("alice", 3, 100, false), fc::assert_exception);
+
+        validate_database();
+    }
+    FC_LOG_AND_RETHROW()
+}
 
+BOOST_AUTO_TEST_CASE(get_expert_token_by_reserved_id)
+{
+    ACTORS((alice))
 
+    try
+    {
+        const auto session = std::make_shared<app::api_session_data>();
+        app::database_api api(app::api_context(app, "database_api", session));
+
+        // one token in an object, the others implicit
+        data_service.adjust_expert_token("alice", 2, 100);
+
+        const auto alice_tokens = api.get_expert_tokens_by_account_name("alice");
+        BOOST_REQUIRE(alice_tokens.size() > 1);
+
+        for (const auto& token : alice_tokens)
+        {
+            const auto& token_by_id = api.get_expert_token(expert_token_id_type(token.id));
+            BOOST_REQUIRE(token_by_id.valid());
+            BOOST_CHECK_EQUAL(fc::json::to_string(fc::variant(*token_by_id)), fc::json::to_string(fc::variant(token)));
+        }
+
+        const auto implicit_token = std::find_if(alice_tokens.begin(), alice_tokens.end(),
+          [](const app::expert_token_api_obj& t) { return t.discipline_id == 3; });
+        BOOST_REQUIRE(implicit_token != alice_tokens.end());
+        BOOST_CHECK(implicit_token->amount == DEIP_DEFAULT_EXPERTISE_AMOUNT);
+
+        const auto& discipline_tokens = api.get_expert_tokens_by_discipline(db.get<discipline_object>(3).external_id);
+        const auto discipline_token = std::find_if(discipline_tokens.begin(), discipline_tokens.end(),
+          [](const app::expert_token_api_obj& t) { return t.account_name == "alice"; });
+        BOOST_REQUIRE(discipline_token != discipline_tokens.end());
+        BOOST_CHECK_EQUAL(discipline_token->id, implicit_token->id);
+
+        // ids past the reserved ones are not tokens
+        const auto last_id = std::max_element(alice_tokens.begin(), alice_tokens.end(),
+          [](const app::expert_token_api_obj& a, const app::expert_token_api_obj& b) { return a.id < b.id; })->id;
+        BOOST_CHECK(!api.get_expert_token(expert_token_id_type(last_id + 1000)).valid());
+    }
+    FC_LOG_AND_RETHROW()
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
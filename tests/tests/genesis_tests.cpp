@@ -2,6 +2,7 @@
 
 #include <fc/io/json.hpp>
 #include <deip/chain/genesis_state.hpp>
+#include <deip/chain/genesis_reader.hpp>
 
 namespace sc = deip::chain;
 namespace sp = deip::protocol;
@@ -65,3 +66,206 @@ BOOST_AUTO_TEST_CASE(check_initial_supply)
 
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(read_genesis_state)
+
+BOOST_AUTO_TEST_CASE(read_header_and_records)
+{
+    const std::string genesis_str = "{ \"init_supply\": 1000000,"
+                                    "\"accounts\": [ {\"name\":\"alice\",\"recovery_account\":\"\","
+                                    "\"public_key\":\"DEIP1111111111111111111111111111111114T1Anm\"},"
+                                    "{\"name\":\"bob\",\"recovery_account\":\"[{,\\\"\","
+                                    "\"public_key\":\"DEIP1111111111111111111111111111111114T1Anm\"}, ],"
+                                    "\"witness_candidates\":[{\"owner_name\":\"alice\","
+                                    "\"block_signing_key\":\"DEIP1111111111111111111111111111111114T1Anm\"}],"
+                                    "\"disciplines\": [],"
+                                    "\"initial_timestamp\": \"2017-11-28T14:48:10\", }";
+
+    const auto reader = std::make_shared<sc::genesis_reader>(genesis_str);
+    const sc::genesis_state_type genesis_state = reader->header();
+
+    BOOST_CHECK(genesis_state.init_supply == 1000000);
+    BOOST_CHECK(genesis_state.initial_timestamp == fc::time_point_sec(1511880490));
+    BOOST_REQUIRE(genesis_state.witness_candidates.size() == 1);
+    BOOST_CHECK(genesis_state.witness_candidates.front().owner_name == "alice");
+    BOOST_CHECK(genesis_state.reader == reader);
+
+    // the record arrays are only read by for_each
+    BOOST_CHECK(genesis_state.accounts.empty());
+
+    std::vector<sc::genesis_state_type::account_type> accounts;
+    reader->for_each<sc::genesis_state_type::account_type>(
+        "accounts", [&](const sc::genesis_state_type::account_type& account) { accounts.push_back(account); });
+
+    BOOST_REQUIRE(accounts.size() == 2);
+    BOOST_CHECK(accounts[0].name == "alice");
+    BOOST_CHECK(accounts[1].name == "bob");
+    BOOST_CHECK(accounts[1].recovery_account == "[{,\"");
+
+    size_t disciplines = 0;
+    reader->for_each<sc::genesis_state_type::discipline_type>(
+        "disciplines", [&](const sc::genesis_state_type::discipline_type&) { ++disciplines; });
+    reader->for_each<sc::genesis_state_type::discipline_type>(
+        "research_groups", [&](const sc::genesis_state_type::discipline_type&) { ++disciplines; });
+    BOOST_CHECK(disciplines == 0);
+}
+
+BOOST_AUTO_TEST_CASE(chain_id_is_hash_of_the_document)
+{
+    const std::string genesis_str = "{\"init_supply\": 1000000, \"accounts\": []}";
+
+    const auto reader = std::make_shared<sc::genesis_reader>(genesis_str);
+
+    BOOST_CHECK(reader->chain_id() == fc::sha256::hash(genesis_str));
+}
+
+BOOST_AUTO_TEST_CASE(malformed_documents_are_rejected)
+{
+    BOOST_CHECK_THROW(std::make_shared<sc::genesis_reader>(std::string("[]")), fc::exception);
+    BOOST_CHECK_THROW(std::make_shared<sc::genesis_reader>(std::string("{\"accounts\": [{}")), fc::exception);
+    BOOST_CHECK_THROW(std::make_shared<sc::genesis_reader>(std::string("{\"init_supply\": \"1")), fc::exception);
+    BOOST_CHECK_THROW(std::make_shared<sc::genesis_reader>(std::string("{\"init_supply\" 1}")), fc::exception);
+
+    const auto reader = std::make_shared<sc::genesis_reader>(std::string("{\"accounts\": {}}"));
+    BOOST_CHECK_THROW(reader->for_each<sc::genesis_state_type::account_type>(
+                          "accounts", [](const sc::genesis_state_type::account_type&) {}),
+                      fc::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#ifdef IS_TEST_NET
+#include <graphene/utilities/tempdir.hpp>
+
+#include <deip/chain/schema/account_balance_object.hpp>
+#include <deip/chain/schema/asset_object.hpp>
+#include <deip/chain/schema/discipline_object.hpp>
+#include <deip/chain/schema/expert_token_object.hpp>
+#include <deip/chain/services/dbs_discipline.hpp>
+#include <deip/chain/services/dbs_expert_token.hpp>
+
+#include "database_fixture.hpp"
+
+namespace deip {
+namespace chain {
+
+/**
+ *  Opens a database from the genesis state of the fixture, as test databases are opened, and
+ *  records the virtual operations pushed by init_genesis.
+ */
+struct genesis_database
+{
+    genesis_database(const genesis_state_type& genesis_state)
+        : data_dir(graphene::utilities::temp_directory_path())
+    {
+        db._log_hardforks = false;
+        db.post_apply_operation.connect(
+            [&](const operation_notification& note) { virtual_ops.push_back(fc::raw::pack(note.op)); });
+        db.open(data_dir.path(), data_dir.path(), TEST_SHARED_MEM_SIZE_128MB, chainbase::database::read_write,
+                genesis_state);
+    }
+
+    ~genesis_database()
+    {
+        db.close();
+    }
+
+    fc::temp_directory data_dir;
+    database db;
+    std::vector<std::vector<char>> virtual_ops;
+};
+
+BOOST_FIXTURE_TEST_SUITE(genesis_reader_database, database_fixture)
+
+BOOST_AUTO_TEST_CASE(read_genesis_state_matches_parsed_genesis_state)
+{
+    try
+    {
+        genesis_state.accounts.push_back({ "alice", "initdelegate", init_account_pub_key });
+        genesis_state.accounts.push_back({ "bob", "initdelegate", init_account_pub_key });
+        // the first of repeated expert tokens is granted
+        genesis_state.expert_tokens.push_back({ "alice", 5000, "9f0224709d86e02b9625b5ebf2786b80ba6bed17" });
+        genesis_state.expert_tokens.push_back({ "alice", 7000, "9f0224709d86e02b9625b5ebf2786b80ba6bed17" });
+
+        const std::string genesis_str = fc::json::to_string(genesis_state);
+
+        genesis_state_type read_genesis_state = std::make_shared<genesis_reader>(genesis_str)->header();
+        read_genesis_state.initial_chain_id = genesis_state.initial_chain_id;
+
+        genesis_database parsed(fc::json::from_string(genesis_str).as<genesis_state_type>());
+        genesis_database read(read_genesis_state);
+
+        BOOST_CHECK(parsed.virtual_ops == read.virtual_ops);
+        BOOST_CHECK(!read.virtual_ops.empty());
+
+        const auto& parsed_accounts = parsed.db.get_index<account_index>().indices().get<by_id>();
+        const auto& read_accounts = read.db.get_index<account_index>().indices().get<by_id>();
+        BOOST_REQUIRE_EQUAL(parsed_accounts.size(), read_accounts.size());
+        BOOST_CHECK(read.db.find_account("alice") != nullptr);
+        for (auto p = parsed_accounts.begin(), r = read_accounts.begin(); p != parsed_accounts.end(); ++p, ++r)
+        {
+            BOOST_CHECK(p->id == r->id);
+            BOOST_CHECK(p->name == r->name);
+            BOOST_CHECK(p->memo_key == r->memo_key);
+            BOOST_CHECK(p->recovery_account == r->recovery_account);
+            BOOST_CHECK(p->common_tokens_balance == r->common_tokens_balance);
+        }
+
+        const auto& parsed_balances = parsed.db.get_index<account_balance_index>().indices().get<by_id>();
+        const auto& read_balances = read.db.get_index<account_balance_index>().indices().get<by_id>();
+        BOOST_REQUIRE_EQUAL(parsed_balances.size(), read_balances.size());
+        for (auto p = parsed_balances.begin(), r = read_balances.begin(); p != parsed_balances.end(); ++p, ++r)
+        {
+            BOOST_CHECK(p->owner == r->owner);
+            BOOST_CHECK(p->symbol == r->symbol);
+            BOOST_CHECK(p->amount == r->amount);
+        }
+
+        const auto& parsed_assets = parsed.db.get_index<asset_index>().indices().get<by_id>();
+        const auto& read_assets = read.db.get_index<asset_index>().indices().get<by_id>();
+        BOOST_REQUIRE_EQUAL(parsed_assets.size(), read_assets.size());
+        for (auto p = parsed_assets.begin(), r = read_assets.begin(); p != parsed_assets.end(); ++p, ++r)
+        {
+            BOOST_CHECK(p->symbol == r->symbol);
+            BOOST_CHECK(p->current_supply == r->current_supply);
+        }
+
+        const auto& parsed_disciplines = parsed.db.get_index<discipline_index>().indices().get<by_id>();
+        const auto& read_disciplines = read.db.get_index<discipline_index>().indices().get<by_id>();
+        BOOST_REQUIRE_EQUAL(parsed_disciplines.size(), read_disciplines.size());
+        for (auto p = parsed_disciplines.begin(), r = read_disciplines.begin(); p != parsed_disciplines.end(); ++p, ++r)
+        {
+            BOOST_CHECK(p->external_id == r->external_id);
+            BOOST_CHECK(p->parent_id == r->parent_id);
+            BOOST_CHECK(fc::to_string(p->name) == fc::to_string(r->name));
+        }
+
+        const auto& parsed_expert_tokens = parsed.db.get_index<expert_token_index>().indices().get<by_id>();
+        const auto& read_expert_tokens = read.db.get_index<expert_token_index>().indices().get<by_id>();
+        BOOST_REQUIRE_EQUAL(parsed_expert_tokens.size(), read_expert_tokens.size());
+        for (auto p = parsed_expert_tokens.begin(), r = read_expert_tokens.begin(); p != parsed_expert_tokens.end(); ++p, ++r)
+        {
+            BOOST_CHECK(p->account_name == r->account_name);
+            BOOST_CHECK(p->discipline_id == r->discipline_id);
+            BOOST_CHECK(p->amount == r->amount);
+        }
+
+        const auto& physics = read.db.obtain_service<dbs_discipline>().get_discipline(
+            external_id_type("9f0224709d86e02b9625b5ebf2786b80ba6bed17"));
+        BOOST_CHECK(read.db.obtain_service<dbs_expert_token>().get_expertise_amount("alice", physics.id) == 5000);
+
+        BOOST_CHECK(parsed.db.get_dynamic_global_properties().current_supply
+                    == read.db.get_dynamic_global_properties().current_supply);
+        BOOST_CHECK(parsed.db.get_dynamic_global_properties().total_common_tokens_amount
+                    == read.db.get_dynamic_global_properties().total_common_tokens_amount);
+        BOOST_CHECK(parsed.db.get_witness_schedule_object().current_shuffled_witnesses
+                    == read.db.get_witness_schedule_object().current_shuffled_witnesses);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace chain
+} // namespace deip
+#endif
@@ -0,0 +1,431 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <deip/app/api_context.hpp>
+#include <deip/app/history_retention.hpp>
+#include <deip/blockchain_history/account_history_api.hpp>
+#include <deip/blockchain_history/blockchain_history_api.hpp>
+#include <deip/blockchain_history/blockchain_history_plugin.hpp>
+#include <deip/chain/services/dbs_asset.hpp>
+#include <deip/eci_history/discipline_eci_history_object.hpp>
+#include <deip/eci_history/eci_history_api.hpp>
+#include <deip/eci_history/eci_history_plugin.hpp>
+#include <deip/investments_history/account_revenue_income_history_object.hpp>
+#include <deip/investments_history/investments_history_api.hpp>
+#include <deip/investments_history/investments_history_plugin.hpp>
+#include <deip/proposal_history/proposal_history_api.hpp>
+#include <deip/proposal_history/proposal_history_plugin.hpp>
+#include <deip/proposal_history/proposal_state_object.hpp>
+
+#include <fc/crypto/base64.hpp>
+#include <fc/io/json.hpp>
+
+#include "database_fixture.hpp"
+
+using namespace deip;
+using namespace deip::app;
+using namespace deip::chain;
+using namespace deip::protocol;
+using namespace deip::blockchain_history;
+
+namespace {
+
+typedef std::map<uint32_t, applied_operation> ops_map;
+
+/**
+ *  Records the responses of the node while it keeps all of its history, so that the responses
+ *  after pruning can be compared with the ones of a full node.
+ */
+struct history_retention_fixture : public clean_database_fixture
+{
+    history_retention_fixture()
+        : session(std::make_shared<api_session_data>())
+        , history_api(api_context(app, "blockchain_history_api", session))
+        , account_api(api_context(app, "account_history_api", session))
+    {
+    }
+
+    void set_retention(uint32_t blocks, uint32_t objects, uint32_t batch)
+    {
+        namespace bpo = boost::program_options;
+
+        bpo::variables_map options;
+        options.insert(std::make_pair("history-retention-blocks", bpo::variable_value(blocks, false)));
+        options.insert(std::make_pair("history-retention-objects", bpo::variable_value(objects, false)));
+        options.insert(std::make_pair("history-prune-batch", bpo::variable_value(batch, false)));
+
+        app.get_plugin<blockchain_history_plugin>(BLOCKCHAIN_HISTORY_PLUGIN_NAME)->plugin_initialize(options);
+    }
+
+    /// one transfer of alice in each block
+    void generate_transfers(uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            transfer("alice", TEST_INIT_DELEGATE_NAME, i + 1);
+            generate_block();
+        }
+    }
+
+    void record_full_node()
+    {
+        for (uint32_t block = 1; block <= db.head_block_num(); ++block)
+        {
+            const ops_map ops = history_api.get_ops_in_block(block, applied_operation_type::all);
+            full_ops_in_block[block] = ops;
+            full_ops.insert(ops.begin(), ops.end());
+        }
+
+        full_alice_history = account_api.get_account_history("alice", uint64_t(-1), 100);
+        BOOST_REQUIRE(!full_alice_history.empty());
+        BOOST_REQUIRE(full_alice_history.begin()->first == 0);
+    }
+
+    uint32_t first_retained_block() const
+    {
+        return db.get_index<operation_index>().indices().get<by_id>().begin()->block;
+    }
+
+    uint32_t first_retained_op() const
+    {
+        return db.get_index<operation_index>().indices().get<by_id>().begin()->id._id;
+    }
+
+    template <typename T> static std::string to_json(const T& value)
+    {
+        return fc::json::to_string(fc::variant(value));
+    }
+
+    std::shared_ptr<api_session_data> session;
+    blockchain_history_api history_api;
+    account_history_api account_api;
+
+    std::map<uint32_t, ops_map> full_ops_in_block;
+    ops_map full_ops;
+    ops_map full_alice_history;
+};
+
+/**
+ *  Node with the investments, ECI and proposal history plugins, which keep their entries for
+ *  retention_blocks blocks. on_block pushes the history operations of each applied block, so
+ *  that every block adds entries with its timestamp.
+ */
+struct plugin_history_retention_fixture : public clean_database_fixture
+{
+    plugin_history_retention_fixture()
+        : session(std::make_shared<api_session_data>())
+        , investments_api(api_context(app, "investments_history_api", session))
+        , eci_api(api_context(app, "eci_history_api", session))
+        , proposal_api(api_context(app, "proposal_history_api", session))
+    {
+        namespace bpo = boost::program_options;
+
+        const uint32_t blocks = retention_blocks;
+        bpo::variables_map options;
+        for (const std::string& prefix :
+             { std::string("investments-history"), std::string("eci-history"), std::string("proposal-history") })
+        {
+            options.insert(std::make_pair(prefix + "-retention-blocks", bpo::variable_value(blocks, false)));
+            options.insert(std::make_pair(prefix + "-prune-batch", bpo::variable_value(uint32_t(100), false)));
+        }
+
+        app.register_plugin<investments_history::investments_history_plugin>()->plugin_initialize(options);
+        app.register_plugin<eci_history::eci_history_plugin>()->plugin_initialize(options);
+        app.register_plugin<proposal_history::proposal_history_plugin>()->plugin_initialize(options);
+
+        // the plugin indices are added when the database is opened
+        resize_shared_mem(TEST_SHARED_MEM_SIZE_128MB);
+
+        applied_block_connection = db.applied_block.connect([this](const signed_block& b) {
+            if (on_block)
+                on_block(b);
+        });
+    }
+
+    /// blocks with history entries, followed by blocks which push the oldest entries out of the window
+    void generate_history_blocks(std::function<void(const signed_block&)> push_history)
+    {
+        on_block = push_history;
+        generate_blocks(history_blocks);
+        on_block = nullptr;
+    }
+
+    void generate_pruning_blocks()
+    {
+        generate_blocks(retention_blocks + 1 - history_blocks / 2);
+    }
+
+    template <typename IndexType> const typename IndexType::value_type& first_retained() const
+    {
+        return *db.get_index<IndexType>().indices().template get<by_id>().begin();
+    }
+
+    template <typename T> static std::string to_json(const T& value)
+    {
+        return fc::json::to_string(fc::variant(value));
+    }
+
+    static const uint32_t retention_blocks = 10;
+    static const uint32_t history_blocks = 8;
+
+    std::shared_ptr<api_session_data> session;
+    investments_history::investments_history_api investments_api;
+    eci_history::eci_history_api eci_api;
+    proposal_history::proposal_history_api proposal_api;
+
+    std::function<void(const signed_block&)> on_block;
+    boost::signals2::scoped_connection applied_block_connection;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(history_retention_tests, history_retention_fixture)
+
+BOOST_AUTO_TEST_CASE(pruned_node_matches_full_node_within_window)
+{
+    try
+    {
+        create_account("alice", init_account_pub_key);
+        fund("alice", 100000);
+        generate_block();
+
+        generate_transfers(20);
+        const uint32_t last_block = db.head_block_num();
+        record_full_node();
+
+        // the window ends about 10 blocks before the last transfer
+        set_retention(30, 0, 100);
+        generate_blocks(20);
+
+        BOOST_REQUIRE(is_pruned<operation_index>(db));
+        BOOST_REQUIRE_GT(first_retained_block(), last_block - 19);
+        BOOST_REQUIRE_LE(first_retained_block(), last_block - 9);
+
+        for (const auto& block : full_ops_in_block)
+        {
+            if (block.first < first_retained_block())
+            {
+                BOOST_CHECK_THROW(history_api.get_ops_in_block(block.first, applied_operation_type::all),
+                                  fc::exception);
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL(to_json(history_api.get_ops_in_block(block.first, applied_operation_type::all)),
+                                  to_json(block.second));
+            }
+        }
+
+        const uint32_t first_op = first_retained_op();
+        const uint32_t last_op = full_ops.rbegin()->first;
+        const uint32_t window = std::min<uint32_t>(last_op - first_op + 1, 100);
+        BOOST_REQUIRE_GT(window, 1u);
+
+        ops_map expected_ops(full_ops.find(last_op - window + 1), full_ops.end());
+        BOOST_CHECK_EQUAL(to_json(history_api.get_ops_history(last_op, window, applied_operation_type::all)),
+                          to_json(expected_ops));
+        BOOST_CHECK_EQUAL(history_api.get_ops_history(first_op, 1, applied_operation_type::all).size(), 1u);
+        BOOST_CHECK_THROW(history_api.get_ops_history(first_op, 2, applied_operation_type::all), fc::exception);
+
+        // alice's entries of the pruned blocks are gone, the later ones are as on the full node
+        ops_map expected_history;
+        for (const auto& entry : full_alice_history)
+        {
+            if (entry.second.block >= first_retained_block())
+                expected_history.insert(entry);
+        }
+        BOOST_REQUIRE(!expected_history.empty());
+        BOOST_REQUIRE_LT(expected_history.size(), full_alice_history.size());
+
+        const uint32_t newest = expected_history.rbegin()->first;
+        const uint32_t retained = expected_history.size();
+        BOOST_CHECK_EQUAL(to_json(account_api.get_account_history("alice", newest, retained)),
+                          to_json(expected_history));
+        BOOST_CHECK_THROW(account_api.get_account_history("alice", newest, retained + 1), fc::exception);
+        BOOST_CHECK_THROW(account_api.get_account_history("alice", newest - retained, 1), fc::exception);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(sequences_continue_after_pruning)
+{
+    try
+    {
+        create_account("alice", init_account_pub_key);
+        fund("alice", 100000);
+        generate_block();
+
+        generate_transfers(5);
+        record_full_node();
+        const uint32_t last_sequence = full_alice_history.rbegin()->first;
+
+        // a few operations at most
+        set_retention(0, 3, 50);
+        generate_blocks(30);
+
+        BOOST_REQUIRE(is_pruned<operation_index>(db));
+        BOOST_CHECK_THROW(account_api.get_account_history("alice", last_sequence, 1), fc::exception);
+
+        transfer("alice", TEST_INIT_DELEGATE_NAME, 1);
+        generate_block();
+
+        const ops_map history = account_api.get_account_history("alice", uint64_t(-1), 1);
+        BOOST_REQUIRE_EQUAL(history.size(), 1u);
+        BOOST_CHECK_EQUAL(history.begin()->first, last_sequence + 1);
+        BOOST_CHECK(history.begin()->second.op.which() == operation::tag<transfer_operation>::value);
+        BOOST_CHECK_THROW(account_api.get_account_history("alice", last_sequence + 1, 2), fc::exception);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(retention_options)
+{
+    try
+    {
+        namespace bpo = boost::program_options;
+
+        bpo::options_description cfg;
+        history_retention::add_program_options(cfg, "test-history");
+
+        const char* argv[] = { "deipd", "--test-history-retention-blocks=100", "--test-history-prune-batch=10" };
+        bpo::variables_map options;
+        bpo::store(bpo::parse_command_line(3, argv, cfg), options);
+
+        const history_retention retention = history_retention::from_options(options, "test-history");
+        BOOST_CHECK(retention.enabled());
+        BOOST_CHECK_EQUAL(retention.max_age_blocks, 100u);
+        BOOST_CHECK_EQUAL(retention.max_objects, 0u);
+        BOOST_CHECK_EQUAL(retention.batch_size, 10u);
+
+        BOOST_CHECK(!history_retention::from_options(bpo::variables_map(), "test-history").enabled());
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE(plugin_history_retention_tests, plugin_history_retention_fixture)
+
+BOOST_AUTO_TEST_CASE(pruned_revenue_history_matches_full_node_within_window)
+{
+    try
+    {
+        using namespace deip::investments_history;
+
+        const asset_symbol_type security_token = db.obtain_service<dbs_asset>().get_asset_by_string_symbol("TESTS").symbol;
+
+        generate_history_blocks([&](const signed_block& b) {
+            db.push_virtual_operation(account_revenue_income_history_operation(
+                TEST_INIT_DELEGATE_NAME, asset(0, security_token), asset(b.block_num(), DEIP_SYMBOL), b.timestamp));
+        });
+
+        const auto full_history = investments_api.get_account_revenue_history(TEST_INIT_DELEGATE_NAME, 0);
+        BOOST_REQUIRE_EQUAL(full_history.size(), size_t(history_blocks));
+        BOOST_REQUIRE(!is_pruned<account_revenue_income_history_index>(db));
+
+        generate_pruning_blocks();
+
+        BOOST_REQUIRE(is_pruned<account_revenue_income_history_index>(db));
+        const int64_t first_id = first_retained<account_revenue_income_history_index>().id._id;
+        BOOST_REQUIRE_LT(first_id, int64_t(history_blocks));
+
+        const std::vector<account_revenue_income_history_api_obj> expected(full_history.begin() + first_id,
+                                                                           full_history.end());
+        BOOST_CHECK_EQUAL(to_json(investments_api.get_account_revenue_history(TEST_INIT_DELEGATE_NAME, first_id)),
+                          to_json(expected));
+        BOOST_CHECK_EQUAL(to_json(investments_api.get_account_revenue_history(TEST_INIT_DELEGATE_NAME, 0)),
+                          to_json(expected));
+        BOOST_CHECK_THROW(investments_api.get_account_revenue_history(TEST_INIT_DELEGATE_NAME, first_id - 1),
+                          fc::exception);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(pruned_eci_history_matches_full_node_within_window)
+{
+    try
+    {
+        using namespace deip::eci_history;
+
+        std::vector<fc::time_point_sec> timestamps;
+        generate_history_blocks([&](const signed_block& b) {
+            db.push_virtual_operation(disciplines_eci_history_operation({}, b.timestamp));
+            timestamps.push_back(b.timestamp);
+        });
+
+        // stats from each block on, as a full node answers them
+        std::map<fc::time_point_sec, std::string> full_stats;
+        for (const auto& timestamp : timestamps)
+            full_stats[timestamp] = to_json(eci_api.get_disciplines_eci_stats_history(timestamp, {}, {}));
+
+        generate_pruning_blocks();
+
+        BOOST_REQUIRE(is_pruned<discipline_eci_history_index>(db));
+        const fc::time_point_sec first_timestamp = first_retained<discipline_eci_history_index>().timestamp;
+        BOOST_REQUIRE(first_timestamp > timestamps.front());
+        BOOST_REQUIRE(first_timestamp <= timestamps.back());
+
+        for (const auto& stats : full_stats)
+        {
+            if (stats.first < first_timestamp)
+            {
+                BOOST_CHECK_THROW(eci_api.get_disciplines_eci_stats_history(stats.first, {}, {}), fc::exception);
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL(to_json(eci_api.get_disciplines_eci_stats_history(stats.first, {}, {})), stats.second);
+            }
+        }
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(pruned_proposal_history_matches_full_node_within_window)
+{
+    try
+    {
+        using namespace deip::proposal_history;
+
+        transfer_operation transfer;
+        transfer.from = TEST_INIT_DELEGATE_NAME;
+        transfer.to = "alice";
+        transfer.amount = asset(1, DEIP_SYMBOL);
+
+        transaction proposed_transaction;
+        proposed_transaction.operations.push_back(transfer);
+        const std::vector<char> packed = fc::raw::pack(proposed_transaction);
+        const std::string serialized = fc::base64_encode(std::string(packed.begin(), packed.end()));
+
+        // every proposal is settled in its block and expires with the next one
+        generate_history_blocks([&](const signed_block& b) {
+            const external_id_type external_id = "proposal" + fc::to_string(b.block_num());
+            db.push_virtual_operation(create_genesis_proposal_operation(
+                external_id, TEST_INIT_DELEGATE_NAME, serialized, b.timestamp + DEIP_BLOCK_INTERVAL, b.timestamp,
+                {}, {}, {}, {}));
+            db.push_virtual_operation(
+                proposal_status_changed_operation(external_id, static_cast<uint8_t>(proposal_status::approved)));
+        });
+
+        const auto full_states = proposal_api.lookup_proposals_states(0, 100);
+        BOOST_REQUIRE_EQUAL(full_states.size(), size_t(history_blocks));
+        BOOST_REQUIRE_EQUAL(proposal_api.get_proposals_by_signer(TEST_INIT_DELEGATE_NAME).size(), size_t(history_blocks));
+        BOOST_REQUIRE(!is_pruned<proposal_history_index>(db));
+
+        generate_pruning_blocks();
+
+        BOOST_REQUIRE(is_pruned<proposal_history_index>(db));
+        const int64_t first_id = first_retained<proposal_history_index>().id._id;
+        BOOST_REQUIRE_LT(first_id, int64_t(history_blocks));
+
+        const std::vector<proposal_state_api_obj> expected(full_states.begin() + first_id, full_states.end());
+        BOOST_CHECK_EQUAL(to_json(proposal_api.lookup_proposals_states(first_id, 100)), to_json(expected));
+        BOOST_CHECK_EQUAL(to_json(proposal_api.lookup_proposals_states(0, 100)), to_json(expected));
+        BOOST_CHECK_THROW(proposal_api.lookup_proposals_states(first_id - 1, 100), fc::exception);
+
+        // the lookups of pruned proposals are gone with them
+        BOOST_CHECK_EQUAL(proposal_api.get_proposals_by_signer(TEST_INIT_DELEGATE_NAME).size(), expected.size());
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
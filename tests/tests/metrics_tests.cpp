@@ -0,0 +1,207 @@
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/utilities/metrics.hpp>
+
+#include <deip/app/metrics_server.hpp>
+
+#include <fc/network/http/connection.hpp>
+
+#include <sstream>
+
+#ifdef IS_TEST_NET
+#include "database_fixture.hpp"
+#endif
+
+using namespace graphene::utilities;
+
+namespace {
+
+/// Value of the sample with the given name and labels in the exposition, or -1 if there is none
+double sample_value(const std::string& exposition, const std::string& sample)
+{
+    std::istringstream lines(exposition);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.compare(0, sample.size() + 1, sample + ' ') == 0)
+            return std::stod(line.substr(sample.size() + 1));
+    }
+
+    return -1;
+}
+
+bool has_line(const std::string& exposition, const std::string& expected)
+{
+    std::istringstream lines(exposition);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line == expected)
+            return true;
+    }
+
+    return false;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(metrics_tests)
+
+BOOST_AUTO_TEST_CASE(counter_and_gauge)
+{
+    try
+    {
+        metrics_registry registry;
+
+        counter& calls = registry.get_counter("test_calls_total", "Calls");
+        calls.inc();
+        calls.inc(4);
+        BOOST_CHECK_EQUAL(calls.value(), 5u);
+
+        // the same metric on a repeated lookup
+        BOOST_CHECK_EQUAL(&registry.get_counter("test_calls_total", "Calls"), &calls);
+
+        gauge& depth = registry.get_gauge("test_depth", "Depth");
+        depth.set(10);
+        depth.add(-2.5);
+        BOOST_CHECK_EQUAL(depth.value(), 7.5);
+
+        const std::string exposition = registry.to_prometheus();
+        BOOST_CHECK(has_line(exposition, "# HELP test_calls_total Calls"));
+        BOOST_CHECK(has_line(exposition, "# TYPE test_calls_total counter"));
+        BOOST_CHECK(has_line(exposition, "test_calls_total 5"));
+        BOOST_CHECK(has_line(exposition, "# TYPE test_depth gauge"));
+        BOOST_CHECK(has_line(exposition, "test_depth 7.5"));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(labels)
+{
+    try
+    {
+        metrics_registry registry;
+
+        registry.get_counter("test_results_total", "Results", { { "result", "ok" } }).inc(2);
+        registry.get_counter("test_results_total", "Results", { { "result", "failed" } }).inc();
+        registry.get_gauge("test_escaped", "Help with \\ and\nnewline", { { "path", "a\"b\\c\nd" } }).set(1);
+
+        const std::string exposition = registry.to_prometheus();
+        BOOST_CHECK(has_line(exposition, "test_results_total{result=\"ok\"} 2"));
+        BOOST_CHECK(has_line(exposition, "test_results_total{result=\"failed\"} 1"));
+        BOOST_CHECK(has_line(exposition, "# HELP test_escaped Help with \\\\ and\\nnewline"));
+        BOOST_CHECK(has_line(exposition, "test_escaped{path=\"a\\\"b\\\\c\\nd\"} 1"));
+
+        // one TYPE line for the family
+        BOOST_CHECK_EQUAL(exposition.find("# TYPE test_results_total"),
+                          exposition.rfind("# TYPE test_results_total"));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+    try
+    {
+        metrics_registry registry;
+
+        histogram& latency = registry.get_histogram("test_latency_seconds", "Latency", { 0.1, 1, 10 });
+        for (double value : { 0.05, 0.1, 0.5, 2.0, 20.0, 30.0 })
+            latency.observe(value);
+
+        const std::vector<uint64_t> counts = latency.cumulative_counts();
+        BOOST_REQUIRE_EQUAL(counts.size(), 4u);
+        BOOST_CHECK_EQUAL(counts[0], 2u);
+        BOOST_CHECK_EQUAL(counts[1], 3u);
+        BOOST_CHECK_EQUAL(counts[2], 4u);
+        BOOST_CHECK_EQUAL(counts[3], 6u);
+        BOOST_CHECK_EQUAL(latency.count(), 6u);
+        BOOST_CHECK_CLOSE(latency.sum(), 52.65, 1e-9);
+
+        const std::string exposition = registry.to_prometheus();
+        BOOST_CHECK(has_line(exposition, "# TYPE test_latency_seconds histogram"));
+        BOOST_CHECK(has_line(exposition, "test_latency_seconds_bucket{le=\"0.1\"} 2"));
+        BOOST_CHECK(has_line(exposition, "test_latency_seconds_bucket{le=\"1\"} 3"));
+        BOOST_CHECK(has_line(exposition, "test_latency_seconds_bucket{le=\"10\"} 4"));
+        BOOST_CHECK(has_line(exposition, "test_latency_seconds_bucket{le=\"+Inf\"} 6"));
+        BOOST_CHECK(has_line(exposition, "test_latency_seconds_count 6"));
+        BOOST_CHECK_CLOSE(sample_value(exposition, "test_latency_seconds_sum"), 52.65, 1e-9);
+
+        registry.get_histogram("test_labeled_seconds", "Labeled", { 1 }, { { "method", "get" } }).observe(0.5);
+        BOOST_CHECK(has_line(registry.to_prometheus(), "test_labeled_seconds_bucket{method=\"get\",le=\"1\"} 1"));
+
+        const std::vector<double> bounds = histogram::exponential_bounds(0.5, 2, 4);
+        BOOST_CHECK(bounds == std::vector<double>({ 0.5, 1, 2, 4 }));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(invalid_registrations)
+{
+    try
+    {
+        metrics_registry registry;
+        registry.get_counter("test_total", "Total");
+        registry.get_histogram("test_seconds", "Seconds", { 1, 2 });
+
+        BOOST_CHECK_THROW(registry.get_gauge("test_total", "Total"), fc::exception);
+        BOOST_CHECK_THROW(registry.get_histogram("test_seconds", "Seconds", { 1, 3 }), fc::exception);
+        BOOST_CHECK_THROW(registry.get_counter("1_invalid", "Invalid"), fc::exception);
+        BOOST_CHECK_THROW(registry.get_counter("test_other_total", "Other", { { "le", "1" } }), fc::exception);
+        BOOST_CHECK_THROW(registry.get_histogram("test_unsorted", "Unsorted", { 2, 1 }), fc::exception);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(metrics_endpoint)
+{
+    try
+    {
+        metrics().get_counter("test_endpoint_total", "Served by the endpoint").inc(3);
+
+        deip::app::metrics_server server(fc::ip::endpoint::from_string("127.0.0.1:0"));
+
+        fc::http::connection connection;
+        connection.connect_to(server.get_local_endpoint());
+        const fc::http::reply reply = connection.request("GET", "/metrics");
+        BOOST_CHECK_EQUAL(reply.status, fc::http::reply::OK);
+
+        const std::string body(reply.body.begin(), reply.body.end());
+        BOOST_CHECK_EQUAL(sample_value(body, "test_endpoint_total"), 3);
+
+        fc::http::connection other;
+        other.connect_to(server.get_local_endpoint());
+        BOOST_CHECK_EQUAL(other.request("GET", "/other").status, fc::http::reply::NotFound);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+#ifdef IS_TEST_NET
+BOOST_FIXTURE_TEST_CASE(chain_metrics, clean_database_fixture)
+{
+    try
+    {
+        generate_block();
+
+        std::string exposition = metrics().to_prometheus();
+        const double blocks_before = sample_value(exposition, "deip_blocks_applied_total");
+        const double applies_before = sample_value(exposition, "deip_block_apply_seconds_count");
+        BOOST_REQUIRE_GE(blocks_before, 1);
+        BOOST_REQUIRE_GE(applies_before, 1);
+
+        generate_blocks(5);
+
+        exposition = metrics().to_prometheus();
+        BOOST_CHECK_EQUAL(sample_value(exposition, "deip_blocks_applied_total"), blocks_before + 5);
+        BOOST_CHECK_EQUAL(sample_value(exposition, "deip_block_apply_seconds_count"), applies_before + 5);
+        BOOST_CHECK_EQUAL(sample_value(exposition, "deip_head_block_num"), db.head_block_num());
+        BOOST_CHECK_EQUAL(sample_value(exposition, "deip_last_irreversible_block_num"),
+                          db.get_dynamic_global_properties().last_irreversible_block_num);
+        BOOST_CHECK_GE(sample_value(exposition, "deip_fork_db_size"), 1);
+        BOOST_CHECK_GT(sample_value(exposition, "deip_shared_memory_free_bytes"), 0);
+        BOOST_CHECK_GE(sample_value(exposition, "deip_chain_write_locks_total"), 0);
+    }
+    FC_LOG_AND_RETHROW()
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 
 #include <deip/chain/schema/research_token_sale_object.hpp>
 #include <deip/chain/services/dbs_research_token_sale.hpp>
+#include <deip/chain/services/dbs_account_balance.hpp>
+#include <deip/chain/schema/research_object.hpp>
 
 #include "database_fixture.hpp"
 
@@ -261,6 +263,92 @@ BOOST_AUTO_TEST_CASE(get_research_token_sale_contributions_by_research_id_and_st
     FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(settle_finished_research_token_sale_over_several_blocks)
+{
+    try
+    {
+        auto& account_balance_service = db.obtain_service<dbs_account_balance>();
+
+        const uint32_t max_settlements = DEIP_MAX_TOKEN_SALE_SETTLEMENTS_PER_BLOCK;
+        const uint32_t contributions_count = max_settlements * 5 / 2;
+        const share_type security_tokens_amount = 10000;
+
+        db.create<research_object>([&](research_object& r) {
+            r.id = RESEARCH_ID;
+            fc::from_string(r.description, "abstract");
+            r.research_group = TEST_INIT_DELEGATE_NAME;
+        });
+
+        account_balance_service.freeze_account_balance(TEST_INIT_DELEGATE_NAME, asset(security_tokens_amount, DEIP_SYMBOL));
+
+        const auto& research_token_sale = db.create<research_token_sale_object>([&](research_token_sale_object& ts) {
+            ts.research_id = RESEARCH_ID;
+            ts.security_tokens_on_sale.insert(asset(security_tokens_amount, DEIP_SYMBOL));
+            ts.start_time = db.head_block_time();
+            ts.end_time = db.head_block_time() + DEIP_BLOCK_INTERVAL;
+            ts.total_amount = asset(10 * contributions_count, DEIP_SYMBOL);
+            ts.soft_cap = asset(SOFT_CAP, DEIP_SYMBOL);
+            ts.hard_cap = asset(10 * contributions_count, DEIP_SYMBOL);
+            ts.status = static_cast<uint16_t>(research_token_sale_status::active);
+        });
+        const research_token_sale_id_type research_token_sale_id = research_token_sale.id;
+
+        for (uint32_t i = 0; i < contributions_count; ++i)
+        {
+            db.create<research_token_sale_contribution_object>([&](research_token_sale_contribution_object& c) {
+                c.research_token_sale_id = research_token_sale_id;
+                c.owner = "c" + std::to_string(i);
+                c.amount = asset(10, DEIP_SYMBOL);
+                c.contribution_time = db.head_block_time();
+            });
+        }
+
+        uint32_t settled_in_block = 0;
+        std::vector<uint32_t> settled_per_block;
+
+        auto settled_connection = db.post_apply_operation.connect([&](const operation_notification& note) {
+            if (note.op.which() == operation::tag<token_sale_contribution_settled_operation>::value)
+                ++settled_in_block;
+        });
+        auto applied_block_connection = db.applied_block.connect([&](const signed_block&) {
+            settled_per_block.push_back(settled_in_block);
+            settled_in_block = 0;
+        });
+
+        const auto& settlements = db.get_index<research_token_sale_settlement_index>().indices();
+
+        generate_block();
+        BOOST_REQUIRE(settlements.size() == 1);
+
+        for (uint32_t i = 0; i < 10 && !settlements.empty(); ++i)
+            generate_block();
+
+        settled_connection.disconnect();
+        applied_block_connection.disconnect();
+
+        BOOST_CHECK(settlements.empty());
+        BOOST_CHECK(std::all_of(settled_per_block.begin(), settled_per_block.end(),
+                                [&](uint32_t settled) { return settled <= max_settlements; }));
+        BOOST_CHECK(std::accumulate(settled_per_block.begin(), settled_per_block.end(), 0u) == contributions_count);
+
+        BOOST_CHECK(data_service.get_research_token_sale_by_id(research_token_sale_id).status
+                    == static_cast<uint16_t>(research_token_sale_status::finished));
+        BOOST_CHECK(data_service.get_research_token_sale_contributions_by_research_token_sale_id(research_token_sale_id).empty());
+
+        share_type distributed = 0;
+        for (uint32_t i = 0; i < contributions_count; ++i)
+        {
+            const auto& balance = account_balance_service.get_account_balance_by_owner_and_asset("c" + std::to_string(i), DEIP_SYMBOL);
+            BOOST_CHECK(balance.amount == security_tokens_amount * 10 / (10 * contributions_count));
+            distributed += balance.amount;
+        }
+
+        BOOST_CHECK(distributed == security_tokens_amount);
+        BOOST_CHECK(account_balance_service.get_account_balance_by_owner_and_asset(TEST_INIT_DELEGATE_NAME, DEIP_SYMBOL).frozen_amount == 0);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace chain
@@ -31,6 +31,9 @@
 #include <fc/crypto/elliptic.hpp>
 #include <fc/reflect/variant.hpp>
 
+#include <graphene/net/core_messages.hpp>
+#include <graphene/net/message.hpp>
+
 #include "database_fixture.hpp"
 
 #include <cmath>
@@ -90,6 +93,51 @@ BOOST_AUTO_TEST_CASE(serialization_raw_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(compact_block_message_test)
+{
+    try
+    {
+        signed_block block;
+        block.timestamp = fc::time_point_sec(TEST_GENESIS_TIMESTAMP);
+        block.witness = TEST_INIT_DELEGATE_NAME;
+
+        for (int64_t amount : { 100, 200 })
+        {
+            transfer_operation op;
+            op.from = "alice";
+            op.to = "bob";
+            op.amount = asset(amount, DEIP_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            block.transactions.push_back(tx);
+        }
+        block.transaction_merkle_root = block.calculate_merkle_root();
+        block.sign(init_account_priv_key);
+
+        const graphene::net::message packed = graphene::net::compact_block_message(block);
+        const auto compact = packed.as<graphene::net::compact_block_message>();
+
+        BOOST_CHECK(compact.header.id() == block.id());
+        BOOST_CHECK(compact.header.signee() == init_account_pub_key);
+        BOOST_REQUIRE_EQUAL(compact.short_transaction_ids.size(), 2u);
+        BOOST_CHECK_NE(compact.short_transaction_ids[0], compact.short_transaction_ids[1]);
+
+        // the short id is the big endian prefix of the transaction id
+        const transaction_id_type trx_id = block.transactions[1].id();
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(trx_id.data());
+        BOOST_CHECK_EQUAL(compact.short_transaction_ids[1] >> 56, bytes[0]);
+        BOOST_CHECK_EQUAL(compact.short_transaction_ids[1] & 0xff, bytes[7]);
+
+        BOOST_CHECK_LT(packed.size, graphene::net::message(graphene::net::block_message(block)).size);
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
 BOOST_AUTO_TEST_CASE(json_tests)
 {
     try